@@ -0,0 +1,465 @@
+/**
+ * @file accuracy_harness.cpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Detection accuracy versus speed of the detect-and-track loop on
+ * synthetic falling objects with known trajectories
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "config.hpp"
+#include "crowd_scene.hpp"
+#include "fall_scenario.hpp"
+#include "analysis_pipeline.hpp"
+#include "synthetic_scene.hpp"
+#include "trajectory.hpp"
+
+#include <algorithm>
+#include <argparse/argparse.hpp>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <opencv2/core.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+#include <stdexcept>
+#include <string>
+#include <vector>
+namespace chrono = std::chrono;
+
+namespace {
+
+/**
+ * @brief Frame interval of the synthetic timestamps (30 fps)
+ */
+constexpr auto FRAME_INTERVAL = chrono::microseconds(33333);
+
+/**
+ * @brief Number of pre-rendered backgrounds (noise patterns) frames cycle
+ * through
+ */
+constexpr int NUM_BACKGROUNDS = 8;
+
+/**
+ * @brief Frames played after the last drop, so that trajectories in
+ * progress end and raise their alerts
+ */
+constexpr int NUM_TAIL_FRAMES = 60;
+
+/**
+ * @brief Alert raised by the tracker (a valid falling object trajectory)
+ */
+struct Alert {
+    int frameIndex; // Frame the alert was raised in
+    int drop;       // Index of the matched drop, -1: false alarm
+};
+
+/**
+ * @brief Get the frame index of a synthetic timestamp
+ *
+ * @param timestamp Timestamp
+ * @return  Frame index
+ */
+int toFrameIndex(Trajectory::Timestamp timestamp) {
+    auto elapsed = chrono::duration_cast<chrono::microseconds>(
+        timestamp.time_since_epoch());
+    return static_cast<int>((elapsed + FRAME_INTERVAL / 2) / FRAME_INTERVAL);
+}
+
+/**
+ * @brief Match a trajectory to the drop that most of its samples lie on
+ *
+ * @param trajectory Trajectory (analysis resolution)
+ * @param scenario Ground truth (full resolution)
+ * @param scale Analysis to full resolution scale {x, y}
+ * @return  Index of the matched drop, -1: matches none
+ */
+int matchDrop(const Trajectory& trajectory,
+              const FallScenario& scenario,
+              cv::Point2f scale) {
+    const auto& drops = scenario.getDrops();
+    auto votes = std::vector<int>(drops.size(), 0);
+
+    for (const auto& sample : trajectory.getSamples()) {
+        int frameIndex = toFrameIndex(sample.timestamp);
+        auto center =
+            cv::Point2f(sample.xCenter * scale.x, sample.yCenter * scale.y);
+
+        for (size_t k = 0; k < drops.size(); k++) {
+            const auto& drop = drops[k];
+            if (frameIndex < drop.startFrame || frameIndex >= drop.endFrame) {
+                continue;
+            }
+
+            // Detections carry a margin and fast objects are blurred over
+            // two frames by the tracker, so be tolerant by one object size
+            auto box = drop.getBox(frameIndex, scenario.getGravity());
+            float tolerance = std::max(box.width, box.height);
+            auto region = cv::Rect2f(box.x - tolerance,
+                                     box.y - tolerance,
+                                     box.width + 2.0F * tolerance,
+                                     box.height + 2.0F * tolerance);
+            if (region.contains(center)) {
+                votes[k]++;
+            }
+        }
+    }
+
+    auto it = std::max_element(votes.begin(), votes.end());
+    if (it == votes.end() ||
+        2 * static_cast<size_t>(*it) < trajectory.getNumSamples()) {
+        return -1;
+    }
+
+    return static_cast<int>(it - votes.begin());
+}
+
+/**
+ * @brief Setup command line arguments
+ *
+ * @return argparse::ArgumentParser arg parser
+ */
+argparse::ArgumentParser getArgParser() {
+    auto parser = argparse::ArgumentParser("accuracy_harness");
+
+    // clang-format off
+    parser.add_argument("--width")
+        .help("Frame width")
+        .default_value(1920)
+        .action([](const std::string& arg) { return std::stoi(arg); });
+
+    parser.add_argument("--height")
+        .help("Frame height")
+        .default_value(1080)
+        .action([](const std::string& arg) { return std::stoi(arg); });
+
+    parser.add_argument("--drops")
+        .help("Number of dropped objects")
+        .default_value(20)
+        .action([](const std::string& arg) { return std::stoi(arg); });
+
+    parser.add_argument("--interval")
+        .help("Frames between two drops")
+        .default_value(60)
+        .action([](const std::string& arg) { return std::stoi(arg); });
+
+    parser.add_argument("--warmup")
+        .help("Frames before the first drop")
+        .default_value(50)
+        .action([](const std::string& arg) { return std::stoi(arg); });
+
+    parser.add_argument("--gravity")
+        .help("Gravity at full resolution (pixels per frame^2)")
+        .default_value(0.7F)
+        .action([](const std::string& arg) { return std::stof(arg); });
+
+    parser.add_argument("--distractors")
+        .help("Number of drifting / jittering objects that are not falls")
+        .default_value(0)
+        .action([](const std::string& arg) { return std::stoi(arg); });
+
+    parser.add_argument("--background")
+        .help("Background image, generated when empty")
+        .default_value(std::string());
+
+    parser.add_argument("--seed")
+        .help("Scenario generator seed")
+        .default_value(42)
+        .action([](const std::string& arg) { return std::stoi(arg); });
+
+    parser.add_argument("--config")
+        .help("Tuning parameters file (YAML / JSON), defaults when empty")
+        .default_value(std::string());
+
+    parser.add_argument("--bg_engine")
+        .help("Background subtraction implementation: vibe, sigma_delta")
+        .default_value(BackgroundSubtractorEngine::VIBE)
+        .action([](const std::string& arg) {
+            return arg == "sigma_delta"
+                       ? BackgroundSubtractorEngine::SIGMA_DELTA
+                       : BackgroundSubtractorEngine::VIBE;
+        });
+
+    parser.add_argument("--blob_engine")
+        .help("Morphology and labelling implementation: native, opencv")
+        .default_value(BlobDetectorEngine::NATIVE)
+        .action([](const std::string& arg) {
+            return arg == "opencv" ? BlobDetectorEngine::OPENCV
+                                   : BlobDetectorEngine::NATIVE;
+        });
+
+    parser.add_argument("--attention_interval")
+        .help("Analyse the whole frame once every n frames, only windows "
+              "around the predicted tracks in between (1: disabled)")
+        .default_value(1)
+        .action([](const std::string& arg) { return std::stoi(arg); });
+
+    parser.add_argument("-o", "--output")
+        .help("JSON report path, none when empty")
+        .default_value(std::string());
+    // clang-format on
+
+    return parser;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    auto parser = getArgParser();
+
+    try {
+        parser.parse_args(argc, argv);
+    } catch (const std::runtime_error& e) {
+        std::printf("%s\n", e.what());
+        std::cout << parser;
+        std::exit(0);
+    }
+
+    int width = parser.get<int>("--width");
+    int height = parser.get<int>("--height");
+    int numDrops = parser.get<int>("--drops");
+    int interval = parser.get<int>("--interval");
+    int numWarmupFrames = parser.get<int>("--warmup");
+    auto gravity = parser.get<float>("--gravity");
+    int numDistractors = parser.get<int>("--distractors");
+    auto backgroundPath = parser.get<std::string>("--background");
+    auto seed = static_cast<uint32_t>(parser.get<int>("--seed"));
+    auto configPath = parser.get<std::string>("--config");
+    auto bgEngine = parser.get<BackgroundSubtractorEngine>("--bg_engine");
+    auto blobEngine = parser.get<BlobDetectorEngine>("--blob_engine");
+    auto attentionParams = AttentionSchedulerParams{
+        .fullFrameInterval = parser.get<int>("--attention_interval"),
+    };
+    auto outputPath = parser.get<std::string>("--output");
+
+    auto config = PipelineConfig();
+    if (!configPath.empty()) {
+        try {
+            config = PipelineConfig::load(configPath, config);
+        } catch (const std::invalid_argument& e) {
+            std::printf("%s\n", e.what());
+            std::exit(EXIT_FAILURE);
+        }
+    }
+
+    // Frames are analysed at the configured scale, like the application
+    // does, ground truth stays at full resolution. Keep sizes even for the
+    // scalers.
+    int analysisWidth = static_cast<int>(width * config.analysis.scale) & ~1;
+    int analysisHeight = static_cast<int>(height * config.analysis.scale) & ~1;
+    bool isScaled = analysisWidth != width || analysisHeight != height;
+    auto scale = cv::Point2f(static_cast<float>(width) / analysisWidth,
+                             static_cast<float>(height) / analysisHeight);
+
+    auto backgrounds = std::vector<cv::Mat>(NUM_BACKGROUNDS);
+    auto image = cv::Mat();
+    if (!backgroundPath.empty()) {
+        image = cv::imread(backgroundPath, cv::IMREAD_COLOR);
+        if (image.empty()) {
+            std::printf("Cannot read background %s\n", backgroundPath.c_str());
+            std::exit(EXIT_FAILURE);
+        }
+        cv::resize(image, image, {width, height}, 0, 0, cv::INTER_AREA);
+    }
+    for (int i = 0; i < NUM_BACKGROUNDS; i++) {
+        backgrounds[i].create(height, width, CV_8UC3);
+        if (image.empty()) {
+            SyntheticScene::renderBackground(backgrounds[i], seed + i);
+        } else {
+            image.copyTo(backgrounds[i]);
+            SyntheticScene::addNoise(backgrounds[i], seed + i);
+        }
+    }
+
+    auto scenario = FallScenario(
+        {width, height}, numDrops, numWarmupFrames, interval, gravity, seed);
+    auto distractors = CrowdScene(numDistractors, {width, height}, seed + 1);
+    auto pipeline = AnalysisPipeline(analysisHeight,
+                                     analysisWidth,
+                                     config,
+                                     AnalysisPipelineParams{
+                                         .blobEngine = blobEngine,
+                                         .bgEngine = bgEngine,
+                                         .attention = attentionParams,
+                                     });
+
+    auto alerts = std::vector<Alert>();
+    int frameIndex = 0;
+    pipeline.getTracker().setTrajectoryEndedCallback(
+        [&](int /*tag*/, const Trajectory& trajectory) {
+            alerts.push_back(
+                {frameIndex, matchDrop(trajectory, scenario, scale)});
+        });
+
+    auto frame = cv::Mat(height, width, CV_8UC3);
+    auto analysisFrame = cv::Mat();
+    auto boxes = std::vector<cv::Rect2f>();
+    auto detections = std::vector<cv::Rect2f>();
+    auto frameSamples = std::vector<uint64_t>();
+    int numFrames = scenario.getEndFrame() + NUM_TAIL_FRAMES;
+    int numDroppedFrames = 0;
+
+    for (; frameIndex < numFrames; frameIndex++) {
+        backgrounds[frameIndex % NUM_BACKGROUNDS].copyTo(frame);
+        scenario.getBoxes(frameIndex, boxes);
+
+        // Falling distractors would be true falls without ground truth
+        distractors.next(detections);
+        for (const auto& object : distractors.getObjects()) {
+            if (object.lifetime > 0 &&
+                object.motion != CrowdScene::Motion::FALLING) {
+                boxes.emplace_back(object.position, object.size);
+            }
+        }
+        SyntheticScene::paintObjects(frame, boxes);
+
+        if (isScaled) {
+            cv::resize(frame,
+                       analysisFrame,
+                       {analysisWidth, analysisHeight},
+                       0,
+                       0,
+                       cv::INTER_AREA);
+        } else {
+            analysisFrame = frame;
+        }
+
+        auto timestamp =
+            Trajectory::Timestamp() +
+            chrono::duration_cast<Trajectory::Duration>(FRAME_INTERVAL *
+                                                        frameIndex);
+        numDroppedFrames += pipeline.process(analysisFrame, timestamp) ? 0 : 1;
+
+        uint64_t frameNs = 0;
+        for (uint64_t ns : pipeline.getLastStageTimes()) {
+            frameNs += ns;
+        }
+        frameSamples.push_back(frameNs);
+    }
+
+    // First alert of each drop, later ones are duplicates
+    auto firstAlertFrames = std::vector<int>(numDrops, -1);
+    int numFalseAlarms = 0;
+    int numDuplicates = 0;
+    for (const auto& alert : alerts) {
+        if (alert.drop < 0) {
+            numFalseAlarms++;
+        } else if (firstAlertFrames[alert.drop] >= 0) {
+            numDuplicates++;
+        } else {
+            firstAlertFrames[alert.drop] = alert.frameIndex;
+        }
+    }
+
+    // Latency from the start of the fall and from when the object is gone
+    auto latencies = std::vector<double>();
+    auto latenciesAfterExit = std::vector<double>();
+    double frameIntervalMs =
+        chrono::duration<double, std::milli>(FRAME_INTERVAL).count();
+    for (int k = 0; k < numDrops; k++) {
+        if (firstAlertFrames[k] < 0) {
+            continue;
+        }
+        const auto& drop = scenario.getDrops()[k];
+        latencies.push_back((firstAlertFrames[k] - drop.startFrame) *
+                            frameIntervalMs);
+        latenciesAfterExit.push_back((firstAlertFrames[k] - drop.endFrame) *
+                                     frameIntervalMs);
+    }
+    std::sort(latencies.begin(), latencies.end());
+    std::sort(latenciesAfterExit.begin(), latenciesAfterExit.end());
+
+    auto getMean = [](const std::vector<double>& values) {
+        double sum = 0.0;
+        for (double value : values) {
+            sum += value;
+        }
+        return values.empty() ? 0.0 : sum / static_cast<double>(values.size());
+    };
+    auto getMax = [](const std::vector<double>& values) {
+        return values.empty() ? 0.0 : values.back();
+    };
+
+    int numDetected = static_cast<int>(latencies.size());
+    double recall = numDrops > 0 ? static_cast<double>(numDetected) / numDrops
+                                 : 0.0;
+    double totalSec = 0.0;
+    for (uint64_t ns : frameSamples) {
+        totalSec += static_cast<double>(ns) * 1e-9;
+    }
+    double fps = totalSec > 0.0 ? numFrames / totalSec : 0.0;
+    double videoMin = numFrames * frameIntervalMs / 60000.0;
+    double falseAlarmsPerMin = videoMin > 0.0 ? numFalseAlarms / videoMin : 0.0;
+
+    std::printf("[ACCURACY] %dx%d analysed at %dx%d, %d frames, %d drops, "
+                "%d distractors\n",
+                width,
+                height,
+                analysisWidth,
+                analysisHeight,
+                numFrames,
+                numDrops,
+                numDistractors);
+    std::printf("[ACCURACY] Recall %.3f (%d / %d), %d false alarms "
+                "(%.2f / min), %d duplicates, %d dropped frames\n",
+                recall,
+                numDetected,
+                numDrops,
+                numFalseAlarms,
+                falseAlarmsPerMin,
+                numDuplicates,
+                numDroppedFrames);
+    std::printf("[ACCURACY] Alert latency from fall start mean %.0f ms, max "
+                "%.0f ms; after exit mean %.0f ms\n",
+                getMean(latencies),
+                getMax(latencies),
+                getMean(latenciesAfterExit));
+    std::printf("[ACCURACY] Throughput %.1f frames/s\n", fps);
+
+    if (outputPath.empty()) {
+        return EXIT_SUCCESS;
+    }
+
+    auto* file = std::fopen(outputPath.c_str(), "w");
+    if (file == nullptr) {
+        std::printf("Cannot write report %s\n", outputPath.c_str());
+        return EXIT_FAILURE;
+    }
+
+    std::fprintf(file,
+                 "{\n"
+                 "  \"width\": %d,\n  \"height\": %d,\n"
+                 "  \"analysis_width\": %d,\n  \"analysis_height\": %d,\n"
+                 "  \"frames\": %d,\n  \"drops\": %d,\n"
+                 "  \"distractors\": %d,\n  \"dropped_frames\": %d,\n"
+                 "  \"recall\": %.4f,\n  \"false_alarms\": %d,\n"
+                 "  \"false_alarms_per_min\": %.3f,\n  \"duplicates\": %d,\n"
+                 "  \"latency_mean_ms\": %.1f,\n  \"latency_max_ms\": %.1f,\n"
+                 "  \"latency_after_exit_mean_ms\": %.1f,\n"
+                 "  \"fps\": %.3f\n"
+                 "}\n",
+                 width,
+                 height,
+                 analysisWidth,
+                 analysisHeight,
+                 numFrames,
+                 numDrops,
+                 numDistractors,
+                 numDroppedFrames,
+                 recall,
+                 numFalseAlarms,
+                 falseAlarmsPerMin,
+                 numDuplicates,
+                 getMean(latencies),
+                 getMax(latencies),
+                 getMean(latenciesAfterExit),
+                 fps);
+    std::fclose(file);
+
+    return EXIT_SUCCESS;
+}
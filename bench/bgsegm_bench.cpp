@@ -0,0 +1,257 @@
+/**
+ * @file bgsegm_bench.cpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Microbenchmarks of the background subtraction kernels
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "sigma_delta.hpp"
+#include "synthetic_scene.hpp"
+#include "vibe.hpp"
+#include "vibe_sequential.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <memory>
+#include <opencv2/core.hpp>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Frame heights (480p, 720p, 1080p, 4K) of 16:9 frames
+ */
+const std::vector<int64_t> HEIGHTS = {480, 720, 1080, 2160};
+
+/**
+ * @brief ViBeSequential sample counts, ViBe has a fixed count
+ */
+const std::vector<int64_t> SEQUENTIAL_NUM_SAMPLES = {8, 14, 20};
+
+/**
+ * @brief Foreground densities (percent of the frame)
+ */
+const std::vector<int64_t> DENSITIES = {0, 2, 10, 50};
+
+/**
+ * @brief Frames the model is warmed up with before measuring
+ */
+constexpr int NUM_WARMUP_FRAMES = 4;
+
+/**
+ * @brief Background subtractor constructed with the pipeline defaults
+ *
+ * @param height Frame height
+ * @param width Frame width
+ * @param numSamples Number of samples (ignored by ViBe and SigmaDelta)
+ * @return  Background subtractor
+ */
+template <typename T>
+std::unique_ptr<T> makeSubtractor(int height, int width, int numSamples);
+
+template <>
+std::unique_ptr<ViBeSequential>
+makeSubtractor<ViBeSequential>(int height, int width, int numSamples) {
+    return std::make_unique<ViBeSequential>(
+        height, width, numSamples, 20, 2, 5);
+}
+
+template <>
+std::unique_ptr<ViBe>
+makeSubtractor<ViBe>(int height, int width, int /*numSamples*/) {
+    return std::make_unique<ViBe>(height, width, 20, 2, 5);
+}
+
+template <>
+std::unique_ptr<SigmaDelta>
+makeSubtractor<SigmaDelta>(int height, int width, int /*numSamples*/) {
+    return std::make_unique<SigmaDelta>(height, width);
+}
+
+/**
+ * @brief Model bytes per pixel: samples, plus the two history images of
+ * ViBeSequential or the random table of ViBe
+ *
+ * @param subtractor Background subtractor
+ * @return  Bytes per pixel
+ */
+double getModelBytesPerPixel(const ViBeSequential& subtractor) {
+    return (subtractor.getNumSamples() + 2) * 3.0;
+}
+
+double getModelBytesPerPixel(const ViBe& subtractor) {
+    return (subtractor.getNumSamples() + 1) * 3.0;
+}
+
+double getModelBytesPerPixel(const SigmaDelta& /*subtractor*/) {
+    return SigmaDelta::MODEL_BYTES_PER_PIXEL;
+}
+
+/**
+ * @brief Frames and masks of one benchmark case, and a subtractor warmed up
+ * on the background
+ */
+template <typename T>
+struct BenchCase {
+    cv::Mat background;
+    cv::Mat frame;
+    cv::Mat fgMask;
+    cv::Mat updateMask;
+    std::unique_ptr<T> subtractor;
+    double fgFraction = 0.0;
+
+    explicit BenchCase(const benchmark::State& state) {
+        int height = static_cast<int>(state.range(0));
+        int width = (height * 16 / 9 + 1) & ~1;
+        int numSamples = static_cast<int>(state.range(1));
+        double density = static_cast<double>(state.range(2)) / 100.0;
+
+        background.create(height, width, CV_8UC3);
+        frame.create(height, width, CV_8UC3);
+        fgMask.create(height, width, CV_8UC1);
+        updateMask.create(height, width, CV_8UC1);
+
+        subtractor = makeSubtractor<T>(height, width, numSamples);
+        for (uint32_t i = 0; i < NUM_WARMUP_FRAMES; i++) {
+            SyntheticScene::renderBackground(background, i + 1);
+            updateMask.setTo(0);
+            subtractor->segment(background, fgMask);
+            subtractor->update(background, updateMask);
+        }
+
+        SyntheticScene::renderBackground(frame, NUM_WARMUP_FRAMES + 1);
+        int numFgPixels = SyntheticScene::paintForeground(frame, density, 7);
+        fgFraction = static_cast<double>(numFgPixels) / (height * width);
+
+        // Foreground pixels are kept out of the model, as the pipeline does
+        subtractor->segment(frame, updateMask);
+    }
+
+    /**
+     * @brief Set counters of a finished benchmark
+     *
+     * @param state Benchmark state
+     * @return
+     */
+    void report(benchmark::State& state) const {
+        double numPixels = static_cast<double>(frame.total());
+        state.counters["pixels/s"] = benchmark::Counter(
+            numPixels, benchmark::Counter::kIsIterationInvariantRate);
+        state.counters["bytes/pixel"] = getModelBytesPerPixel(*subtractor);
+        state.counters["fg"] = fgFraction;
+        state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) *
+                                static_cast<int64_t>(frame.total()) * 4);
+    }
+};
+
+/**
+ * @brief Classify every pixel of a frame against a warmed-up model
+ */
+template <typename T>
+void BM_Segment(benchmark::State& state) {
+    auto bench = BenchCase<T>(state);
+
+    for (auto _ : state) {
+        bench.subtractor->segment(bench.frame, bench.fgMask);
+        benchmark::DoNotOptimize(bench.fgMask.data);
+        benchmark::ClobberMemory();
+    }
+
+    bench.report(state);
+}
+
+/**
+ * @brief Refresh the model with the background pixels of a frame
+ */
+template <typename T>
+void BM_Update(benchmark::State& state) {
+    auto bench = BenchCase<T>(state);
+
+    for (auto _ : state) {
+        bench.subtractor->update(bench.frame, bench.updateMask);
+        benchmark::ClobberMemory();
+    }
+
+    bench.report(state);
+}
+
+/**
+ * @brief Build the model from a first frame (after clear()), the first
+ * frame is segmented as well
+ */
+template <typename T>
+void BM_Init(benchmark::State& state) {
+    auto bench = BenchCase<T>(state);
+
+    for (auto _ : state) {
+        bench.subtractor->clear();
+        bench.subtractor->segment(bench.background, bench.fgMask);
+        benchmark::DoNotOptimize(bench.fgMask.data);
+        benchmark::ClobberMemory();
+    }
+
+    bench.report(state);
+}
+
+} // namespace
+
+// ViBe parallelises over cv::parallel_for_, so wall time is reported
+BENCHMARK_TEMPLATE(BM_Segment, ViBeSequential)
+    ->ArgsProduct({HEIGHTS, SEQUENTIAL_NUM_SAMPLES, DENSITIES})
+    ->ArgNames({"height", "samples", "fg"})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_Segment, ViBe)
+    ->ArgsProduct({HEIGHTS, {16}, DENSITIES})
+    ->ArgNames({"height", "samples", "fg"})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_Segment, SigmaDelta)
+    ->ArgsProduct({HEIGHTS, {0}, DENSITIES})
+    ->ArgNames({"height", "samples", "fg"})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_Update, ViBeSequential)
+    ->ArgsProduct({HEIGHTS, SEQUENTIAL_NUM_SAMPLES, DENSITIES})
+    ->ArgNames({"height", "samples", "fg"})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_Update, ViBe)
+    ->ArgsProduct({HEIGHTS, {16}, DENSITIES})
+    ->ArgNames({"height", "samples", "fg"})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_Update, SigmaDelta)
+    ->ArgsProduct({HEIGHTS, {0}, DENSITIES})
+    ->ArgNames({"height", "samples", "fg"})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_Init, ViBeSequential)
+    ->ArgsProduct({HEIGHTS, SEQUENTIAL_NUM_SAMPLES, {0}})
+    ->ArgNames({"height", "samples", "fg"})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_Init, ViBe)
+    ->ArgsProduct({HEIGHTS, {16}, {0}})
+    ->ArgNames({"height", "samples", "fg"})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK_TEMPLATE(BM_Init, SigmaDelta)
+    ->ArgsProduct({HEIGHTS, {0}, {0}})
+    ->ArgNames({"height", "samples", "fg"})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,352 @@
+/**
+ * @file blob_detector_bench.cpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Benchmark of the foreground mask post-processing chain (morphology
+ * and blob extraction) of each engine on synthetic masks, on the whole mask
+ * or around its active tiles, with the results cross-checked before timing
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "active_tiles.hpp"
+#include "blob_detector.hpp"
+#include "synthetic_scene.hpp"
+
+#include <algorithm>
+#include <array>
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <opencv2/core.hpp>
+#include <tuple>
+#include <vector>
+namespace chrono = std::chrono;
+
+namespace {
+
+constexpr std::array<BlobDetectorEngine, 2> ENGINES{
+    BlobDetectorEngine::OPENCV,
+    BlobDetectorEngine::NATIVE,
+};
+
+constexpr std::array<const char*, 2> ENGINE_NAMES{"opencv", "native"};
+
+/**
+ * @brief Numbers of blobs in a mask
+ */
+const std::vector<int64_t> NUM_BLOBS = {0, 8, 64, 512};
+
+/**
+ * @brief Noise densities (per mille of pixels)
+ */
+const std::vector<int64_t> NOISE_DENSITIES = {0, 10, 50};
+
+const cv::Size FRAME_SIZE = {1920, 1080};
+
+/**
+ * @brief Number of different masks iterations cycle through
+ */
+constexpr int NUM_MASKS = 4;
+
+/**
+ * @brief Parameters with blob and run limits far above what the filtered
+ * masks have, so that every mask goes through the whole chain instead of
+ * being rejected as too noisy
+ *
+ * @param engine Engine
+ * @return  Parameters
+ */
+BlobDetectorParams getParams(BlobDetectorEngine engine) {
+    auto params = BlobDetectorParams();
+    params.engine = engine;
+    params.maxNumBlobs = 1 << 16;
+    params.maxNumRuns = 1 << 20;
+    return params;
+}
+
+/**
+ * @brief Render the masks of a case
+ *
+ * @param numBlobs Number of blobs
+ * @param noiseDensity Noise density (per mille)
+ * @return  Masks
+ */
+std::vector<cv::Mat> renderMasks(int numBlobs, int noiseDensity) {
+    auto masks = std::vector<cv::Mat>(NUM_MASKS);
+    for (int i = 0; i < NUM_MASKS; i++) {
+        masks[i].create(FRAME_SIZE, CV_8UC1);
+        SyntheticScene::renderMask(
+            masks[i], numBlobs, noiseDensity * 1e-3, 42U + i);
+    }
+    return masks;
+}
+
+/**
+ * @brief Nanoseconds elapsed since a time point, which is then moved to now
+ *
+ * @param last Time point
+ * @return  Elapsed time (ns)
+ */
+uint64_t lap(chrono::steady_clock::time_point& last) {
+    auto now = chrono::steady_clock::now();
+    auto ns = chrono::duration_cast<chrono::nanoseconds>(now - last).count();
+    last = now;
+    return static_cast<uint64_t>(ns);
+}
+
+/**
+ * @brief Run the post-processing chain on one mask, in the order of the
+ * detection loop
+ *
+ * @param detector Blob detector
+ * @param tiles Active tiles, whole mask when null
+ * @param fgMask Foreground mask, filtered in place
+ * @param updateMask Output update mask
+ * @param detections Output detections
+ * @param times Time (ns) of tiles, update mask, filter and extract, added to
+ * @return  Number of blobs
+ */
+int postProcess(BlobDetector& detector,
+                ActiveTiles* tiles,
+                cv::Mat& fgMask,
+                cv::Mat& updateMask,
+                std::vector<cv::Rect2f>& detections,
+                std::array<double, 4>& times) {
+    auto last = chrono::steady_clock::now();
+    bool isSparse = tiles != nullptr && tiles->build(fgMask);
+    times[0] += static_cast<double>(lap(last));
+
+    if (!isSparse) {
+        detector.makeUpdateMask(fgMask, updateMask);
+        times[1] += static_cast<double>(lap(last));
+        detector.filter(fgMask);
+        times[2] += static_cast<double>(lap(last));
+        int numBlobs = detector.extract(fgMask, detections);
+        times[3] += static_cast<double>(lap(last));
+        return numBlobs;
+    }
+
+    const auto& windows = tiles->getWindows();
+    updateMask.setTo(0);
+    detector.makeUpdateMask(fgMask, updateMask, windows);
+    times[1] += static_cast<double>(lap(last));
+    detector.filter(fgMask, windows);
+    times[2] += static_cast<double>(lap(last));
+    int numBlobs = detector.extract(fgMask, detections, windows);
+    times[3] += static_cast<double>(lap(last));
+    return numBlobs;
+}
+
+/**
+ * @brief Time the post-processing chain of one mask per iteration
+ */
+void BM_PostProcess(benchmark::State& state) {
+    auto engine = ENGINES[static_cast<size_t>(state.range(0))];
+    bool isTiled = state.range(1) != 0;
+    auto masks = renderMasks(static_cast<int>(state.range(2)),
+                             static_cast<int>(state.range(3)));
+
+    auto detector =
+        BlobDetector(FRAME_SIZE.height, FRAME_SIZE.width, getParams(engine));
+    auto tiles = ActiveTiles(FRAME_SIZE.height, FRAME_SIZE.width);
+    auto fgMask = cv::Mat(FRAME_SIZE, CV_8UC1);
+    auto updateMask = cv::Mat(FRAME_SIZE, CV_8UC1);
+    auto detections = std::vector<cv::Rect2f>();
+
+    auto totalTimes = std::array<double, 4>();
+    double numBlobs = 0.0;
+    int64_t i = 0;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        masks[i++ % NUM_MASKS].copyTo(fgMask);
+        state.ResumeTiming();
+
+        numBlobs += postProcess(detector,
+                                isTiled ? &tiles : nullptr,
+                                fgMask,
+                                updateMask,
+                                detections,
+                                totalTimes);
+    }
+
+    // Per mask averages, stage times in ms
+    state.counters["tiles"] = benchmark::Counter(
+        totalTimes[0] * 1e-6, benchmark::Counter::kAvgIterations);
+    state.counters["update_mask"] = benchmark::Counter(
+        totalTimes[1] * 1e-6, benchmark::Counter::kAvgIterations);
+    state.counters["filter"] = benchmark::Counter(
+        totalTimes[2] * 1e-6, benchmark::Counter::kAvgIterations);
+    state.counters["extract"] = benchmark::Counter(
+        totalTimes[3] * 1e-6, benchmark::Counter::kAvgIterations);
+    state.counters["blobs"] =
+        benchmark::Counter(numBlobs, benchmark::Counter::kAvgIterations);
+}
+
+/**
+ * @brief Register every engine x tiling x blob count x noise density case
+ *
+ * @param benchmark Benchmark
+ * @return
+ */
+void registerCases(benchmark::internal::Benchmark* benchmark) {
+    for (size_t engine = 0; engine < ENGINES.size(); engine++) {
+        for (int64_t isTiled : {0, 1}) {
+            for (int64_t numBlobs : NUM_BLOBS) {
+                for (int64_t noiseDensity : NOISE_DENSITIES) {
+                    benchmark->Args({static_cast<int64_t>(engine),
+                                     isTiled,
+                                     numBlobs,
+                                     noiseDensity});
+                }
+            }
+        }
+    }
+}
+
+/**
+ * @brief Tells whether two masks are identical
+ *
+ * @param a Mask
+ * @param b Mask
+ * @return  True: identical
+ */
+bool isMaskEqual(const cv::Mat& a, const cv::Mat& b) {
+    return cv::countNonZero(a != b) == 0;
+}
+
+/**
+ * @brief Tells whether two blob lists are identical, whatever order the
+ * engines labelled the blobs in
+ *
+ * @param a Blobs, sorted
+ * @param b Blobs, sorted
+ * @return  True: identical
+ */
+bool isBlobsEqual(std::vector<BlobDetector::Blob> a,
+                  std::vector<BlobDetector::Blob> b) {
+    auto toTuple = [](const BlobDetector::Blob& blob) {
+        const auto& bbox = blob.bbox;
+        return std::make_tuple(
+            bbox.y, bbox.x, bbox.height, bbox.width, blob.area);
+    };
+    auto isBefore = [&](const auto& lhs, const auto& rhs) {
+        return toTuple(lhs) < toTuple(rhs);
+    };
+    auto isSame = [&](const auto& lhs, const auto& rhs) {
+        return toTuple(lhs) == toTuple(rhs);
+    };
+
+    std::sort(a.begin(), a.end(), isBefore);
+    std::sort(b.begin(), b.end(), isBefore);
+    return a.size() == b.size() &&
+           std::equal(a.begin(), a.end(), b.begin(), isSame);
+}
+
+/**
+ * @brief Run the chain of every engine, on the whole mask and around active
+ * tiles, on the masks of every case and compare the masks and the blobs
+ * with those of the first engine on the whole mask
+ *
+ * @return  Number of mismatched masks
+ */
+int crossCheckEngines() {
+    // Every engine on the whole mask, then every engine with tiles
+    constexpr size_t NUM_CHAINS = ENGINES.size() * 2;
+    auto detectors = std::vector<BlobDetector>();
+    detectors.reserve(NUM_CHAINS);
+    for (size_t k = 0; k < NUM_CHAINS; k++) {
+        detectors.emplace_back(FRAME_SIZE.height,
+                               FRAME_SIZE.width,
+                               getParams(ENGINES[k % ENGINES.size()]));
+    }
+    auto tiles = ActiveTiles(FRAME_SIZE.height, FRAME_SIZE.width);
+
+    // The native engine writes into preallocated masks only
+    auto fgMasks = std::vector<cv::Mat>(NUM_CHAINS);
+    auto updateMasks = std::vector<cv::Mat>(NUM_CHAINS);
+    for (size_t k = 0; k < NUM_CHAINS; k++) {
+        fgMasks[k].create(FRAME_SIZE, CV_8UC1);
+        updateMasks[k].create(FRAME_SIZE, CV_8UC1);
+    }
+    auto detections = std::vector<cv::Rect2f>();
+    auto times = std::array<double, 4>();
+
+    int numMasks = 0;
+    int numMismatches = 0;
+
+    for (int64_t numBlobs : NUM_BLOBS) {
+        for (int64_t noiseDensity : NOISE_DENSITIES) {
+            auto masks = renderMasks(static_cast<int>(numBlobs),
+                                     static_cast<int>(noiseDensity));
+
+            for (int i = 0; i < NUM_MASKS; i++, numMasks++) {
+                bool isRejected = false;
+                for (size_t k = 0; k < NUM_CHAINS; k++) {
+                    masks[i].copyTo(fgMasks[k]);
+                    int numFgBlobs =
+                        postProcess(detectors[k],
+                                    k < ENGINES.size() ? nullptr : &tiles,
+                                    fgMasks[k],
+                                    updateMasks[k],
+                                    detections,
+                                    times);
+                    isRejected |= numFgBlobs > detectors[k].getMaxNumBlobs();
+                }
+
+                bool isEqual = !isRejected;
+                for (size_t k = 1; k < NUM_CHAINS && isEqual; k++) {
+                    isEqual = isMaskEqual(updateMasks[k], updateMasks[0]) &&
+                              isMaskEqual(fgMasks[k], fgMasks[0]) &&
+                              isBlobsEqual(detectors[k].getBlobs(),
+                                           detectors[0].getBlobs());
+                }
+
+                if (!isEqual) {
+                    std::printf("[BLOB DETECTOR BENCH] Chains disagree on "
+                                "mask %d of %lld blobs, noise %lld%s\n",
+                                i,
+                                static_cast<long long>(numBlobs),
+                                static_cast<long long>(noiseDensity),
+                                isRejected ? " (rejected as too noisy)" : "");
+                    numMismatches++;
+                }
+            }
+        }
+    }
+
+    std::printf("[BLOB DETECTOR BENCH] Engines and tiles cross-checked on "
+                "%d masks, %d mismatched\n",
+                numMasks,
+                numMismatches);
+
+    return numMismatches;
+}
+
+} // namespace
+
+BENCHMARK(BM_PostProcess)
+    ->Apply(registerCases)
+    ->ArgNames({"engine", "tiles", "blobs", "noise"})
+    ->Unit(benchmark::kMillisecond);
+
+int main(int argc, char* argv[]) {
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return EXIT_FAILURE;
+    }
+
+    // Timing engines that disagree is meaningless
+    if (crossCheckEngines() > 0) {
+        return EXIT_FAILURE;
+    }
+
+    benchmark::RunSpecifiedBenchmarks();
+
+    return EXIT_SUCCESS;
+}
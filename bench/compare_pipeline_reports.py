@@ -0,0 +1,92 @@
+"""Compare two pipeline_bench JSON reports.
+
+Prints every metric of the baseline and the candidate side by side, and exits
+with status 1 when the candidate regresses beyond the thresholds:
+
+    python3 compare_pipeline_reports.py baseline.json candidate.json \
+        --time-threshold 10 --memory-threshold 10
+"""
+
+import argparse
+import json
+import sys
+
+
+def get_metrics(report):
+    """Flatten a report into {name: (value, higher_is_better, kind)}."""
+    metrics = {"fps": (report["fps"], True, "time")}
+    for stage, summary in report["stages"].items():
+        for key in ("mean_ms", "p50_ms", "p99_ms"):
+            metrics[f"{stage}.{key}"] = (summary[key], False, "time")
+    metrics["peak_rss_kb"] = (report["peak_rss_kb"], False, "memory")
+    metrics["allocations"] = (report["allocations"], False, "memory")
+    return metrics
+
+
+def get_regression(baseline, candidate, higher_is_better):
+    """Relative regression (percent), negative when the candidate is better."""
+    delta = baseline - candidate if higher_is_better else candidate - baseline
+    if baseline == 0:
+        # E.g. allocations appearing in a loop that had none
+        return float("inf") if delta > 0 else 0.0
+    return 100.0 * delta / abs(baseline)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("baseline", help="Baseline report")
+    parser.add_argument("candidate", help="Candidate report")
+    parser.add_argument("--time-threshold", type=float, default=10.0,
+                        help="Allowed regression of frames/s and stage "
+                             "latencies (percent)")
+    parser.add_argument("--memory-threshold", type=float, default=10.0,
+                        help="Allowed regression of peak RSS and allocation "
+                             "count (percent)")
+    parser.add_argument("--ignore-p99", action="store_true",
+                        help="Don't fail on p99 latencies (noisy on short "
+                             "runs)")
+    args = parser.parse_args()
+
+    with open(args.baseline) as f:
+        baseline = json.load(f)
+    with open(args.candidate) as f:
+        candidate = json.load(f)
+
+    for key in ("width", "height", "frames", "objects"):
+        if baseline.get(key) != candidate.get(key):
+            print(f"[WARNING] {key} differs: {baseline.get(key)} vs "
+                  f"{candidate.get(key)}")
+
+    thresholds = {"time": args.time_threshold,
+                  "memory": args.memory_threshold}
+    baseline_metrics = get_metrics(baseline)
+    candidate_metrics = get_metrics(candidate)
+
+    failures = []
+    print(f"{'metric':<24}{'baseline':>14}{'candidate':>14}{'change':>10}")
+    for name, (value, higher_is_better, kind) in baseline_metrics.items():
+        if name not in candidate_metrics:
+            continue
+        new_value = candidate_metrics[name][0]
+        regression = get_regression(value, new_value, higher_is_better)
+        change = (100.0 * (new_value - value) / value) if value else 0.0
+
+        is_checked = not (args.ignore_p99 and name.endswith("p99_ms"))
+        is_failed = is_checked and regression > thresholds[kind]
+        if is_failed:
+            failures.append(name)
+
+        print(f"{name:<24}{value:>14.4g}{new_value:>14.4g}{change:>+9.1f}%"
+              f"{'  REGRESSION' if is_failed else ''}")
+
+    if failures:
+        print(f"[FAILED] {len(failures)} metric(s) regressed: "
+              f"{', '.join(failures)}")
+        return 1
+
+    print("[PASSED] No regression beyond thresholds")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
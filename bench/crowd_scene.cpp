@@ -0,0 +1,157 @@
+/**
+ * @file crowd_scene.cpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Implementation of deterministic synthetic object motion
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "crowd_scene.hpp"
+
+#include <cmath>
+
+namespace {
+
+/**
+ * @brief Gravity of falling objects (pixels per frame^2)
+ */
+constexpr float GRAVITY = 0.7F;
+
+/**
+ * @brief Largest speed of drifting objects (pixels per frame)
+ */
+constexpr float MAX_DRIFT_SPEED = 4.0F;
+
+/**
+ * @brief Largest step of jittering objects (pixels per frame)
+ */
+constexpr float MAX_JITTER = 2.0F;
+
+/**
+ * @brief Lifetime range of an object (frames)
+ */
+constexpr int MIN_LIFETIME = 30;
+constexpr int MAX_LIFETIME = 150;
+
+/**
+ * @brief Largest number of frames a slot stays empty
+ */
+constexpr int MAX_HIDDEN_FRAMES = 10;
+
+/**
+ * @brief Size range of an object (pixels)
+ */
+constexpr float MIN_OBJECT_SIZE = 8.0F;
+constexpr float MAX_OBJECT_SIZE = 32.0F;
+
+} // namespace
+
+CrowdScene::CrowdScene(int numObjects, cv::Size frameSize, uint32_t seed)
+    : _objects(numObjects), _frameSize(frameSize), _seed(seed) {
+    // Slots start at different points of their lifetime, so that objects
+    // don't all appear and disappear at once
+    for (auto& object : _objects) {
+        spawn(object);
+        object.lifetime = 1 + static_cast<int>(
+                                  nextUniform() *
+                                  static_cast<float>(object.lifetime));
+    }
+}
+
+void CrowdScene::next(std::vector<cv::Rect2f>& detections) {
+    detections.clear();
+
+    for (auto& object : _objects) {
+        if (object.lifetime <= 0) {
+            if (--object.hiddenFrames < 0) {
+                spawn(object);
+            }
+            continue;
+        }
+
+        move(object);
+        object.lifetime--;
+
+        auto bbox = cv::Rect2f(object.position, object.size);
+        // Objects leaving the canvas disappear
+        if ((bbox & cv::Rect2f(0.0F,
+                               0.0F,
+                               static_cast<float>(_frameSize.width),
+                               static_cast<float>(_frameSize.height)))
+                .empty()) {
+            object.lifetime = 0;
+            continue;
+        }
+
+        if (nextUniform() < MISS_RATE) {
+            continue;
+        }
+
+        // Detected bboxes are off by a pixel or so
+        detections.emplace_back(bbox.x + nextUniform() - 0.5F,
+                                bbox.y + nextUniform() - 0.5F,
+                                bbox.width + nextUniform() - 0.5F,
+                                bbox.height + nextUniform() - 0.5F);
+    }
+}
+
+float CrowdScene::nextUniform() {
+    _seed = _seed * 1664525U + 1013904223U;
+    return static_cast<float>(_seed >> 8U) / static_cast<float>(1U << 24U);
+}
+
+void CrowdScene::spawn(Object& object) {
+    auto width = static_cast<float>(_frameSize.width);
+    auto height = static_cast<float>(_frameSize.height);
+    float sizeRange = MAX_OBJECT_SIZE - MIN_OBJECT_SIZE;
+
+    object.motion = static_cast<Motion>(static_cast<int>(nextUniform() * 3.0F));
+    object.size = {MIN_OBJECT_SIZE + sizeRange * nextUniform(),
+                   MIN_OBJECT_SIZE + sizeRange * nextUniform()};
+    object.anchor = {nextUniform() * width, nextUniform() * height};
+    object.velocity = {0.0F, 0.0F};
+
+    switch (object.motion) {
+    case Motion::FALLING:
+        // Dropped from the upper half with a little sideways speed
+        object.anchor.y *= 0.5F;
+        object.velocity.x = nextUniform() - 0.5F;
+        break;
+    case Motion::DRIFTING: {
+        float angle = 2.0F * static_cast<float>(CV_PI) * nextUniform();
+        float speed = MAX_DRIFT_SPEED * nextUniform();
+        object.velocity = {speed * std::cos(angle), speed * std::sin(angle)};
+        break;
+    }
+    case Motion::JITTERING:
+    default: break;
+    }
+
+    object.position = object.anchor;
+    object.lifetime =
+        MIN_LIFETIME + static_cast<int>(
+                           nextUniform() *
+                           static_cast<float>(MAX_LIFETIME - MIN_LIFETIME));
+    object.hiddenFrames =
+        static_cast<int>(nextUniform() * (MAX_HIDDEN_FRAMES + 1));
+}
+
+void CrowdScene::move(Object& object) {
+    switch (object.motion) {
+    case Motion::FALLING:
+        object.velocity.y += GRAVITY;
+        object.position += object.velocity;
+        break;
+    case Motion::DRIFTING: object.position += object.velocity; break;
+    case Motion::JITTERING:
+    default:
+        object.position.x += MAX_JITTER * (2.0F * nextUniform() - 1.0F);
+        object.position.y += MAX_JITTER * (2.0F * nextUniform() - 1.0F);
+        // Pulled back so that the walk stays around its anchor
+        object.position += 0.1F * (object.anchor - object.position);
+        break;
+    }
+}
@@ -0,0 +1,125 @@
+/**
+ * @file crowd_scene.hpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Deterministic synthetic object motion for tracker benchmarks
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+
+#include <cstdint>
+#include <opencv2/core.hpp>
+#include <vector>
+
+/**
+ * @brief Generates per-frame detections of a fixed number of object slots
+ *        without any video file. Each slot holds a falling, drifting or
+ *        jittering object for a random lifetime, then stays empty for a few
+ *        frames and respawns somewhere else. Detections are occasionally
+ *        missed, like the blob detector does.
+ */
+class CrowdScene final {
+  public:
+#pragma region Public types
+
+    /**
+     * @brief Motion of an object
+     */
+    enum class Motion {
+        FALLING,   // Accelerating downwards from the upper part
+        DRIFTING,  // Constant velocity in any direction
+        JITTERING, // Random walk around a fixed point
+    };
+
+    /**
+     * @brief Object in a slot
+     */
+    struct Object {
+        Motion motion;
+        cv::Point2f anchor;   // Spawn point (JITTERING: center of the walk)
+        cv::Point2f position; // Top-left corner
+        cv::Point2f velocity; // Pixels per frame
+        cv::Size2f size;
+        int lifetime;         // Frames left, <= 0: slot is empty
+        int hiddenFrames;     // Frames left before an empty slot respawns
+    };
+
+#pragma endregion
+
+#pragma region Public member methods
+
+    /**
+     * @brief Construct a new CrowdScene object
+     *
+     * @param numObjects Number of object slots (concurrent objects)
+     * @param frameSize Size of the canvas objects move in
+     * @param seed Generator seed, the same seed gives the same sequence
+     * @return
+     */
+    CrowdScene(int numObjects, cv::Size frameSize, uint32_t seed);
+
+    /**
+     * @brief Advance the scene by one frame
+     *
+     * @param detections Output detected bboxes (cleared first)
+     * @return
+     */
+    void next(std::vector<cv::Rect2f>& detections);
+
+    /**
+     * @brief Get the objects of the current frame
+     *
+     * @return  Objects, one per slot
+     */
+    const std::vector<Object>& getObjects() const { return _objects; }
+
+#pragma endregion
+
+#pragma region Public constants
+
+    /**
+     * @brief Probability that a visible object is not detected in a frame
+     */
+    static constexpr float MISS_RATE = 0.05F;
+
+#pragma endregion
+
+  private:
+#pragma region Private member variables
+
+    std::vector<Object> _objects;
+    cv::Size _frameSize;
+    uint32_t _seed;
+
+#pragma endregion
+
+#pragma region Private member methods
+
+    /**
+     * @brief Next uniform value in [0, 1)
+     *
+     * @return  Value
+     */
+    float nextUniform();
+
+    /**
+     * @brief Put a new object in a slot
+     *
+     * @param object Slot
+     * @return
+     */
+    void spawn(Object& object);
+
+    /**
+     * @brief Move an object by one frame
+     *
+     * @param object Object
+     * @return
+     */
+    void move(Object& object);
+
+#pragma endregion
+};
@@ -0,0 +1,97 @@
+/**
+ * @file fall_scenario.cpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Implementation of synthetic falling objects with known trajectories
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "fall_scenario.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+/**
+ * @brief Size range of a dropped object (fraction of the frame height)
+ */
+constexpr float MIN_OBJECT_SIZE = 0.012F;
+constexpr float MAX_OBJECT_SIZE = 0.04F;
+
+/**
+ * @brief Next uniform value in [0, 1) of a linear congruential generator
+ *
+ * @param seed Generator state
+ * @return  Value
+ */
+float nextUniform(uint32_t& seed) {
+    seed = seed * 1664525U + 1013904223U;
+    return static_cast<float>(seed >> 8U) / static_cast<float>(1U << 24U);
+}
+
+} // namespace
+
+cv::Rect2f FallScenario::Drop::getBox(int frameIndex, float gravity) const {
+    auto t = static_cast<float>(frameIndex - startFrame);
+    return {position.x + xVelocity * t,
+            position.y + 0.5F * gravity * t * t,
+            size.width,
+            size.height};
+}
+
+FallScenario::FallScenario(cv::Size frameSize,
+                           int numDrops,
+                           int firstFrame,
+                           int interval,
+                           float gravity,
+                           uint32_t seed)
+    : _drops(numDrops), _gravity(gravity) {
+    auto width = static_cast<float>(frameSize.width);
+    auto height = static_cast<float>(frameSize.height);
+    auto bounds = cv::Rect2f(0.0F, 0.0F, width, height);
+    float sizeRange = MAX_OBJECT_SIZE - MIN_OBJECT_SIZE;
+
+    // Objects that never fall would never leave the frame
+    CV_Assert(gravity > 0.0F);
+
+    for (int i = 0; i < numDrops; i++) {
+        auto& drop = _drops[i];
+        float side = height * (MIN_OBJECT_SIZE + sizeRange * nextUniform(seed));
+
+        drop.startFrame = firstFrame + i * interval;
+        drop.size = {side, side * (0.6F + 0.8F * nextUniform(seed))};
+        // Dropped from the upper quarter, away from the sides
+        drop.position = {(0.1F + 0.8F * nextUniform(seed)) * width,
+                         0.25F * nextUniform(seed) * height};
+        drop.xVelocity = 2.0F * nextUniform(seed) - 1.0F;
+
+        // Falls until it is entirely out of view
+        drop.endFrame = drop.startFrame;
+        while ((drop.getBox(drop.endFrame, gravity) & bounds).area() > 0.0F) {
+            drop.endFrame++;
+        }
+    }
+}
+
+void FallScenario::getBoxes(int frameIndex,
+                            std::vector<cv::Rect2f>& boxes) const {
+    boxes.clear();
+    for (const auto& drop : _drops) {
+        if (frameIndex >= drop.startFrame && frameIndex < drop.endFrame) {
+            boxes.push_back(drop.getBox(frameIndex, _gravity));
+        }
+    }
+}
+
+int FallScenario::getEndFrame() const {
+    int endFrame = 0;
+    for (const auto& drop : _drops) {
+        endFrame = std::max(endFrame, drop.endFrame);
+    }
+
+    return endFrame;
+}
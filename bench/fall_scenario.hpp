@@ -0,0 +1,97 @@
+/**
+ * @file fall_scenario.hpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Synthetic falling objects with known trajectories
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+
+#include <cstdint>
+#include <opencv2/core.hpp>
+#include <vector>
+
+/**
+ * @brief Ground truth of a series of objects dropped one after another from
+ *        the upper part of the frame, each falls freely until it leaves the
+ *        frame
+ */
+class FallScenario final {
+  public:
+#pragma region Public types
+
+    /**
+     * @brief One dropped object
+     */
+    struct Drop {
+        int startFrame;       // Frame the object appears in
+        int endFrame;         // First frame the object is out of view
+        cv::Point2f position; // Top-left corner at the start frame
+        float xVelocity;      // Sideways speed (pixels per frame)
+        cv::Size2f size;
+
+        /**
+         * @brief Get the bbox of the object in a frame
+         *
+         * @param frameIndex Frame index, in [startFrame, endFrame)
+         * @param gravity Gravity (pixels per frame^2)
+         * @return  Bbox
+         */
+        cv::Rect2f getBox(int frameIndex, float gravity) const;
+    };
+
+#pragma endregion
+
+#pragma region Public member methods
+
+    /**
+     * @brief Construct a new FallScenario object
+     *
+     * @param frameSize Frame size
+     * @param numDrops Number of dropped objects
+     * @param firstFrame Start frame of the first drop
+     * @param interval Frames between the starts of consecutive drops
+     * @param gravity Gravity (pixels per frame^2)
+     * @param seed Generator seed
+     * @return
+     */
+    FallScenario(cv::Size frameSize,
+                 int numDrops,
+                 int firstFrame,
+                 int interval,
+                 float gravity,
+                 uint32_t seed);
+
+    /**
+     * @brief Get the bboxes of all objects in view in a frame
+     *
+     * @param frameIndex Frame index
+     * @param boxes Output bboxes (cleared first)
+     * @return
+     */
+    void getBoxes(int frameIndex, std::vector<cv::Rect2f>& boxes) const;
+
+    const std::vector<Drop>& getDrops() const { return _drops; }
+
+    float getGravity() const { return _gravity; }
+
+    /**
+     * @brief Get the frame after which no object is in view
+     *
+     * @return  End frame of the last drop
+     */
+    int getEndFrame() const;
+
+#pragma endregion
+
+  private:
+#pragma region Private member variables
+
+    std::vector<Drop> _drops;
+    float _gravity;
+
+#pragma endregion
+};
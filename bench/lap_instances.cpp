@@ -0,0 +1,157 @@
+/**
+ * @file lap_instances.cpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Implementation of generated linear assignment problem instances
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "lap_instances.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace {
+
+/**
+ * @brief Next uniform value in [0, 1) of a linear congruential generator
+ *
+ * @param seed Generator state
+ * @return  Value
+ */
+float nextUniform(uint32_t& seed) {
+    seed = seed * 1664525U + 1013904223U;
+    return static_cast<float>(seed >> 8U) / static_cast<float>(1U << 24U);
+}
+
+/**
+ * @brief IoU of two boxes
+ *
+ * @param a Box A
+ * @param b Box B
+ * @return  IoU
+ */
+float getIoU(const cv::Rect2f& a, const cv::Rect2f& b) {
+    float intersection = (a & b).area();
+    float area = a.area() + b.area() - intersection;
+    return area > 0.0F ? intersection / area : 0.0F;
+}
+
+} // namespace
+
+LAPInstance LAPInstances::make(LAPInstanceKind kind, int size, uint32_t seed) {
+    auto instance = LAPInstance();
+
+    switch (kind) {
+    case LAPInstanceKind::DENSE:
+    case LAPInstanceKind::RECTANGULAR: {
+        int rows = kind == LAPInstanceKind::RECTANGULAR ? 2 * size : size;
+        instance.cost.create(rows, size, CV_32F);
+        for (int i = 0; i < rows; i++) {
+            auto* row = instance.cost.ptr<float>(i);
+            for (int j = 0; j < size; j++) {
+                row[j] = nextUniform(seed);
+            }
+        }
+        break;
+    }
+    case LAPInstanceKind::SPARSE_IOU: {
+        // About one box per 64x64 cell, moved by a few pixels per frame
+        float canvas = 64.0F * std::ceil(std::sqrt(static_cast<float>(size)));
+        auto boxes = std::vector<cv::Rect2f>(size);
+        auto moved = std::vector<cv::Rect2f>(size);
+        for (int i = 0; i < size; i++) {
+            float w = 12.0F + 36.0F * nextUniform(seed);
+            float h = 12.0F + 36.0F * nextUniform(seed);
+            boxes[i] = {nextUniform(seed) * canvas,
+                        nextUniform(seed) * canvas,
+                        w,
+                        h};
+            moved[i] = {boxes[i].x + 8.0F * (nextUniform(seed) - 0.5F),
+                        boxes[i].y + 12.0F * nextUniform(seed),
+                        w,
+                        h};
+        }
+
+        // Detections come in a different order than tracks
+        for (int i = size - 1; i > 0; i--) {
+            int k = static_cast<int>(nextUniform(seed) * (i + 1));
+            std::swap(moved[i], moved[std::min(k, i)]);
+        }
+
+        instance.cost.create(size, size, CV_32F);
+        for (int i = 0; i < size; i++) {
+            auto* row = instance.cost.ptr<float>(i);
+            for (int j = 0; j < size; j++) {
+                row[j] = getIoU(boxes[i], moved[j]);
+            }
+        }
+        instance.maximize = true;
+        break;
+    }
+    case LAPInstanceKind::ADVERSARIAL:
+    default:
+        instance.cost.create(size, size, CV_32F);
+        for (int i = 0; i < size; i++) {
+            auto* row = instance.cost.ptr<float>(i);
+            for (int j = 0; j < size; j++) {
+                row[j] = static_cast<float>((i + 1) * (j + 1));
+            }
+        }
+        break;
+    }
+
+    return instance;
+}
+
+const char* LAPInstances::getName(LAPInstanceKind kind) {
+    switch (kind) {
+    case LAPInstanceKind::DENSE: return "dense";
+    case LAPInstanceKind::SPARSE_IOU: return "sparse_iou";
+    case LAPInstanceKind::RECTANGULAR: return "rectangular";
+    case LAPInstanceKind::ADVERSARIAL: return "adversarial";
+    default: return "unknown";
+    }
+}
+
+double LAPInstances::getTotalCost(const cv::Mat& cost,
+                                  const std::vector<int>& assignment) {
+    double totalCost = 0.0;
+    for (int i = 0; i < cost.rows; i++) {
+        if (assignment[i] >= 0) {
+            totalCost += cost.at<float>(i, assignment[i]);
+        }
+    }
+
+    return totalCost;
+}
+
+double LAPInstances::solveBruteForce(const LAPInstance& instance) {
+    const auto& cost = instance.cost;
+    CV_Assert(cost.rows <= 8 && cost.cols <= 8);
+
+    // Permute the longer side, the shorter side is fully assigned
+    bool isTransposed = cost.rows > cost.cols;
+    int numAssigned = std::min(cost.rows, cost.cols);
+    auto permutation = std::vector<int>(std::max(cost.rows, cost.cols));
+    std::iota(permutation.begin(), permutation.end(), 0);
+
+    double best = instance.maximize ? std::numeric_limits<double>::lowest()
+                                    : std::numeric_limits<double>::max();
+    do {
+        double totalCost = 0.0;
+        for (int k = 0; k < numAssigned; k++) {
+            totalCost += isTransposed ? cost.at<float>(permutation[k], k)
+                                      : cost.at<float>(k, permutation[k]);
+        }
+        best = instance.maximize ? std::max(best, totalCost)
+                                 : std::min(best, totalCost);
+    } while (std::next_permutation(permutation.begin(), permutation.end()));
+
+    return best;
+}
@@ -0,0 +1,102 @@
+/**
+ * @file lap_instances.hpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Generated linear assignment problem instances
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+
+#include <cstdint>
+#include <opencv2/core.hpp>
+#include <vector>
+
+/**
+ * @brief Shape of a generated cost matrix
+ */
+enum class LAPInstanceKind {
+    /**
+     * @brief Square, uniform random costs
+     */
+    DENSE,
+
+    /**
+     * @brief Square IoU matrix of boxes against their moved copies, mostly
+     * zeros, maximized like in the tracker
+     */
+    SPARSE_IOU,
+
+    /**
+     * @brief Twice as many rows as columns, uniform random costs (solved
+     * transposed)
+     */
+    RECTANGULAR,
+
+    /**
+     * @brief Square, cost (i + 1) * (j + 1): all row minima lie in the first
+     * column, so every row but one is assigned through augmenting paths and
+     * repeated cost adjustments
+     */
+    ADVERSARIAL,
+
+    NUM_KINDS,
+};
+
+/**
+ * @brief Generated linear assignment problem
+ */
+struct LAPInstance {
+    cv::Mat cost;
+    bool maximize = false;
+};
+
+/**
+ * @brief Generates reproducible LAP instances and checks solutions
+ */
+class LAPInstances final {
+  public:
+#pragma region Static methods
+
+    /**
+     * @brief Generate an instance
+     *
+     * @param kind Shape of the cost matrix
+     * @param size Number of columns (rows for RECTANGULAR are twice this)
+     * @param seed Generator seed
+     * @return  Instance
+     */
+    static LAPInstance make(LAPInstanceKind kind, int size, uint32_t seed);
+
+    /**
+     * @brief Get the name of an instance kind
+     *
+     * @param kind Instance kind
+     * @return  Name
+     */
+    static const char* getName(LAPInstanceKind kind);
+
+    /**
+     * @brief Total cost of an assignment, accumulated in double so that
+     * different optimal assignments compare equal
+     *
+     * @param cost Cost matrix
+     * @param assignment Assignment indices (rows -> columns, -1: none)
+     * @return  Total cost
+     */
+    static double getTotalCost(const cv::Mat& cost,
+                               const std::vector<int>& assignment);
+
+    /**
+     * @brief Optimal total cost by enumerating all assignments, for
+     * matrices with up to 8 rows and columns
+     *
+     * @param instance Instance
+     * @return  Optimal total cost
+     */
+    static double solveBruteForce(const LAPInstance& instance);
+
+#pragma endregion
+};
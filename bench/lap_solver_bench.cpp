@@ -0,0 +1,183 @@
+/**
+ * @file lap_solver_bench.cpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Scaling benchmark of the LAP solver engines, every instance is
+ * cross-checked between engines before it is timed
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "lap_instances.hpp"
+#include "lap_solver.hpp"
+
+#include <algorithm>
+#include <array>
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr std::array<LAPSolverEngine, 2> ENGINES{
+    LAPSolverEngine::HUNGARIAN,
+    LAPSolverEngine::SHORTEST_PATH,
+};
+
+constexpr std::array<const char*, 2> ENGINE_NAMES{
+    "hungarian",
+    "shortest_path",
+};
+
+/**
+ * @brief Largest size of each engine. Zero covering of the Hungarian engine
+ * grows about as n^4 and already takes seconds at 256.
+ */
+constexpr std::array<int64_t, 2> ENGINE_MAX_SIZES{256, 2048};
+
+/**
+ * @brief Matrix sizes, 4 to 2048
+ */
+const std::vector<int64_t> SIZES = benchmark::CreateRange(4, 2048, 2);
+
+/**
+ * @brief Relative tolerance of total costs between engines
+ */
+constexpr double TOLERANCE = 1e-6;
+
+/**
+ * @brief Solve an instance with every engine covering its size (and by
+ * enumeration when it is small) and compare the optimal total costs
+ *
+ * @param instance Instance
+ * @param size Instance size
+ * @return  Empty: all agree
+ *          Otherwise: description of the first disagreement
+ */
+std::string checkAgreement(const LAPInstance& instance, int64_t size) {
+    auto assignment = std::vector<int>();
+    auto assignmentReversed = std::vector<int>();
+    auto totalCosts = std::array<double, ENGINES.size()>();
+    auto isSolved = std::array<bool, ENGINES.size()>();
+
+    for (size_t k = 0; k < ENGINES.size(); k++) {
+        isSolved[k] = size <= ENGINE_MAX_SIZES[k];
+        if (!isSolved[k]) {
+            continue;
+        }
+
+        auto solver = LAPSolver(ENGINES[k]);
+        solver.solve(
+            instance.cost, assignment, assignmentReversed, instance.maximize);
+        totalCosts[k] = LAPInstances::getTotalCost(instance.cost, assignment);
+    }
+
+    // Engines are compared with the first one that ran
+    size_t first = 0;
+    while (!isSolved[first]) {
+        first++;
+    }
+
+    double reference = totalCosts[first];
+    const char* referenceName = ENGINE_NAMES[first];
+    if (instance.cost.rows <= 8 && instance.cost.cols <= 8) {
+        reference = LAPInstances::solveBruteForce(instance);
+        referenceName = "brute_force";
+    }
+
+    for (size_t k = 0; k < ENGINES.size(); k++) {
+        if (!isSolved[k]) {
+            continue;
+        }
+
+        double error = std::abs(totalCosts[k] - reference);
+        if (error > TOLERANCE * std::max(1.0, std::abs(reference))) {
+            std::array<char, 128> str;
+            std::snprintf(str.data(),
+                          str.size(),
+                          "%s total cost %.6f, %s %.6f",
+                          ENGINE_NAMES[k],
+                          totalCosts[k],
+                          referenceName,
+                          reference);
+            return str.data();
+        }
+    }
+
+    return {};
+}
+
+/**
+ * @brief Time one engine on one generated instance
+ */
+void BM_Solve(benchmark::State& state) {
+    auto engineIndex = static_cast<size_t>(state.range(0));
+    auto kind = static_cast<LAPInstanceKind>(state.range(1));
+    int size = static_cast<int>(state.range(2));
+
+    auto instance = LAPInstances::make(kind, size, 42U + size);
+    state.SetLabel(LAPInstances::getName(kind));
+
+    // Each instance is checked once, not once per engine
+    static auto messages = std::map<std::pair<int, int64_t>, std::string>();
+    auto key = std::make_pair(static_cast<int>(kind), state.range(2));
+    if (messages.count(key) == 0) {
+        messages[key] = checkAgreement(instance, state.range(2));
+    }
+
+    if (!messages[key].empty()) {
+        state.SkipWithError(messages[key].c_str());
+        return;
+    }
+
+    auto solver = LAPSolver(ENGINES[engineIndex]);
+    auto assignment = std::vector<int>();
+    auto assignmentReversed = std::vector<int>();
+
+    for (auto _ : state) {
+        float totalCost = solver.solve(
+            instance.cost, assignment, assignmentReversed, instance.maximize);
+        benchmark::DoNotOptimize(totalCost);
+    }
+
+    state.counters["cells/s"] = benchmark::Counter(
+        static_cast<double>(instance.cost.total()),
+        benchmark::Counter::kIsIterationInvariantRate);
+}
+
+/**
+ * @brief Register every engine x kind x size case
+ *
+ * @param benchmark Benchmark
+ * @return
+ */
+void registerCases(benchmark::internal::Benchmark* benchmark) {
+    for (size_t engine = 0; engine < ENGINES.size(); engine++) {
+        for (int kind = 0;
+             kind < static_cast<int>(LAPInstanceKind::NUM_KINDS);
+             kind++) {
+            for (int64_t size : SIZES) {
+                if (size > ENGINE_MAX_SIZES[engine]) {
+                    continue;
+                }
+                benchmark->Args({static_cast<int64_t>(engine), kind, size});
+            }
+        }
+    }
+}
+
+} // namespace
+
+BENCHMARK(BM_Solve)
+    ->Apply(registerCases)
+    ->ArgNames({"engine", "kind", "n"})
+    ->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
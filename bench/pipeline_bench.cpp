@@ -0,0 +1,343 @@
+/**
+ * @file pipeline_bench.cpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief End-to-end benchmark of the detect-and-track loop on a synthetic
+ * scene, writes a JSON report to compare with compare_pipeline_reports.py
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "alloc_counter.hpp"
+#include "config.hpp"
+#include "crowd_scene.hpp"
+#include "analysis_pipeline.hpp"
+#include "synthetic_scene.hpp"
+
+#include <algorithm>
+#include <argparse/argparse.hpp>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <opencv2/core.hpp>
+#include <stdexcept>
+#include <string>
+#include <sys/resource.h>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Number of pre-rendered backgrounds (noise patterns) frames cycle
+ * through, rendering is kept out of the measured loop
+ */
+constexpr int NUM_BACKGROUNDS = 8;
+
+/**
+ * @brief Frame interval of the synthetic timestamps
+ */
+constexpr auto FRAME_INTERVAL = std::chrono::milliseconds(33);
+
+/**
+ * @brief Latency summary of a stage
+ */
+struct LatencySummary {
+    double meanMs = 0.0;
+    double p50Ms = 0.0;
+    double p99Ms = 0.0;
+};
+
+/**
+ * @brief Summarise latency samples
+ *
+ * @param samples Latencies (ns), reordered
+ * @return  Summary
+ */
+LatencySummary summarise(std::vector<uint64_t>& samples) {
+    auto summary = LatencySummary();
+    if (samples.empty()) {
+        return summary;
+    }
+
+    double sum = 0.0;
+    for (uint64_t ns : samples) {
+        sum += static_cast<double>(ns);
+    }
+    summary.meanMs = sum / static_cast<double>(samples.size()) * 1e-6;
+
+    auto getQuantile = [&](double q) {
+        auto k =
+            static_cast<size_t>(q * static_cast<double>(samples.size() - 1));
+        std::nth_element(samples.begin(), samples.begin() + k, samples.end());
+        return static_cast<double>(samples[k]) * 1e-6;
+    };
+    summary.p50Ms = getQuantile(0.50);
+    summary.p99Ms = getQuantile(0.99);
+
+    return summary;
+}
+
+/**
+ * @brief Get the peak resident set size of this process
+ *
+ * @return  Peak RSS (KiB)
+ */
+long getPeakRSS() {
+    struct rusage usage {};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+/**
+ * @brief Setup command line arguments
+ *
+ * @return argparse::ArgumentParser arg parser
+ */
+argparse::ArgumentParser getArgParser() {
+    auto parser = argparse::ArgumentParser("pipeline_bench");
+
+    // clang-format off
+    parser.add_argument("--width")
+        .help("Frame width")
+        .default_value(1920)
+        .action([](const std::string& arg) { return std::stoi(arg); });
+
+    parser.add_argument("--height")
+        .help("Frame height")
+        .default_value(1080)
+        .action([](const std::string& arg) { return std::stoi(arg); });
+
+    parser.add_argument("--frames")
+        .help("Number of measured frames")
+        .default_value(600)
+        .action([](const std::string& arg) { return std::stoi(arg); });
+
+    parser.add_argument("--warmup")
+        .help("Number of frames played before measuring")
+        .default_value(100)
+        .action([](const std::string& arg) { return std::stoi(arg); });
+
+    parser.add_argument("--objects")
+        .help("Number of concurrent synthetic objects")
+        .default_value(8)
+        .action([](const std::string& arg) { return std::stoi(arg); });
+
+    parser.add_argument("--seed")
+        .help("Scene generator seed")
+        .default_value(42)
+        .action([](const std::string& arg) { return std::stoi(arg); });
+
+    parser.add_argument("--config")
+        .help("Tuning parameters file (YAML / JSON), defaults when empty")
+        .default_value(std::string());
+
+    parser.add_argument("--bg_engine")
+        .help("Background subtraction implementation: vibe, sigma_delta")
+        .default_value(BackgroundSubtractorEngine::VIBE)
+        .action([](const std::string& arg) {
+            return arg == "sigma_delta"
+                       ? BackgroundSubtractorEngine::SIGMA_DELTA
+                       : BackgroundSubtractorEngine::VIBE;
+        });
+
+    parser.add_argument("--blob_engine")
+        .help("Morphology and labelling implementation: native, opencv")
+        .default_value(BlobDetectorEngine::NATIVE)
+        .action([](const std::string& arg) {
+            return arg == "opencv" ? BlobDetectorEngine::OPENCV
+                                   : BlobDetectorEngine::NATIVE;
+        });
+
+    parser.add_argument("--attention_interval")
+        .help("Analyse the whole frame once every n frames, only windows "
+              "around the predicted tracks in between (1: disabled)")
+        .default_value(1)
+        .action([](const std::string& arg) { return std::stoi(arg); });
+
+    parser.add_argument("-o", "--output")
+        .help("JSON report path")
+        .default_value(std::string("pipeline_bench.json"));
+    // clang-format on
+
+    return parser;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    auto parser = getArgParser();
+
+    try {
+        parser.parse_args(argc, argv);
+    } catch (const std::runtime_error& e) {
+        std::printf("%s\n", e.what());
+        std::cout << parser;
+        std::exit(0);
+    }
+
+    int width = parser.get<int>("--width");
+    int height = parser.get<int>("--height");
+    int numFrames = parser.get<int>("--frames");
+    int numWarmupFrames = parser.get<int>("--warmup");
+    int numObjects = parser.get<int>("--objects");
+    auto seed = static_cast<uint32_t>(parser.get<int>("--seed"));
+    auto configPath = parser.get<std::string>("--config");
+    auto bgEngine = parser.get<BackgroundSubtractorEngine>("--bg_engine");
+    auto blobEngine = parser.get<BlobDetectorEngine>("--blob_engine");
+    auto attentionParams = AttentionSchedulerParams{
+        .fullFrameInterval = parser.get<int>("--attention_interval"),
+    };
+    auto outputPath = parser.get<std::string>("--output");
+
+    auto config = PipelineConfig();
+    if (!configPath.empty()) {
+        try {
+            config = PipelineConfig::load(configPath, config);
+        } catch (const std::invalid_argument& e) {
+            std::printf("%s\n", e.what());
+            std::exit(EXIT_FAILURE);
+        }
+    }
+
+    // Render backgrounds before anything is measured
+    auto backgrounds = std::vector<cv::Mat>(NUM_BACKGROUNDS);
+    for (int i = 0; i < NUM_BACKGROUNDS; i++) {
+        backgrounds[i].create(height, width, CV_8UC3);
+        SyntheticScene::renderBackground(backgrounds[i], seed + i);
+    }
+
+    auto scene = CrowdScene(numObjects, {width, height}, seed);
+    auto pipeline = AnalysisPipeline(height,
+                                     width,
+                                     config,
+                                     AnalysisPipelineParams{
+                                         .blobEngine = blobEngine,
+                                         .bgEngine = bgEngine,
+                                         .attention = attentionParams,
+                                     });
+    auto frame = cv::Mat(height, width, CV_8UC3);
+    auto objects = std::vector<cv::Rect2f>();
+    auto detections = std::vector<cv::Rect2f>();
+    auto timestamp = SortTracker::Timestamp();
+
+    constexpr auto NUM_STAGES =
+        static_cast<size_t>(AnalysisStage::NUM_STAGES);
+    auto stageSamples = std::vector<std::vector<uint64_t>>(NUM_STAGES);
+    auto frameSamples = std::vector<uint64_t>();
+    for (auto& samples : stageSamples) {
+        samples.reserve(numFrames);
+    }
+    frameSamples.reserve(numFrames);
+
+    uint64_t totalNs = 0;
+    uint64_t numAllocs = 0;
+    uint64_t numAllocatedBytes = 0;
+    int numDroppedFrames = 0;
+    uint64_t numWindowFrames = 0;
+
+    for (int i = 0; i < numWarmupFrames + numFrames; i++) {
+        // Objects are painted where they are, detection noise of the scene
+        // is not used
+        scene.next(detections);
+        objects.clear();
+        for (const auto& object : scene.getObjects()) {
+            if (object.lifetime > 0) {
+                objects.emplace_back(object.position, object.size);
+            }
+        }
+        backgrounds[i % NUM_BACKGROUNDS].copyTo(frame);
+        SyntheticScene::paintObjects(frame, objects);
+
+        uint64_t numWindowFramesBefore =
+            pipeline.getAttention().getNumWindowFrames();
+        auto allocScope = AllocScope();
+        bool isValid = pipeline.process(frame, timestamp += FRAME_INTERVAL);
+        if (i < numWarmupFrames) {
+            continue;
+        }
+
+        numAllocs += allocScope.count();
+        numAllocatedBytes += allocScope.bytes();
+        numDroppedFrames += isValid ? 0 : 1;
+        numWindowFrames += pipeline.getAttention().getNumWindowFrames() -
+                           numWindowFramesBefore;
+
+        uint64_t frameNs = 0;
+        const auto& times = pipeline.getLastStageTimes();
+        for (size_t k = 0; k < NUM_STAGES; k++) {
+            stageSamples[k].push_back(times[k]);
+            frameNs += times[k];
+        }
+        frameSamples.push_back(frameNs);
+        totalNs += frameNs;
+    }
+
+    double totalSec = static_cast<double>(totalNs) * 1e-9;
+    double fps = totalNs > 0 ? numFrames / totalSec : 0.0;
+    long peakRSS = getPeakRSS();
+
+    auto* file = std::fopen(outputPath.c_str(), "w");
+    if (file == nullptr) {
+        std::printf("Cannot write report %s\n", outputPath.c_str());
+        return EXIT_FAILURE;
+    }
+
+    std::fprintf(file, "{\n");
+    std::fprintf(file,
+                 "  \"width\": %d,\n  \"height\": %d,\n  \"frames\": %d,\n"
+                 "  \"objects\": %d,\n  \"dropped_frames\": %d,\n"
+                 "  \"window_frames\": %llu,\n",
+                 width,
+                 height,
+                 numFrames,
+                 numObjects,
+                 numDroppedFrames,
+                 static_cast<unsigned long long>(numWindowFrames));
+    std::fprintf(file, "  \"fps\": %.3f,\n", fps);
+    std::fprintf(file, "  \"stages\": {\n");
+    for (size_t k = 0; k <= NUM_STAGES; k++) {
+        bool isFrame = k == NUM_STAGES;
+        auto summary = summarise(isFrame ? frameSamples : stageSamples[k]);
+        const char* name = isFrame ? "frame"
+                                   : AnalysisPipeline::getStageName(
+                                         static_cast<AnalysisStage>(k));
+        std::fprintf(file,
+                     "    \"%s\": {\"mean_ms\": %.4f, \"p50_ms\": %.4f, "
+                     "\"p99_ms\": %.4f}%s\n",
+                     name,
+                     summary.meanMs,
+                     summary.p50Ms,
+                     summary.p99Ms,
+                     isFrame ? "" : ",");
+        if (isFrame) {
+            std::printf("[PIPELINE BENCH] %dx%d, %d objects: %.1f frames/s, "
+                        "frame p50 %.2f ms, p99 %.2f ms\n",
+                        width,
+                        height,
+                        numObjects,
+                        fps,
+                        summary.p50Ms,
+                        summary.p99Ms);
+        }
+    }
+    std::fprintf(file, "  },\n");
+    std::fprintf(file, "  \"peak_rss_kb\": %ld,\n", peakRSS);
+    std::fprintf(file,
+                 "  \"allocations\": %llu,\n  \"allocated_bytes\": %llu\n",
+                 static_cast<unsigned long long>(numAllocs),
+                 static_cast<unsigned long long>(numAllocatedBytes));
+    std::fprintf(file, "}\n");
+    std::fclose(file);
+
+    std::printf("[PIPELINE BENCH] Peak RSS %ld KiB, %llu allocations, "
+                "report written to %s\n",
+                peakRSS,
+                static_cast<unsigned long long>(numAllocs),
+                outputPath.c_str());
+
+    return EXIT_SUCCESS;
+}
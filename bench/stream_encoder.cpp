@@ -0,0 +1,246 @@
+/**
+ * @file stream_encoder.cpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Implementation of the encoder of local test streams
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "stream_encoder.hpp"
+
+#include <cstring>
+#include <opencv2/imgproc.hpp>
+
+StreamEncoder::StreamEncoder(const std::string& filename,
+                             const StreamEncoderParams& params)
+    : _avFormatContext(nullptr),
+      _avEncoderContext(nullptr),
+      _avStream(nullptr),
+      _avPacket(nullptr),
+      _avFrame(nullptr),
+      _isOpened(false),
+      _numFrames(0) {
+    int err;
+
+    // 4:2:0 chroma subsampling
+    CV_Assert(params.size.width % 2 == 0 && params.size.height % 2 == 0);
+
+    const auto* avEncoder =
+        avcodec_find_encoder_by_name(params.codecName.c_str());
+    if (avEncoder == nullptr) {
+        av_log(nullptr,
+               AV_LOG_ERROR,
+               "Encoder %s is not available\n",
+               params.codecName.c_str());
+        return;
+    }
+
+    err = avformat_alloc_output_context2(
+        &_avFormatContext, nullptr, nullptr, filename.c_str());
+    if (err < 0) {
+        av_log(nullptr,
+               AV_LOG_ERROR,
+               "Failed to guess container of %s, error: %d\n",
+               filename.c_str(),
+               err);
+        return;
+    }
+
+    // Set up encoder
+    _avEncoderContext = avcodec_alloc_context3(avEncoder);
+    _avEncoderContext->width = params.size.width;
+    _avEncoderContext->height = params.size.height;
+    _avEncoderContext->time_base = {1, params.fps};
+    _avEncoderContext->framerate = {params.fps, 1};
+    _avEncoderContext->pix_fmt = AVPixelFormat::AV_PIX_FMT_YUV420P;
+    _avEncoderContext->gop_size = params.gopSize;
+    _avEncoderContext->max_b_frames = params.maxBFrames;
+    _avEncoderContext->bit_rate =
+        params.bitRate > 0 ? params.bitRate : 4LL * params.size.area();
+
+    if ((_avFormatContext->oformat->flags & AVFMT_GLOBALHEADER) != 0) {
+        _avEncoderContext->flags |= AV_CODEC_FLAG_GLOBAL_HEADER;
+    }
+
+    // Encoders ignore private options they don't have
+    AVDictionary* avEncoderOptions = nullptr;
+    av_dict_set(&avEncoderOptions, "preset", "veryfast", 0);
+    err = avcodec_open2(_avEncoderContext, avEncoder, &avEncoderOptions);
+    av_dict_free(&avEncoderOptions);
+    if (err < 0) {
+        av_log(
+            nullptr, AV_LOG_ERROR, "Failed to open encoder, error: %d\n", err);
+        return;
+    }
+
+    // Set up stream
+    _avStream = avformat_new_stream(_avFormatContext, nullptr);
+    if (_avStream == nullptr) {
+        av_log(nullptr, AV_LOG_ERROR, "Failed to create stream\n");
+        return;
+    }
+
+    _avStream->time_base = _avEncoderContext->time_base;
+    err = avcodec_parameters_from_context(_avStream->codecpar,
+                                          _avEncoderContext);
+    if (err < 0) {
+        av_log(
+            nullptr, AV_LOG_ERROR, "Failed to setup stream, error: %d\n", err);
+        return;
+    }
+
+    // Open file and write header
+    err = avio_open(&_avFormatContext->pb, filename.c_str(), AVIO_FLAG_WRITE);
+    if (err < 0) {
+        av_log(nullptr,
+               AV_LOG_ERROR,
+               "Failed to open file: %s, error: %d\n",
+               filename.c_str(),
+               err);
+        return;
+    }
+
+    err = avformat_write_header(_avFormatContext, nullptr);
+    if (err < 0) {
+        av_log(
+            nullptr, AV_LOG_ERROR, "Failed to write header, error: %d\n", err);
+        return;
+    }
+
+    // Allocate frame buffers
+    _avPacket = av_packet_alloc();
+    _avFrame = av_frame_alloc();
+    _avFrame->format = _avEncoderContext->pix_fmt;
+    _avFrame->width = params.size.width;
+    _avFrame->height = params.size.height;
+
+    err = av_frame_get_buffer(_avFrame, 0);
+    if (err < 0) {
+        av_log(nullptr,
+               AV_LOG_ERROR,
+               "Failed to allocate frame buffer, error: %d\n",
+               err);
+        return;
+    }
+
+    _isOpened = true;
+}
+
+StreamEncoder::~StreamEncoder() {
+    finish();
+
+    av_packet_free(&_avPacket);
+    av_frame_free(&_avFrame);
+    avcodec_free_context(&_avEncoderContext);
+    if (_avFormatContext != nullptr) {
+        avio_closep(&_avFormatContext->pb);
+    }
+    avformat_free_context(_avFormatContext);
+}
+
+bool StreamEncoder::write(const cv::Mat& frame) {
+    if (!_isOpened) {
+        return false;
+    }
+
+    CV_Assert(frame.type() == CV_8UC3 && frame.cols == _avFrame->width &&
+              frame.rows == _avFrame->height);
+
+    // The encoder may still hold references to the previous frame
+    int err = av_frame_make_writable(_avFrame);
+    if (err < 0) {
+        av_log(
+            nullptr, AV_LOG_ERROR, "Failed to reuse frame, error: %d\n", err);
+        return false;
+    }
+
+    // Convert to I420, whose Y, U and V planes are stored one after another
+    cv::cvtColor(frame, _yuv, cv::COLOR_BGR2YUV_I420);
+
+    const auto* plane = _yuv.data;
+    for (int i = 0; i < 3; i++) {
+        int width = i == 0 ? _avFrame->width : _avFrame->width / 2;
+        int height = i == 0 ? _avFrame->height : _avFrame->height / 2;
+        for (int y = 0; y < height; y++) {
+            std::memcpy(_avFrame->data[i] + y * _avFrame->linesize[i],
+                        plane + y * width,
+                        width);
+        }
+        plane += width * height;
+    }
+
+    _avFrame->pts = _numFrames++;
+
+    err = avcodec_send_frame(_avEncoderContext, _avFrame);
+    if (err < 0) {
+        av_log(nullptr,
+               AV_LOG_ERROR,
+               "Failed to send frame to encoder, error: %d\n",
+               err);
+        return false;
+    }
+
+    return writePackets();
+}
+
+bool StreamEncoder::finish() {
+    if (!_isOpened) {
+        return false;
+    }
+    _isOpened = false;
+
+    // Flush the delayed packets (e.g. B-frames)
+    int err = avcodec_send_frame(_avEncoderContext, nullptr);
+    if (err < 0) {
+        av_log(
+            nullptr, AV_LOG_ERROR, "Failed to flush encoder, error: %d\n", err);
+        return false;
+    }
+
+    bool isOK = writePackets();
+
+    err = av_write_trailer(_avFormatContext);
+    if (err < 0) {
+        av_log(
+            nullptr, AV_LOG_ERROR, "Failed to write trailer, error: %d\n", err);
+        return false;
+    }
+
+    return isOK;
+}
+
+bool StreamEncoder::writePackets() {
+    while (true) {
+        int err = avcodec_receive_packet(_avEncoderContext, _avPacket);
+
+        // Wait for more frames, or flushed
+        if (err == AVERROR(EAGAIN) || err == AVERROR_EOF) {
+            return true;
+        }
+
+        if (err < 0) {
+            av_log(nullptr,
+                   AV_LOG_ERROR,
+                   "Failed to receive packet from encoder, error: %d\n",
+                   err);
+            return false;
+        }
+
+        av_packet_rescale_ts(
+            _avPacket, _avEncoderContext->time_base, _avStream->time_base);
+        _avPacket->stream_index = _avStream->index;
+
+        // Takes ownership of the packet data
+        err = av_interleaved_write_frame(_avFormatContext, _avPacket);
+        if (err < 0) {
+            av_log(nullptr,
+                   AV_LOG_ERROR,
+                   "Failed to write packet, error: %d\n",
+                   err);
+            return false;
+        }
+    }
+}
@@ -0,0 +1,139 @@
+/**
+ * @file stream_encoder.hpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Encoder of BGR frames into local video files, used to produce test
+ * streams without any camera footage
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+
+#include <opencv2/core.hpp>
+#include <string>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavformat/avformat.h>
+}
+
+/**
+ * @brief Encoding parameters of a test stream
+ */
+struct StreamEncoderParams {
+    /**
+     * @brief libavcodec encoder name (e.g. libx264, mpeg4, ffv1)
+     */
+    std::string codecName = "mpeg4";
+
+    /**
+     * @brief Frame size, width and height must be even
+     */
+    cv::Size size = {1280, 720};
+
+    /**
+     * @brief Frames per second
+     */
+    int fps = 30;
+
+    /**
+     * @brief Distance between key frames (1: intra only)
+     */
+    int gopSize = 30;
+
+    /**
+     * @brief Maximum number of consecutive B-frames
+     */
+    int maxBFrames = 0;
+
+    /**
+     * @brief Bit rate (bits per second, 0: four bits per pixel per second)
+     */
+    int64_t bitRate = 0;
+};
+
+/**
+ * @brief Encodes BGR frames into a video file, the container is guessed from
+ * the file name (e.g. .mkv)
+ */
+class StreamEncoder final {
+  public:
+#pragma region Public member methods
+
+    /**
+     * @brief Construct a new StreamEncoder object and write the file header
+     *
+     * @param filename Output file
+     * @param params Encoding parameters
+     */
+    StreamEncoder(const std::string& filename,
+                  const StreamEncoderParams& params);
+
+    /**
+     * @brief Destroy the StreamEncoder object, the file is finished if it
+     * has not been
+     *
+     */
+    ~StreamEncoder();
+
+    StreamEncoder(const StreamEncoder&) = delete;
+
+    StreamEncoder& operator=(const StreamEncoder&) = delete;
+
+    /**
+     * @brief Tells whether the encoder and the file have been opened
+     *
+     * @return true Ready to write
+     * @return false Encoder not available or file not writable
+     */
+    bool isOpened() const { return _isOpened; }
+
+    /**
+     * @brief Encode a frame
+     *
+     * @param frame BGR frame (CV_8UC3) of the stream size
+     * @return true Written successfully
+     * @return false Encoding or writing failed
+     */
+    bool write(const cv::Mat& frame);
+
+    /**
+     * @brief Flush the encoder and write the file trailer
+     *
+     * @return true Finished successfully
+     * @return false Flushing or writing failed
+     */
+    bool finish();
+
+#pragma endregion
+
+  private:
+#pragma region Private member variables
+
+    AVFormatContext* _avFormatContext;
+    AVCodecContext* _avEncoderContext;
+    AVStream* _avStream;
+    AVPacket* _avPacket;
+    AVFrame* _avFrame;
+
+    cv::Mat _yuv;
+
+    bool _isOpened;
+    int64_t _numFrames;
+
+#pragma endregion
+
+#pragma region Private member methods
+
+    /**
+     * @brief Receive all available packets from the encoder and write them
+     *
+     * @return true No error
+     * @return false Encoding or writing failed
+     */
+    bool writePackets();
+
+#pragma endregion
+};
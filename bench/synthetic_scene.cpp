@@ -0,0 +1,154 @@
+/**
+ * @file synthetic_scene.cpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Implementation of deterministic synthetic frames for benchmarks
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "synthetic_scene.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+void SyntheticScene::renderBackground(cv::Mat& frame, uint32_t seed) {
+    CV_Assert(frame.type() == CV_8UC3);
+
+    for (int y = 0; y < frame.rows; y++) {
+        auto* row = frame.ptr<uint8_t>(y);
+        for (int x = 0; x < frame.cols; x++) {
+            seed = seed * 1664525U + 1013904223U;
+            int noise = static_cast<int>(seed >> 29U) - 4;
+            int value = 64 + (x * 96) / frame.cols + (y * 32) / frame.rows;
+            row[3 * x + 0] = cv::saturate_cast<uint8_t>(value + noise);
+            row[3 * x + 1] = cv::saturate_cast<uint8_t>(value + 8 + noise);
+            row[3 * x + 2] = cv::saturate_cast<uint8_t>(value + 16 + noise);
+        }
+    }
+}
+
+void SyntheticScene::addNoise(cv::Mat& frame, uint32_t seed) {
+    CV_Assert(frame.type() == CV_8UC3);
+
+    for (int y = 0; y < frame.rows; y++) {
+        auto* row = frame.ptr<uint8_t>(y);
+        for (int x = 0; x < 3 * frame.cols; x += 3) {
+            seed = seed * 1664525U + 1013904223U;
+            int noise = static_cast<int>(seed >> 29U) - 4;
+            for (int c = 0; c < 3; c++) {
+                row[x + c] = cv::saturate_cast<uint8_t>(row[x + c] + noise);
+            }
+        }
+    }
+}
+
+int SyntheticScene::paintForeground(cv::Mat& frame,
+                                    double density,
+                                    uint32_t seed) {
+    CV_Assert(frame.type() == CV_8UC3);
+
+    // Tiles are selected independently, so the covered fraction converges to
+    // the density on large frames
+    auto threshold = static_cast<uint32_t>(
+        std::clamp(density, 0.0, 1.0) * static_cast<double>(UINT32_MAX));
+    int numPainted = 0;
+
+    for (int y0 = 0; y0 < frame.rows; y0 += TILE_SIZE) {
+        for (int x0 = 0; x0 < frame.cols; x0 += TILE_SIZE) {
+            seed = seed * 1664525U + 1013904223U;
+            if (seed >= threshold || density <= 0.0) {
+                continue;
+            }
+
+            // Dark or bright depending on the tile, never close to the
+            // mid-grey background
+            uint8_t value = (seed & 0x100U) != 0 ? 8 : 248;
+            int y1 = std::min(y0 + TILE_SIZE, frame.rows);
+            int x1 = std::min(x0 + TILE_SIZE, frame.cols);
+            for (int y = y0; y < y1; y++) {
+                auto* row = frame.ptr<uint8_t>(y);
+                std::fill(row + 3 * x0, row + 3 * x1, value);
+            }
+            numPainted += (y1 - y0) * (x1 - x0);
+        }
+    }
+
+    return numPainted;
+}
+
+int SyntheticScene::paintObjects(cv::Mat& frame,
+                                 const std::vector<cv::Rect2f>& boxes) {
+    CV_Assert(frame.type() == CV_8UC3);
+
+    auto bounds = cv::Rect(0, 0, frame.cols, frame.rows);
+    int numPainted = 0;
+
+    for (const auto& box : boxes) {
+        auto rect = cv::Rect(cv::Rect2f(std::round(box.x),
+                                        std::round(box.y),
+                                        std::round(box.width),
+                                        std::round(box.height))) &
+                    bounds;
+        for (int y = rect.y; y < rect.y + rect.height; y++) {
+            auto* row = frame.ptr<uint8_t>(y);
+            std::fill(row + 3 * rect.x, row + 3 * (rect.x + rect.width), 8);
+        }
+        numPainted += rect.area();
+    }
+
+    return numPainted;
+}
+
+int SyntheticScene::renderMask(cv::Mat& mask,
+                               int numBlobs,
+                               double noiseDensity,
+                               uint32_t seed) {
+    CV_Assert(mask.type() == CV_8UC1);
+
+    auto nextUniform = [&seed]() {
+        seed = seed * 1664525U + 1013904223U;
+        return static_cast<float>(seed >> 8U) / static_cast<float>(1U << 24U);
+    };
+
+    auto threshold = static_cast<uint32_t>(
+        std::clamp(noiseDensity, 0.0, 1.0) * static_cast<double>(UINT32_MAX));
+    for (int y = 0; y < mask.rows; y++) {
+        auto* row = mask.ptr<uint8_t>(y);
+        for (int x = 0; x < mask.cols; x++) {
+            seed = seed * 1664525U + 1013904223U;
+            row[x] = seed < threshold && noiseDensity > 0.0 ? 255 : 0;
+        }
+    }
+
+    for (int i = 0; i < numBlobs; i++) {
+        float cx = nextUniform() * static_cast<float>(mask.cols);
+        float cy = nextUniform() * static_cast<float>(mask.rows);
+        float rx = 3.0F + 21.0F * nextUniform();
+        float ry = 3.0F + 21.0F * nextUniform();
+        // A quarter of the blobs have a hole the closing should fill
+        bool hasHole = nextUniform() < 0.25F;
+
+        auto bounds = cv::Rect(0, 0, mask.cols, mask.rows);
+        auto rect = cv::Rect(static_cast<int>(cx - rx),
+                             static_cast<int>(cy - ry),
+                             static_cast<int>(2.0F * rx) + 2,
+                             static_cast<int>(2.0F * ry) + 2) &
+                    bounds;
+        for (int y = rect.y; y < rect.y + rect.height; y++) {
+            auto* row = mask.ptr<uint8_t>(y);
+            float dy = (static_cast<float>(y) - cy) / ry;
+            for (int x = rect.x; x < rect.x + rect.width; x++) {
+                float dx = (static_cast<float>(x) - cx) / rx;
+                float r2 = dx * dx + dy * dy;
+                if (r2 <= 1.0F) {
+                    row[x] = hasHole && r2 < 0.04F ? 0 : 255;
+                }
+            }
+        }
+    }
+
+    return cv::countNonZero(mask);
+}
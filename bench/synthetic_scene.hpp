@@ -0,0 +1,93 @@
+/**
+ * @file synthetic_scene.hpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Deterministic synthetic frames for benchmarks
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+
+#include <cstdint>
+#include <opencv2/core.hpp>
+#include <vector>
+
+/**
+ * @brief Renders reproducible frames without any video file: a static
+ *        gradient background with sensor noise, and foreground tiles or
+ *        objects whose colour is far from the background
+ */
+class SyntheticScene final {
+  public:
+#pragma region Public constants
+
+    /**
+     * @brief Side of a foreground tile (pixels)
+     */
+    static constexpr int TILE_SIZE = 16;
+
+#pragma endregion
+
+#pragma region Static methods
+
+    /**
+     * @brief Render the static background with a little sensor noise
+     *
+     * @param frame Output frame (CV_8UC3, allocated by caller)
+     * @param seed Noise generator state, a different value gives a different
+     * noise pattern over the same background
+     * @return
+     */
+    static void renderBackground(cv::Mat& frame, uint32_t seed);
+
+    /**
+     * @brief Add the same sensor noise as renderBackground() to a frame,
+     * e.g. a still image used as background
+     *
+     * @param frame Frame (CV_8UC3)
+     * @param seed Noise generator state
+     * @return
+     */
+    static void addNoise(cv::Mat& frame, uint32_t seed);
+
+    /**
+     * @brief Paint foreground tiles over a frame
+     *
+     * @param frame Frame (CV_8UC3)
+     * @param density Expected fraction of the frame covered by foreground
+     * (0 to 1)
+     * @param seed Tile selection generator state
+     * @return  Number of foreground pixels painted
+     */
+    static int paintForeground(cv::Mat& frame, double density, uint32_t seed);
+
+    /**
+     * @brief Paint solid dark objects over a frame
+     *
+     * @param frame Frame (CV_8UC3)
+     * @param boxes Object bboxes, clipped to the frame
+     * @return  Number of foreground pixels painted (overlaps counted once per
+     * object)
+     */
+    static int paintObjects(cv::Mat& frame,
+                            const std::vector<cv::Rect2f>& boxes);
+
+    /**
+     * @brief Render a raw foreground mask: elliptic blobs, some with a hole,
+     * over isolated noise pixels
+     *
+     * @param mask Output mask (CV_8UC1, allocated by caller)
+     * @param numBlobs Number of blobs
+     * @param noiseDensity Fraction of pixels turned on by noise (0 to 1)
+     * @param seed Generator state
+     * @return  Number of foreground pixels
+     */
+    static int renderMask(cv::Mat& mask,
+                          int numBlobs,
+                          double noiseDensity,
+                          uint32_t seed);
+
+#pragma endregion
+};
@@ -0,0 +1,147 @@
+/**
+ * @file tracker_bench.cpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Scaling benchmark of the SORT tracker on synthetic crowded scenes,
+ * with the time of each stage of an update reported separately
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "crowd_scene.hpp"
+#include "lap_solver.hpp"
+#include "tracker.hpp"
+
+#include <array>
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <cstdint>
+#include <opencv2/core.hpp>
+#include <vector>
+
+namespace {
+
+constexpr std::array<LAPSolverEngine, 2> ENGINES{
+    LAPSolverEngine::HUNGARIAN,
+    LAPSolverEngine::SHORTEST_PATH,
+};
+
+/**
+ * @brief Largest number of objects of each engine, the Hungarian engine
+ * takes seconds per frame beyond this
+ */
+constexpr std::array<int64_t, 2> ENGINE_MAX_NUM_OBJECTS{500, 2000};
+
+/**
+ * @brief Numbers of concurrent objects
+ */
+const std::vector<int64_t> NUM_OBJECTS = {1, 8, 64, 250, 500, 1000, 2000};
+
+/**
+ * @brief Canvas the objects move in (pixels)
+ */
+const cv::Size CANVAS_SIZE = {1280, 720};
+
+/**
+ * @brief Frame handed to the tracker. Every new trajectory keeps a copy of
+ * it, a full size frame would make the benchmark measure memcpy (and hold
+ * gigabytes with thousands of trajectories)
+ */
+const cv::Size FRAME_SIZE = {64, 36};
+
+/**
+ * @brief Frames played before measuring, longer than an object lifetime so
+ * that tracks and trajectories are in steady state
+ */
+constexpr int NUM_WARMUP_FRAMES = 200;
+
+/**
+ * @brief Frame interval of the synthetic timestamps
+ */
+constexpr auto FRAME_INTERVAL = std::chrono::milliseconds(33);
+
+/**
+ * @brief Time one SortTracker::update per iteration, one frame after
+ * another of the same scene
+ */
+void BM_Update(benchmark::State& state) {
+    auto engine = ENGINES[static_cast<size_t>(state.range(0))];
+    int numObjects = static_cast<int>(state.range(1));
+
+    auto scene = CrowdScene(numObjects, CANVAS_SIZE, 42U);
+    auto frame = cv::Mat(FRAME_SIZE, CV_8UC3, cv::Scalar::all(0));
+    auto detections = std::vector<cv::Rect2f>();
+    detections.reserve(numObjects);
+
+    // Pipeline default thresholds
+    auto tracker = SortTracker(3, 3, 15, 16, 128, 0.25F);
+    tracker.setLAPSolverEngine(engine);
+
+    auto timestamp = SortTracker::Timestamp();
+    for (int i = 0; i < NUM_WARMUP_FRAMES; i++) {
+        scene.next(detections);
+        tracker.update(detections, frame, timestamp += FRAME_INTERVAL);
+    }
+
+    auto totalTimes = std::array<double, 4>();
+    double numDetections = 0.0;
+    double numTracks = 0.0;
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        scene.next(detections);
+        state.ResumeTiming();
+
+        tracker.update(detections, frame, timestamp += FRAME_INTERVAL);
+
+        const auto& times = tracker.getLastStageTimes();
+        totalTimes[0] += static_cast<double>(times.predictNs);
+        totalTimes[1] += static_cast<double>(times.iouNs);
+        totalTimes[2] += static_cast<double>(times.assignmentNs);
+        totalTimes[3] += static_cast<double>(times.bookkeepingNs);
+        numDetections += static_cast<double>(detections.size());
+        numTracks += static_cast<double>(tracker.getNumTracks());
+    }
+
+    // Per frame averages, stage times in ms
+    state.counters["predict"] = benchmark::Counter(
+        totalTimes[0] * 1e-6, benchmark::Counter::kAvgIterations);
+    state.counters["iou"] = benchmark::Counter(
+        totalTimes[1] * 1e-6, benchmark::Counter::kAvgIterations);
+    state.counters["assign"] = benchmark::Counter(
+        totalTimes[2] * 1e-6, benchmark::Counter::kAvgIterations);
+    state.counters["bookkeep"] = benchmark::Counter(
+        totalTimes[3] * 1e-6, benchmark::Counter::kAvgIterations);
+    state.counters["detections"] = benchmark::Counter(
+        numDetections, benchmark::Counter::kAvgIterations);
+    state.counters["tracks"] =
+        benchmark::Counter(numTracks, benchmark::Counter::kAvgIterations);
+}
+
+/**
+ * @brief Register every engine x object count case
+ *
+ * @param benchmark Benchmark
+ * @return
+ */
+void registerCases(benchmark::internal::Benchmark* benchmark) {
+    for (size_t engine = 0; engine < ENGINES.size(); engine++) {
+        for (int64_t numObjects : NUM_OBJECTS) {
+            if (numObjects > ENGINE_MAX_NUM_OBJECTS[engine]) {
+                continue;
+            }
+            benchmark->Args({static_cast<int64_t>(engine), numObjects});
+        }
+    }
+}
+
+} // namespace
+
+BENCHMARK(BM_Update)
+    ->Apply(registerCases)
+    ->ArgNames({"engine", "objects"})
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
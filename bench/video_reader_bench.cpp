@@ -0,0 +1,309 @@
+/**
+ * @file video_reader_bench.cpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Decode and conversion benchmark of VideoReader on test streams
+ * encoded locally from a synthetic scene, with the time of each step of a
+ * read reported separately
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "crowd_scene.hpp"
+#include "stream_encoder.hpp"
+#include "synthetic_scene.hpp"
+#include "video_reader.hpp"
+
+#include <array>
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <opencv2/core.hpp>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief A codec of the test streams
+ */
+struct CodecConfig {
+    const char* name;        // Name in the benchmark label
+    const char* encoderName; // libavcodec encoder
+    bool isIntraOnly;        // GOP structures don't apply
+};
+
+/**
+ * @brief A GOP structure of the test streams
+ */
+struct GOPConfig {
+    const char* name;
+    int gopSize;
+    int maxBFrames;
+};
+
+/**
+ * @brief An output mode of VideoReader
+ */
+struct OutputMode {
+    const char* name;
+    bool isHalfSize;
+    int rotateFlag;
+};
+
+/**
+ * @brief A decoder thread configuration
+ */
+struct ThreadConfig {
+    const char* name;
+    int decoderThreads;
+    int decoderThreadType;
+};
+
+/**
+ * @brief A locally encoded test stream
+ */
+struct TestStream {
+    std::string filename;
+    cv::Size size;
+};
+
+constexpr std::array<CodecConfig, 3> CODECS{{
+    {"h264", "libx264", false},
+    {"mpeg4", "mpeg4", false},
+    {"ffv1", "ffv1", true},
+}};
+
+const std::vector<cv::Size> SIZES = {{640, 360}, {1280, 720}, {1920, 1080}};
+
+constexpr std::array<GOPConfig, 3> GOPS{{
+    {"intra", 1, 0},
+    {"gop30", 30, 0},
+    {"gop30b2", 30, 2},
+}};
+
+constexpr std::array<OutputMode, 3> OUTPUT_MODES{{
+    {"native", false, -1},
+    {"half", true, -1},
+    {"rotate90", false, cv::RotateFlags::ROTATE_90_CLOCKWISE},
+}};
+
+constexpr std::array<ThreadConfig, 3> THREAD_CONFIGS{{
+    {"single", 1, FF_THREAD_FRAME},
+    {"frame", 0, FF_THREAD_FRAME},
+    {"slice", 0, FF_THREAD_SLICE},
+}};
+
+/**
+ * @brief Length of a test stream, a few GOPs
+ */
+constexpr int NUM_FRAMES = 90;
+
+/**
+ * @brief Number of moving objects in the test streams, the rest of the
+ * frame changes only by sensor noise like a static camera
+ */
+constexpr int NUM_OBJECTS = 16;
+
+constexpr uint32_t SEED = 42;
+
+/**
+ * @brief Encode a test stream of the synthetic scene
+ *
+ * @param filename Output file
+ * @param params Encoding parameters
+ * @return true Encoded successfully
+ * @return false Encoder not available or encoding failed
+ */
+bool encodeTestStream(const std::string& filename,
+                      const StreamEncoderParams& params) {
+    auto encoder = StreamEncoder(filename, params);
+    if (!encoder.isOpened()) {
+        return false;
+    }
+
+    auto background = cv::Mat(params.size, CV_8UC3);
+    SyntheticScene::renderBackground(background, SEED);
+
+    auto scene = CrowdScene(NUM_OBJECTS, params.size, SEED);
+    auto frame = cv::Mat(params.size, CV_8UC3);
+    auto objects = std::vector<cv::Rect2f>();
+    auto detections = std::vector<cv::Rect2f>();
+
+    for (int i = 0; i < NUM_FRAMES; i++) {
+        scene.next(detections);
+        objects.clear();
+        for (const auto& object : scene.getObjects()) {
+            if (object.lifetime > 0) {
+                objects.emplace_back(object.position, object.size);
+            }
+        }
+
+        background.copyTo(frame);
+        SyntheticScene::paintObjects(frame, objects);
+        SyntheticScene::addNoise(frame, SEED + i);
+
+        if (!encoder.write(frame)) {
+            return false;
+        }
+    }
+
+    return encoder.finish();
+}
+
+/**
+ * @brief Read a whole test stream per iteration
+ *
+ * @param state Benchmark state
+ * @param stream Test stream
+ * @param outputMode Output mode
+ * @param threadConfig Decoder thread configuration
+ * @return
+ */
+void BM_Read(benchmark::State& state,
+             const TestStream& stream,
+             const OutputMode& outputMode,
+             const ThreadConfig& threadConfig) {
+    auto params = VideoReaderParams();
+    params.rotateFlag = outputMode.rotateFlag;
+    params.resize = outputMode.isHalfSize ? stream.size / 2 : cv::Size(0, 0);
+    params.decoderThreads = threadConfig.decoderThreads;
+    params.decoderThreadType = threadConfig.decoderThreadType;
+
+    auto frame = cv::Mat();
+    auto total = VideoReader::StageTimes();
+    int64_t numFrames = 0;
+    double totalSec = 0.0;
+
+    for (auto _ : state) {
+        // Opening (probing the container, starting decoder threads) and
+        // closing are not measured
+        auto reader = VideoReader(stream.filename, params);
+        if (!reader.isOpened()) {
+            state.SkipWithError("Failed to open test stream");
+            break;
+        }
+        // Preallocated like the frames of the detection loop
+        frame.create(reader.getHeight(), reader.getWidth(), CV_8UC3);
+
+        auto begin = std::chrono::steady_clock::now();
+        while (reader.read(frame)) {
+            const auto& times = reader.getLastStageTimes();
+            total.demuxNs += times.demuxNs;
+            total.decodeNs += times.decodeNs;
+            total.transferNs += times.transferNs;
+            total.convertNs += times.convertNs;
+            total.rotateNs += times.rotateNs;
+            numFrames++;
+        }
+        benchmark::DoNotOptimize(frame.data);
+
+        // Decoder threads keep working while the reading thread waits, the
+        // wall time is what matters
+        auto elapsed = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - begin);
+        state.SetIterationTime(elapsed.count());
+        totalSec += elapsed.count();
+    }
+
+    if (numFrames == 0) {
+        return;
+    }
+
+    auto perFrameMs = [&](uint64_t ns) {
+        return static_cast<double>(ns) * 1e-6 / static_cast<double>(numFrames);
+    };
+    state.counters["frames/s"] = static_cast<double>(numFrames) / totalSec;
+    state.counters["demux_ms"] = perFrameMs(total.demuxNs);
+    state.counters["decode_ms"] = perFrameMs(total.decodeNs);
+    state.counters["transfer_ms"] = perFrameMs(total.transferNs);
+    state.counters["convert_ms"] = perFrameMs(total.convertNs);
+    state.counters["rotate_ms"] = perFrameMs(total.rotateNs);
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return EXIT_FAILURE;
+    }
+
+    // Opening a reader logs at info level
+    av_log_set_level(AV_LOG_ERROR);
+
+    // Test streams are written to a temporary directory, removed at exit
+    const char* tmpDir = std::getenv("TMPDIR");
+    auto dirname = std::string(tmpDir != nullptr ? tmpDir : "/tmp") +
+                   "/video_reader_bench.XXXXXX";
+    if (mkdtemp(dirname.data()) == nullptr) {
+        std::printf("[VIDEO READER BENCH] Cannot create %s\n",
+                    dirname.c_str());
+        return EXIT_FAILURE;
+    }
+
+    // Encoded before any benchmark is registered, so that the benchmark
+    // list only has the codecs this FFmpeg build can encode
+    auto streams = std::vector<TestStream>();
+
+    for (const auto& codec : CODECS) {
+        for (const auto& size : SIZES) {
+            for (const auto& gop : GOPS) {
+                if (codec.isIntraOnly && gop.gopSize != 1) {
+                    continue;
+                }
+
+                auto label = std::string(codec.name) + '/' +
+                             std::to_string(size.width) + 'x' +
+                             std::to_string(size.height) + '/' + gop.name;
+                auto filename = dirname + '/' + codec.name + '_' +
+                                std::to_string(size.height) + 'p' + '_' +
+                                gop.name + ".mkv";
+
+                auto params = StreamEncoderParams();
+                params.codecName = codec.encoderName;
+                params.size = size;
+                params.gopSize = gop.gopSize;
+                params.maxBFrames = gop.maxBFrames;
+
+                if (!encodeTestStream(filename, params)) {
+                    std::printf("[VIDEO READER BENCH] %s skipped, encoder %s "
+                                "not available or encoding failed\n",
+                                label.c_str(),
+                                codec.encoderName);
+                    std::remove(filename.c_str());
+                    continue;
+                }
+
+                streams.push_back({filename, size});
+                for (const auto& outputMode : OUTPUT_MODES) {
+                    for (const auto& threadConfig : THREAD_CONFIGS) {
+                        auto name = "BM_Read/" + label + '/' +
+                                    outputMode.name + '/' + threadConfig.name;
+                        benchmark::RegisterBenchmark(name.c_str(),
+                                                     BM_Read,
+                                                     streams.back(),
+                                                     outputMode,
+                                                     threadConfig)
+                            ->Unit(benchmark::kMillisecond)
+                            ->UseManualTime();
+                    }
+                }
+            }
+        }
+    }
+
+    benchmark::RunSpecifiedBenchmarks();
+
+    for (const auto& stream : streams) {
+        std::remove(stream.filename.c_str());
+    }
+    rmdir(dirname.c_str());
+
+    return EXIT_SUCCESS;
+}
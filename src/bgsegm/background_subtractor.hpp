@@ -0,0 +1,114 @@
+/**
+ * @file background_subtractor.hpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Common interface of the background subtraction engines
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+
+#include <cstddef>
+#include <opencv2/core.hpp>
+#include <vector>
+
+/**
+ * @brief Implementation of background subtraction
+ */
+enum class BackgroundSubtractorEngine {
+    /**
+     * @brief ViBeSequential, about 42 bytes of model per pixel
+     */
+    VIBE,
+
+    /**
+     * @brief SigmaDelta, 3 bytes of model per pixel, for low-end hardware
+     */
+    SIGMA_DELTA,
+};
+
+/**
+ * @brief Background subtractor of the detection loop: segment() labels the
+ *        pixels of a frame, then update() refreshes the model with the same
+ *        frame, skipping the pixels of the update mask. Both can be limited
+ *        to windows of the frame, so that frames between two full passes
+ *        only cost the area around the tracked objects.
+ */
+class BackgroundSubtractor {
+  public:
+#pragma region Public member methods
+
+    virtual ~BackgroundSubtractor() = default;
+
+    /**
+     * @brief Label the pixels of a frame, the first frame after construction
+     * or clear() initializes the model
+     *
+     * @param frame Input current frame (in CV_8UC3 format)
+     * @param fgMask Output foreground mask (in CV_8UC1 format, 0 or 255)
+     * @return
+     */
+    virtual void segment(const cv::Mat& frame, cv::Mat& fgMask) = 0;
+
+    /**
+     * @brief Refresh the background model
+     *
+     * @param frame Input current frame (in CV_8UC3 format)
+     * @param updateMask Input update mask (in CV_8UC1 format), non-zero
+     * pixels are kept out of the model
+     * @return
+     */
+    virtual void update(const cv::Mat& frame, const cv::Mat& updateMask) = 0;
+
+    /**
+     * @brief Label the pixels of some windows of a frame, the rest of the
+     * mask is left untouched. An uninitialized model segments the whole
+     * frame instead.
+     *
+     * @param frame Input current frame (in CV_8UC3 format)
+     * @param fgMask Output foreground mask (in CV_8UC1 format, 0 or 255)
+     * @param windows Disjoint windows inside the frame
+     * @return
+     */
+    virtual void segment(const cv::Mat& frame,
+                         cv::Mat& fgMask,
+                         const std::vector<cv::Rect>& windows) = 0;
+
+    /**
+     * @brief Refresh the background model inside some windows of a frame
+     *
+     * @param frame Input current frame (in CV_8UC3 format)
+     * @param updateMask Input update mask (in CV_8UC1 format), non-zero
+     * pixels are kept out of the model
+     * @param windows Disjoint windows inside the frame
+     * @return
+     */
+    virtual void update(const cv::Mat& frame,
+                        const cv::Mat& updateMask,
+                        const std::vector<cv::Rect>& windows) = 0;
+
+    /**
+     * @brief Reset the model, the next segmented frame initializes it again
+     *
+     * @return
+     */
+    virtual void clear() = 0;
+
+    /**
+     * @brief Tells whether the model is uninitialized
+     *
+     * @return  True: no frame segmented since construction or clear()
+     */
+    virtual bool empty() const = 0;
+
+    /**
+     * @brief Get the memory held by the background model
+     *
+     * @return  Size (bytes)
+     */
+    virtual size_t getMemoryUsage() const = 0;
+
+#pragma endregion
+};
@@ -0,0 +1,351 @@
+/**
+ * @file sigma_delta.cpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Implementation of sigma-delta background subtraction with
+ * three-frame differencing
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "sigma_delta.hpp"
+
+#include "trace.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <opencv2/core.hpp>
+#include <opencv2/core/hal/intrin.hpp>
+
+namespace {
+
+/**
+ * @brief Top bit of a variance byte, set when the pixel moved in the
+ * previous frame
+ */
+constexpr uint8_t MOTION_FLAG = 0x80;
+
+/**
+ * @brief Variance bits of a variance byte
+ */
+constexpr uint8_t VARIANCE_BITS = 0x7F;
+
+constexpr int VECTOR_WIDTH = cv::v_uint8x16::nlanes;
+
+/**
+ * @brief BT.601 luma weights of B, G and R (8-bit fixed point)
+ */
+constexpr uint16_t WEIGHT_B = 29;
+constexpr uint16_t WEIGHT_G = 150;
+constexpr uint16_t WEIGHT_R = 77;
+
+/**
+ * @brief Luma of a BGR pixel
+ *
+ * @param pixel Pointer to the pixel
+ * @return  Luma
+ */
+inline uint8_t getLuma(const uint8_t* pixel) {
+    return static_cast<uint8_t>(
+        (WEIGHT_B * pixel[0] + WEIGHT_G * pixel[1] + WEIGHT_R * pixel[2] +
+         128) >>
+        8);
+}
+
+/**
+ * @brief Luma of 16 consecutive BGR pixels
+ *
+ * @param pixels Pointer to the first pixel
+ * @return  Luma vector
+ */
+inline cv::v_uint8x16 getLuma16(const uint8_t* pixels) {
+    cv::v_uint8x16 vB;
+    cv::v_uint8x16 vG;
+    cv::v_uint8x16 vR;
+    cv::v_load_deinterleave(pixels, vB, vG, vR);
+
+    // The weighted sum fits in 16 bits
+    std::array<cv::v_uint16x8, 2> vB16;
+    std::array<cv::v_uint16x8, 2> vG16;
+    std::array<cv::v_uint16x8, 2> vR16;
+    cv::v_expand(vB, vB16[0], vB16[1]);
+    cv::v_expand(vG, vG16[0], vG16[1]);
+    cv::v_expand(vR, vR16[0], vR16[1]);
+
+    std::array<cv::v_uint16x8, 2> vLuma16;
+    for (size_t k = 0; k < vLuma16.size(); k++) {
+        vLuma16[k] = (vB16[k] * cv::v_setall_u16(WEIGHT_B) +
+                      vG16[k] * cv::v_setall_u16(WEIGHT_G) +
+                      vR16[k] * cv::v_setall_u16(WEIGHT_R) +
+                      cv::v_setall_u16(128)) >>
+                     8;
+    }
+
+    return cv::v_pack(vLuma16[0], vLuma16[1]);
+}
+
+/**
+ * @brief Step a value by one towards a target, without branches
+ *
+ * @param value Value
+ * @param target Target
+ * @return  Stepped value
+ */
+inline uint8_t stepTowards(uint8_t value, uint8_t target) {
+    return static_cast<uint8_t>(value + static_cast<int>(target > value) -
+                                static_cast<int>(target < value));
+}
+
+/**
+ * @brief Step 16 values by one towards their targets
+ *
+ * @param vValue Values
+ * @param vTarget Targets
+ * @return  Stepped values
+ */
+inline cv::v_uint8x16 stepTowards16(const cv::v_uint8x16& vValue,
+                                    const cv::v_uint8x16& vTarget) {
+    auto vOne = cv::v_setall_u8(1);
+    return (vValue + (vOne & (vTarget > vValue))) -
+           (vOne & (vTarget < vValue));
+}
+
+} // namespace
+
+SigmaDelta::SigmaDelta(int height, int width, const SigmaDeltaParams& params)
+    : _h(height),
+      _w(width),
+      _mean(height, width, CV_8UC1),
+      _variance(height, width, CV_8UC1),
+      _previous(height, width, CV_8UC1),
+      _numUpdates(0),
+      _isInitialized(false) {
+    setParams(params);
+}
+
+void SigmaDelta::setParams(const SigmaDeltaParams& params) {
+    _params = params;
+    _params.maxVariance = std::clamp(params.maxVariance, 1, 127);
+    _params.minVariance =
+        std::clamp(params.minVariance, 1, _params.maxVariance);
+    _params.updatePeriod = std::max(params.updatePeriod, 1);
+}
+
+size_t SigmaDelta::getMemoryUsage() const {
+    return _mean.total() + _variance.total() + _previous.total();
+}
+
+void SigmaDelta::init(const cv::Mat& frame) {
+    int numPixels = _h * _w;
+    auto minVariance = static_cast<uint8_t>(_params.minVariance);
+
+    for (int i = 0; i < numPixels; i++) {
+        uint8_t luma = getLuma(frame.data + i * 3);
+        _mean.data[i] = luma;
+        _previous.data[i] = luma;
+        _variance.data[i] = minVariance;
+    }
+
+    _numUpdates = 0;
+    _isInitialized = true;
+}
+
+void SigmaDelta::segment(const cv::Mat& frame, cv::Mat& fgMask) {
+    TRACE_SCOPE("SigmaDelta::segment");
+
+    checkInputs(frame, fgMask);
+
+    if (!_isInitialized) {
+        init(frame);
+    }
+
+    segmentSpan(frame, fgMask, 0, _h * _w);
+}
+
+void SigmaDelta::segment(const cv::Mat& frame,
+                         cv::Mat& fgMask,
+                         const std::vector<cv::Rect>& windows) {
+    if (!_isInitialized) {
+        segment(frame, fgMask);
+        return;
+    }
+
+    TRACE_SCOPE("SigmaDelta::segmentWindows");
+
+    checkInputs(frame, fgMask);
+
+    for (const auto& window : windows) {
+        CV_Assert((window & cv::Rect(0, 0, _w, _h)) == window);
+        for (int y = window.y; y < window.y + window.height; y++) {
+            int begin = y * _w + window.x;
+            segmentSpan(frame, fgMask, begin, begin + window.width);
+        }
+    }
+}
+
+void SigmaDelta::update(const cv::Mat& frame, const cv::Mat& updateMask) {
+    TRACE_SCOPE("SigmaDelta::update");
+
+    checkInputs(frame, updateMask);
+
+    if (!_isInitialized) {
+        return;
+    }
+
+    // Estimates only step once per period, motion is tracked every frame
+    bool isStepping = _numUpdates++ % _params.updatePeriod == 0;
+    updateSpan(frame, updateMask, 0, _h * _w, isStepping);
+}
+
+void SigmaDelta::update(const cv::Mat& frame,
+                        const cv::Mat& updateMask,
+                        const std::vector<cv::Rect>& windows) {
+    TRACE_SCOPE("SigmaDelta::updateWindows");
+
+    checkInputs(frame, updateMask);
+
+    if (!_isInitialized) {
+        return;
+    }
+
+    bool isStepping = _numUpdates++ % _params.updatePeriod == 0;
+    for (const auto& window : windows) {
+        CV_Assert((window & cv::Rect(0, 0, _w, _h)) == window);
+        for (int y = window.y; y < window.y + window.height; y++) {
+            int begin = y * _w + window.x;
+            updateSpan(
+                frame, updateMask, begin, begin + window.width, isStepping);
+        }
+    }
+}
+
+void SigmaDelta::checkInputs(const cv::Mat& frame, const cv::Mat& mask) const {
+    CV_Assert(frame.type() == CV_8UC3 && mask.type() == CV_8UC1);
+    CV_Assert(frame.rows == _h && frame.cols == _w);
+    CV_Assert(mask.rows == _h && mask.cols == _w);
+    CV_Assert(frame.isContinuous());
+    CV_Assert(mask.isContinuous());
+}
+
+void SigmaDelta::segmentSpan(const cv::Mat& frame,
+                             cv::Mat& fgMask,
+                             int begin,
+                             int end) {
+    auto threshold = static_cast<uint8_t>(_params.differenceThreshold);
+    const uint8_t* src = frame.data;
+    const uint8_t* mean = _mean.data;
+    const uint8_t* variance = _variance.data;
+    const uint8_t* previous = _previous.data;
+    uint8_t* dst = fgMask.data;
+
+    auto vThreshold = cv::v_setall_u8(threshold);
+    auto vVarianceBits = cv::v_setall_u8(VARIANCE_BITS);
+
+    int i = begin;
+    for (; i + VECTOR_WIDTH <= end; i += VECTOR_WIDTH) {
+        auto vLuma = getLuma16(src + i * 3);
+        auto vVariance = cv::v_load(variance + i);
+
+        auto vIsChanged = cv::v_absdiff(vLuma, cv::v_load(mean + i)) >
+                          (vVariance & vVarianceBits);
+        auto vIsMoving =
+            (cv::v_absdiff(vLuma, cv::v_load(previous + i)) > vThreshold) |
+            (vVariance > vVarianceBits);
+
+        cv::v_store(dst + i, vIsChanged & vIsMoving);
+    }
+
+    for (; i < end; i++) {
+        uint8_t luma = getLuma(src + i * 3);
+
+        bool isChanged =
+            std::abs(luma - mean[i]) > (variance[i] & VARIANCE_BITS);
+        bool isMoving = std::abs(luma - previous[i]) > threshold ||
+                        (variance[i] & MOTION_FLAG) != 0;
+
+        dst[i] = isChanged && isMoving ? 255 : 0;
+    }
+}
+
+void SigmaDelta::updateSpan(const cv::Mat& frame,
+                            const cv::Mat& updateMask,
+                            int begin,
+                            int end,
+                            bool isStepping) {
+    auto threshold = static_cast<uint8_t>(_params.differenceThreshold);
+    auto amplification = static_cast<uint16_t>(_params.amplification);
+    auto minVariance = static_cast<uint8_t>(_params.minVariance);
+    auto maxVariance = static_cast<uint8_t>(_params.maxVariance);
+    const uint8_t* src = frame.data;
+    const uint8_t* mask = updateMask.data;
+    uint8_t* mean = _mean.data;
+    uint8_t* variance = _variance.data;
+    uint8_t* previous = _previous.data;
+
+    auto vZero = cv::v_setzero_u8();
+    auto vThreshold = cv::v_setall_u8(threshold);
+    auto vAmplification = cv::v_setall_u16(amplification);
+    auto vMinVariance = cv::v_setall_u8(minVariance);
+    auto vMaxVariance = cv::v_setall_u8(maxVariance);
+    auto vVarianceBits = cv::v_setall_u8(VARIANCE_BITS);
+    auto vMotionFlag = cv::v_setall_u8(MOTION_FLAG);
+
+    int i = begin;
+    for (; i + VECTOR_WIDTH <= end; i += VECTOR_WIDTH) {
+        auto vLuma = getLuma16(src + i * 3);
+        auto vMean = cv::v_load(mean + i);
+        auto vVariance = cv::v_load(variance + i) & vVarianceBits;
+        auto vPrevious = cv::v_load(previous + i);
+
+        if (isStepping) {
+            auto vIsBackground = cv::v_load(mask + i) == vZero;
+            vMean = cv::v_select(
+                vIsBackground, stepTowards16(vMean, vLuma), vMean);
+
+            // Target amplification * |I - M|, saturated to the upper bound
+            auto vDiff = cv::v_absdiff(vLuma, vMean);
+            cv::v_uint16x8 vDiff0;
+            cv::v_uint16x8 vDiff1;
+            cv::v_expand(vDiff, vDiff0, vDiff1);
+            auto vTarget = cv::v_min(cv::v_pack(vDiff0 * vAmplification,
+                                                vDiff1 * vAmplification),
+                                     vMaxVariance);
+
+            auto vStepped = cv::v_max(
+                cv::v_min(stepTowards16(vVariance, vTarget), vMaxVariance),
+                vMinVariance);
+            vVariance = cv::v_select(
+                vIsBackground & (vDiff != vZero), vStepped, vVariance);
+            cv::v_store(mean + i, vMean);
+        }
+
+        auto vIsMoving = cv::v_absdiff(vLuma, vPrevious) > vThreshold;
+        cv::v_store(variance + i, vVariance | (vIsMoving & vMotionFlag));
+        cv::v_store(previous + i, vLuma);
+    }
+
+    for (; i < end; i++) {
+        uint8_t luma = getLuma(src + i * 3);
+        uint8_t value = variance[i] & VARIANCE_BITS;
+
+        if (isStepping) {
+            bool isBackground = mask[i] == 0;
+            mean[i] = isBackground ? stepTowards(mean[i], luma) : mean[i];
+
+            int diff = std::abs(luma - mean[i]);
+            auto target =
+                static_cast<uint8_t>(std::min(diff * amplification,
+                                              static_cast<int>(maxVariance)));
+            uint8_t stepped = std::clamp(
+                stepTowards(value, target), minVariance, maxVariance);
+            value = isBackground && diff != 0 ? stepped : value;
+        }
+
+        bool isMoving = std::abs(luma - previous[i]) > threshold;
+        variance[i] = value | (isMoving ? MOTION_FLAG : 0);
+        previous[i] = luma;
+    }
+}
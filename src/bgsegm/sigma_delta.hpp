@@ -0,0 +1,187 @@
+/**
+ * @file sigma_delta.hpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Sigma-delta background estimation combined with three-frame
+ * differencing, for low-end hardware
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+
+#include "background_subtractor.hpp"
+
+#include <cstdint>
+#include <opencv2/core.hpp>
+#include <vector>
+
+/**
+ * @brief Additional parameters for SigmaDelta class (gray levels)
+ */
+struct SigmaDeltaParams {
+    /**
+     * @brief Factor of the absolute difference to the background estimate
+     * that the variance estimate converges to
+     */
+    int amplification = 4;
+
+    /**
+     * @brief Lower bound of the variance estimate, sensor noise below it
+     * never makes a pixel foreground
+     */
+    int minVariance = 12;
+
+    /**
+     * @brief Upper bound of the variance estimate (at most 127)
+     */
+    int maxVariance = 96;
+
+    /**
+     * @brief Threshold of the absolute difference between consecutive frames
+     * for a pixel to be moving
+     */
+    int differenceThreshold = 12;
+
+    /**
+     * @brief The background and variance estimates step once every this
+     * many frames
+     */
+    int updatePeriod = 2;
+};
+
+/**
+ * @brief Sigma-delta background subtractor on the luma of frames.
+ *
+ *        The background estimate M steps by one gray level towards each
+ *        frame, and the variance estimate V steps towards amplification *
+ *        |I - M|. A pixel is foreground when |I - M| > V and it is moving,
+ *        i.e. it differs from the previous frame or the previous frame
+ *        differed from the one before (three-frame differencing), which
+ *        removes the ghosts and slow changes sigma-delta is late to absorb.
+ *
+ *        The model takes 3 bytes per pixel: M, V and the previous luma. V
+ *        is at most 127, its top bit holds the motion of the previous frame.
+ *        All steps are branch-free and run on 16 pixels at a time.
+ */
+class SigmaDelta final : public BackgroundSubtractor {
+  public:
+#pragma region Public constants
+
+    /**
+     * @brief Model size (bytes per pixel)
+     */
+    static constexpr int MODEL_BYTES_PER_PIXEL = 3;
+
+#pragma endregion
+
+#pragma region Public member methods
+
+    /**
+     * @brief Construct a new SigmaDelta object
+     *
+     * @param height Frame height
+     * @param width Frame width
+     * @param params Additional parameters
+     */
+    SigmaDelta(int height,
+               int width,
+               const SigmaDeltaParams& params = SigmaDeltaParams());
+
+    void segment(const cv::Mat& frame, cv::Mat& fgMask) override;
+
+    void update(const cv::Mat& frame, const cv::Mat& updateMask) override;
+
+    void segment(const cv::Mat& frame,
+                 cv::Mat& fgMask,
+                 const std::vector<cv::Rect>& windows) override;
+
+    void update(const cv::Mat& frame,
+                const cv::Mat& updateMask,
+                const std::vector<cv::Rect>& windows) override;
+
+    void clear() override { _isInitialized = false; }
+
+    bool empty() const override { return !_isInitialized; }
+
+    size_t getMemoryUsage() const override;
+
+    /**
+     * @brief Set parameters, the model is kept and they take effect on the
+     * next frame
+     *
+     * @param params Parameters (variance bounds are clamped to [1, 127])
+     * @return
+     */
+    void setParams(const SigmaDeltaParams& params);
+
+    const SigmaDeltaParams& getParams() const { return _params; }
+
+#pragma endregion
+
+  private:
+#pragma region Private member variables
+
+    int _h;
+    int _w;
+    SigmaDeltaParams _params;
+
+    /* Model */
+    cv::Mat _mean;
+    cv::Mat _variance;
+    cv::Mat _previous;
+
+    uint32_t _numUpdates;
+    bool _isInitialized;
+
+#pragma endregion
+
+#pragma region Private member methods
+
+    /**
+     * @brief Initialize the model with the first frame
+     *
+     * @param frame First frame
+     * @return
+     */
+    void init(const cv::Mat& frame);
+
+    /**
+     * @brief Check the frame and mask given to segment() or update()
+     *
+     * @param frame Frame
+     * @param mask Foreground or update mask
+     * @return
+     */
+    void checkInputs(const cv::Mat& frame, const cv::Mat& mask) const;
+
+    /**
+     * @brief Segment a span of consecutive pixels
+     *
+     * @param frame Input current frame
+     * @param fgMask Output foreground mask
+     * @param begin Index of the first pixel
+     * @param end Index past the last pixel
+     * @return
+     */
+    void segmentSpan(const cv::Mat& frame, cv::Mat& fgMask, int begin, int end);
+
+    /**
+     * @brief Update the model of a span of consecutive pixels
+     *
+     * @param frame Input current frame
+     * @param updateMask Input update mask
+     * @param begin Index of the first pixel
+     * @param end Index past the last pixel
+     * @param isStepping Whether the estimates step on this frame
+     * @return
+     */
+    void updateSpan(const cv::Mat& frame,
+                    const cv::Mat& updateMask,
+                    int begin,
+                    int end,
+                    bool isStepping);
+
+#pragma endregion
+};
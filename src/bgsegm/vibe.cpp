@@ -12,6 +12,8 @@
 
 #include "vibe.hpp"
 
+#include "trace.hpp"
+
 #include <array>
 #include <ctime>
 #include <opencv2/core.hpp>
@@ -35,6 +37,8 @@ ViBe::ViBe(int height,
 }
 
 void ViBe::segment(const cv::Mat& frame, cv::Mat& fgMask) {
+    TRACE_SCOPE("ViBe::segment");
+
     CV_Assert(!frame.empty());
     CV_Assert(!fgMask.empty());
     CV_Assert(frame.rows == _h && frame.cols == _w);
@@ -62,6 +66,8 @@ void ViBe::segment(const cv::Mat& frame, cv::Mat& fgMask) {
 }
 
 void ViBe::update(const cv::Mat& frame, const cv::Mat& updateMask) {
+    TRACE_SCOPE("ViBe::update");
+
     CV_Assert(!frame.empty());
     CV_Assert(!updateMask.empty());
     CV_Assert(frame.rows == _h && frame.cols == _w);
@@ -100,6 +100,8 @@ class ViBe : public cv::Algorithm {
      */
     bool empty() const override { return !_isInitalized; }
 
+    int getNumSamples() const { return NUM_SAMPLES; }
+
 #pragma endregion
   private:
 #pragma region Private constants
@@ -11,6 +11,9 @@
 
 #include "vibe_sequential.hpp"
 
+#include "trace.hpp"
+
+#include <algorithm>
 #include <array>
 #include <opencv2/core.hpp>
 
@@ -24,6 +27,7 @@ ViBeSequential::ViBeSequential(int height,
       _w(width),
       _numPixelsPerFrame(height * width),
       _numSamples(numSamples),
+      _numActiveSamples(numSamples),
       _thresholdL1(thresholdL1 * 3),
       _minNumCloseSamples(minNumCloseSamples),
       _updateFactor(updateFactor),
@@ -48,79 +52,55 @@ ViBeSequential::~ViBeSequential() {
     cv::fastFree(_historySamples);
 }
 
+size_t ViBeSequential::getMemoryUsage() const {
+    // Two history images and the samples, 3 bytes per pixel each
+    size_t numPixels = static_cast<size_t>(_numPixelsPerFrame);
+    size_t numIndices =
+        _jump.capacity() + _neighborIndex.capacity() + _replaceIndex.capacity();
+    return numPixels * 3 * (2 + _numSamples) + numIndices * sizeof(int);
+}
+
 void ViBeSequential::segment(const cv::Mat& frame, cv::Mat& fgMask) {
-    CV_Assert(!frame.empty());
-    CV_Assert(!fgMask.empty());
-    CV_Assert(frame.rows == _h && frame.cols == _w);
-    CV_Assert(fgMask.rows == _h && fgMask.cols == _w);
-    CV_Assert(frame.isContinuous());
-    CV_Assert(fgMask.isContinuous());
+    TRACE_SCOPE("ViBeSequential::segment");
+
+    checkInputs(frame, fgMask);
 
     if (!_isInitalized) {
         init(frame);
     }
 
-    // Clear segmentation mask
-    fgMask.setTo(_minNumCloseSamples - 1);
-
-    int numPixels = _h * _w;
-
     _swapHistoryImageFlag = !_swapHistoryImageFlag;
-    uint8_t* swappingHistoryImage =
-        _swapHistoryImageFlag ? _historyImage1 : _historyImage0;
-
-    // Compare with first history image
-    for (int i = 0; i < numPixels; i++) {
-        if (!isClose(
-                _historyImage0 + i * 3, frame.data + i * 3, _thresholdL1)) {
-            fgMask.data[i] = _minNumCloseSamples;
-        }
-    }
+    segmentSpan(frame, fgMask, 0, _h * _w);
+}
 
-    // Compare with second history image
-    for (int i = 0; i < numPixels; i++) {
-        if (isClose(_historyImage1 + i * 3, frame.data + i * 3, _thresholdL1)) {
-            fgMask.data[i]--;
-        }
+void ViBeSequential::segment(const cv::Mat& frame,
+                             cv::Mat& fgMask,
+                             const std::vector<cv::Rect>& windows) {
+    if (!_isInitalized) {
+        segment(frame, fgMask);
+        return;
     }
 
-    // Compare with history samples
-    for (int i = 0; i < numPixels; i++) {
-        // This pixel is already labelled as background, move to next one
-        if (fgMask.data[i] < 0) {
-            continue;
-        }
-
-        uint8_t* historySample = _historySamples + i * _numSamples * 3;
-        std::array<uint8_t, 3> currentPixel;
-        copyPixel(currentPixel.data(), frame.data + i * 3);
-
-        for (int k = 0; k < _numSamples && fgMask.data[i] > 0; k++) {
-            if (isClose(
-                    historySample + k * 3, currentPixel.data(), _thresholdL1)) {
-                fgMask.data[i]--;
+    TRACE_SCOPE("ViBeSequential::segmentWindows");
 
-                // Put the close sample pixel into history image buffer
-                swapPixel(swappingHistoryImage + i * 3, historySample + k * 3);
-            }
-        }
-    }
+    checkInputs(frame, fgMask);
 
-    // Assgin foreground label for "survivors"
-    for (int i = 0; i < numPixels; i++) {
-        if (fgMask.data[i] > 0) {
-            fgMask.data[i] = FOREGROUND_LABEL;
+    _swapHistoryImageFlag = !_swapHistoryImageFlag;
+    for (const auto& window : windows) {
+        CV_Assert((window & cv::Rect(0, 0, _w, _h)) == window);
+        for (int y = window.y; y < window.y + window.height; y++) {
+            segmentSpan(frame,
+                        fgMask,
+                        y * _w + window.x,
+                        y * _w + window.x + window.width);
         }
     }
 }
 
 void ViBeSequential::update(const cv::Mat& frame, const cv::Mat& updateMask) {
-    CV_Assert(!frame.empty());
-    CV_Assert(!updateMask.empty());
-    CV_Assert(frame.rows == _h && frame.cols == _w);
-    CV_Assert(updateMask.rows == _h && updateMask.cols == _w);
-    CV_Assert(frame.isContinuous());
-    CV_Assert(updateMask.isContinuous());
+    TRACE_SCOPE("ViBeSequential::update");
+
+    checkInputs(frame, updateMask);
 
     int shift;
     int indX;
@@ -132,41 +112,7 @@ void ViBeSequential::update(const cv::Mat& frame, const cv::Mat& updateMask) {
     // Update background model
     // All but border
     for (y = 1; y < _h - 1; ++y) {
-        shift = _rng.uniform(0, _w);
-        indX = _jump[shift];
-        k = _replaceIndex[shift];
-        int neighborIndex = _neighborIndex[shift];
-
-        while (indX < _w - 1) {
-            int i = indX + y * _w;
-            std::array<uint8_t, 3> currentPixel;
-            copyPixel(currentPixel.data(), frame.data + i * 3);
-
-            if (updateMask.data[i] == BACKGROUND_LABEL) {
-                if (k < 2) {
-                    uint8_t* historyImage =
-                        (k == 0) ? _historyImage0 : _historyImage1;
-
-                    copyPixel(historyImage + i * 3, currentPixel.data());
-                    copyPixel(historyImage + (i + neighborIndex) * 3,
-                              currentPixel.data());
-                } else {
-                    int kSample = k - 2;
-
-                    copyPixel(_historySamples +
-                                  (i * _numSamples * 3 + kSample * 3),
-                              currentPixel.data());
-
-                    copyPixel(_historySamples +
-                                  ((i + neighborIndex) * _numSamples * 3 +
-                                   kSample * 3),
-                              currentPixel.data());
-                }
-            }
-
-            ++shift;
-            indX += _jump[shift];
-        }
+        updateSpan(frame, updateMask, y, 1, _w - 1);
     }
 
     auto replaceSample =
@@ -246,9 +192,49 @@ void ViBeSequential::update(const cv::Mat& frame, const cv::Mat& updateMask) {
     }
 }
 
+void ViBeSequential::update(const cv::Mat& frame,
+                            const cv::Mat& updateMask,
+                            const std::vector<cv::Rect>& windows) {
+    TRACE_SCOPE("ViBeSequential::updateWindows");
+
+    checkInputs(frame, updateMask);
+
+    // The border rows and columns need the bounded updates of update()
+    auto interior = cv::Rect(1, 1, _w - 2, _h - 2);
+    for (const auto& window : windows) {
+        auto rect = window & interior;
+        for (int y = rect.y; y < rect.y + rect.height; y++) {
+            updateSpan(frame, updateMask, y, rect.x, rect.x + rect.width);
+        }
+    }
+}
+
 void ViBeSequential::clear() { _isInitalized = false; }
 
+void ViBeSequential::setNumActiveSamples(int numActiveSamples) {
+    _numActiveSamples =
+        std::clamp(numActiveSamples, _minNumCloseSamples, _numSamples);
+}
+
+void ViBeSequential::setMinNumCloseSamples(int minNumCloseSamples) {
+    _minNumCloseSamples = std::clamp(minNumCloseSamples, 1, _numSamples);
+    setNumActiveSamples(_numActiveSamples);
+}
+
+void ViBeSequential::setUpdateFactor(int updateFactor) {
+    _updateFactor = std::max(1, updateFactor);
+
+    // Jumps between updated pixels follow the new rate
+    if (_isInitalized) {
+        for (auto& jump : _jump) {
+            jump = _rng.uniform(1, _updateFactor * 2 + 1);
+        }
+    }
+}
+
 void ViBeSequential::init(const cv::Mat& frame) {
+    TRACE_SCOPE("ViBeSequential::init");
+
     // Fill in history images
     uint8_t* src = frame.data;
     int sizePerFrame = _numPixelsPerFrame * 3;
@@ -276,6 +262,115 @@ void ViBeSequential::init(const cv::Mat& frame) {
     _isInitalized = true;
 }
 
+void ViBeSequential::checkInputs(const cv::Mat& frame,
+                                 const cv::Mat& mask) const {
+    CV_Assert(!frame.empty());
+    CV_Assert(!mask.empty());
+    CV_Assert(frame.rows == _h && frame.cols == _w);
+    CV_Assert(mask.rows == _h && mask.cols == _w);
+    CV_Assert(frame.isContinuous());
+    CV_Assert(mask.isContinuous());
+}
+
+void ViBeSequential::segmentSpan(const cv::Mat& frame,
+                                 cv::Mat& fgMask,
+                                 int begin,
+                                 int end) {
+    // Clear segmentation mask
+    std::fill(fgMask.data + begin,
+              fgMask.data + end,
+              static_cast<uint8_t>(_minNumCloseSamples - 1));
+
+    uint8_t* swappingHistoryImage =
+        _swapHistoryImageFlag ? _historyImage1 : _historyImage0;
+
+    // Compare with first history image
+    for (int i = begin; i < end; i++) {
+        if (!isClose(
+                _historyImage0 + i * 3, frame.data + i * 3, _thresholdL1)) {
+            fgMask.data[i] = _minNumCloseSamples;
+        }
+    }
+
+    // Compare with second history image
+    for (int i = begin; i < end; i++) {
+        if (isClose(_historyImage1 + i * 3, frame.data + i * 3, _thresholdL1)) {
+            fgMask.data[i]--;
+        }
+    }
+
+    // Compare with history samples
+    for (int i = begin; i < end; i++) {
+        // This pixel is already labelled as background, move to next one
+        if (fgMask.data[i] < 0) {
+            continue;
+        }
+
+        uint8_t* historySample = _historySamples + i * _numSamples * 3;
+        std::array<uint8_t, 3> currentPixel;
+        copyPixel(currentPixel.data(), frame.data + i * 3);
+
+        for (int k = 0; k < _numActiveSamples && fgMask.data[i] > 0; k++) {
+            if (isClose(
+                    historySample + k * 3, currentPixel.data(), _thresholdL1)) {
+                fgMask.data[i]--;
+
+                // Put the close sample pixel into history image buffer
+                swapPixel(swappingHistoryImage + i * 3, historySample + k * 3);
+            }
+        }
+    }
+
+    // Assgin foreground label for "survivors"
+    for (int i = begin; i < end; i++) {
+        if (fgMask.data[i] > 0) {
+            fgMask.data[i] = FOREGROUND_LABEL;
+        }
+    }
+}
+
+
+void ViBeSequential::updateSpan(const cv::Mat& frame,
+                                const cv::Mat& updateMask,
+                                int y,
+                                int xBegin,
+                                int xEnd) {
+    int shift = _rng.uniform(0, _w);
+    int indX = xBegin - 1 + _jump[shift];
+    int k = _replaceIndex[shift];
+    int neighborIndex = _neighborIndex[shift];
+
+    while (indX < xEnd) {
+        int i = indX + y * _w;
+        std::array<uint8_t, 3> currentPixel;
+        copyPixel(currentPixel.data(), frame.data + i * 3);
+
+        if (updateMask.data[i] == BACKGROUND_LABEL) {
+            if (k < 2) {
+                uint8_t* historyImage =
+                    (k == 0) ? _historyImage0 : _historyImage1;
+
+                copyPixel(historyImage + i * 3, currentPixel.data());
+                copyPixel(historyImage + (i + neighborIndex) * 3,
+                          currentPixel.data());
+            } else {
+                int kSample = k - 2;
+
+                copyPixel(_historySamples + (i * _numSamples * 3 + kSample * 3),
+                          currentPixel.data());
+
+                copyPixel(_historySamples +
+                              ((i + neighborIndex) * _numSamples * 3 +
+                               kSample * 3),
+                          currentPixel.data());
+            }
+        }
+
+        ++shift;
+        indX += _jump[shift];
+    }
+}
+
 bool ViBeSequential::isClose(const uint8_t* pixelA,
                              const uint8_t* pixelB,
                              uint32_t thresholdL1) {
@@ -11,6 +11,8 @@
 
 #pragma once
 
+#include "background_subtractor.hpp"
+
 #include <memory>
 #include <opencv2/core.hpp>
 #include <vector>
@@ -18,7 +20,7 @@
 /**
  * @brief ViBe background substractor running sequentially
  */
-class ViBeSequential : cv::Algorithm {
+class ViBeSequential : public BackgroundSubtractor, cv::Algorithm {
   public:
 #pragma region Public member methods
 
@@ -80,7 +82,7 @@ class ViBeSequential : cv::Algorithm {
      * @param fgMask Output foreground mask (in CV_8UC1 format)
      * @return
      */
-    void segment(const cv::Mat& frame, cv::Mat& fgMask);
+    void segment(const cv::Mat& frame, cv::Mat& fgMask) override;
 
     /**
      * @brief
@@ -89,7 +91,24 @@ class ViBeSequential : cv::Algorithm {
      * @param updateMask Input update mask (in CV_8UC1 format)
      * @return
      */
-    void update(const cv::Mat& frame, const cv::Mat& updateMask);
+    void update(const cv::Mat& frame, const cv::Mat& updateMask) override;
+
+    void segment(const cv::Mat& frame,
+                 cv::Mat& fgMask,
+                 const std::vector<cv::Rect>& windows) override;
+
+    /**
+     * @brief Refresh the background model inside some windows, the pixels
+     * on the frame border are only refreshed by full updates
+     *
+     * @param frame Input current frame (in CV_8UC3 format)
+     * @param updateMask Input update mask (in CV_8UC1 format)
+     * @param windows Disjoint windows inside the frame
+     * @return
+     */
+    void update(const cv::Mat& frame,
+                const cv::Mat& updateMask,
+                const std::vector<cv::Rect>& windows) override;
 
     /**
      * @brief Reset the background substractor by invalidating all samples in
@@ -108,6 +127,57 @@ class ViBeSequential : cv::Algorithm {
      */
     bool empty() const override { return !_isInitalized; }
 
+    size_t getMemoryUsage() const override;
+
+    /**
+     * @brief Compare pixels with only the first n background samples in
+     * segment(), trading accuracy for speed. All samples are still updated,
+     * so raising n again takes effect immediately.
+     *
+     * @param numActiveSamples Number of compared samples (clamped to
+     * [minNumCloseSamples, numSamples])
+     * @return
+     */
+    void setNumActiveSamples(int numActiveSamples);
+
+    int getNumActiveSamples() const { return _numActiveSamples; }
+
+    int getNumSamples() const { return _numSamples; }
+
+    /**
+     * @brief Set the L1 norm threshold, takes effect on the next frame
+     *
+     * @param thresholdL1 L1 norm threshold (per channel)
+     * @return
+     */
+    void setThresholdL1(uint32_t thresholdL1) {
+        _thresholdL1 = thresholdL1 * 3;
+    }
+
+    uint32_t getThresholdL1() const { return _thresholdL1 / 3; }
+
+    /**
+     * @brief Set the minimum number of close samples of a background pixel,
+     * takes effect on the next frame
+     *
+     * @param minNumCloseSamples Minimum number of close samples (clamped to
+     * [1, numSamples])
+     * @return
+     */
+    void setMinNumCloseSamples(int minNumCloseSamples);
+
+    int getMinNumCloseSamples() const { return _minNumCloseSamples; }
+
+    /**
+     * @brief Set the update factor, the background model is kept
+     *
+     * @param updateFactor Update factor
+     * @return
+     */
+    void setUpdateFactor(int updateFactor);
+
+    int getUpdateFactor() const { return _updateFactor; }
+
 #pragma endregion
   private:
 #pragma region Private constants
@@ -133,6 +203,7 @@ class ViBeSequential : cv::Algorithm {
     int _w;
     int _numPixelsPerFrame;
     int _numSamples;
+    int _numActiveSamples;
     uint32_t _thresholdL1;
     int _minNumCloseSamples;
     int _updateFactor;
@@ -165,6 +236,43 @@ class ViBeSequential : cv::Algorithm {
      */
     void init(const cv::Mat& frame);
 
+    /**
+     * @brief Check the frame and mask given to segment() or update()
+     *
+     * @param frame Frame
+     * @param mask Foreground or update mask
+     * @return
+     */
+    void checkInputs(const cv::Mat& frame, const cv::Mat& mask) const;
+
+    /**
+     * @brief Segment a span of consecutive pixels
+     *
+     * @param frame Input current frame
+     * @param fgMask Output foreground mask
+     * @param begin Index of the first pixel
+     * @param end Index past the last pixel
+     * @return
+     */
+    void segmentSpan(const cv::Mat& frame, cv::Mat& fgMask, int begin, int end);
+
+    /**
+     * @brief Refresh randomly picked pixels of a row span (and their
+     * neighbors), away from the frame border
+     *
+     * @param frame Input current frame
+     * @param updateMask Input update mask
+     * @param y Row
+     * @param xBegin First column (at least 1)
+     * @param xEnd Column past the last one (at most width - 1)
+     * @return
+     */
+    void updateSpan(const cv::Mat& frame,
+                    const cv::Mat& updateMask,
+                    int y,
+                    int xBegin,
+                    int xEnd);
+
 #pragma endregion
 
 #pragma region Static helper methods
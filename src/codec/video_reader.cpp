@@ -1,5 +1,11 @@
 #include "video_reader.hpp"
 
+#include "trace.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+
 #if defined(ROCKCHIP_PLATFORM)
 
 extern "C" {
@@ -11,6 +17,25 @@ extern "C" {
 
 #endif
 
+namespace {
+
+/**
+ * @brief Nanoseconds elapsed since a time point, which is then moved to now
+ *
+ * @param last Time point
+ * @return  Elapsed time (ns)
+ */
+uint64_t lap(std::chrono::steady_clock::time_point& last) {
+    auto now = std::chrono::steady_clock::now();
+    auto ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(now - last)
+            .count();
+    last = now;
+    return static_cast<uint64_t>(ns);
+}
+
+} // namespace
+
 VideoReader::VideoReader()
     : _avFormatContext(nullptr),
       _avFormatOptions(nullptr),
@@ -21,7 +46,11 @@ VideoReader::VideoReader()
       _avFrameRaw(nullptr),
       _avFrameSw(nullptr),
       _avFrameBGR24(nullptr),
-      _frameCount(0) {
+      _isOpened(false),
+      _frameCount(0),
+      _receiveBufferSize(0),
+      _decodedFramesSize(0),
+      _outputBufferSize(0) {
     // Allocate necessary objects
     _avFormatContext = avformat_alloc_context();
     _avPacket = av_packet_alloc();
@@ -57,6 +86,7 @@ VideoReader::VideoReader(const std::string& addr,
                 0);
 
     avformat_network_init();
+    _receiveBufferSize = params.receiveBufferSize;
 
     auto url = "rtsp://" + addr + ':' + std::to_string(port) + '/' + filename;
     open(url, params);
@@ -113,42 +143,9 @@ void VideoReader::open(std::string_view path, const VideoReaderParams& params) {
     _fps = av_q2d(stream->r_frame_rate);
     _rotateFlag = params.rotateFlag;
 
-    // Set output size
-    if (!params.resize.empty()) {
-        _height = params.resize.height;
-        _width = params.resize.width;
-    } else if (_rotateFlag == cv::RotateFlags::ROTATE_90_CLOCKWISE ||
-               _rotateFlag == cv::RotateFlags::ROTATE_90_COUNTERCLOCKWISE) {
-        _height = _widthRaw;
-        _width = _heightRaw;
-    } else {
-        _height = _heightRaw;
-        _width = _widthRaw;
-    }
-
     // Allocate BGR24 frame buffer for intermediate processing
     _avFrameBGR24 = av_frame_alloc();
-    if (_rotateFlag == -1 || _rotateFlag == cv::RotateFlags::ROTATE_180) {
-        _avFrameBGR24->height = _height;
-        _avFrameBGR24->width = _width;
-    } else if (_rotateFlag == cv::RotateFlags::ROTATE_90_CLOCKWISE ||
-               _rotateFlag == cv::RotateFlags::ROTATE_90_COUNTERCLOCKWISE) {
-        _avFrameBGR24->height = _width;
-        _avFrameBGR24->width = _height;
-    }
-
-    err = av_image_alloc(_avFrameBGR24->data,
-                         _avFrameBGR24->linesize,
-                         _avFrameBGR24->width,
-                         _avFrameBGR24->height,
-                         AVPixelFormat::AV_PIX_FMT_BGR24,
-                         16);
-
-    if (err < 0) {
-        av_log(nullptr,
-               AV_LOG_ERROR,
-               "Failed to allocate BGR24 frame buffer, error: %d\n",
-               err);
+    if (!allocateOutputBuffer(params.resize)) {
         return;
     }
 
@@ -156,8 +153,10 @@ void VideoReader::open(std::string_view path, const VideoReaderParams& params) {
     _avDecoderContext = avcodec_alloc_context3(avDecoder);
 
     // Enable multi-threaded decoding
-    _avDecoderContext->thread_count = cv::getNumberOfCPUs();
-    _avDecoderContext->thread_type = FF_THREAD_FRAME;
+    _avDecoderContext->thread_count = params.decoderThreads > 0
+                                          ? params.decoderThreads
+                                          : cv::getNumberOfCPUs();
+    _avDecoderContext->thread_type = params.decoderThreadType;
 
     // Try to get hardware device type
     auto hwDeiveType =
@@ -221,12 +220,29 @@ void VideoReader::open(std::string_view path, const VideoReaderParams& params) {
         return;
     }
 
+    // Decoded frames in flight: the references, one per frame thread and
+    // the raw (and transferred) frame
+    int numDecodedFrames = std::max(_avDecoderContext->refs, 1) + 2;
+    if ((_avDecoderContext->thread_type & FF_THREAD_FRAME) != 0) {
+        numDecodedFrames += _avDecoderContext->thread_count;
+    }
+    auto rawFormat = static_cast<AVPixelFormat>(stream->codecpar->format);
+    int rawFrameSize = av_image_get_buffer_size(
+        rawFormat == AV_PIX_FMT_NONE ? AV_PIX_FMT_YUV420P : rawFormat,
+        _widthRaw,
+        _heightRaw,
+        1);
+    _decodedFramesSize =
+        static_cast<size_t>(std::max(rawFrameSize, 0)) * numDecodedFrames;
+
     _isOpened = true;
 }
 
 VideoReader::~VideoReader() { close(); }
 
 bool VideoReader::read(cv::Mat& frame) {
+    TRACE_SCOPE("VideoReader::read");
+
     if (!_isOpened) {
         return false;
     }
@@ -235,8 +251,12 @@ bool VideoReader::read(cv::Mat& frame) {
     int numErrors = 0;
     bool hasGotFrame = false;
 
+    _stageTimes = StageTimes();
+    auto last = std::chrono::steady_clock::now();
+
     while (!hasGotFrame) {
         err = av_read_frame(_avFormatContext, _avPacket);
+        _stageTimes.demuxNs += lap(last);
 
         // Wait for more data
         if (err == AVERROR(EAGAIN)) {
@@ -256,8 +276,9 @@ bool VideoReader::read(cv::Mat& frame) {
             break;
         }
 
-        // Send the packet to decoder
+        // Send the packet to decoder, which keeps its own reference
         err = avcodec_send_packet(_avDecoderContext, _avPacket);
+        av_packet_unref(_avPacket);
 
         // if (err == AVERROR(EAGAIN)) {
         //     continue;
@@ -269,11 +290,13 @@ bool VideoReader::read(cv::Mat& frame) {
                    "Failed to send packet to decoder, error: %d\n",
                    err);
             numErrors++;
+            _stageTimes.decodeNs += lap(last);
             continue;
         }
 
         // Receive frame from decoder
         err = avcodec_receive_frame(_avDecoderContext, _avFrameRaw);
+        _stageTimes.decodeNs += lap(last);
 
         // Wait for more packets to decode a frame
         if (err == AVERROR(EAGAIN)) {
@@ -298,13 +321,14 @@ bool VideoReader::read(cv::Mat& frame) {
         _frameCount++;
     }
 
-    // Unref the packet
-    av_packet_unref(_avPacket);
     return postProcess(frame);
 }
 
 bool VideoReader::postProcess(cv::Mat& frame) {
+    TRACE_SCOPE("VideoReader::postProcess");
+
     int err;
+    auto last = std::chrono::steady_clock::now();
 #if defined(ROCKCHIP_PLATFORM)
     // Do YUV420P to RGB conversion
 
@@ -328,13 +352,24 @@ bool VideoReader::postProcess(cv::Mat& frame) {
     auto src = rga::wrapbuffer_fd_t(
         fd, _widthRaw, _heightRaw, _widthRaw, _heightRaw, rkFormat);
 
+    // Convert directly into a preallocated output frame when no rotation is
+    // needed, otherwise into the BGR24 buffer
+    bool isDirect = _rotateFlag == -1 && isPreallocated(frame);
+
     // WRAP BGR24 buffer to dst
-    auto dst = rga::wrapbuffer_virtualaddr_t(_avFrameBGR24->data[0],
-                                             _avFrameBGR24->width,
-                                             _avFrameBGR24->height,
-                                             _avFrameBGR24->linesize[0] / 3,
-                                             _avFrameBGR24->height,
-                                             RK_FORMAT_BGR_888);
+    auto dst = isDirect ? rga::wrapbuffer_virtualaddr_t(frame.data,
+                                                        _width,
+                                                        _height,
+                                                        frame.step / 3,
+                                                        _height,
+                                                        RK_FORMAT_BGR_888)
+                        : rga::wrapbuffer_virtualaddr_t(
+                              _avFrameBGR24->data[0],
+                              _avFrameBGR24->width,
+                              _avFrameBGR24->height,
+                              _avFrameBGR24->linesize[0] / 3,
+                              _avFrameBGR24->height,
+                              RK_FORMAT_BGR_888);
 
     // Convert color space & resize
     err = rga::imcvtcolor_t(
@@ -372,7 +407,7 @@ bool VideoReader::postProcess(cv::Mat& frame) {
                    err);
             return false;
         }
-    } else {
+    } else if (!isDirect) {
         // Wrap the BGR24 buffer to output cv::Mat
         frame = cv::Mat(_avFrameBGR24->height,
                         _avFrameBGR24->width,
@@ -389,6 +424,10 @@ bool VideoReader::postProcess(cv::Mat& frame) {
         return false;
     }
 
+    // RGA jobs run asynchronously, the conversion and rotation are timed
+    // together
+    _stageTimes.convertNs = lap(last);
+
 #else
     // If hardware acceleration is enabled, it is necessary to copy the data
     // from device to memory
@@ -407,6 +446,8 @@ bool VideoReader::postProcess(cv::Mat& frame) {
     } else {
         avFrameSrc = _avFrameRaw;
     }
+    _stageTimes.transferNs = lap(last);
+
     // Get cached SwsContext object (do not free the object afterwards)
     _swsContext =
         sws_getCachedContext(_swsContext,
@@ -426,14 +467,20 @@ bool VideoReader::postProcess(cv::Mat& frame) {
         return false;
     }
 
+    // Convert directly into a preallocated output frame when no rotation is
+    // needed, otherwise into the BGR24 buffer
+    bool isDirect = _rotateFlag == -1 && isPreallocated(frame);
+    std::array<uint8_t*, 4> dstData = {frame.data, nullptr, nullptr, nullptr};
+    std::array<int, 4> dstLinesize = {static_cast<int>(frame.step), 0, 0, 0};
+
     // Convert color space & resize
     err = sws_scale(_swsContext,
                     avFrameSrc->data,
                     avFrameSrc->linesize,
                     0,
                     _heightRaw,
-                    _avFrameBGR24->data,
-                    _avFrameBGR24->linesize);
+                    isDirect ? dstData.data() : _avFrameBGR24->data,
+                    isDirect ? dstLinesize.data() : _avFrameBGR24->linesize);
 
     if (err < 0) {
         av_log(nullptr,
@@ -442,6 +489,7 @@ bool VideoReader::postProcess(cv::Mat& frame) {
                err);
         return false;
     }
+    _stageTimes.convertNs = lap(last);
 
     if (_rotateFlag != -1) {
         // Allocate frame if size or type is not matched
@@ -459,7 +507,8 @@ bool VideoReader::postProcess(cv::Mat& frame) {
 
         // Rotate the temp frame to output frame
         cv::rotate(temp, frame, _rotateFlag);
-    } else {
+        _stageTimes.rotateNs = lap(last);
+    } else if (!isDirect) {
         // Wrap the BGR24 buffer to output cv::Mat
         frame = cv::Mat(_avFrameBGR24->height,
                         _avFrameBGR24->width,
@@ -472,12 +521,73 @@ bool VideoReader::postProcess(cv::Mat& frame) {
     return true;
 }
 
+bool VideoReader::setResize(cv::Size resize) {
+    if (!_isOpened) {
+        return false;
+    }
+
+    return allocateOutputBuffer(resize);
+}
+
+bool VideoReader::allocateOutputBuffer(cv::Size resize) {
+    int err;
+
+    // Set output size
+    if (!resize.empty()) {
+        _height = resize.height;
+        _width = resize.width;
+    } else if (_rotateFlag == cv::RotateFlags::ROTATE_90_CLOCKWISE ||
+               _rotateFlag == cv::RotateFlags::ROTATE_90_COUNTERCLOCKWISE) {
+        _height = _widthRaw;
+        _width = _heightRaw;
+    } else {
+        _height = _heightRaw;
+        _width = _widthRaw;
+    }
+
+    // Allocate BGR24 frame buffer for intermediate processing
+    av_freep(&_avFrameBGR24->data[0]);
+
+    if (_rotateFlag == -1 || _rotateFlag == cv::RotateFlags::ROTATE_180) {
+        _avFrameBGR24->height = _height;
+        _avFrameBGR24->width = _width;
+    } else if (_rotateFlag == cv::RotateFlags::ROTATE_90_CLOCKWISE ||
+               _rotateFlag == cv::RotateFlags::ROTATE_90_COUNTERCLOCKWISE) {
+        _avFrameBGR24->height = _width;
+        _avFrameBGR24->width = _height;
+    }
+
+    err = av_image_alloc(_avFrameBGR24->data,
+                         _avFrameBGR24->linesize,
+                         _avFrameBGR24->width,
+                         _avFrameBGR24->height,
+                         AVPixelFormat::AV_PIX_FMT_BGR24,
+                         16);
+
+    if (err < 0) {
+        av_log(nullptr,
+               AV_LOG_ERROR,
+               "Failed to allocate BGR24 frame buffer, error: %d\n",
+               err);
+        _outputBufferSize.store(0, std::memory_order_relaxed);
+        return false;
+    }
+
+    // Size of the allocated buffer
+    _outputBufferSize.store(static_cast<size_t>(err),
+                            std::memory_order_relaxed);
+    return true;
+}
+
 void VideoReader::close() {
     avformat_network_deinit();
 
     av_packet_free(&_avPacket);
     av_frame_free(&_avFrameRaw);
     av_frame_free(&_avFrameSw);
+    if (_avFrameBGR24 != nullptr) {
+        av_freep(&_avFrameBGR24->data[0]);
+    }
     av_frame_free(&_avFrameBGR24);
 
     av_dict_free(&_avFormatOptions);
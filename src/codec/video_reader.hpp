@@ -1,5 +1,8 @@
 #pragma once
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <opencv2/core.hpp>
 
 extern "C" {
@@ -47,6 +50,16 @@ struct VideoReaderParams {
      * @brief Resize (output size)
      */
     cv::Size resize = {0, 0};
+
+    /**
+     * @brief Number of decoding threads (0: number of CPUs)
+     */
+    int decoderThreads = 0;
+
+    /**
+     * @brief Decoder threading method (FF_THREAD_FRAME / FF_THREAD_SLICE)
+     */
+    int decoderThreadType = FF_THREAD_FRAME;
 };
 
 /**
@@ -54,6 +67,21 @@ struct VideoReaderParams {
  */
 class VideoReader {
   public:
+#pragma region Public types
+
+    /**
+     * @brief Time spent in each step of a read (ns)
+     */
+    struct StageTimes {
+        uint64_t demuxNs = 0;    // Reading packets from the container
+        uint64_t decodeNs = 0;   // Sending packets and receiving frames
+        uint64_t transferNs = 0; // Copying frames from device to memory
+        uint64_t convertNs = 0;  // Color conversion and resize
+        uint64_t rotateNs = 0;
+    };
+
+#pragma endregion
+
 #pragma region Public member methods
     /**
      * @brief Construct a new VideoReader object that reads remote RTSP stream
@@ -84,7 +112,9 @@ class VideoReader {
     ~VideoReader();
 
     /**
-     * @brief Read a frame
+     * @brief Read a frame. If frame is preallocated with the output size
+     * (CV_8UC3), the frame is written into it; otherwise frame is set to wrap
+     * an internal buffer that is overwritten by the next read.
      *
      * @param frame Output frame
      * @return true Read successfully
@@ -123,6 +153,30 @@ class VideoReader {
 
     int getFrameCount() const { return _frameCount; }
 
+    const StageTimes& getLastStageTimes() const { return _stageTimes; }
+
+    /**
+     * @brief Change the output size of following reads, must be called from
+     * the reading thread
+     *
+     * @param resize Output size ({0, 0}: original size)
+     * @return  True: output buffer reallocated
+     *          False: not opened or allocation failed
+     */
+    bool setResize(cv::Size resize);
+
+    /**
+     * @brief Get an estimate of the memory held for reading: the receive
+     * buffer, decoded frames in flight and the output buffer. May be called
+     * from any thread.
+     *
+     * @return  Size (bytes)
+     */
+    size_t getMemoryUsage() const {
+        return _receiveBufferSize + _decodedFramesSize +
+               _outputBufferSize.load(std::memory_order_relaxed);
+    }
+
 #pragma endregion
 
   private:
@@ -167,6 +221,13 @@ class VideoReader {
     int _streamIndex;
     int _rotateFlag;
 
+    /* Memory estimate */
+    size_t _receiveBufferSize;
+    size_t _decodedFramesSize;
+    std::atomic<size_t> _outputBufferSize;
+
+    StageTimes _stageTimes;
+
 #pragma endregion
 
 #pragma region Private member methods
@@ -194,5 +255,26 @@ class VideoReader {
      */
     bool postProcess(cv::Mat& frame);
 
+    /**
+     * @brief Set output size and (re)allocate the BGR24 frame buffer
+     *
+     * @param resize Output size ({0, 0}: original size)
+     * @return  True: allocated successfully
+     */
+    bool allocateOutputBuffer(cv::Size resize);
+
+    /**
+     * @brief Tells whether the output frame is preallocated by the caller
+     * with the output size and type
+     *
+     * @param frame Output frame
+     * @return  True: frame can be written in place
+     *          False: frame has to be (re)assigned
+     */
+    bool isPreallocated(const cv::Mat& frame) const {
+        return frame.rows == _height && frame.cols == _width &&
+               frame.type() == CV_8UC3;
+    }
+
 #pragma endregion
 };
\ No newline at end of file
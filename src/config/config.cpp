@@ -0,0 +1,289 @@
+/**
+ * @file config.cpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Implementation of pipeline config loading and hot reload
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "config.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <opencv2/core.hpp>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <utility>
+
+namespace {
+
+/**
+ * @brief Read a numeric value of a section if the key is present
+ *
+ * @param section Section node
+ * @param key Key in the section
+ * @param value Output value, untouched if the key is absent
+ * @return
+ */
+template <typename T>
+void readIfPresent(const cv::FileNode& section, const char* key, T& value) {
+    if (!section.isMap()) {
+        return;
+    }
+
+    auto node = section[key];
+    if (node.empty() || node.isNone()) {
+        return;
+    }
+
+    if (!node.isInt() && !node.isReal()) {
+        throw std::invalid_argument(std::string("Config: '") +
+                                    section.name() + "." + key +
+                                    "' is not a number");
+    }
+
+    node >> value;
+}
+
+/**
+ * @brief Throw if a value is out of range
+ *
+ * @param isValid Result of the range check
+ * @param name Name of the value
+ * @return
+ */
+void require(bool isValid, const char* name) {
+    if (!isValid) {
+        throw std::invalid_argument(std::string("Config: '") + name +
+                                    "' is out of range");
+    }
+}
+
+/**
+ * @brief Get modification time and size of a file
+ *
+ * @param path File path
+ * @param mtime Output modification time
+ * @param size Output size (-1: file not found)
+ * @return
+ */
+void statFile(const std::string& path, timespec& mtime, int64_t& size) {
+    struct stat st {};
+    if (::stat(path.c_str(), &st) != 0) {
+        mtime = timespec{};
+        size = -1;
+        return;
+    }
+
+#if defined(__APPLE__)
+    mtime = st.st_mtimespec;
+#else
+    mtime = st.st_mtim;
+#endif
+    size = static_cast<int64_t>(st.st_size);
+}
+
+} // namespace
+
+PipelineConfig PipelineConfig::load(const std::string& path,
+                                    const PipelineConfig& base) {
+    auto config = base;
+
+    try {
+        auto fs = cv::FileStorage(path, cv::FileStorage::READ);
+        if (!fs.isOpened()) {
+            throw std::invalid_argument("Config: cannot open '" + path + "'");
+        }
+
+        auto vibe = fs["vibe"];
+        readIfPresent(vibe, "num_samples", config.vibe.numSamples);
+        readIfPresent(vibe, "threshold_l1", config.vibe.thresholdL1);
+        readIfPresent(
+            vibe, "min_num_close_samples", config.vibe.minNumCloseSamples);
+        readIfPresent(vibe, "update_factor", config.vibe.updateFactor);
+
+        auto sigmaDelta = fs["sigma_delta"];
+        readIfPresent(
+            sigmaDelta, "amplification", config.sigmaDelta.amplification);
+        readIfPresent(
+            sigmaDelta, "min_variance", config.sigmaDelta.minVariance);
+        readIfPresent(
+            sigmaDelta, "max_variance", config.sigmaDelta.maxVariance);
+        readIfPresent(sigmaDelta,
+                      "difference_threshold",
+                      config.sigmaDelta.differenceThreshold);
+        readIfPresent(
+            sigmaDelta, "update_period", config.sigmaDelta.updatePeriod);
+
+        auto tracker = fs["tracker"];
+        readIfPresent(tracker, "max_bbox_age", config.tracker.maxBBoxAge);
+        readIfPresent(
+            tracker, "min_bbox_hit_streak", config.tracker.minBBoxHitStreak);
+        readIfPresent(
+            tracker, "max_trajectory_age", config.tracker.maxTrajectoryAge);
+        readIfPresent(tracker,
+                      "min_trajectory_num_samples",
+                      config.tracker.minTrajectoryNumSamples);
+        readIfPresent(tracker,
+                      "min_trajectory_falling_distance",
+                      config.tracker.minTrajectoryFallingDistance);
+        readIfPresent(tracker, "iou_threshold", config.tracker.iouThreshold);
+
+        auto blob = fs["blob"];
+        readIfPresent(blob, "max_num_blobs", config.blob.maxNumBlobs);
+        readIfPresent(blob, "bbox_margin", config.blob.bboxMargin);
+
+        readIfPresent(fs["analysis"], "scale", config.analysis.scale);
+    } catch (const cv::Exception& e) {
+        throw std::invalid_argument("Config: cannot parse '" + path +
+                                    "': " + e.msg);
+    }
+
+    config.validate();
+    return config;
+}
+
+void PipelineConfig::validate() const {
+    require(vibe.numSamples >= 2 && vibe.numSamples <= 64, "vibe.num_samples");
+    require(vibe.thresholdL1 >= 0 && vibe.thresholdL1 <= 255,
+            "vibe.threshold_l1");
+    require(vibe.minNumCloseSamples >= 1 &&
+                vibe.minNumCloseSamples <= vibe.numSamples,
+            "vibe.min_num_close_samples");
+    require(vibe.updateFactor >= 1 && vibe.updateFactor <= 256,
+            "vibe.update_factor");
+
+    require(sigmaDelta.amplification >= 1 && sigmaDelta.amplification <= 16,
+            "sigma_delta.amplification");
+    require(sigmaDelta.minVariance >= 1 && sigmaDelta.minVariance <= 127,
+            "sigma_delta.min_variance");
+    require(sigmaDelta.maxVariance >= sigmaDelta.minVariance &&
+                sigmaDelta.maxVariance <= 127,
+            "sigma_delta.max_variance");
+    require(sigmaDelta.differenceThreshold >= 0 &&
+                sigmaDelta.differenceThreshold <= 255,
+            "sigma_delta.difference_threshold");
+    require(sigmaDelta.updatePeriod >= 1 && sigmaDelta.updatePeriod <= 256,
+            "sigma_delta.update_period");
+
+    require(tracker.maxBBoxAge >= 1, "tracker.max_bbox_age");
+    require(tracker.minBBoxHitStreak >= 1, "tracker.min_bbox_hit_streak");
+    require(tracker.maxTrajectoryAge >= 1, "tracker.max_trajectory_age");
+    require(tracker.minTrajectoryNumSamples >= 3,
+            "tracker.min_trajectory_num_samples");
+    require(tracker.minTrajectoryFallingDistance >= 0.0F,
+            "tracker.min_trajectory_falling_distance");
+    require(tracker.iouThreshold > 0.0F && tracker.iouThreshold <= 1.0F,
+            "tracker.iou_threshold");
+
+    require(blob.maxNumBlobs >= 1, "blob.max_num_blobs");
+    require(blob.bboxMargin >= 0, "blob.bbox_margin");
+
+    require(analysis.scale > 0.0F && analysis.scale <= 1.0F,
+            "analysis.scale");
+}
+
+ConfigWatcher::ConfigWatcher(std::string path,
+                             const PipelineConfig& config,
+                             const ConfigWatcherParams& params)
+    : _path(std::move(path)),
+      _params(params),
+      _pending(config),
+      _hasUpdate(false),
+      _numReloads(0),
+      _numFailures(0),
+      _isRunning(false) {
+
+    // The current file is already in effect
+    statFile(_path, _mtime, _size);
+}
+
+ConfigWatcher::~ConfigWatcher() { stop(); }
+
+void ConfigWatcher::start() {
+    if (_isRunning.exchange(true)) {
+        return;
+    }
+
+    _thread = std::thread(&ConfigWatcher::run, this);
+}
+
+void ConfigWatcher::stop() {
+    if (!_isRunning.exchange(false)) {
+        return;
+    }
+
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+}
+
+bool ConfigWatcher::consume(PipelineConfig& config) {
+    if (!_hasUpdate.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    auto lock = std::lock_guard(_mutex);
+    config = _pending;
+    _hasUpdate.store(false, std::memory_order_relaxed);
+    return true;
+}
+
+void ConfigWatcher::run() {
+    using namespace std::chrono_literals;
+    auto interval = std::chrono::milliseconds(_params.pollIntervalMs);
+    auto nextPoll = std::chrono::steady_clock::now() + interval;
+
+    while (_isRunning.load()) {
+        std::this_thread::sleep_for(100ms);
+        if (std::chrono::steady_clock::now() < nextPoll) {
+            continue;
+        }
+
+        poll();
+        nextPoll += interval;
+    }
+}
+
+void ConfigWatcher::poll() {
+    timespec mtime{};
+    int64_t size = 0;
+    statFile(_path, mtime, size);
+
+    if (size == _size && mtime.tv_sec == _mtime.tv_sec &&
+        mtime.tv_nsec == _mtime.tv_nsec) {
+        return;
+    }
+
+    _mtime = mtime;
+    _size = size;
+
+    // Removed file, keep the current config
+    if (size < 0) {
+        return;
+    }
+
+    PipelineConfig base;
+    {
+        auto lock = std::lock_guard(_mutex);
+        base = _pending;
+    }
+
+    try {
+        auto config = PipelineConfig::load(_path, base);
+
+        auto lock = std::lock_guard(_mutex);
+        _pending = config;
+        _hasUpdate.store(true, std::memory_order_release);
+        _numReloads++;
+        std::printf("[CONFIG] Reloaded %s\n", _path.c_str());
+    } catch (const std::invalid_argument& e) {
+        // A file caught half-way through a write is picked up again on its
+        // next modification
+        _numFailures++;
+        std::printf("[CONFIG] %s, keeping the current config\n", e.what());
+    }
+}
@@ -1 +1,240 @@
-#pragma once
\ No newline at end of file
+/**
+ * @file config.hpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Tuning parameters of the analysis pipeline and their hot reload
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/**
+ * @brief Tuning parameters of the analysis pipeline, read from a YAML / JSON
+ *        file (cv::FileStorage). Keys that are absent keep their value.
+ *
+ *        vibe:     num_samples, threshold_l1, min_num_close_samples,
+ *                  update_factor
+ *        sigma_delta: amplification, min_variance, max_variance,
+ *                  difference_threshold, update_period
+ *        tracker:  max_bbox_age, min_bbox_hit_streak, max_trajectory_age,
+ *                  min_trajectory_num_samples,
+ *                  min_trajectory_falling_distance, iou_threshold
+ *        blob:     max_num_blobs, bbox_margin
+ *        analysis: scale
+ */
+struct PipelineConfig {
+    /**
+     * @brief ViBe background model
+     */
+    struct ViBe {
+        int numSamples = 14;
+        int thresholdL1 = 20;
+        int minNumCloseSamples = 2;
+        int updateFactor = 5;
+    };
+
+    /**
+     * @brief Sigma-delta background model (gray levels)
+     */
+    struct SigmaDelta {
+        int amplification = 4;
+        int minVariance = 12;
+        int maxVariance = 96;
+        int differenceThreshold = 12;
+        int updatePeriod = 2;
+    };
+
+    /**
+     * @brief SORT tracker
+     */
+    struct Tracker {
+        int maxBBoxAge = 3;
+        int minBBoxHitStreak = 3;
+        int maxTrajectoryAge = 15;
+        int minTrajectoryNumSamples = 16;
+        float minTrajectoryFallingDistance = 128.0F;
+        float iouThreshold = 0.25F;
+    };
+
+    /**
+     * @brief Foreground blob detector
+     */
+    struct Blob {
+        int maxNumBlobs = 64;
+        int bboxMargin = 6;
+    };
+
+    /**
+     * @brief Analysis input
+     */
+    struct Analysis {
+        /**
+         * @brief Analysis resolution relative to the decoded size, the
+         * governor scales it further
+         */
+        float scale = 1.0F;
+    };
+
+    ViBe vibe;
+    SigmaDelta sigmaDelta;
+    Tracker tracker;
+    Blob blob;
+    Analysis analysis;
+
+    /**
+     * @brief Read a config file over a base config
+     *
+     * @param path Path of the YAML / JSON file
+     * @param base Values of the keys absent from the file
+     * @return  Config
+     * @throw   std::invalid_argument on unreadable file or invalid values
+     */
+    static PipelineConfig load(const std::string& path,
+                               const PipelineConfig& base);
+
+    /**
+     * @brief Check all values are within range
+     *
+     * @return
+     * @throw   std::invalid_argument naming the first invalid value
+     */
+    void validate() const;
+
+    /**
+     * @brief Tells whether a background model built with this config can
+     * take the other one in place
+     *
+     * @param other New config
+     * @return  True: setters are enough
+     *          False: the model must be rebuilt (ViBe sample count changed)
+     */
+    bool isModelCompatible(const PipelineConfig& other) const {
+        return vibe.numSamples == other.vibe.numSamples;
+    }
+};
+
+/**
+ * @brief Additional parameters for ConfigWatcher class
+ */
+struct ConfigWatcherParams {
+    /**
+     * @brief Interval between two checks of the file modification time (ms)
+     */
+    int pollIntervalMs = 1000;
+};
+
+/**
+ * @brief Watches a config file on a background thread. A changed file is
+ *        parsed and validated off the analysis thread, then handed over as a
+ *        whole: the analysis thread takes it between two frames, so a frame
+ *        never sees half of an update. Invalid files are reported and the
+ *        last good config stays in effect.
+ */
+class ConfigWatcher final {
+  public:
+#pragma region Public member methods
+
+    /**
+     * @brief Construct a new ConfigWatcher object
+     *
+     * @param path Path of the config file
+     * @param config Config in effect, reloads are read over it
+     * @param params Additional parameters
+     */
+    ConfigWatcher(std::string path,
+                  const PipelineConfig& config,
+                  const ConfigWatcherParams& params = ConfigWatcherParams());
+
+    ConfigWatcher(const ConfigWatcher&) = delete;
+
+    ConfigWatcher& operator=(const ConfigWatcher&) = delete;
+
+    /**
+     * @brief Stop watching and join the background thread
+     */
+    ~ConfigWatcher();
+
+    /**
+     * @brief Start watching
+     *
+     * @return
+     */
+    void start();
+
+    /**
+     * @brief Stop watching
+     *
+     * @return
+     */
+    void stop();
+
+    /**
+     * @brief Take the reloaded config if there is one, cheap enough to call
+     * once per frame
+     *
+     * @param config Output config, untouched if there is no update
+     * @return  True: config was updated
+     *          False: no update
+     */
+    bool consume(PipelineConfig& config);
+
+    uint64_t getNumReloads() const { return _numReloads.load(); }
+
+    uint64_t getNumFailures() const { return _numFailures.load(); }
+
+#pragma endregion
+
+  private:
+#pragma region Private member variables
+
+    std::string _path;
+    ConfigWatcherParams _params;
+
+    /**
+     * @brief Last successfully loaded config, guarded by _mutex
+     */
+    PipelineConfig _pending;
+    std::mutex _mutex;
+    std::atomic<bool> _hasUpdate;
+
+    /**
+     * @brief Modification time and size of the file when last checked
+     */
+    timespec _mtime;
+    int64_t _size;
+
+    std::atomic<uint64_t> _numReloads;
+    std::atomic<uint64_t> _numFailures;
+
+    std::atomic<bool> _isRunning;
+    std::thread _thread;
+
+#pragma endregion
+
+#pragma region Private member methods
+
+    /**
+     * @brief Background thread body
+     *
+     * @return
+     */
+    void run();
+
+    /**
+     * @brief Check the file and reload it if it has changed
+     *
+     * @return
+     */
+    void poll();
+
+#pragma endregion
+};
@@ -0,0 +1,176 @@
+/**
+ * @file active_tiles.cpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Implementation of foreground tiles and post-processing windows
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "active_tiles.hpp"
+
+#include "trace.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+/**
+ * @brief Alignment (pixels) of the left edge of windows
+ */
+constexpr int WINDOW_ALIGNMENT = 16;
+
+/**
+ * @brief Tells whether two windows overlap or touch (8-connectivity)
+ *
+ * @param a Window
+ * @param b Window
+ * @return  True: overlapping or touching
+ */
+bool isAdjacent(const cv::Rect& a, const cv::Rect& b) {
+    return a.x <= b.x + b.width && b.x <= a.x + a.width &&
+           a.y <= b.y + b.height && b.y <= a.y + a.height;
+}
+
+/**
+ * @brief Tells whether a span of a mask row holds any foreground
+ *
+ * @param row Mask row
+ * @param begin First column
+ * @param end Column past the last one
+ * @return  True: any foreground
+ */
+bool hasForeground(const uint8_t* row, int begin, int end) {
+    int x = begin;
+    for (; x + 8 <= end; x += 8) {
+        uint64_t word;
+        std::memcpy(&word, row + x, sizeof(word));
+        if (word != 0) {
+            return true;
+        }
+    }
+    for (; x < end; x++) {
+        if (row[x] != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+ActiveTiles::ActiveTiles(int height,
+                         int width,
+                         const ActiveTilesParams& params)
+    : _h(height),
+      _w(width),
+      _params(params),
+      _numTileRows((height + params.tileSize - 1) / params.tileSize),
+      _numTileCols((width + params.tileSize - 1) / params.tileSize),
+      _numActiveTiles(0) {
+    _isActive.resize(_numTileRows * _numTileCols);
+    _windows.reserve(_numTileRows * _numTileCols);
+}
+
+bool ActiveTiles::build(const cv::Mat& fgMask) {
+    TRACE_SCOPE("ActiveTiles::build");
+
+    CV_Assert(fgMask.type() == CV_8UC1);
+    CV_Assert(fgMask.rows == _h && fgMask.cols == _w);
+
+    std::fill(_isActive.begin(), _isActive.end(), 0);
+    _windows.clear();
+
+    _numActiveTiles = 0;
+    for (int r = 0; r < _numTileRows; r++) {
+        _numActiveTiles += markTileRow(fgMask, r);
+    }
+
+    if (_numActiveTiles > _params.maxActiveFraction * getNumTiles()) {
+        return false;
+    }
+
+    makeWindows();
+    return true;
+}
+
+int ActiveTiles::markTileRow(const cv::Mat& fgMask, int tileRow) {
+    int size = _params.tileSize;
+    int yEnd = std::min(_h, (tileRow + 1) * size);
+    auto* isActive = _isActive.data() + tileRow * _numTileCols;
+
+    // Tiles found active are not scanned again
+    int numMarked = 0;
+    for (int y = tileRow * size; y < yEnd && numMarked < _numTileCols; y++) {
+        const auto* row = fgMask.ptr<uint8_t>(y);
+        for (int c = 0; c < _numTileCols; c++) {
+            if (isActive[c] == 0 &&
+                hasForeground(row, c * size, std::min(_w, (c + 1) * size))) {
+                isActive[c] = 1;
+                numMarked++;
+            }
+        }
+    }
+
+    return numMarked;
+}
+
+void ActiveTiles::makeWindows() {
+    int size = _params.tileSize;
+    int halo = _params.halo;
+    auto frame = cv::Rect(0, 0, _w, _h);
+
+    // Runs of active tiles in each tile row, then merged across rows
+    for (int r = 0; r < _numTileRows; r++) {
+        const auto* isActive = _isActive.data() + r * _numTileCols;
+        int c = 0;
+        while (c < _numTileCols) {
+            if (isActive[c] == 0) {
+                c++;
+                continue;
+            }
+
+            int cBegin = c;
+            while (c < _numTileCols && isActive[c] != 0) {
+                c++;
+            }
+
+            int x0 = alignLeft(cBegin * size - halo);
+            int y0 = r * size - halo;
+            int x1 = c * size + halo;
+            int y1 = (r + 1) * size + halo;
+            _windows.push_back(cv::Rect(x0, y0, x1 - x0, y1 - y0) & frame);
+        }
+    }
+
+    mergeWindows(_windows);
+}
+
+void ActiveTiles::mergeWindows(std::vector<cv::Rect>& windows) {
+    // A grown window may touch windows already passed, hence the passes
+    bool isMerged = true;
+    while (isMerged) {
+        isMerged = false;
+        for (size_t i = 0; i < windows.size(); i++) {
+            size_t j = i + 1;
+            while (j < windows.size()) {
+                if (isAdjacent(windows[i], windows[j])) {
+                    windows[i] |= windows[j];
+                    windows[j] = windows.back();
+                    windows.pop_back();
+                    isMerged = true;
+                    j = i + 1;
+                } else {
+                    j++;
+                }
+            }
+        }
+    }
+}
+
+int ActiveTiles::alignLeft(int x) {
+    return x - ((x % WINDOW_ALIGNMENT) + WINDOW_ALIGNMENT) % WINDOW_ALIGNMENT;
+}
@@ -0,0 +1,139 @@
+/**
+ * @file active_tiles.hpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Tiles of a foreground mask that hold foreground
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+
+#include <cstdint>
+#include <opencv2/core.hpp>
+#include <vector>
+
+/**
+ * @brief Additional parameters for ActiveTiles class
+ */
+struct ActiveTilesParams {
+    /**
+     * @brief Side (pixels) of square tiles
+     */
+    int tileSize = 32;
+
+    /**
+     * @brief Margin (pixels) around active tiles, must cover the reach of
+     * the post-processing morphology (open 3x3 then close 5x5: 5 pixels)
+     */
+    int halo = 8;
+
+    /**
+     * @brief Max fraction of active tiles, a denser mask is post-processed
+     * in full
+     */
+    double maxActiveFraction = 0.5;
+};
+
+/**
+ * @brief Finds the tiles of a segmented foreground mask that hold any
+ *        foreground, and turns them into windows for post-processing.
+ *        Windows are the active tiles plus a halo, left edges aligned to 16
+ *        pixels, merged until disjoint and not touching, so morphology and
+ *        labelling in the windows give the same blobs as on the whole mask
+ *        while skipping its empty parts. An empty mask has no windows.
+ */
+class ActiveTiles final {
+  public:
+#pragma region Public member methods
+
+    /**
+     * @brief Construct a new ActiveTiles object
+     *
+     * @param height Frame height
+     * @param width Frame width
+     * @param params Additional parameters
+     */
+    ActiveTiles(int height,
+                int width,
+                const ActiveTilesParams& params = ActiveTilesParams());
+
+    /**
+     * @brief Find the active tiles of a foreground mask
+     *
+     * @param fgMask Segmented foreground mask (CV_8UC1)
+     * @return  True: foreground is sparse, post-process getWindows() only
+     *          False: post-process the whole mask
+     */
+    bool build(const cv::Mat& fgMask);
+
+    /**
+     * @brief Get the windows around the active tiles of the last mask
+     *
+     * @return  Disjoint windows inside the frame, empty when the mask is
+     * empty or dense
+     */
+    const std::vector<cv::Rect>& getWindows() const { return _windows; }
+
+    int getNumActiveTiles() const { return _numActiveTiles; }
+
+    int getNumTiles() const { return _numTileRows * _numTileCols; }
+
+#pragma endregion
+
+#pragma region Static methods
+
+    /**
+     * @brief Merge windows until no two of them overlap or touch
+     *
+     * @param windows Windows, merged in place
+     * @return
+     */
+    static void mergeWindows(std::vector<cv::Rect>& windows);
+
+    /**
+     * @brief Align the left edge of a window down for vector loops
+     *
+     * @param x Left edge
+     * @return  Aligned left edge (may be negative, clip afterwards)
+     */
+    static int alignLeft(int x);
+
+#pragma endregion
+
+  private:
+#pragma region Private member variables
+
+    int _h;
+    int _w;
+    ActiveTilesParams _params;
+    int _numTileRows;
+    int _numTileCols;
+
+    std::vector<uint8_t> _isActive;
+    std::vector<cv::Rect> _windows;
+    int _numActiveTiles;
+
+#pragma endregion
+
+#pragma region Private member methods
+
+    /**
+     * @brief Mark the tiles of one tile row holding foreground
+     *
+     * @param fgMask Foreground mask
+     * @param tileRow Tile row
+     * @return  Number of tiles marked
+     */
+    int markTileRow(const cv::Mat& fgMask, int tileRow);
+
+    /**
+     * @brief Build windows of the marked tiles
+     *
+     * @return
+     */
+    void makeWindows();
+
+#pragma endregion
+};
@@ -0,0 +1,119 @@
+/**
+ * @file binary_morphology.cpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Allocation-free morphology for 8-bit masks with symmetric structuring
+ * elements
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "binary_morphology.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <opencv2/core.hpp>
+
+BinaryMorphology::Kernel
+BinaryMorphology::Kernel::fromStructuringElement(const cv::Mat& element) {
+    CV_Assert(element.type() == CV_8UC1);
+    CV_Assert(element.rows % 2 == 1 && element.cols % 2 == 1);
+    CV_Assert(element.rows <= 15 && element.cols <= 15);
+
+    auto kernel = Kernel{};
+    kernel.radius = element.rows / 2;
+    kernel.halfWidths.fill(-1);
+
+    int xCenter = element.cols / 2;
+    for (int i = 0; i < element.rows; i++) {
+        const auto* row = element.ptr<uint8_t>(i);
+
+        int halfWidth = -1;
+        while (halfWidth + 1 <= xCenter && row[xCenter - halfWidth - 1] != 0 &&
+               row[xCenter + halfWidth + 1] != 0) {
+            halfWidth++;
+        }
+
+        // Every row must be a single span centered on the anchor
+        for (int j = 0; j < element.cols; j++) {
+            bool isInSpan = std::abs(j - xCenter) <= halfWidth;
+            CV_Assert((row[j] != 0) == isInSpan);
+        }
+
+        kernel.halfWidths[i] = halfWidth;
+    }
+
+    return kernel;
+}
+
+template <bool IsErode>
+void BinaryMorphology::filter(const cv::Mat& src,
+                              cv::Mat& dst,
+                              const Kernel& kernel) {
+    CV_Assert(src.type() == CV_8UC1 && dst.type() == CV_8UC1);
+    CV_Assert(src.size() == dst.size());
+    CV_Assert(src.data != dst.data);
+
+    int h = src.rows;
+    int w = src.cols;
+    uint8_t identity = IsErode ? 255 : 0;
+
+    for (int y = 0; y < h; y++) {
+        auto* out = dst.ptr<uint8_t>(y);
+        std::memset(out, identity, w);
+
+        for (int dy = -kernel.radius; dy <= kernel.radius; dy++) {
+            int halfWidth = kernel.halfWidths[dy + kernel.radius];
+            int yy = y + dy;
+            if (halfWidth < 0 || yy < 0 || yy >= h) {
+                continue;
+            }
+
+            const auto* in = src.ptr<uint8_t>(yy);
+            for (int dx = -halfWidth; dx <= halfWidth; dx++) {
+                int xBegin = std::max(0, -dx);
+                int xEnd = std::min(w, w - dx);
+                const auto* shifted = in + dx;
+
+                for (int x = xBegin; x < xEnd; x++) {
+                    if constexpr (IsErode) {
+                        out[x] = std::min(out[x], shifted[x]);
+                    } else {
+                        out[x] = std::max(out[x], shifted[x]);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void BinaryMorphology::erode(const cv::Mat& src,
+                             cv::Mat& dst,
+                             const Kernel& kernel) {
+    filter<true>(src, dst, kernel);
+}
+
+void BinaryMorphology::dilate(const cv::Mat& src,
+                              cv::Mat& dst,
+                              const Kernel& kernel) {
+    filter<false>(src, dst, kernel);
+}
+
+void BinaryMorphology::open(const cv::Mat& src,
+                            cv::Mat& dst,
+                            cv::Mat& temp,
+                            const Kernel& kernel) {
+    erode(src, temp, kernel);
+    dilate(temp, dst, kernel);
+}
+
+void BinaryMorphology::close(const cv::Mat& src,
+                             cv::Mat& dst,
+                             cv::Mat& temp,
+                             const Kernel& kernel) {
+    dilate(src, temp, kernel);
+    erode(temp, dst, kernel);
+}
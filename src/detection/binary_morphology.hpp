@@ -0,0 +1,118 @@
+/**
+ * @file binary_morphology.hpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Allocation-free morphology for 8-bit masks with symmetric structuring
+ * elements
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+
+#include <array>
+#include <opencv2/core.hpp>
+
+/**
+ * @brief Morphological filtering on CV_8UC1 masks.
+ *        The structuring element is described by one centered horizontal span
+ *        per row (this covers MORPH_RECT, MORPH_CROSS and MORPH_ELLIPSE), so
+ *        the filter is a plain min/max over contiguous row segments which the
+ *        compiler vectorizes. Pixels outside the image are ignored, which
+ *        matches the default border of cv::erode/cv::dilate.
+ */
+class BinaryMorphology final {
+  public:
+#pragma region Public types
+
+    /**
+     * @brief Structuring element as row spans
+     */
+    struct Kernel {
+        /**
+         * @brief Vertical radius (the kernel has 2 * radius + 1 rows)
+         */
+        int radius;
+
+        /**
+         * @brief Half width of the span of each row (-1: empty row)
+         */
+        std::array<int, 2 * 7 + 1> halfWidths;
+
+        /**
+         * @brief Convert a structuring element from
+         * cv::getStructuringElement()
+         *
+         * @param element Structuring element (odd size, centered anchor,
+         * up to 15 x 15)
+         * @return  Kernel
+         */
+        static Kernel fromStructuringElement(const cv::Mat& element);
+    };
+
+#pragma endregion
+
+#pragma region Static methods
+
+    /**
+     * @brief Erode src into dst (dst must not alias src)
+     *
+     * @param src Input mask (CV_8UC1)
+     * @param dst Output mask (CV_8UC1, same size as src)
+     * @param kernel Structuring element
+     * @return
+     */
+    static void erode(const cv::Mat& src, cv::Mat& dst, const Kernel& kernel);
+
+    /**
+     * @brief Dilate src into dst (dst must not alias src)
+     *
+     * @param src Input mask (CV_8UC1)
+     * @param dst Output mask (CV_8UC1, same size as src)
+     * @param kernel Structuring element
+     * @return
+     */
+    static void dilate(const cv::Mat& src, cv::Mat& dst, const Kernel& kernel);
+
+    /**
+     * @brief Opening (erode then dilate), dst may alias src
+     *
+     * @param src Input mask (CV_8UC1)
+     * @param dst Output mask (CV_8UC1, same size as src)
+     * @param temp Temporary buffer (CV_8UC1, same size as src)
+     * @param kernel Structuring element
+     * @return
+     */
+    static void open(const cv::Mat& src,
+                     cv::Mat& dst,
+                     cv::Mat& temp,
+                     const Kernel& kernel);
+
+    /**
+     * @brief Closing (dilate then erode), dst may alias src
+     *
+     * @param src Input mask (CV_8UC1)
+     * @param dst Output mask (CV_8UC1, same size as src)
+     * @param temp Temporary buffer (CV_8UC1, same size as src)
+     * @param kernel Structuring element
+     * @return
+     */
+    static void close(const cv::Mat& src,
+                      cv::Mat& dst,
+                      cv::Mat& temp,
+                      const Kernel& kernel);
+
+#pragma endregion
+
+  private:
+#pragma region Static helper methods
+
+    /**
+     * @brief Shared implementation of erosion (IsErode = true) and dilation
+     */
+    template <bool IsErode>
+    static void filter(const cv::Mat& src, cv::Mat& dst, const Kernel& kernel);
+
+#pragma endregion
+};
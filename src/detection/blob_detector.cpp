@@ -0,0 +1,353 @@
+/**
+ * @file blob_detector.cpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Foreground mask post-processing and blob (bbox) extraction
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "blob_detector.hpp"
+
+#include "trace.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+
+namespace {
+
+/**
+ * @brief Border of OpenCV morphology in a window: pixels outside the window
+ * are ignored, like at the frame edges and in BinaryMorphology
+ */
+constexpr int WINDOW_BORDER = cv::BORDER_CONSTANT | cv::BORDER_ISOLATED;
+
+} // namespace
+
+BlobDetector::BlobDetector(int height,
+                           int width,
+                           const BlobDetectorParams& params)
+    : _h(height),
+      _w(width),
+      _params(params) {
+
+    // Prepare structure elements for morphological filtering
+    _se3x3 = cv::getStructuringElement(cv::MORPH_ELLIPSE, {3, 3});
+    _se5x5 = cv::getStructuringElement(cv::MORPH_ELLIPSE, {5, 5});
+    _kernel3x3 = BinaryMorphology::Kernel::fromStructuringElement(_se3x3);
+    _kernel5x5 = BinaryMorphology::Kernel::fromStructuringElement(_se5x5);
+
+    // Allocate buffers
+    _temp = cv::Mat(height, width, CV_8U);
+    _blobs.reserve(params.maxNumBlobs + 1);
+
+    if (params.engine == BlobDetectorEngine::OPENCV) {
+        _labels = cv::Mat(height, width, CV_32S);
+        _stats = cv::Mat(params.maxNumBlobs + 1, 5, CV_32S);
+        _centroids = cv::Mat(params.maxNumBlobs + 1, 2, CV_64F);
+    } else {
+        _runs.resize(params.maxNumRuns);
+        _parents.resize(params.maxNumRuns);
+        _runBlobs.resize(params.maxNumRuns);
+    }
+}
+
+size_t BlobDetector::getMemoryUsage() const {
+    size_t size = 0;
+    for (const auto* mat : {&_temp, &_labels, &_stats, &_centroids}) {
+        size += mat->total() * mat->elemSize();
+    }
+    size += _runs.capacity() * sizeof(Run);
+    size += _parents.capacity() * sizeof(int);
+    size += (_runBlobs.capacity() + _blobs.capacity()) * sizeof(Blob);
+    return size;
+}
+
+void BlobDetector::makeUpdateMask(const cv::Mat& fgMask, cv::Mat& updateMask) {
+    TRACE_SCOPE("BlobDetector::makeUpdateMask");
+
+    if (_params.engine == BlobDetectorEngine::OPENCV) {
+        cv::morphologyEx(fgMask, updateMask, cv::MORPH_OPEN, _se3x3);
+    } else {
+        BinaryMorphology::open(fgMask, updateMask, _temp, _kernel3x3);
+    }
+}
+
+void BlobDetector::filter(cv::Mat& fgMask) {
+    TRACE_SCOPE("BlobDetector::filter");
+
+    if (_params.engine == BlobDetectorEngine::OPENCV) {
+        cv::morphologyEx(fgMask, fgMask, cv::MORPH_OPEN, _se3x3);
+        cv::morphologyEx(fgMask, fgMask, cv::MORPH_CLOSE, _se5x5);
+    } else {
+        BinaryMorphology::open(fgMask, fgMask, _temp, _kernel3x3);
+        BinaryMorphology::close(fgMask, fgMask, _temp, _kernel5x5);
+    }
+}
+
+int BlobDetector::extract(const cv::Mat& fgMask,
+                          std::vector<cv::Rect2f>& detections) {
+    TRACE_SCOPE("BlobDetector::extract");
+
+    CV_Assert(fgMask.type() == CV_8UC1);
+    CV_Assert(fgMask.rows == _h && fgMask.cols == _w);
+
+    detections.clear();
+    _blobs.clear();
+
+    int numBlobs = _params.engine == BlobDetectorEngine::OPENCV
+                       ? labelOpenCV(fgMask)
+                       : labelRuns(fgMask);
+
+    return makeDetections(numBlobs, detections);
+}
+
+void BlobDetector::makeUpdateMask(const cv::Mat& fgMask,
+                                  cv::Mat& updateMask,
+                                  const std::vector<cv::Rect>& windows) {
+    TRACE_SCOPE("BlobDetector::makeUpdateMaskWindows");
+
+    CV_Assert(updateMask.size() == fgMask.size());
+
+    for (const auto& window : windows) {
+        auto dst = updateMask(window);
+        if (_params.engine == BlobDetectorEngine::OPENCV) {
+            cv::morphologyEx(fgMask(window),
+                             dst,
+                             cv::MORPH_OPEN,
+                             _se3x3,
+                             cv::Point(-1, -1),
+                             1,
+                             WINDOW_BORDER);
+        } else {
+            auto temp = _temp(window);
+            BinaryMorphology::open(fgMask(window), dst, temp, _kernel3x3);
+        }
+    }
+}
+
+void BlobDetector::filter(cv::Mat& fgMask,
+                          const std::vector<cv::Rect>& windows) {
+    TRACE_SCOPE("BlobDetector::filterWindows");
+
+    for (const auto& window : windows) {
+        auto mask = fgMask(window);
+        if (_params.engine == BlobDetectorEngine::OPENCV) {
+            cv::morphologyEx(mask,
+                             mask,
+                             cv::MORPH_OPEN,
+                             _se3x3,
+                             cv::Point(-1, -1),
+                             1,
+                             WINDOW_BORDER);
+            cv::morphologyEx(mask,
+                             mask,
+                             cv::MORPH_CLOSE,
+                             _se5x5,
+                             cv::Point(-1, -1),
+                             1,
+                             WINDOW_BORDER);
+        } else {
+            auto temp = _temp(window);
+            BinaryMorphology::open(mask, mask, temp, _kernel3x3);
+            BinaryMorphology::close(mask, mask, temp, _kernel5x5);
+        }
+    }
+}
+
+int BlobDetector::extract(const cv::Mat& fgMask,
+                          std::vector<cv::Rect2f>& detections,
+                          const std::vector<cv::Rect>& windows) {
+    TRACE_SCOPE("BlobDetector::extractWindows");
+
+    CV_Assert(fgMask.type() == CV_8UC1);
+    CV_Assert(fgMask.rows == _h && fgMask.cols == _w);
+
+    detections.clear();
+    _blobs.clear();
+
+    int numBlobs = 0;
+    for (const auto& window : windows) {
+        size_t first = _blobs.size();
+        numBlobs += _params.engine == BlobDetectorEngine::OPENCV
+                        ? labelOpenCV(fgMask(window))
+                        : labelRuns(fgMask(window));
+        if (numBlobs > _params.maxNumBlobs) {
+            break;
+        }
+
+        // Back to frame coordinates
+        for (size_t i = first; i < _blobs.size(); i++) {
+            _blobs[i].bbox += window.tl();
+        }
+    }
+
+    return makeDetections(numBlobs, detections);
+}
+
+int BlobDetector::makeDetections(int numBlobs,
+                                 std::vector<cv::Rect2f>& detections) {
+    // Too many blobs, consider this frame invalid
+    if (numBlobs > _params.maxNumBlobs) {
+        _blobs.clear();
+        return numBlobs;
+    }
+
+    int margin = _params.bboxMargin;
+    for (const auto& blob : _blobs) {
+        const auto& bbox = blob.bbox;
+        detections.emplace_back(bbox.x - margin,
+                                bbox.y - margin,
+                                bbox.width + margin * 2,
+                                bbox.height + margin * 2);
+    }
+
+    return numBlobs;
+}
+
+int BlobDetector::labelOpenCV(const cv::Mat& fgMask) {
+    // Find all connected components (label 0 is the background), labels of
+    // a window go to the top left corner of the label buffer
+    auto labels = _labels(cv::Rect(0, 0, fgMask.cols, fgMask.rows));
+    int numLabels =
+        cv::connectedComponentsWithStats(fgMask, labels, _stats, _centroids);
+
+    int numBlobs = numLabels - 1;
+    if (numBlobs > _params.maxNumBlobs) {
+        return numBlobs;
+    }
+
+    for (int i = 1; i < numLabels; i++) {
+        const auto* stat = _stats.ptr<int>(i);
+        _blobs.push_back(Blob{
+            .bbox = {stat[cv::CC_STAT_LEFT],
+                     stat[cv::CC_STAT_TOP],
+                     stat[cv::CC_STAT_WIDTH],
+                     stat[cv::CC_STAT_HEIGHT]},
+            .area = stat[cv::CC_STAT_AREA],
+        });
+    }
+
+    return numBlobs;
+}
+
+int BlobDetector::labelRuns(const cv::Mat& fgMask) {
+    int numRuns = 0;
+    int prevBegin = 0;
+    int prevEnd = 0;
+
+    auto unite = [this](int a, int b) {
+        int rootA = findRoot(a);
+        int rootB = findRoot(b);
+        // Keep the earliest run as root, so blobs come out in raster order
+        if (rootA < rootB) {
+            _parents[rootB] = rootA;
+        } else if (rootB < rootA) {
+            _parents[rootA] = rootB;
+        }
+    };
+
+    int h = fgMask.rows;
+    int w = fgMask.cols;
+
+    for (int y = 0; y < h; y++) {
+        const auto* row = fgMask.ptr<uint8_t>(y);
+        int currBegin = numRuns;
+        int x = 0;
+
+        while (x < w) {
+            // Skip background 8 pixels at a time
+            while (x + 8 <= w) {
+                uint64_t word;
+                std::memcpy(&word, row + x, sizeof(word));
+                if (word != 0) {
+                    break;
+                }
+                x += 8;
+            }
+
+            while (x < w && row[x] == 0) {
+                x++;
+            }
+
+            if (x >= w) {
+                break;
+            }
+
+            int xBegin = x;
+            while (x < w && row[x] != 0) {
+                x++;
+            }
+
+            // Out of run capacity, the frame is far too noisy
+            if (numRuns == _params.maxNumRuns) {
+                return _params.maxNumBlobs + 1;
+            }
+
+            _runs[numRuns] = Run{.y = y, .xBegin = xBegin, .xEnd = x};
+            _parents[numRuns] = numRuns;
+            numRuns++;
+        }
+
+        int currEnd = numRuns;
+
+        // Connect with 8-neighboring runs in the previous row
+        int k = prevBegin;
+        for (int r = currBegin; r < currEnd; r++) {
+            const auto& run = _runs[r];
+
+            while (k < prevEnd && _runs[k].xEnd < run.xBegin) {
+                k++;
+            }
+
+            for (int p = k; p < prevEnd && _runs[p].xBegin <= run.xEnd; p++) {
+                unite(r, p);
+            }
+        }
+
+        prevBegin = currBegin;
+        prevEnd = currEnd;
+    }
+
+    // Accumulate stats of runs into their root runs, roots always precede
+    // their members
+    int numBlobs = 0;
+    for (int i = 0; i < numRuns; i++) {
+        const auto& run = _runs[i];
+        auto rect = cv::Rect(run.xBegin, run.y, run.xEnd - run.xBegin, 1);
+        int root = findRoot(i);
+
+        if (root == i) {
+            _runBlobs[i] = Blob{.bbox = rect, .area = rect.width};
+            numBlobs++;
+        } else {
+            auto& blob = _runBlobs[root];
+            blob.bbox |= rect;
+            blob.area += rect.width;
+        }
+    }
+
+    if (numBlobs > _params.maxNumBlobs) {
+        return numBlobs;
+    }
+
+    for (int i = 0; i < numRuns; i++) {
+        if (_parents[i] == i) {
+            _blobs.push_back(_runBlobs[i]);
+        }
+    }
+
+    return numBlobs;
+}
+
+int BlobDetector::findRoot(int i) {
+    while (_parents[i] != i) {
+        _parents[i] = _parents[_parents[i]];
+        i = _parents[i];
+    }
+    return i;
+}
@@ -0,0 +1,269 @@
+/**
+ * @file blob_detector.hpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Foreground mask post-processing and blob (bbox) extraction
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+
+#include "binary_morphology.hpp"
+
+#include <opencv2/core.hpp>
+#include <vector>
+
+/**
+ * @brief Implementation used for morphology and connected components
+ */
+enum class BlobDetectorEngine {
+    /**
+     * @brief cv::morphologyEx and cv::connectedComponentsWithStats
+     */
+    OPENCV,
+
+    /**
+     * @brief BinaryMorphology and run-length connected components, works
+     * entirely in preallocated buffers
+     */
+    NATIVE,
+};
+
+/**
+ * @brief Additional parameters for BlobDetector class
+ */
+struct BlobDetectorParams {
+    /**
+     * @brief Max number of foreground blobs in a valid frame
+     */
+    int maxNumBlobs = 64;
+
+    /**
+     * @brief Margin (pixels) added around each blob bbox
+     */
+    int bboxMargin = 6;
+
+    /**
+     * @brief Morphology and labelling implementation
+     */
+    BlobDetectorEngine engine = BlobDetectorEngine::NATIVE;
+
+    /**
+     * @brief Capacity of foreground runs for the native labeller, a frame
+     * with more runs is considered to have too many blobs
+     */
+    int maxNumRuns = 1 << 15;
+};
+
+/**
+ * @brief Foreground blob detector
+ */
+class BlobDetector final {
+  public:
+#pragma region Public types
+
+    /**
+     * @brief Statistics of a connected foreground blob
+     */
+    struct Blob {
+        cv::Rect bbox;
+        int area;
+    };
+
+#pragma endregion
+
+#pragma region Public member methods
+
+    /**
+     * @brief Construct a new BlobDetector object
+     *
+     * @param height Frame height
+     * @param width Frame width
+     * @param params Additional parameters
+     */
+    BlobDetector(int height,
+                 int width,
+                 const BlobDetectorParams& params = BlobDetectorParams());
+
+    /**
+     * @brief Make the background model update mask from a raw foreground
+     * mask (opening with a 3x3 ellipse)
+     *
+     * @param fgMask Raw foreground mask (CV_8UC1)
+     * @param updateMask Output update mask (CV_8UC1)
+     * @return
+     */
+    void makeUpdateMask(const cv::Mat& fgMask, cv::Mat& updateMask);
+
+    /**
+     * @brief Remove noise and fill holes in a foreground mask in place
+     * (opening with a 3x3 ellipse then closing with a 5x5 ellipse)
+     *
+     * @param fgMask Foreground mask (CV_8UC1)
+     * @return
+     */
+    void filter(cv::Mat& fgMask);
+
+    /**
+     * @brief Extract blobs from a filtered foreground mask
+     *
+     * @param fgMask Filtered foreground mask (CV_8UC1)
+     * @param detections Output bboxes (with margin), left empty when the
+     * frame has too many blobs
+     * @return  Number of foreground blobs (at least maxNumBlobs + 1 if the
+     * frame has too many blobs)
+     */
+    int extract(const cv::Mat& fgMask, std::vector<cv::Rect2f>& detections);
+
+    /**
+     * @brief makeUpdateMask() inside some windows only, the rest of the
+     * update mask is left untouched
+     *
+     * @param fgMask Raw foreground mask (CV_8UC1)
+     * @param updateMask Output update mask (CV_8UC1, preallocated)
+     * @param windows Disjoint windows inside the frame
+     * @return
+     */
+    void makeUpdateMask(const cv::Mat& fgMask,
+                        cv::Mat& updateMask,
+                        const std::vector<cv::Rect>& windows);
+
+    /**
+     * @brief filter() inside some windows only, pixels outside a window do
+     * not take part in the filtering of its pixels
+     *
+     * @param fgMask Foreground mask (CV_8UC1)
+     * @param windows Disjoint windows inside the frame
+     * @return
+     */
+    void filter(cv::Mat& fgMask, const std::vector<cv::Rect>& windows);
+
+    /**
+     * @brief extract() inside some windows only, a blob cut by the edge of a
+     * window ends there
+     *
+     * @param fgMask Filtered foreground mask (CV_8UC1)
+     * @param detections Output bboxes (with margin, in frame coordinates),
+     * left empty when the windows have too many blobs in total
+     * @param windows Disjoint windows inside the frame
+     * @return  Number of foreground blobs (at least maxNumBlobs + 1 if the
+     * windows have too many blobs)
+     */
+    int extract(const cv::Mat& fgMask,
+                std::vector<cv::Rect2f>& detections,
+                const std::vector<cv::Rect>& windows);
+
+    /**
+     * @brief Get blobs found by the last extract() call
+     *
+     * @return  Blobs
+     */
+    const std::vector<Blob>& getBlobs() const { return _blobs; }
+
+    int getMaxNumBlobs() const { return _params.maxNumBlobs; }
+
+    void setMaxNumBlobs(int maxNumBlobs) { _params.maxNumBlobs = maxNumBlobs; }
+
+    int getBBoxMargin() const { return _params.bboxMargin; }
+
+    void setBBoxMargin(int bboxMargin) { _params.bboxMargin = bboxMargin; }
+
+    BlobDetectorEngine getEngine() const { return _params.engine; }
+
+    /**
+     * @brief Get the memory held by the scratch buffers of morphology and
+     * labelling
+     *
+     * @return  Size (bytes)
+     */
+    size_t getMemoryUsage() const;
+
+#pragma endregion
+
+  private:
+#pragma region Private types
+
+    /**
+     * @brief Horizontal run of foreground pixels [xBegin, xEnd) in row y
+     */
+    struct Run {
+        int y;
+        int xBegin;
+        int xEnd;
+    };
+
+#pragma endregion
+
+#pragma region Private member variables
+
+    int _h;
+    int _w;
+    BlobDetectorParams _params;
+
+    cv::Mat _se3x3;
+    cv::Mat _se5x5;
+    BinaryMorphology::Kernel _kernel3x3;
+    BinaryMorphology::Kernel _kernel5x5;
+
+    /**
+     * @brief Scratch mask for morphology
+     */
+    cv::Mat _temp;
+
+    /* OpenCV engine buffers */
+    cv::Mat _labels;
+    cv::Mat _stats;
+    cv::Mat _centroids;
+
+    /* Native engine buffers */
+    std::vector<Run> _runs;
+    std::vector<int> _parents;
+    std::vector<Blob> _runBlobs;
+
+    /**
+     * @brief Blobs of the last extracted frame
+     */
+    std::vector<Blob> _blobs;
+
+#pragma endregion
+
+#pragma region Private member methods
+
+    /**
+     * @brief Label with cv::connectedComponentsWithStats, blobs are appended
+     *
+     * @param fgMask Foreground mask (the whole frame or a window of it)
+     * @return  Number of foreground blobs
+     */
+    int labelOpenCV(const cv::Mat& fgMask);
+
+    /**
+     * @brief Label by merging runs of consecutive rows (8-connectivity),
+     * blobs are appended
+     *
+     * @param fgMask Foreground mask (the whole frame or a window of it)
+     * @return  Number of foreground blobs
+     */
+    int labelRuns(const cv::Mat& fgMask);
+
+    /**
+     * @brief Turn the labelled blobs into detections
+     *
+     * @param numBlobs Number of labelled blobs
+     * @param detections Output bboxes (with margin)
+     * @return  Number of foreground blobs
+     */
+    int makeDetections(int numBlobs, std::vector<cv::Rect2f>& detections);
+
+    /**
+     * @brief Find root run with path halving
+     *
+     * @param i Run index
+     * @return  Root run index
+     */
+    int findRoot(int i);
+
+#pragma endregion
+};
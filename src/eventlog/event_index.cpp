@@ -0,0 +1,179 @@
+/**
+ * @file event_index.cpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Spatio-temporal index file format of ended trajectories
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "event_index.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+
+namespace {
+
+constexpr std::string_view FILE_EXTENSION = ".fodidx";
+
+/**
+ * @brief Convert days since the Unix epoch to a proleptic Gregorian date
+ *
+ * @param day Days since the Unix epoch
+ * @param year Output year
+ * @param month Output month [1, 12]
+ * @param dayOfMonth Output day of month [1, 31]
+ * @return
+ */
+void toDate(int32_t day, int& year, int& month, int& dayOfMonth) {
+    int64_t z = static_cast<int64_t>(day) + 719468;
+    int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+    int64_t dayOfEra = z - era * 146097;
+    int64_t yearOfEra =
+        (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) /
+        365;
+    int64_t dayOfYear =
+        dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    int64_t monthIndex = (5 * dayOfYear + 2) / 153; // March based
+    dayOfMonth = static_cast<int>(dayOfYear - (153 * monthIndex + 2) / 5 + 1);
+    month = static_cast<int>(monthIndex < 10 ? monthIndex + 3 : monthIndex - 9);
+    year = static_cast<int>(yearOfEra + era * 400 + (month <= 2 ? 1 : 0));
+}
+
+/**
+ * @brief Convert a proleptic Gregorian date to days since the Unix epoch
+ *
+ * @param year Year
+ * @param month Month [1, 12]
+ * @param dayOfMonth Day of month [1, 31]
+ * @return  Days since the Unix epoch
+ */
+int32_t fromDate(int year, int month, int dayOfMonth) {
+    int64_t y = month <= 2 ? year - 1 : year;
+    int64_t era = (y >= 0 ? y : y - 399) / 400;
+    int64_t yearOfEra = y - era * 400;
+    int64_t dayOfYear =
+        (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + dayOfMonth - 1;
+    int64_t dayOfEra =
+        yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return static_cast<int32_t>(era * 146097 + dayOfEra - 719468);
+}
+
+/**
+ * @brief Get the grid column / row of a normalized coordinate
+ *
+ * @param value Normalized coordinate
+ * @return  Cell index [0, GRID_SIZE)
+ */
+int getCell(float value) {
+    auto cell = static_cast<int>(std::floor(value * EventIndex::GRID_SIZE));
+    return std::clamp(cell, 0, EventIndex::GRID_SIZE - 1);
+}
+
+} // namespace
+
+std::string EventIndex::getFileName(int32_t day) {
+    int year = 0;
+    int month = 0;
+    int dayOfMonth = 0;
+    toDate(day, year, month, dayOfMonth);
+
+    std::array<char, 32> name;
+    std::snprintf(name.data(),
+                  name.size(),
+                  "%04d-%02d-%02d%.*s",
+                  year,
+                  month,
+                  dayOfMonth,
+                  static_cast<int>(FILE_EXTENSION.size()),
+                  FILE_EXTENSION.data());
+    return name.data();
+}
+
+bool EventIndex::parseFileName(std::string_view name, int32_t& day) {
+    // YYYY-MM-DD followed by the extension
+    if (name.size() != 10 + FILE_EXTENSION.size() ||
+        name.substr(10) != FILE_EXTENSION) {
+        return false;
+    }
+
+    int year = 0;
+    int month = 0;
+    int dayOfMonth = 0;
+    auto date = std::string(name.substr(0, 10));
+    if (std::sscanf(date.c_str(), "%4d-%2d-%2d", &year, &month, &dayOfMonth) !=
+            3 ||
+        month < 1 || month > 12 || dayOfMonth < 1 || dayOfMonth > 31) {
+        return false;
+    }
+
+    day = fromDate(year, month, dayOfMonth);
+    return true;
+}
+
+uint64_t
+EventIndex::getCellMask(float xMin, float yMin, float xMax, float yMax) {
+    if (xMax < 0.0F || yMax < 0.0F || xMin > 1.0F || yMin > 1.0F ||
+        xMin > xMax || yMin > yMax) {
+        return 0;
+    }
+
+    int left = getCell(xMin);
+    int right = getCell(xMax);
+    int top = getCell(yMin);
+    int bottom = getCell(yMax);
+
+    // Cells [left, right] of one row, then copied to each row
+    uint64_t row = ((uint64_t(1) << (right - left + 1)) - 1) << left;
+    uint64_t mask = 0;
+    for (int y = top; y <= bottom; y++) {
+        mask |= row << (y * GRID_SIZE);
+    }
+    return mask;
+}
+
+EventIndexEntry
+EventIndex::makeEntry(int32_t tag, uint32_t frameWidth, uint32_t frameHeight) {
+    return EventIndexEntry{
+        .startTimeNs = std::numeric_limits<int64_t>::max(),
+        .endTimeNs = std::numeric_limits<int64_t>::min(),
+        .cellMask = 0,
+        .xMin = std::numeric_limits<float>::max(),
+        .yMin = std::numeric_limits<float>::max(),
+        .xMax = std::numeric_limits<float>::lowest(),
+        .yMax = std::numeric_limits<float>::lowest(),
+        .tag = tag,
+        .numSamples = 0,
+        .frameWidth = frameWidth,
+        .frameHeight = frameHeight,
+        .reserved = {0, 0},
+    };
+}
+
+void EventIndex::addSample(EventIndexEntry& entry,
+                           int64_t timeNs,
+                           float x,
+                           float y,
+                           float width,
+                           float height) {
+    float scaleX = 1.0F / static_cast<float>(std::max(entry.frameWidth, 1U));
+    float scaleY = 1.0F / static_cast<float>(std::max(entry.frameHeight, 1U));
+    float xMin = x * scaleX;
+    float yMin = y * scaleY;
+    float xMax = (x + width) * scaleX;
+    float yMax = (y + height) * scaleY;
+
+    entry.startTimeNs = std::min(entry.startTimeNs, timeNs);
+    entry.endTimeNs = std::max(entry.endTimeNs, timeNs);
+    entry.cellMask |= getCellMask(xMin, yMin, xMax, yMax);
+    entry.xMin = std::min(entry.xMin, xMin);
+    entry.yMin = std::min(entry.yMin, yMin);
+    entry.xMax = std::max(entry.xMax, xMax);
+    entry.yMax = std::max(entry.yMax, yMax);
+    entry.numSamples++;
+}
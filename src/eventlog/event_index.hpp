@@ -0,0 +1,150 @@
+/**
+ * @file event_index.hpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Spatio-temporal index file format of ended trajectories
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/*
+ * An event index is a directory with one file per UTC day, named
+ * YYYY-MM-DD.fodidx. A file is a header followed by fixed size entries, one
+ * per trajectory starting that day, so a query maps only the files of its
+ * days and scans their entries in place, without decoding any sample.
+ *
+ * Coordinates are normalized to the analysis frame ([0, 1]), which keeps
+ * entries comparable when the analysis resolution changes. Every entry has
+ * the cells of a GRID_SIZE x GRID_SIZE grid crossed by its bboxes as a bit
+ * mask, and the union of its bboxes for the exact bounds.
+ *
+ * Files are only ever appended to. An entry cut short by a crash is dropped
+ * by the writer before appending again.
+ */
+
+/**
+ * @brief File header of an event index day file
+ */
+struct EventIndexHeader {
+    char magic[8];
+    uint32_t version;
+    int32_t day; // Days since the Unix epoch (UTC)
+};
+
+/**
+ * @brief Indexed trajectory
+ */
+struct EventIndexEntry {
+    int64_t startTimeNs; // Unix time of the first sample (ns)
+    int64_t endTimeNs;   // Unix time of the last sample (ns)
+    uint64_t cellMask;   // Grid cells crossed by the bboxes, bit y * 8 + x
+    float xMin;          // Normalized union of the bboxes
+    float yMin;
+    float xMax;
+    float yMax;
+    int32_t tag;         // Tracker tag
+    uint32_t numSamples; // Number of samples
+    uint32_t frameWidth; // Analysis frame size the bboxes referred to
+    uint32_t frameHeight;
+    uint32_t reserved[2];
+};
+
+/**
+ * @brief Normalized region of the analysis frame ([0, 1])
+ */
+struct EventIndexRegion {
+    float xMin = 0.0F;
+    float yMin = 0.0F;
+    float xMax = 1.0F;
+    float yMax = 1.0F;
+};
+
+/**
+ * @brief Format constants and helpers
+ */
+struct EventIndex {
+    static constexpr char MAGIC[8] = {'F', 'O', 'D', 'I', 'N', 'D', 'E', 'X'};
+    static constexpr uint32_t VERSION = 1;
+    static constexpr int GRID_SIZE = 8;
+    static constexpr int64_t NS_PER_DAY = 86'400'000'000'000LL;
+
+    /**
+     * @brief Get the UTC day of a time
+     *
+     * @param timeNs Unix time (ns)
+     * @return  Days since the Unix epoch
+     */
+    static constexpr int32_t getDay(int64_t timeNs) {
+        int64_t day = timeNs / NS_PER_DAY;
+        return static_cast<int32_t>(timeNs % NS_PER_DAY < 0 ? day - 1 : day);
+    }
+
+    /**
+     * @brief Get the file name of a day
+     *
+     * @param day Days since the Unix epoch
+     * @return  File name (YYYY-MM-DD.fodidx)
+     */
+    static std::string getFileName(int32_t day);
+
+    /**
+     * @brief Get the day of a file name
+     *
+     * @param name File name
+     * @param day Output days since the Unix epoch
+     * @return  True: name of a day file
+     */
+    static bool parseFileName(std::string_view name, int32_t& day);
+
+    /**
+     * @brief Get the grid cells crossed by a normalized rectangle
+     *
+     * @param xMin Left
+     * @param yMin Top
+     * @param xMax Right
+     * @param yMax Bottom
+     * @return  Cell mask, 0 if the rectangle is outside the frame
+     */
+    static uint64_t getCellMask(float xMin, float yMin, float xMax, float yMax);
+
+    /**
+     * @brief Make an entry without samples
+     *
+     * @param tag Tracker tag
+     * @param frameWidth Analysis frame width
+     * @param frameHeight Analysis frame height
+     * @return  Entry
+     */
+    static EventIndexEntry
+    makeEntry(int32_t tag, uint32_t frameWidth, uint32_t frameHeight);
+
+    /**
+     * @brief Add a bbox sample to an entry
+     *
+     * @param entry Entry
+     * @param timeNs Unix time of the sample (ns)
+     * @param x Left of the bbox (pixels)
+     * @param y Top of the bbox (pixels)
+     * @param width Width of the bbox (pixels)
+     * @param height Height of the bbox (pixels)
+     * @return
+     */
+    static void addSample(EventIndexEntry& entry,
+                          int64_t timeNs,
+                          float x,
+                          float y,
+                          float width,
+                          float height);
+};
+
+static_assert(sizeof(EventIndexHeader) == 16);
+static_assert(sizeof(EventIndexEntry) == 64);
+static_assert(EventIndex::GRID_SIZE * EventIndex::GRID_SIZE == 64);
@@ -0,0 +1,215 @@
+/**
+ * @file event_index_cli.cpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Query the spatio-temporal event index, or build it from event logs
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "event_index_reader.hpp"
+#include "event_index_writer.hpp"
+#include "event_log_reader.hpp"
+
+#include <argparse/argparse.hpp>
+#include <array>
+#include <chrono>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <string>
+
+/**
+ * @brief Setup command line arguments
+ *
+ * @return argparse::ArgumentParser arg parser
+ */
+static argparse::ArgumentParser getArgParser() {
+    auto parser = argparse::ArgumentParser("fod_event_index");
+
+    // clang-format off
+    parser.add_argument("dir")
+        .help("Event index directory");
+
+    parser.add_argument("--from")
+        .help("Only trajectories ending after this Unix time (seconds)")
+        .default_value(-1.0)
+        .action([](const std::string& arg) { return std::stod(arg); });
+
+    parser.add_argument("--to")
+        .help("Only trajectories starting before this Unix time (seconds)")
+        .default_value(-1.0)
+        .action([](const std::string& arg) { return std::stod(arg); });
+
+    parser.add_argument("--region")
+        .help("Only trajectories crossing this region, as x,y,w,h in pixels "
+              "of --frame_size, or normalized to [0, 1] without it")
+        .default_value(std::array<float, 4>{0.0F, 0.0F, 1.0F, 1.0F})
+        .action([](const std::string& arg) {
+            auto region = std::array<float, 4>{0.0F, 0.0F, 0.0F, 0.0F};
+            std::sscanf(arg.c_str(), "%f,%f,%f,%f",
+                        &region[0], &region[1], &region[2], &region[3]);
+            return region;
+        });
+
+    parser.add_argument("--frame_size")
+        .help("Frame size the region refers to, as WxH")
+        .default_value(std::array<int, 2>{0, 0})
+        .action([](const std::string& arg) {
+            auto size = std::array<int, 2>{0, 0};
+            std::sscanf(arg.c_str(), "%dx%d", &size[0], &size[1]);
+            return size;
+        });
+
+    parser.add_argument("--tag")
+        .help("Only trajectories with this tracker tag")
+        .default_value(-1)
+        .action([](const std::string& arg) { return std::stoi(arg); });
+
+    parser.add_argument("--build")
+        .help("Index the trajectories of this event log instead of querying")
+        .default_value(std::string(""));
+    // clang-format on
+
+    return parser;
+}
+
+/**
+ * @brief Add the trajectories of an event log to the index
+ *
+ * @param dir Index directory
+ * @param logPath Event log file
+ * @return  Exit code
+ */
+static int build(const std::string& dir, const std::string& logPath) {
+    auto reader = EventLogReader(logPath);
+    if (!reader.isOpened()) {
+        std::fprintf(
+            stderr, "[EVENT INDEX] Cannot read %s\n", logPath.c_str());
+        return EXIT_FAILURE;
+    }
+
+    auto writer = EventIndexWriter(dir);
+    if (!writer.isOpened()) {
+        return EXIT_FAILURE;
+    }
+
+    reader.forEachTrajectory(
+        [&writer](const EventLogReader::TrajectoryView& view) {
+            const auto& record = *view.record;
+            auto entry = EventIndex::makeEntry(
+                record.tag, record.frameWidth, record.frameHeight);
+            for (uint32_t i = 0; i < record.numSamples; i++) {
+                const auto& sample = view.getSample(i);
+                EventIndex::addSample(entry,
+                                      sample.timeNs,
+                                      sample.x,
+                                      sample.y,
+                                      sample.width,
+                                      sample.height);
+            }
+            writer.add(entry);
+        });
+
+    std::printf("[EVENT INDEX] %zu trajectories of %s added to %s\n",
+                writer.getNumAdded(),
+                logPath.c_str(),
+                dir.c_str());
+    return EXIT_SUCCESS;
+}
+
+int main(int argc, char* argv[]) {
+    auto parser = getArgParser();
+
+    try {
+        parser.parse_args(argc, argv);
+    } catch (const std::runtime_error& e) {
+        std::printf("%s\n", e.what());
+        std::cout << parser;
+        std::exit(0);
+    }
+
+    auto dir = parser.get("dir");
+    if (auto logPath = parser.get("--build"); !logPath.empty()) {
+        return build(dir, logPath);
+    }
+
+    auto toNs = [](double seconds, int64_t defaultNs) {
+        return seconds < 0.0
+                   ? defaultNs
+                   : static_cast<int64_t>(std::llround(seconds * 1e9));
+    };
+    int64_t fromNs = toNs(parser.get<double>("--from"),
+                          std::numeric_limits<int64_t>::min());
+    int64_t toNsLimit = toNs(parser.get<double>("--to"),
+                             std::numeric_limits<int64_t>::max());
+    int tag = parser.get<int>("--tag");
+
+    auto rect = parser.get<std::array<float, 4>>("--region");
+    auto frameSize = parser.get<std::array<int, 2>>("--frame_size");
+    float scaleX = frameSize[0] > 0 ? 1.0F / frameSize[0] : 1.0F;
+    float scaleY = frameSize[1] > 0 ? 1.0F / frameSize[1] : 1.0F;
+    auto region = EventIndexRegion{
+        .xMin = rect[0] * scaleX,
+        .yMin = rect[1] * scaleY,
+        .xMax = (rect[0] + rect[2]) * scaleX,
+        .yMax = (rect[1] + rect[3]) * scaleY,
+    };
+
+    std::printf("%-8s %-20s %10s %8s %-24s %s\n",
+                "TAG",
+                "START (s)",
+                "DURATION",
+                "SAMPLES",
+                "BBOX (x,y,w,h)",
+                "SNAPSHOT");
+
+    auto reader = EventIndexReader(dir);
+    auto startTime = std::chrono::steady_clock::now();
+    size_t numListed = 0;
+    reader.query(
+        [&](const EventIndexEntry& entry) {
+            if (tag >= 0 && entry.tag != tag) {
+                return;
+            }
+            numListed++;
+
+            // Union of the bboxes in pixels of the analysis frame
+            std::array<char, 48> bbox;
+            std::snprintf(bbox.data(),
+                          bbox.size(),
+                          "%.0f,%.0f,%.0f,%.0f",
+                          entry.xMin * entry.frameWidth,
+                          entry.yMin * entry.frameHeight,
+                          (entry.xMax - entry.xMin) * entry.frameWidth,
+                          (entry.yMax - entry.yMin) * entry.frameHeight);
+
+            std::printf("%-8d %-20.3f %9.3fs %8u %-24s "
+                        "trajectory_%d_%" PRId64 ".jpg\n",
+                        entry.tag,
+                        entry.startTimeNs * 1e-9,
+                        (entry.endTimeNs - entry.startTimeNs) * 1e-9,
+                        entry.numSamples,
+                        bbox.data(),
+                        entry.tag,
+                        entry.startTimeNs);
+        },
+        fromNs,
+        toNsLimit,
+        region);
+    auto elapsed = std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now() - startTime);
+
+    std::printf("# %zu trajectories (%zu entries in %zu day files scanned "
+                "in %.3f ms)\n",
+                numListed,
+                reader.getNumScanned(),
+                reader.getNumFiles(),
+                elapsed.count());
+
+    return 0;
+}
@@ -0,0 +1,113 @@
+/**
+ * @file event_index_reader.cpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Region and time range queries over the spatio-temporal event index
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "event_index_reader.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+size_t EventIndexReader::query(const Callback& callback,
+                               int64_t fromNs,
+                               int64_t toNs,
+                               const EventIndexRegion& region) const {
+    _numScanned = 0;
+    _numFiles = 0;
+
+    uint64_t regionMask = EventIndex::getCellMask(
+        region.xMin, region.yMin, region.xMax, region.yMax);
+    if (regionMask == 0 || fromNs > toNs) {
+        return 0;
+    }
+
+    // Entries are filed by start day, trajectories starting the day before
+    // can still overlap the range (they are far shorter than a day)
+    int32_t firstDay = EventIndex::getDay(fromNs) - 1;
+    int32_t lastDay = EventIndex::getDay(toNs);
+
+    DIR* dir = ::opendir(_dir.c_str());
+    if (dir == nullptr) {
+        return 0;
+    }
+
+    std::vector<int32_t> days;
+    while (const auto* dirEntry = ::readdir(dir)) {
+        int32_t day = 0;
+        if (EventIndex::parseFileName(dirEntry->d_name, day) &&
+            day >= firstDay && day <= lastDay) {
+            days.push_back(day);
+        }
+    }
+    ::closedir(dir);
+    std::sort(days.begin(), days.end());
+
+    size_t numMatched = 0;
+    for (int32_t day : days) {
+        auto path = _dir + "/" + EventIndex::getFileName(day);
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            continue;
+        }
+
+        struct stat fileStat {};
+        if (::fstat(fd, &fileStat) != 0 ||
+            static_cast<size_t>(fileStat.st_size) <= sizeof(EventIndexHeader)) {
+            ::close(fd);
+            continue;
+        }
+
+        auto size = static_cast<size_t>(fileStat.st_size);
+        void* data = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (data == MAP_FAILED) {
+            continue;
+        }
+        _numFiles++;
+
+        const auto* header = static_cast<const EventIndexHeader*>(data);
+        if (std::memcmp(header->magic,
+                        EventIndex::MAGIC,
+                        sizeof(header->magic)) != 0 ||
+            header->version != EventIndex::VERSION || header->day != day) {
+            ::munmap(data, size);
+            continue;
+        }
+
+        // A partial entry at the end is ignored
+        const auto* entries = reinterpret_cast<const EventIndexEntry*>(
+            static_cast<const uint8_t*>(data) + sizeof(EventIndexHeader));
+        size_t numEntries =
+            (size - sizeof(EventIndexHeader)) / sizeof(EventIndexEntry);
+        _numScanned += numEntries;
+
+        for (size_t i = 0; i < numEntries; i++) {
+            const auto& entry = entries[i];
+            if (entry.startTimeNs > toNs || entry.endTimeNs < fromNs ||
+                (entry.cellMask & regionMask) == 0 ||
+                entry.xMin > region.xMax || entry.xMax < region.xMin ||
+                entry.yMin > region.yMax || entry.yMax < region.yMin) {
+                continue;
+            }
+
+            callback(entry);
+            numMatched++;
+        }
+
+        ::munmap(data, size);
+    }
+
+    return numMatched;
+}
@@ -0,0 +1,83 @@
+/**
+ * @file event_index_reader.hpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Region and time range queries over the spatio-temporal event index
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+
+#include "event_index.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string>
+
+/**
+ * @brief Answers region and time range queries over an event index
+ *        directory. Only the day files of the queried range are mapped, and
+ *        their entries are filtered by grid cells before the exact bounds.
+ */
+class EventIndexReader final {
+  public:
+#pragma region Public types
+
+    using Callback = std::function<void(const EventIndexEntry&)>;
+
+#pragma endregion
+
+#pragma region Public member methods
+
+    /**
+     * @brief Construct a new EventIndexReader object
+     *
+     * @param dir Index directory
+     */
+    explicit EventIndexReader(const std::string& dir) : _dir(dir) {}
+
+    /**
+     * @brief Visit trajectories overlapping a time range whose bboxes cross a
+     * region, in day order
+     *
+     * @param callback Called with each matching entry
+     * @param fromNs Range begin (Unix time, ns)
+     * @param toNs Range end (Unix time, ns)
+     * @param region Queried region
+     * @return  Number of visited trajectories
+     */
+    size_t query(const Callback& callback,
+                 int64_t fromNs = std::numeric_limits<int64_t>::min(),
+                 int64_t toNs = std::numeric_limits<int64_t>::max(),
+                 const EventIndexRegion& region = EventIndexRegion()) const;
+
+    /**
+     * @brief Get the number of entries scanned by the last query
+     *
+     * @return  Number of entries
+     */
+    size_t getNumScanned() const { return _numScanned; }
+
+    /**
+     * @brief Get the number of day files mapped by the last query
+     *
+     * @return  Number of files
+     */
+    size_t getNumFiles() const { return _numFiles; }
+
+#pragma endregion
+
+  private:
+#pragma region Private member variables
+
+    std::string _dir;
+
+    mutable size_t _numScanned = 0;
+    mutable size_t _numFiles = 0;
+
+#pragma endregion
+};
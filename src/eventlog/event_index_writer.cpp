@@ -0,0 +1,125 @@
+/**
+ * @file event_index_writer.cpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Append-only writer of the spatio-temporal event index
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "event_index_writer.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+EventIndexWriter::EventIndexWriter(const std::string& dir) : _dir(dir) {
+    if (::mkdir(_dir.c_str(), 0755) != 0 && errno != EEXIST) {
+        std::printf("[EVENT INDEX] Cannot create %s\n", _dir.c_str());
+        return;
+    }
+
+    struct stat dirStat {};
+    if (::stat(_dir.c_str(), &dirStat) != 0 || !S_ISDIR(dirStat.st_mode)) {
+        std::printf("[EVENT INDEX] %s is not a directory\n", _dir.c_str());
+        return;
+    }
+
+    _isOpened = true;
+}
+
+EventIndexWriter::~EventIndexWriter() {
+    if (_fd >= 0) {
+        ::close(_fd);
+    }
+}
+
+bool EventIndexWriter::add(const EventIndexEntry& entry) {
+    if (!_isOpened || entry.numSamples == 0) {
+        return false;
+    }
+
+    int32_t day = EventIndex::getDay(entry.startTimeNs);
+    if ((_fd < 0 || day != _day) && !open(day)) {
+        return false;
+    }
+
+    // A single append, an entry is never interleaved or split by another
+    if (::write(_fd, &entry, sizeof(entry)) !=
+        static_cast<ssize_t>(sizeof(entry))) {
+        std::printf("[EVENT INDEX] Write to %s failed\n",
+                    EventIndex::getFileName(_day).c_str());
+        return false;
+    }
+
+    _numAdded++;
+    return true;
+}
+
+bool EventIndexWriter::open(int32_t day) {
+    if (_fd >= 0) {
+        ::close(_fd);
+        _fd = -1;
+    }
+
+    auto path = _dir + "/" + EventIndex::getFileName(day);
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_APPEND, 0644);
+    if (fd < 0) {
+        std::printf("[EVENT INDEX] Cannot open %s\n", path.c_str());
+        return false;
+    }
+
+    struct stat fileStat {};
+    if (::fstat(fd, &fileStat) != 0) {
+        ::close(fd);
+        return false;
+    }
+
+    // Keep the complete entries of an existing file with a valid header
+    auto size = static_cast<size_t>(fileStat.st_size);
+    auto header = EventIndexHeader{};
+    bool isValid =
+        size >= sizeof(header) &&
+        ::pread(fd, &header, sizeof(header), 0) ==
+            static_cast<ssize_t>(sizeof(header)) &&
+        std::memcmp(header.magic, EventIndex::MAGIC, sizeof(header.magic)) ==
+            0 &&
+        header.version == EventIndex::VERSION && header.day == day;
+
+    if (isValid) {
+        size_t numEntries = (size - sizeof(header)) / sizeof(EventIndexEntry);
+        size_t validSize =
+            sizeof(header) + numEntries * sizeof(EventIndexEntry);
+        if (validSize != size &&
+            ::ftruncate(fd, static_cast<off_t>(validSize)) != 0) {
+            ::close(fd);
+            return false;
+        }
+    } else if (size >= sizeof(header)) {
+        // Never overwrite what isn't an index file cut short
+        std::printf("[EVENT INDEX] %s is not an index file\n", path.c_str());
+        ::close(fd);
+        return false;
+    } else {
+        header = EventIndexHeader{};
+        std::memcpy(header.magic, EventIndex::MAGIC, sizeof(header.magic));
+        header.version = EventIndex::VERSION;
+        header.day = day;
+
+        if (::ftruncate(fd, 0) != 0 ||
+            ::write(fd, &header, sizeof(header)) !=
+                static_cast<ssize_t>(sizeof(header))) {
+            ::close(fd);
+            return false;
+        }
+    }
+
+    _fd = fd;
+    _day = day;
+    return true;
+}
@@ -0,0 +1,93 @@
+/**
+ * @file event_index_writer.hpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Append-only writer of the spatio-temporal event index
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+
+#include "event_index.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Appends entries to the day files of an event index directory.
+ *        Each entry is written with a single write to the file of the day
+ *        it starts, the file of the last day stays open.
+ */
+class EventIndexWriter final {
+  public:
+#pragma region Public member methods
+
+    /**
+     * @brief Construct a new EventIndexWriter object, the directory is
+     * created if needed
+     *
+     * @param dir Index directory
+     */
+    explicit EventIndexWriter(const std::string& dir);
+
+    /**
+     * @brief Destroy the EventIndexWriter object, closes the open day file
+     */
+    ~EventIndexWriter();
+
+    EventIndexWriter(const EventIndexWriter&) = delete;
+    EventIndexWriter& operator=(const EventIndexWriter&) = delete;
+
+    /**
+     * @brief Tells whether the index directory is usable
+     *
+     * @return  True: Opened
+     */
+    bool isOpened() const { return _isOpened; }
+
+    /**
+     * @brief Append an entry to the file of its start day
+     *
+     * @param entry Entry with at least one sample
+     * @return  True: Appended
+     */
+    bool add(const EventIndexEntry& entry);
+
+    /**
+     * @brief Get the number of entries appended by this writer
+     *
+     * @return  Number of entries
+     */
+    size_t getNumAdded() const { return _numAdded; }
+
+#pragma endregion
+
+  private:
+#pragma region Private member variables
+
+    std::string _dir;
+    bool _isOpened = false;
+
+    int _fd = -1;
+    int32_t _day = 0;
+
+    size_t _numAdded = 0;
+
+#pragma endregion
+
+#pragma region Private member methods
+
+    /**
+     * @brief Open the file of a day, writing a file header to a new file and
+     * dropping a partial entry at the end of an existing one
+     *
+     * @param day Days since the Unix epoch
+     * @return  True: Opened
+     */
+    bool open(int32_t day);
+
+#pragma endregion
+};
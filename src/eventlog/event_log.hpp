@@ -0,0 +1,105 @@
+/**
+ * @file event_log.hpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Binary event log file format
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * An event log is a file header followed by records. Every record starts
+ * with an EventRecordHeader and its payload is padded to 8 bytes, so records
+ * can be read in place from a memory mapped file.
+ *
+ *   TRAJECTORY  TrajectoryRecord, followed by numSamples SAMPLE records
+ *   SAMPLE      SampleRecord
+ *   METADATA    key '\0' value '\0'
+ *
+ * Files are only ever appended to. A record cut short by a crash is the end
+ * of the log, and the writer truncates it before appending again.
+ */
+
+/**
+ * @brief File header of an event log
+ */
+struct EventLogHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+};
+
+/**
+ * @brief Type of an event record
+ */
+enum class EventRecordType : uint16_t {
+    METADATA = 1,
+    TRAJECTORY = 2,
+    SAMPLE = 3,
+};
+
+/**
+ * @brief Header of an event record
+ */
+struct EventRecordHeader {
+    EventRecordType type;
+    uint16_t reserved;
+    uint32_t size; // Payload size (bytes), without padding
+};
+
+/**
+ * @brief Ended trajectory
+ */
+struct TrajectoryRecord {
+    int64_t startTimeNs; // Unix time of the first sample (ns)
+    int64_t endTimeNs;   // Unix time of the last sample (ns)
+    int32_t tag;         // Tracker tag
+    uint32_t numSamples; // Number of following SAMPLE records
+    float rangeX;        // X range of bbox centers (pixels)
+    float rangeY;        // Y range of bbox centers (pixels)
+    uint32_t frameWidth; // Analysis frame size the bboxes refer to
+    uint32_t frameHeight;
+};
+
+/**
+ * @brief Bbox sample of a trajectory
+ */
+struct SampleRecord {
+    int64_t timeNs; // Unix time (ns)
+    float x;
+    float y;
+    float width;
+    float height;
+    float xVelocity;
+    float yVelocity;
+};
+
+/**
+ * @brief Format constants
+ */
+struct EventLog {
+    static constexpr char MAGIC[8] = {'F', 'O', 'D', 'E', 'V', 'L', 'O', 'G'};
+    static constexpr uint32_t VERSION = 1;
+    static constexpr size_t ALIGNMENT = 8;
+
+    /**
+     * @brief Get the size of a record payload padded to the alignment
+     *
+     * @param size Payload size
+     * @return  Padded size
+     */
+    static constexpr size_t getPaddedSize(size_t size) {
+        return (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    }
+};
+
+static_assert(sizeof(EventLogHeader) == 16);
+static_assert(sizeof(EventRecordHeader) == 8);
+static_assert(sizeof(TrajectoryRecord) % EventLog::ALIGNMENT == 0);
+static_assert(sizeof(SampleRecord) % EventLog::ALIGNMENT == 0);
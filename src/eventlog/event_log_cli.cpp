@@ -0,0 +1,198 @@
+/**
+ * @file event_log_cli.cpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Query and export binary event logs
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "event_log_reader.hpp"
+
+#include <argparse/argparse.hpp>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <string>
+
+/**
+ * @brief Setup command line arguments
+ *
+ * @return argparse::ArgumentParser arg parser
+ */
+static argparse::ArgumentParser getArgParser() {
+    auto parser = argparse::ArgumentParser("fod_event_log");
+
+    // clang-format off
+    parser.add_argument("file")
+        .help("Event log file");
+
+    parser.add_argument("--from")
+        .help("Only trajectories ending after this Unix time (seconds)")
+        .default_value(-1.0)
+        .action([](const std::string& arg) { return std::stod(arg); });
+
+    parser.add_argument("--to")
+        .help("Only trajectories starting before this Unix time (seconds)")
+        .default_value(-1.0)
+        .action([](const std::string& arg) { return std::stod(arg); });
+
+    parser.add_argument("--tag")
+        .help("Only trajectories with this tracker tag")
+        .default_value(-1)
+        .action([](const std::string& arg) { return std::stoi(arg); });
+
+    parser.add_argument("--json")
+        .help("Export trajectories and their samples as JSON")
+        .default_value(false)
+        .implicit_value(true);
+    // clang-format on
+
+    return parser;
+}
+
+/**
+ * @brief Print a string as a JSON string literal
+ *
+ * @param str String
+ * @return
+ */
+static void printJSONString(std::string_view str) {
+    std::putchar('"');
+    for (char c : str) {
+        if (c == '"' || c == '\\') {
+            std::printf("\\%c", c);
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            std::printf("\\u%04x", c);
+        } else {
+            std::putchar(c);
+        }
+    }
+    std::putchar('"');
+}
+
+int main(int argc, char* argv[]) {
+    auto parser = getArgParser();
+
+    try {
+        parser.parse_args(argc, argv);
+    } catch (const std::runtime_error& e) {
+        std::printf("%s\n", e.what());
+        std::cout << parser;
+        std::exit(0);
+    }
+
+    auto reader = EventLogReader(parser.get("file"));
+    if (!reader.isOpened()) {
+        std::fprintf(stderr, "[EVENT LOG] Cannot read %s\n",
+                     parser.get("file").c_str());
+        std::exit(EXIT_FAILURE);
+    }
+
+    auto toNs = [](double seconds, int64_t defaultNs) {
+        return seconds < 0.0
+                   ? defaultNs
+                   : static_cast<int64_t>(std::llround(seconds * 1e9));
+    };
+    int64_t fromNs = toNs(parser.get<double>("--from"),
+                          std::numeric_limits<int64_t>::min());
+    int64_t toNsLimit = toNs(parser.get<double>("--to"),
+                             std::numeric_limits<int64_t>::max());
+    int tag = parser.get<int>("--tag");
+    bool isJSON = parser.get<bool>("--json");
+
+    if (!isJSON) {
+        reader.forEachMetadata(
+            [](std::string_view key, std::string_view value) {
+                std::printf("# %.*s: %.*s\n",
+                            static_cast<int>(key.size()),
+                            key.data(),
+                            static_cast<int>(value.size()),
+                            value.data());
+            });
+        std::printf("%-8s %-20s %10s %8s %8s %8s\n",
+                    "TAG",
+                    "START (s)",
+                    "DURATION",
+                    "SAMPLES",
+                    "RANGE X",
+                    "RANGE Y");
+    } else {
+        std::printf("{\"metadata\":{");
+        bool isFirst = true;
+        reader.forEachMetadata(
+            [&isFirst](std::string_view key, std::string_view value) {
+                std::printf(isFirst ? "" : ",");
+                printJSONString(key);
+                std::putchar(':');
+                printJSONString(value);
+                isFirst = false;
+            });
+        std::printf("},\"trajectories\":[");
+    }
+
+    bool isFirst = true;
+    size_t numTrajectories = 0;
+    reader.forEachTrajectory(
+        [&](const EventLogReader::TrajectoryView& view) {
+            const auto& record = *view.record;
+            if (tag >= 0 && record.tag != tag) {
+                return;
+            }
+            numTrajectories++;
+
+            if (!isJSON) {
+                std::printf("%-8d %-20.3f %9.3fs %8u %8.1f %8.1f\n",
+                            record.tag,
+                            record.startTimeNs * 1e-9,
+                            (record.endTimeNs - record.startTimeNs) * 1e-9,
+                            record.numSamples,
+                            record.rangeX,
+                            record.rangeY);
+                return;
+            }
+
+            std::printf("%s{\"tag\":%d,\"start_ns\":%" PRId64
+                        ",\"end_ns\":%" PRId64
+                        ",\"frame_size\":[%u,%u],\"range\":[%g,%g],"
+                        "\"samples\":[",
+                        isFirst ? "" : ",",
+                        record.tag,
+                        record.startTimeNs,
+                        record.endTimeNs,
+                        record.frameWidth,
+                        record.frameHeight,
+                        record.rangeX,
+                        record.rangeY);
+
+            // [t_ns, x, y, w, h, v_x, v_y]
+            for (uint32_t i = 0; i < record.numSamples; i++) {
+                const auto& sample = view.getSample(i);
+                std::printf("%s[%" PRId64 ",%g,%g,%g,%g,%g,%g]",
+                            i == 0 ? "" : ",",
+                            sample.timeNs,
+                            sample.x,
+                            sample.y,
+                            sample.width,
+                            sample.height,
+                            sample.xVelocity,
+                            sample.yVelocity);
+            }
+            std::printf("]}");
+            isFirst = false;
+        },
+        fromNs,
+        toNsLimit);
+
+    if (isJSON) {
+        std::printf("]}\n");
+    } else {
+        std::printf("# %zu trajectories\n", numTrajectories);
+    }
+
+    return 0;
+}
@@ -0,0 +1,181 @@
+/**
+ * @file event_log_reader.cpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Memory mapped reader of binary event logs
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "event_log_reader.hpp"
+
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+EventLogReader::EventLogReader(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+
+    struct stat fileStat {};
+    if (::fstat(fd, &fileStat) != 0) {
+        ::close(fd);
+        return;
+    }
+
+    _size = static_cast<size_t>(fileStat.st_size);
+
+    // An empty file is a log without header yet
+    if (_size == 0) {
+        ::close(fd);
+        _isValid = true;
+        return;
+    }
+
+    void* data = ::mmap(nullptr, _size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        _size = 0;
+        return;
+    }
+    _data = static_cast<const uint8_t*>(data);
+
+    // A log cut short inside the file header is treated as empty
+    if (_size < sizeof(EventLogHeader)) {
+        _isValid = true;
+        return;
+    }
+
+    const auto* header = reinterpret_cast<const EventLogHeader*>(_data);
+    if (std::memcmp(header->magic, EventLog::MAGIC, sizeof(header->magic)) !=
+            0 ||
+        header->version != EventLog::VERSION) {
+        return;
+    }
+    _isValid = true;
+
+    // Find the end of the last complete record, a trajectory is only
+    // complete with all its samples
+    size_t offset = sizeof(EventLogHeader);
+    while (const auto* record = getRecord(offset)) {
+        size_t next = record->type == EventRecordType::TRAJECTORY
+                          ? getTrajectoryEnd(offset, record)
+                          : getNextOffset(offset, record);
+        if (next == 0) {
+            break;
+        }
+        offset = next;
+    }
+    _validSize = offset;
+}
+
+EventLogReader::~EventLogReader() {
+    if (_data != nullptr) {
+        ::munmap(const_cast<uint8_t*>(_data), _size);
+    }
+}
+
+size_t EventLogReader::forEachTrajectory(const TrajectoryCallback& callback,
+                                         int64_t fromNs,
+                                         int64_t toNs) const {
+    size_t numVisited = 0;
+    size_t offset = sizeof(EventLogHeader);
+
+    while (offset < _validSize) {
+        const auto* record = getRecord(offset);
+        offset = getNextOffset(offset, record);
+
+        if (record->type != EventRecordType::TRAJECTORY ||
+            record->size != sizeof(TrajectoryRecord)) {
+            continue;
+        }
+
+        const auto* trajectory =
+            reinterpret_cast<const TrajectoryRecord*>(record + 1);
+
+        if (trajectory->endTimeNs >= fromNs &&
+            trajectory->startTimeNs <= toNs) {
+            callback(TrajectoryView{
+                .record = trajectory,
+                .samples = _data + offset,
+            });
+            numVisited++;
+        }
+
+        // Skip over the samples
+        offset += trajectory->numSamples * SAMPLE_STRIDE;
+    }
+
+    return numVisited;
+}
+
+void EventLogReader::forEachMetadata(const MetadataCallback& callback) const {
+    size_t offset = sizeof(EventLogHeader);
+
+    while (offset < _validSize) {
+        const auto* record = getRecord(offset);
+        offset = getNextOffset(offset, record);
+
+        if (record->type != EventRecordType::METADATA) {
+            continue;
+        }
+
+        const auto* payload = reinterpret_cast<const char*>(record + 1);
+        auto key = std::string_view(payload, strnlen(payload, record->size));
+        if (key.size() + 1 >= record->size) {
+            continue;
+        }
+        auto value = std::string_view(payload + key.size() + 1,
+                                      strnlen(payload + key.size() + 1,
+                                              record->size - key.size() - 1));
+        callback(key, value);
+    }
+}
+
+const EventRecordHeader* EventLogReader::getRecord(size_t offset) const {
+    if (offset + sizeof(EventRecordHeader) > _size) {
+        return nullptr;
+    }
+
+    const auto* header =
+        reinterpret_cast<const EventRecordHeader*>(_data + offset);
+    if (header->type != EventRecordType::METADATA &&
+        header->type != EventRecordType::TRAJECTORY &&
+        header->type != EventRecordType::SAMPLE) {
+        return nullptr;
+    }
+
+    if (getNextOffset(offset, header) > _size) {
+        return nullptr;
+    }
+
+    return header;
+}
+
+size_t EventLogReader::getTrajectoryEnd(size_t offset,
+                                        const EventRecordHeader* header) const {
+    if (header->size != sizeof(TrajectoryRecord)) {
+        return 0;
+    }
+
+    const auto* trajectory =
+        reinterpret_cast<const TrajectoryRecord*>(header + 1);
+    offset = getNextOffset(offset, header);
+
+    for (uint32_t i = 0; i < trajectory->numSamples; i++) {
+        const auto* sample = getRecord(offset);
+        if (sample == nullptr || sample->type != EventRecordType::SAMPLE ||
+            sample->size != sizeof(SampleRecord)) {
+            return 0;
+        }
+        offset = getNextOffset(offset, sample);
+    }
+
+    return offset;
+}
@@ -0,0 +1,168 @@
+/**
+ * @file event_log_reader.hpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Memory mapped reader of binary event logs
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+
+#include "event_log.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Reads an event log in place from a memory mapping.
+ *        Records are visited in file order without copying, trajectories
+ *        outside the queried time range are skipped over with their samples.
+ */
+class EventLogReader final {
+  public:
+#pragma region Public types
+
+    /**
+     * @brief Trajectory with its samples, pointing into the mapping
+     */
+    struct TrajectoryView {
+        const TrajectoryRecord* record;
+
+        /**
+         * @brief First sample record (header) following the trajectory
+         */
+        const uint8_t* samples;
+
+        /**
+         * @brief Get a sample of this trajectory
+         *
+         * @param i Sample index
+         * @return  Sample
+         */
+        const SampleRecord& getSample(size_t i) const {
+            return *reinterpret_cast<const SampleRecord*>(
+                samples + i * SAMPLE_STRIDE + sizeof(EventRecordHeader));
+        }
+    };
+
+    using TrajectoryCallback = std::function<void(const TrajectoryView&)>;
+    using MetadataCallback =
+        std::function<void(std::string_view key, std::string_view value)>;
+
+#pragma endregion
+
+#pragma region Public constants
+
+    /**
+     * @brief Distance between two consecutive sample records
+     */
+    static constexpr size_t SAMPLE_STRIDE =
+        sizeof(EventRecordHeader) + sizeof(SampleRecord);
+
+#pragma endregion
+
+#pragma region Public member methods
+
+    /**
+     * @brief Construct a new EventLogReader object, maps the whole log
+     *
+     * @param path Log file path
+     */
+    explicit EventLogReader(const std::string& path);
+
+    /**
+     * @brief Destroy the EventLogReader object, unmaps the log
+     */
+    ~EventLogReader();
+
+    EventLogReader(const EventLogReader&) = delete;
+    EventLogReader& operator=(const EventLogReader&) = delete;
+
+    /**
+     * @brief Tells whether the log is mapped and has a valid file header
+     *
+     * @return  True: Opened
+     */
+    bool isOpened() const { return _isValid; }
+
+    /**
+     * @brief Get the size of the log up to the end of the last complete record
+     *
+     * @return  Size (bytes)
+     */
+    size_t getValidSize() const { return _validSize; }
+
+    /**
+     * @brief Visit trajectories overlapping a time range
+     *
+     * @param callback Called with each trajectory
+     * @param fromNs Range begin (Unix time, ns)
+     * @param toNs Range end (Unix time, ns)
+     * @return  Number of visited trajectories
+     */
+    size_t forEachTrajectory(
+        const TrajectoryCallback& callback,
+        int64_t fromNs = std::numeric_limits<int64_t>::min(),
+        int64_t toNs = std::numeric_limits<int64_t>::max()) const;
+
+    /**
+     * @brief Visit metadata records
+     *
+     * @param callback Called with each {key, value}
+     * @return
+     */
+    void forEachMetadata(const MetadataCallback& callback) const;
+
+#pragma endregion
+
+  private:
+#pragma region Private member variables
+
+    const uint8_t* _data = nullptr;
+    size_t _size = 0;
+    size_t _validSize = 0;
+    bool _isValid = false;
+
+#pragma endregion
+
+#pragma region Private member methods
+
+    /**
+     * @brief Get the record at an offset
+     *
+     * @param offset Record offset
+     * @return  Record header, nullptr if the record is incomplete
+     */
+    const EventRecordHeader* getRecord(size_t offset) const;
+
+    /**
+     * @brief Get the end of a trajectory record and its samples
+     *
+     * @param offset Trajectory record offset
+     * @param header Trajectory record header
+     * @return  End offset, 0 if a sample is missing
+     */
+    size_t getTrajectoryEnd(size_t offset,
+                            const EventRecordHeader* header) const;
+
+    /**
+     * @brief Get the offset of the record following one
+     *
+     * @param offset Record offset
+     * @param header Record header
+     * @return  Next record offset
+     */
+    static size_t getNextOffset(size_t offset,
+                                const EventRecordHeader* header) {
+        return offset + sizeof(EventRecordHeader) +
+               EventLog::getPaddedSize(header->size);
+    }
+
+#pragma endregion
+};
@@ -0,0 +1,157 @@
+/**
+ * @file event_log_writer.cpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Buffered append-only writer of binary event logs
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "event_log_writer.hpp"
+
+#include "event_log_reader.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+int64_t toUnixNs(Trajectory::Timestamp timestamp) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               timestamp.time_since_epoch())
+        .count();
+}
+
+/**
+ * @brief Get the size of a record in the log
+ *
+ * @param size Payload size
+ * @return  Record size with its header and padding
+ */
+size_t getRecordSize(size_t size) {
+    return sizeof(EventRecordHeader) + EventLog::getPaddedSize(size);
+}
+
+/**
+ * @brief Serialize a record, the padding is left zeroed
+ *
+ * @param data Output bytes, getRecordSize(size) of them
+ * @param type Record type
+ * @param payload Payload
+ * @param size Payload size
+ * @return  Bytes after the record
+ */
+uint8_t* writeRecord(uint8_t* data,
+                     EventRecordType type,
+                     const void* payload,
+                     size_t size) {
+    auto header = EventRecordHeader{
+        .type = type,
+        .reserved = 0,
+        .size = static_cast<uint32_t>(size),
+    };
+
+    std::memcpy(data, &header, sizeof(header));
+    std::memcpy(data + sizeof(header), payload, size);
+    return data + getRecordSize(size);
+}
+
+} // namespace
+
+EventLogWriter::EventLogWriter(const std::string& path,
+                               const EventLogWriterParams& params)
+    : _file(AppendFileParams{
+          .flushIntervalMs = params.flushIntervalMs,
+          .syncIntervalMs = params.syncIntervalMs,
+          .bufferSize = params.bufferSize,
+          .maxBufferSize = 0,
+      }) {
+    if (!open(path)) {
+        std::printf("[EVENT LOG] Cannot open %s\n", path.c_str());
+    }
+}
+
+EventLogWriter::~EventLogWriter() = default;
+
+void EventLogWriter::writeMetadata(const std::string& key,
+                                   const std::string& value) {
+    if (!isOpened()) {
+        return;
+    }
+
+    // key '\0' value '\0'
+    auto payload = std::vector<char>(key.size() + value.size() + 2, '\0');
+    std::memcpy(payload.data(), key.data(), key.size());
+    std::memcpy(payload.data() + key.size() + 1, value.data(), value.size());
+
+    _file.append(getRecordSize(payload.size()), [&payload](uint8_t* data) {
+        writeRecord(
+            data, EventRecordType::METADATA, payload.data(), payload.size());
+    });
+}
+
+void EventLogWriter::writeTrajectory(int tag, const Trajectory& trajectory) {
+    const auto& samples = trajectory.getSamples();
+    if (!isOpened() || samples.empty()) {
+        return;
+    }
+
+    auto record = TrajectoryRecord{
+        .startTimeNs = toUnixNs(samples.front().timestamp),
+        .endTimeNs = toUnixNs(samples.back().timestamp),
+        .tag = tag,
+        .numSamples = static_cast<uint32_t>(samples.size()),
+        .rangeX = trajectory.getRangeX(),
+        .rangeY = trajectory.getRangeY(),
+        .frameWidth = static_cast<uint32_t>(trajectory.getFrameSize().width),
+        .frameHeight =
+            static_cast<uint32_t>(trajectory.getFrameSize().height),
+    };
+
+    // The trajectory and its samples in one append, never split by a flush
+    size_t size = getRecordSize(sizeof(record)) +
+                  getRecordSize(sizeof(SampleRecord)) * samples.size();
+    _file.append(size, [&record, &samples](uint8_t* data) {
+        data = writeRecord(
+            data, EventRecordType::TRAJECTORY, &record, sizeof(record));
+
+        for (const auto& sample : samples) {
+            auto sampleRecord = SampleRecord{
+                .timeNs = toUnixNs(sample.timestamp),
+                .x = sample.x,
+                .y = sample.y,
+                .width = sample.width,
+                .height = sample.height,
+                .xVelocity = sample.xVelocity,
+                .yVelocity = sample.yVelocity,
+            };
+            data = writeRecord(data,
+                               EventRecordType::SAMPLE,
+                               &sampleRecord,
+                               sizeof(sampleRecord));
+        }
+    });
+}
+
+bool EventLogWriter::open(const std::string& path) {
+    // Find the end of the last complete record of an existing log
+    auto validSize = size_t(0);
+    if (::access(path.c_str(), F_OK) == 0) {
+        auto reader = EventLogReader(path);
+        if (!reader.isOpened()) {
+            return false;
+        }
+        validSize = reader.getValidSize();
+    }
+
+    auto header = EventLogHeader{};
+    std::memcpy(header.magic, EventLog::MAGIC, sizeof(header.magic));
+    header.version = EventLog::VERSION;
+
+    return _file.open(path, validSize, &header, sizeof(header));
+}
@@ -0,0 +1,123 @@
+/**
+ * @file event_log_writer.hpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Buffered append-only writer of binary event logs
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+
+#include "append_file.hpp"
+#include "event_log.hpp"
+#include "trajectory.hpp"
+
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Additional parameters for EventLogWriter class
+ */
+struct EventLogWriterParams {
+    /**
+     * @brief Interval between two writes of buffered records (ms)
+     */
+    int flushIntervalMs = 1000;
+
+    /**
+     * @brief Interval between two syncs of written records to storage (ms)
+     */
+    int syncIntervalMs = 30000;
+
+    /**
+     * @brief Initial capacity of the record buffer (bytes)
+     */
+    size_t bufferSize = 64 * 1024;
+};
+
+/**
+ * @brief Appends records to an event log.
+ *        Records are serialized into the buffer of an AppendFile by the
+ *        caller, its background thread writes them out.
+ */
+class EventLogWriter final {
+  public:
+#pragma region Public member methods
+
+    /**
+     * @brief Construct a new EventLogWriter object, the log is created or
+     * appended to
+     *
+     * @param path Log file path
+     * @param params Additional parameters
+     */
+    explicit EventLogWriter(
+        const std::string& path,
+        const EventLogWriterParams& params = EventLogWriterParams());
+
+    /**
+     * @brief Destroy the EventLogWriter object, buffered records are written
+     * and synced
+     */
+    ~EventLogWriter();
+
+    EventLogWriter(const EventLogWriter&) = delete;
+    EventLogWriter& operator=(const EventLogWriter&) = delete;
+
+    /**
+     * @brief Tells whether the log is opened
+     *
+     * @return  True: Opened
+     */
+    bool isOpened() const { return _file.isOpened(); }
+
+    /**
+     * @brief Append a metadata record
+     *
+     * @param key Key
+     * @param value Value
+     * @return
+     */
+    void writeMetadata(const std::string& key, const std::string& value);
+
+    /**
+     * @brief Append an ended trajectory and its samples
+     *
+     * @param tag Tracker tag
+     * @param trajectory Trajectory
+     * @return
+     */
+    void writeTrajectory(int tag, const Trajectory& trajectory);
+
+    /**
+     * @brief Write buffered records now
+     *
+     * @param sync Also sync the file to storage
+     * @return
+     */
+    void flush(bool sync = false) { _file.flush(sync); }
+
+#pragma endregion
+
+  private:
+#pragma region Private member variables
+
+    AppendFile _file;
+
+#pragma endregion
+
+#pragma region Private member methods
+
+    /**
+     * @brief Open the log, writing a file header to a new log and dropping a
+     * partial record at the end of an existing one
+     *
+     * @param path Log file path
+     * @return  True: Opened
+     */
+    bool open(const std::string& path);
+
+#pragma endregion
+};
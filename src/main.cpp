@@ -8,15 +8,36 @@
  * @copyright Copyright (c) 2020
  *
  */
+#include "analysis_pipeline.hpp"
+#include "attention_scheduler.hpp"
+#include "blob_detector.hpp"
+#include "config.hpp"
+#include "cpu_placement.hpp"
+#include "event_index_writer.hpp"
+#include "event_log_writer.hpp"
+#include "frame_bus.hpp"
+#include "frame_queue.hpp"
+#include "governor.hpp"
+#include "idle_controller.hpp"
+#include "mask_recorder.hpp"
+#include "memory_accountant.hpp"
+#include "memory_governor.hpp"
+#include "metrics.hpp"
+#include "metrics_exporter.hpp"
+#include "preview_sink.hpp"
+#include "snapshot_encoder.hpp"
+#include "trace.hpp"
 #include "tracker.hpp"
 #include "trajectory.hpp"
 #include "utils.hpp"
-#include "vibe_sequential.hpp"
 #include "video_reader.hpp"
 
+#include <algorithm>
 #include <argparse/argparse.hpp>
 #include <array>
+#include <atomic>
 #include <chrono>
+#include <csignal>
 #include <cmath>
 #include <cstddef>
 #include <cstdio>
@@ -113,8 +134,20 @@ static argparse::ArgumentParser getArgParser() {
         });
 
     parser.add_argument("--log")
-        .help("Log tracked objects to file")
-        .default_value("falling_objects_detection_log.json");
+        .help("Append trajectories to this binary event log (empty: disabled), "
+              "read it with fod_event_log")
+        .default_value(std::string("falling_objects_detection.evlog"));
+
+    parser.add_argument("--index")
+        .help("Index trajectories by day and frame region in this directory "
+              "(empty: disabled), query it with fod_event_index")
+        .default_value(std::string(""));
+
+    parser.add_argument("--mask_record")
+        .help("Record the foreground and update masks of every analysed "
+              "frame, run-length encoded, to this file (empty: disabled), "
+              "read it with fod_mask_record")
+        .default_value(std::string(""));
 
     parser.add_argument("--log_interval")
         .help("Number of frames between two logs")
@@ -130,6 +163,158 @@ static argparse::ArgumentParser getArgParser() {
         .default_value(64)
         .action([](const std::string& arg) { return std::stoi(arg); });
 
+    parser.add_argument("--config")
+        .help("YAML / JSON file of tuning parameters, reloaded when it "
+              "changes (empty: built-in defaults)")
+        .default_value(std::string(""));
+
+    parser.add_argument("--bg_engine")
+        .help("Background subtraction implementation (vibe, sigma_delta: "
+              "lighter, for low-end boards)")
+        .default_value(BackgroundSubtractorEngine::VIBE)
+        .action([](const std::string& arg) {
+            return arg == "sigma_delta"
+                       ? BackgroundSubtractorEngine::SIGMA_DELTA
+                       : BackgroundSubtractorEngine::VIBE;
+        });
+
+    parser.add_argument("--blob_engine")
+        .help("Morphology and labelling implementation (native, opencv)")
+        .default_value(BlobDetectorEngine::NATIVE)
+        .action([](const std::string& arg) {
+            return arg == "opencv" ? BlobDetectorEngine::OPENCV
+                                   : BlobDetectorEngine::NATIVE;
+        });
+
+    parser.add_argument("--queue_size")
+        .help("Max number of decoded frames waiting for analysis (the oldest "
+              "is dropped when a live stream falls behind)")
+        .default_value(2)
+        .action([](const std::string& arg) { return std::stoi(arg); });
+
+    parser.add_argument("--frame_bus")
+        .help("Publish decoded frames to this POSIX shared memory object for "
+              "other local processes, e.g. \"/fod_cam0\", always at the "
+              "decoded size whatever the analysis resolution")
+        .default_value(std::string(""));
+
+    parser.add_argument("--frame_bus_slots")
+        .help("Number of frames in the shared memory ring")
+        .default_value(4)
+        .action([](const std::string& arg) { return std::stoi(arg); });
+
+    parser.add_argument("--cpu_placement")
+        .help("Pin pipeline threads to CPUs, e.g. \"capture=0;analysis=1-2;aux=3\"")
+        .default_value(std::string(""));
+
+    parser.add_argument("--capture_rt_priority")
+        .help("SCHED_FIFO priority of the capture thread (0: disabled)")
+        .default_value(0)
+        .action([](const std::string& arg) { return std::stoi(arg); });
+
+    parser.add_argument("--governor")
+        .help("Adapt analysis resolution, ViBe samples and frame rate to hold "
+              "the CPU and latency budget")
+        .default_value(false)
+        .implicit_value(true);
+
+    parser.add_argument("--target_cpu")
+        .help("Governor target share of one core spent in analysis")
+        .default_value(0.7)
+        .action([](const std::string& arg) { return std::stod(arg); });
+
+    parser.add_argument("--target_latency")
+        .help("Governor target end-to-end frame latency (ms)")
+        .default_value(200.0)
+        .action([](const std::string& arg) { return std::stod(arg); });
+
+    parser.add_argument("--memory_budget")
+        .help("Memory budget of the pipeline (MiB, 0: accounting only), "
+              "ViBe samples, analysis resolution and trajectory evidence "
+              "are reduced to hold it")
+        .default_value(0)
+        .action([](const std::string& arg) { return std::stoi(arg); });
+
+    parser.add_argument("--idle_after")
+        .help("Analyse at a reduced rate after the scene has been static for "
+              "this long (seconds, 0: disabled)")
+        .default_value(0.0)
+        .action([](const std::string& arg) { return std::stod(arg); });
+
+    parser.add_argument("--idle_stride")
+        .help("Analyse one of every n frames while idle")
+        .default_value(5)
+        .action([](const std::string& arg) { return std::stoi(arg); });
+
+    parser.add_argument("--attention_interval")
+        .help("Analyse the whole frame once every n frames, only windows "
+              "around the predicted tracks in between (1: disabled)")
+        .default_value(1)
+        .action([](const std::string& arg) { return std::stoi(arg); });
+
+    parser.add_argument("--attention_margin")
+        .help("Margin around the predicted tracks of attention windows (px)")
+        .default_value(24)
+        .action([](const std::string& arg) { return std::stoi(arg); });
+
+    parser.add_argument("--preview_fps")
+        .help("Max number of previewed frames per second (0: disabled, "
+              "default: 10 with windows, one per log interval of verbose "
+              "headless builds)")
+        .default_value(-1.0)
+        .action([](const std::string& arg) { return std::stod(arg); });
+
+    parser.add_argument("--preview_scale")
+        .help("Preview resolution relative to the analysis resolution")
+        .default_value(0.5)
+        .action([](const std::string& arg) { return std::stod(arg); });
+
+    parser.add_argument("--encoder_threads")
+        .help("Number of threads encoding and writing images")
+        .default_value(1)
+        .action([](const std::string& arg) { return std::stoi(arg); });
+
+    parser.add_argument("--encoder_queue_size")
+        .help("Max number of images waiting to be written (debug images are "
+              "dropped beyond)")
+        .default_value(8)
+        .action([](const std::string& arg) { return std::stoi(arg); });
+
+    parser.add_argument("--jpeg_quality")
+        .help("JPEG quality of written images (0 - 100)")
+        .default_value(90)
+        .action([](const std::string& arg) { return std::stoi(arg); });
+
+    parser.add_argument("--png_compression")
+        .help("PNG compression level of written images (0 - 9)")
+        .default_value(1)
+        .action([](const std::string& arg) { return std::stoi(arg); });
+
+    parser.add_argument("--metrics_file")
+        .help("Periodically export runtime metrics to file (Prometheus text)")
+        .default_value(std::string(""));
+
+    parser.add_argument("--metrics_interval")
+        .help("Interval between two metrics file exports (seconds)")
+        .default_value(10)
+        .action([](const std::string& arg) { return std::stoi(arg); });
+
+    parser.add_argument("--metrics_port")
+        .help("Serve runtime metrics on http://127.0.0.1:<port> (0: disabled)")
+        .default_value(0)
+        .action([](const std::string& arg) { return std::stoi(arg); });
+
+    parser.add_argument("--perf_counters")
+        .help("Sample hardware performance counters per stage and print a "
+              "summary on exit (Linux only)")
+        .default_value(false)
+        .implicit_value(true);
+
+    parser.add_argument("--trace")
+        .help("Record stage trace events and write a Chrome/Perfetto JSON trace "
+              "to this path on exit or on SIGUSR1")
+        .default_value(std::string(""));
+
     // clang-format on
 
     return parser;
@@ -162,7 +347,31 @@ int main(int argc, char* argv[]) {
 
     auto outputDir = parser.get("--output");
 
-    int maxNumBlobs = parser.get<int>("--max_blob_count");
+    // Tuning parameters, the config file is read over the command line
+    auto config = PipelineConfig();
+    config.blob.maxNumBlobs = parser.get<int>("--max_blob_count");
+    auto configPath = parser.get("--config");
+    if (!configPath.empty()) {
+        try {
+            config = PipelineConfig::load(configPath, config);
+        } catch (const std::invalid_argument& e) {
+            std::printf("%s\n", e.what());
+            std::exit(EXIT_FAILURE);
+        }
+    }
+
+    auto bgEngine = parser.get<BackgroundSubtractorEngine>("--bg_engine");
+    auto blobEngine = parser.get<BlobDetectorEngine>("--blob_engine");
+
+    CpuPlacement cpuPlacement;
+    try {
+        cpuPlacement =
+            CpuPlacement::parse(parser.get("--cpu_placement"),
+                                parser.get<int>("--capture_rt_priority"));
+    } catch (const std::invalid_argument& e) {
+        std::printf("%s\n", e.what());
+        std::exit(EXIT_FAILURE);
+    }
 
     std::unique_ptr<VideoReader> videoReader;
 
@@ -214,15 +423,114 @@ int main(int argc, char* argv[]) {
     logInterval =
         (logInterval == 0) ? static_cast<size_t>(std::round(fps)) : logInterval;
 
-    // Create vibe algorithm instance
-    auto vibe = std::make_unique<ViBeSequential>(height, width, 14, 20, 2, 5);
-    // Create tracker instance
-    auto tracker = std::make_unique<SortTracker>(3, 3);
+    // Memory budget of this camera, checked between frames
+    int memoryBudgetMiB = std::max(parser.get<int>("--memory_budget"), 0);
+    auto memoryGovernor = MemoryGovernor(MemoryGovernorParams{
+        .budgetBytes = static_cast<size_t>(memoryBudgetMiB) << 20U,
+    });
+
+    // Create the analysis stages: background subtraction, blob detection
+    // and tracking. Attention windows: between full-frame passes, only the
+    // surroundings of the tracks predicted by the tracker are analysed.
+    auto pipeline = AnalysisPipeline(
+        height,
+        width,
+        config,
+        AnalysisPipelineParams{
+            .blobEngine = blobEngine,
+            .bgEngine = bgEngine,
+            .attention =
+                AttentionSchedulerParams{
+                    .fullFrameInterval =
+                        parser.get<int>("--attention_interval"),
+                    .windowMargin = parser.get<int>("--attention_margin"),
+                },
+        });
+
+    // Images are encoded and written off the analysis thread
+    auto snapshotEncoder = SnapshotEncoder(SnapshotEncoderParams{
+        .numWorkers = parser.get<int>("--encoder_threads"),
+        .capacity = parser.get<int>("--encoder_queue_size"),
+        .jpegQuality = parser.get<int>("--jpeg_quality"),
+        .pngCompression = parser.get<int>("--png_compression"),
+    });
+
+    // Persist ended trajectories
+    std::unique_ptr<EventLogWriter> eventLog;
+    if (auto logPath = parser.get("--log"); !logPath.empty()) {
+        eventLog = std::make_unique<EventLogWriter>(logPath);
+        if (eventLog->isOpened()) {
+            eventLog->writeMetadata("source",
+                                    isLocalFile ? file
+                                                : parser.get("--addr") + "/" +
+                                                      file);
+            eventLog->writeMetadata("frame_size",
+                                    std::to_string(width) + "x" +
+                                        std::to_string(height));
+            eventLog->writeMetadata("fps", std::to_string(fps));
+            eventLog->writeMetadata(
+                "start_time",
+                std::to_string(std::chrono::duration_cast<std::chrono::seconds>(
+                                   std::chrono::system_clock::now()
+                                       .time_since_epoch())
+                                   .count()));
+        } else {
+            eventLog.reset();
+        }
+    }
+
+    // Index ended trajectories for region and time range queries
+    std::unique_ptr<EventIndexWriter> eventIndex;
+    if (auto indexDir = parser.get("--index"); !indexDir.empty()) {
+        eventIndex = std::make_unique<EventIndexWriter>(indexDir);
+        if (!eventIndex->isOpened()) {
+            eventIndex.reset();
+        }
+    }
+
+    // Record masks of every analysed frame for offline debugging
+    std::unique_ptr<MaskRecorder> maskRecorder;
+    if (auto recordPath = parser.get("--mask_record"); !recordPath.empty()) {
+        maskRecorder = std::make_unique<MaskRecorder>(recordPath);
+        if (!maskRecorder->isOpened()) {
+            maskRecorder.reset();
+        }
+    }
 
     // Register callback for tracker
     cv::Mat anno;
-    tracker->setTrajectoryEndedCallback(
-        [&outputDir, &anno, isVerbose](int tag, const Trajectory& trajectory) {
+    pipeline.getTracker().setTrajectoryEndedCallback(
+        [&outputDir,
+         &anno,
+         &snapshotEncoder,
+         &eventLog,
+         &eventIndex,
+         isVerbose](int tag, const Trajectory& trajectory) {
+            if (eventLog) {
+                eventLog->writeTrajectory(tag, trajectory);
+            }
+
+            if (eventIndex) {
+                auto frameSize = trajectory.getFrameSize();
+                auto entry = EventIndex::makeEntry(
+                    tag,
+                    static_cast<uint32_t>(frameSize.width),
+                    static_cast<uint32_t>(frameSize.height));
+                for (const auto& sample : trajectory.getSamples()) {
+                    auto timeNs =
+                        std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            sample.timestamp.time_since_epoch())
+                            .count();
+                    EventIndex::addSample(entry,
+                                          timeNs,
+                                          sample.x,
+                                          sample.y,
+                                          sample.width,
+                                          sample.height);
+                }
+                eventIndex->add(entry);
+            }
+
             // Draw trajectory on annotated image
             trajectory.draw(anno);
             auto timestamp =
@@ -241,7 +549,10 @@ int main(int argc, char* argv[]) {
             }
 
 #if defined(ROCKCHIP_PLATFORM)
-            cv::imwrite(str.data(), anno);
+            // The annotation shares the trajectory's first frame, which is
+            // not reused while the encoder holds it
+            snapshotEncoder.submit(
+                str.data(), std::move(anno), SnapshotPriority::HIGH);
 #else
             cv::imshow(str.data(), anno);
             cv::waitKey();
@@ -249,140 +560,591 @@ int main(int argc, char* argv[]) {
 #endif
         });
 
-    auto detections = std::vector<cv::Rect2f>(8);
-    cv::Mat fgMask(height, width, CV_8U);
-    cv::Mat updateMask(height, width, CV_8U);
-    cv::Mat fgBlobLabels(height, width, CV_32S);
-    cv::Mat fgBlobCentroids(64, 2, CV_64F);
-    cv::Mat fgBlobStats(64, 5, CV_32S);
+    // Prepare runtime metrics
+    auto& metrics = MetricsRegistry::instance();
+    auto& decodeLatency =
+        metrics.histogram("fod_stage_decode", "Frame read and decode latency");
+    auto& segmentLatency = metrics.histogram(
+        "fod_stage_segment", "Background segmentation latency");
+    auto& updateMaskLatency = metrics.histogram(
+        "fod_stage_update_mask", "Update mask morphology latency");
+    auto& filterLatency = metrics.histogram(
+        "fod_stage_filter", "Foreground mask open / close filter latency");
+    auto& updateLatency = metrics.histogram(
+        "fod_stage_update", "Background model update latency");
+    auto& labellingLatency = metrics.histogram(
+        "fod_stage_labelling", "Connected components labelling latency");
+    auto& trackingLatency =
+        metrics.histogram("fod_stage_tracking", "SORT tracker update latency");
+    auto& frameLatency = metrics.histogram(
+        "fod_frame_process", "Total per-frame processing latency");
+    pipeline.setStageHistograms(AnalysisPipeline::StageHistograms{
+        &segmentLatency,
+        &updateMaskLatency,
+        &updateLatency,
+        &filterLatency,
+        &labellingLatency,
+        &trackingLatency,
+    });
+
+    auto& framesCounter =
+        metrics.counter("fod_frames_total", "Number of frames analysed");
+    auto& droppedFramesCounter = metrics.counter(
+        "fod_frames_dropped_total",
+        "Number of frames dropped for having too many foreground blobs");
+    auto& blobsCounter = metrics.counter(
+        "fod_blobs_total", "Number of foreground blobs detected");
+    auto& activeTracksGauge =
+        metrics.gauge("fod_active_tracks", "Number of tracked bboxes");
+    auto& activeTrajectoriesGauge = metrics.gauge(
+        "fod_active_trajectories", "Number of trajectories in progress");
+    auto& captureDroppedCounter = metrics.counter(
+        "fod_capture_dropped_total",
+        "Number of decoded frames dropped because analysis fell behind");
+    auto& queueDepthGauge =
+        metrics.gauge("fod_capture_queue_depth",
+                      "Number of decoded frames waiting for analysis");
+
+    auto& snapshotsDroppedCounter = metrics.counter(
+        "fod_snapshots_dropped_total",
+        "Number of debug images dropped because the encoder was saturated");
+
+    auto& governorLevelGauge = metrics.gauge(
+        "fod_governor_level", "Governor degradation level (0: full quality)");
+    auto& memoryLevelGauge = metrics.gauge(
+        "fod_memory_level",
+        "Memory budget degradation level (0: full quality)");
+
+    auto& idleGauge = metrics.gauge(
+        "fod_idle", "Whether analysis is idle for a static scene (0 or 1)");
+    auto& idleSkippedCounter = metrics.counter(
+        "fod_frames_idle_skipped_total",
+        "Number of frames not analysed while the scene was static");
+    auto& windowedCounter = metrics.counter(
+        "fod_frames_windowed_total",
+        "Number of frames analysed in attention windows only");
+    auto& maskRecordsDroppedCounter = metrics.counter(
+        "fod_mask_records_dropped_total",
+        "Number of frames whose masks were not recorded because storage "
+        "fell behind");
+    auto& emptyFramesCounter = metrics.counter(
+        "fod_frames_empty_total",
+        "Number of analysed frames without foreground, post-processing "
+        "skipped");
+
+    // Threads created from here on (metrics export) inherit the aux CPU set
+    if (!cpuPlacement.empty()) {
+        cpuPlacement.apply(PipelineRole::AUX);
+    }
 
-    // Prepare structure elements for morphological filtering
-    cv::Mat se3x3 = cv::getStructuringElement(cv::MORPH_ELLIPSE, {3, 3});
-    cv::Mat se5x5 = cv::getStructuringElement(cv::MORPH_ELLIPSE, {5, 5});
-    cv::Mat se7x7 = cv::getStructuringElement(cv::MORPH_ELLIPSE, {7, 7});
+    auto metricsExporter = MetricsExporter(
+        metrics,
+        MetricsExporterParams{
+            .filePath = parser.get("--metrics_file"),
+            .fileIntervalMs = parser.get<int>("--metrics_interval") * 1000,
+            .httpPort = static_cast<uint16_t>(parser.get<int>("--metrics_port")),
+        });
+    metricsExporter.start();
+    snapshotEncoder.start();
 
-    // Prepare runtime measurement
-    auto tm = cv::TickMeter();
+    std::unique_ptr<ConfigWatcher> configWatcher;
+    if (!configPath.empty()) {
+        configWatcher = std::make_unique<ConfigWatcher>(configPath, config);
+        configWatcher->start();
+    }
+
+    // Preview is rendered on its own thread (in the aux CPU set), windows are
+    // shown from the main thread
+    double previewFps = parser.get<double>("--preview_fps");
+    if (previewFps < 0.0) {
+#if defined(ROCKCHIP_PLATFORM)
+        previewFps = isVerbose ? fps / static_cast<double>(logInterval) : 0.0;
+#else
+        previewFps = 10.0;
+#endif
+    }
+
+    std::unique_ptr<PreviewSink> preview;
+    if (previewFps > 0.0) {
+        preview = std::make_unique<PreviewSink>(PreviewSinkParams{
+            .fps = previewFps,
+            .scale = parser.get<double>("--preview_scale"),
+#if defined(ROCKCHIP_PLATFORM)
+            .outputDir = outputDir,
+            .encoder = &snapshotEncoder,
+#endif
+        });
+        preview->start();
+    }
+
+    // Hardware performance counters are attributed by the stage timers
+    if (parser.get<bool>("--perf_counters") &&
+        !PerfCounters::instance().enable()) {
+        std::printf("[PERF COUNTERS] perf_event_open is not available\n");
+    }
+
+    // Prepare trace recording
+    auto tracePath = parser.get("--trace");
+    if (!tracePath.empty()) {
+        Tracer::setEnabled(true);
+        Tracer::installFlushSignal(SIGUSR1);
+        Tracer::instance().setThreadName("analysis");
+    }
 
     // auto colors = Utils::getRandomColors<32>();
 
-    // Start play
-    auto frame = cv::Mat(height, width, CV_8UC3);
-    while (videoReader->read(frame)) {
+    // Decode on a dedicated capture thread, frames are decoded directly into
+    // preallocated slots and handed over to the analysis (this) thread
+    auto frameQueue = FrameQueue(height,
+                                 width,
+                                 CV_8UC3,
+                                 parser.get<int>("--queue_size"),
+                                 !isLocalFile);
+
+    // Governor of analysis quality, the capture thread applies the requested
+    // resolution and the analysis thread the rest
+    bool isGovernorEnabled = parser.get<bool>("--governor");
+    auto governor = Governor(GovernorParams{
+        .targetCpuShare = parser.get<double>("--target_cpu"),
+        .targetLatencyMs = parser.get<double>("--target_latency"),
+        .numSamples = pipeline.getNumSamples(),
+        .minNumSamples = pipeline.getMinNumSamples(),
+    });
+
+    // Analysis resolution: the lower of the CPU and the memory budget ones
+    auto getAnalysisScale = [&]() {
+        return config.analysis.scale *
+               std::min(governor.getSettings().scale,
+                        memoryGovernor.getSettings().scale);
+    };
+    std::atomic<float> requestedScale{getAnalysisScale()};
+
+    // Decoded frames are shared with other analysers on this host, they
+    // never slow down capture
+    std::unique_ptr<FrameBusPublisher> frameBus;
+    if (auto frameBusName = parser.get("--frame_bus"); !frameBusName.empty()) {
+        frameBus = std::make_unique<FrameBusPublisher>(
+            frameBusName,
+            static_cast<size_t>(height) * width * 3,
+            parser.get<int>("--frame_bus_slots"));
+    }
 
-#if defined(ROCKCHIP_PLATFORM)
-        using namespace std::chrono_literals;
-        std::this_thread::sleep_for(16ms);
-#else
-        if (cv::waitKey(16) == static_cast<int>('q')) {
-            if (isVerbose) {
-                std::printf("[STOP REQUESTED]\n");
-            }
-            break;
+    auto captureThread = std::thread([&]() {
+        if (!cpuPlacement.empty()) {
+            cpuPlacement.apply(PipelineRole::CAPTURE);
+        }
+        if (Tracer::isEnabled()) {
+            Tracer::instance().setThreadName("capture");
         }
-#endif
 
-        /* Segmentation and update. */
-        tm.reset();
-        tm.start();
+        auto captureTimer = StageTimer();
+        uint64_t numDropped = 0;
+        float appliedScale = 1.0F;
+        auto analysisSize = cv::Size(width, height);
 
-        // Run background segmentation with ViBe
-        vibe->segment(frame, fgMask);
+        // Frame bus readers always get the decoded size, analysis frames are
+        // then scaled from it instead of by the decoder
+        cv::Mat fullFrame;
+        if (frameBus) {
+            fullFrame.create(height, width, CV_8UC3);
+        }
 
-        // Process update mask
-        cv::morphologyEx(fgMask, updateMask, cv::MORPH_OPEN, se3x3);
+        while (auto* slot = frameQueue.beginWrite()) {
+            if (float scale = requestedScale.load(); scale != appliedScale) {
+                // Keep sizes even for the scalers
+                analysisSize = cv::Size(static_cast<int>(width * scale) & ~1,
+                                        static_cast<int>(height * scale) & ~1);
+                if (!frameBus) {
+                    videoReader->setResize(analysisSize);
+                }
+                appliedScale = scale;
+            }
 
-        // Update ViBe
-        vibe->update(frame, updateMask);
+            // Slots only reallocate when the output size has changed
+            slot->create(analysisSize, CV_8UC3);
+            bool isScaled = frameBus && analysisSize != fullFrame.size();
 
-        // Post-processing on foreground mask
-        cv::morphologyEx(fgMask, fgMask, cv::MORPH_OPEN, se3x3);
-        cv::morphologyEx(fgMask, fgMask, cv::MORPH_CLOSE, se5x5);
+            captureTimer.reset();
+            if (!videoReader->read(isScaled ? fullFrame : *slot)) {
+                break;
+            }
+            if (isScaled) {
+                cv::resize(
+                    fullFrame, *slot, analysisSize, 0, 0, cv::INTER_AREA);
+            }
+            captureTimer.lap(decodeLatency);
+
+            if (frameBus) {
+                auto timestamp = std::chrono::duration_cast<
+                    std::chrono::nanoseconds>(
+                    std::chrono::system_clock::now().time_since_epoch());
+                frameBus->publish(isScaled ? fullFrame : *slot,
+                                  timestamp.count());
+            }
 
-        tm.stop();
+            frameQueue.endWrite();
 
-        double vibeProcessTimeMs = tm.getTimeMilli();
+            if (uint64_t n = frameQueue.getNumDropped(); n > numDropped) {
+                captureDroppedCounter.increment(n - numDropped);
+                numDropped = n;
+            }
+        }
 
-        // Find all connected components
-        int numFgBlobs = cv::connectedComponentsWithStats(
-            fgMask, fgBlobLabels, fgBlobStats, fgBlobCentroids);
+        frameQueue.close();
+    });
 
-        if (numFgBlobs > maxNumBlobs) {
-            // Too many blobs, consider this frame invalid
+    if (!cpuPlacement.empty()) {
+        cpuPlacement.apply(PipelineRole::ANALYSIS);
+    }
 
-#if !defined(ROCKCHIP_PLATFORM)
-            cv::imshow("frame", frame);
-            cv::imshow("fgmask", fgMask);
-            cv::imshow("update mask", updateMask);
-#endif
+    // Idle duty-cycling: every frame is probed, full analysis runs at a
+    // reduced rate while the scene stays static
+    double idleAfterSec = parser.get<double>("--idle_after");
+    bool isIdleEnabled = idleAfterSec > 0.0;
+    auto idleController = IdleController(
+        fps,
+        IdleControllerParams{
+            .idleAfterSec = idleAfterSec,
+            .idleStride = parser.get<int>("--idle_stride"),
+        });
 
-            tracker->clear();
-            continue;
+    // Memory of this camera's pipeline, components are asked between frames
+    auto memoryAccountant = MemoryAccountant(&metrics);
+    memoryAccountant.add("video_reader",
+                         [&]() { return videoReader->getMemoryUsage(); });
+    memoryAccountant.add("frame_queue",
+                         [&]() { return frameQueue.getMemoryUsage(); });
+    memoryAccountant.add(
+        "bgsegm", [&]() { return pipeline.getSubtractor().getMemoryUsage(); });
+    memoryAccountant.add("detection", [&]() {
+        return pipeline.getBlobDetector().getMemoryUsage() +
+               pipeline.getFgMask().total() + pipeline.getUpdateMask().total();
+    });
+    memoryAccountant.add(
+        "tracker", [&]() { return pipeline.getTracker().getMemoryUsage(); });
+    memoryAccountant.add("idle",
+                         [&]() { return idleController.getMemoryUsage(); });
+
+    // Sample steps of the governor follow the background model: call after
+    // the model is rebuilt or its min sample count changes
+    auto applyGovernorSamples = [&]() {
+        bool isChanged = governor.setNumSamples(pipeline.getNumSamples(),
+                                                pipeline.getMinNumSamples());
+        if (isGovernorEnabled) {
+            pipeline.setNumActiveSamples(governor.getSettings().numSamples);
+        }
+        if (isChanged) {
+            requestedScale.store(getAnalysisScale());
+            governorLevelGauge.set(governor.getLevel());
+        }
+    };
+
+    // Apply a memory budget step between two frames. A new sample cap
+    // rebuilds the background model, a new scale goes through the
+    // resolution change below.
+    auto applyMemorySettings = [&]() {
+        const auto& settings = memoryGovernor.getSettings();
+        pipeline.getTracker().setCropOnlyEvidence(settings.isCropOnly);
+        requestedScale.store(getAnalysisScale());
+
+        if (pipeline.setMaxNumSamples(settings.maxNumSamples)) {
+            applyGovernorSamples();
         }
 
-        detections.clear();
-        for (int i = 1; i < numFgBlobs; i++) {
-            auto* blobStat = fgBlobStats.ptr<int>(i);
+        memoryLevelGauge.set(memoryGovernor.getLevel());
+    };
 
-            int x = blobStat[cv::CC_STAT_LEFT] - 6;
-            int y = blobStat[cv::CC_STAT_TOP] - 6;
-            int w = blobStat[cv::CC_STAT_WIDTH] + 12;
-            int h = blobStat[cv::CC_STAT_HEIGHT] + 12;
-            // int a = blobStat[cv::CC_STAT_AREA];
+    auto governFrame = [&](uint64_t busyNs) {
+        if (!isGovernorEnabled) {
+            return;
+        }
 
-            // Add new bbox
-            detections.emplace_back(x, y, w, h);
+        auto now = Governor::Clock::now();
+        auto latencyNs = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                now - frameQueue.getReadyTime())
+                .count());
+
+        if (governor.update(busyNs, latencyNs, now)) {
+            const auto& settings = governor.getSettings();
+            requestedScale.store(getAnalysisScale());
+            pipeline.setNumActiveSamples(settings.numSamples);
+            governorLevelGauge.set(governor.getLevel());
+        }
+    };
+
+    // Apply a reloaded config between two frames. Thresholds take effect in
+    // place; a new ViBe sample count rebuilds the background model and a new
+    // scale goes through the resolution change below.
+    auto applyConfig = [&](const PipelineConfig& newConfig) {
+        config = newConfig;
+        if (pipeline.setConfig(config)) {
+            std::printf("[CONFIG] Background model rebuilt with %d samples\n",
+                        pipeline.getNumSamples());
+        }
 
-            // auto color = colors.row(i % colors.rows);
-            cv::rectangle(frame, {x, y, w, h}, {255, 50, 0}, 1);
+        applyGovernorSamples();
+        requestedScale.store(getAnalysisScale());
+    };
+
+    auto frameTimer = StageTimer();
+    size_t frameCount = 0;
+
+    // Copy a sampled frame and its analysis results to the preview, the
+    // analysis buffers are never drawn on
+    auto submitPreview = [&](const cv::Mat& frame,
+                             bool isValid,
+                             const char* caption) {
+        auto now = PreviewSink::Clock::now();
+        if (!preview || !preview->isDue(now)) {
+            return;
         }
 
-        tm.reset();
-        tm.start();
+        auto& snapshot = preview->beginSubmit(now);
+        frame.copyTo(snapshot.frame);
+        pipeline.getFgMask().copyTo(snapshot.fgMask);
+        pipeline.getUpdateMask().copyTo(snapshot.updateMask);
+        snapshot.detections = pipeline.getDetections();
+        pipeline.getTracker().getTracks(snapshot.tracks);
+        std::snprintf(snapshot.caption.data(),
+                      snapshot.caption.size(),
+                      "%s",
+                      caption != nullptr ? caption : "");
+        snapshot.isValid = isValid;
+        preview->endSubmit();
+    };
+
+    // Full analysis of one frame
+    auto analyseFrame = [&](cv::Mat& frame, SortTracker::Timestamp timestamp) {
+        frameTimer.reset();
+        framesCounter.increment();
+
+        // Segmentation, update and labelling, on the whole frame or only on
+        // windows around the predicted tracks
+        bool isValid = pipeline.detect(frame);
+        int numFgBlobs = pipeline.getNumBlobs();
+        if (!pipeline.isFullFrame()) {
+            windowedCounter.increment();
+        }
+        if (pipeline.isEmpty()) {
+            emptyFramesCounter.increment();
+        }
+        blobsCounter.increment(numFgBlobs);
+
+        if (maskRecorder) {
+            uint32_t flags =
+                pipeline.isFullFrame() ? 0U : MASK_RECORD_WINDOWED;
+            if (!isValid) {
+                flags |= MASK_RECORD_INVALID;
+            }
+            if (!maskRecorder->record(
+                    pipeline.getFgMask(), pipeline.getUpdateMask(), flags)) {
+                maskRecordsDroppedCounter.increment();
+            }
+        }
+
+        if (!isValid) {
+            // Too many blobs, consider this frame invalid, the tracker is
+            // cleared
+
+            submitPreview(frame, false, nullptr);
+
+            pipeline.track(frame, timestamp);
+            droppedFramesCounter.increment();
+            governFrame(frameTimer.lap(frameLatency));
+            if (isIdleEnabled) {
+                idleController.onAnalysed(1.0);
+                idleGauge.set(0);
+            }
+            return;
+        }
 
         // Update tracker with newly detected bboxes
-        tracker->update(detections, frame);
+        pipeline.track(frame, timestamp);
+
+        governFrame(frameTimer.lap(frameLatency));
+        const auto& tracker = pipeline.getTracker();
+        activeTracksGauge.set(static_cast<int64_t>(tracker.getNumTracks()));
+        activeTrajectoriesGauge.set(
+            static_cast<int64_t>(tracker.getNumTrajectories()));
+
+        if (isIdleEnabled) {
+            int fgArea = 0;
+            for (const auto& blob : pipeline.getBlobDetector().getBlobs()) {
+                fgArea += blob.area;
+            }
+            idleController.onAnalysed(static_cast<double>(fgArea) /
+                                      (frame.rows * frame.cols));
+            idleGauge.set(idleController.isIdle() ? 1 : 0);
+        }
+
+        bool isLogged = isVerbose && frameCount % logInterval == 0;
+        bool isPreviewed =
+            preview && preview->isDue(PreviewSink::Clock::now());
+        if (!isLogged && !isPreviewed) {
+            return;
+        }
 
-        tm.stop();
-        double trackingTimeMs = tm.getTimeMilli();
+        const auto& times = pipeline.getLastStageTimes();
+        auto getTimeMs = [&times](AnalysisStage stage) {
+            return times[static_cast<size_t>(stage)] * 1e-6;
+        };
 
         std::array<char, 64> str;
         std::sprintf(str.data(),
                      "[PROCESS TIME] ViBe: %.2f ms, Tracking: %.2f",
-                     vibeProcessTimeMs,
-                     trackingTimeMs);
+                     getTimeMs(AnalysisStage::SEGMENT) +
+                         getTimeMs(AnalysisStage::UPDATE_MASK) +
+                         getTimeMs(AnalysisStage::UPDATE) +
+                         getTimeMs(AnalysisStage::FILTER),
+                     getTimeMs(AnalysisStage::TRACKING));
 
-        if (isVerbose && videoReader->getFrameCount() % logInterval == 0) {
+        if (isLogged) {
             std::printf("%s\n", str.data());
         }
 
-        // Draw process time measurement result on current frame
-        cv::putText(frame,
-                    str.data(),
-                    {12, 30},
-                    cv::FONT_HERSHEY_SIMPLEX,
-                    0.5,
-                    {0, 0, 255},
-                    1,
-                    cv::LINE_AA);
+        submitPreview(frame, true, str.data());
+    };
 
-// Draw results
-#if defined(ROCKCHIP_PLATFORM)
-        if (isVerbose && videoReader->getFrameCount() % logInterval == 0) {
-            cv::imwrite(outputDir + "/frame.png", frame);
-            cv::imwrite(outputDir + "/fgmask.png", fgMask);
-            cv::imwrite(outputDir + "/update_mask.png", updateMask);
+    // Start play
+    uint64_t numSnapshotsDropped = 0;
+    auto reloadedConfig = PipelineConfig();
+    while (true) {
+        TRACE_SCOPE("frame");
+
+        if (Tracer::consumeFlushRequest()) {
+            Tracer::instance().flush(tracePath);
+        }
+
+        auto* slot = frameQueue.read();
+        if (slot == nullptr) {
+            break;
+        }
+        auto& frame = *slot;
+        frameCount++;
+
+        // Capture time of the frame: when it was queued, on the system clock
+        auto captureTime =
+            std::chrono::system_clock::now() -
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                FrameQueue::Clock::now() - frameQueue.getReadyTime());
+        queueDepthGauge.set(frameQueue.getDepth());
+
+        if (uint64_t n = snapshotEncoder.getNumDropped();
+            n > numSnapshotsDropped) {
+            snapshotsDroppedCounter.increment(n - numSnapshotsDropped);
+            numSnapshotsDropped = n;
+        }
+
+        // Lowered analysis frame rate
+        if (frameCount % governor.getSettings().frameStride != 0) {
+            continue;
+        }
+
+        if (configWatcher && configWatcher->consume(reloadedConfig)) {
+            applyConfig(reloadedConfig);
+        }
+
+        if (auto now = MemoryGovernor::Clock::now();
+            memoryGovernor.isDue(now) &&
+            memoryGovernor.update(memoryAccountant.sample(), now)) {
+            applyMemorySettings();
+        }
+
+        // Analysis resolution changed, rebuild size-dependent state
+        if (frame.size() != pipeline.getFgMask().size()) {
+            pipeline.resize(frame.rows, frame.cols);
+            applyGovernorSamples();
+
+            std::printf("[GOVERNOR] Analysis resolution: %dx%d\n",
+                        frame.cols,
+                        frame.rows);
+        }
+
+        // While idle, skipped frames are kept and replayed on wake-up so the
+        // beginning of a fall is still tracked
+        auto decision = isIdleEnabled
+                            ? idleController.onFrame(frame, captureTime)
+                            : IdleController::Decision::ANALYSE;
+        switch (decision) {
+        case IdleController::Decision::SKIP:
+            idleSkippedCounter.increment();
+            break;
+        case IdleController::Decision::WAKE:
+            idleGauge.set(0);
+            for (int i = 0; i < idleController.getNumCatchUpFrames(); i++) {
+                auto& catchUpFrame = idleController.getCatchUpFrame(i);
+                if (catchUpFrame.size() == frame.size()) {
+                    analyseFrame(catchUpFrame,
+                                 idleController.getCatchUpTime(i));
+                }
+            }
+            analyseFrame(frame, captureTime);
+            break;
+        case IdleController::Decision::ANALYSE:
+            analyseFrame(frame, captureTime);
+            break;
         }
+
+#if defined(ROCKCHIP_PLATFORM)
+        using namespace std::chrono_literals;
+        std::this_thread::sleep_for(16ms);
 #else
-        cv::imshow("frame", frame);
-        cv::imshow("fgmask", fgMask);
-        cv::imshow("update mask", updateMask);
+        if (preview && preview->present() == static_cast<int>('q')) {
+            if (isVerbose) {
+                std::printf("[STOP REQUESTED]\n");
+            }
+            break;
+        }
 #endif
+
     }
 
+    frameQueue.close();
+    captureThread.join();
+
+    if (preview) {
+        preview->stop();
 #if !defined(ROCKCHIP_PLATFORM)
-    cv::destroyAllWindows();
+        cv::destroyAllWindows();
 #endif
+    }
+
+    // Pending trajectory images are written before exit
+    snapshotEncoder.stop();
+
+    if (maskRecorder) {
+        std::printf("[MASK RECORDER] %llu frames recorded (%.1f KiB), %llu "
+                    "dropped\n",
+                    static_cast<unsigned long long>(
+                        maskRecorder->getNumRecorded()),
+                    maskRecorder->getNumBytes() / 1024.0,
+                    static_cast<unsigned long long>(
+                        maskRecorder->getNumDropped()));
+        maskRecorder.reset();
+    }
+
+    if (isVerbose || memoryGovernor.isEnabled()) {
+        std::printf("[MEMORY] Last accounted (level %d/%d):\n%s",
+                    memoryGovernor.getLevel(),
+                    memoryGovernor.getNumLevels() - 1,
+                    memoryAccountant.summary().c_str());
+    }
+
+    if (configWatcher) {
+        configWatcher->stop();
+    }
+
+    metricsExporter.stop();
+
+    if (PerfCounters::isEnabled()) {
+        std::printf("[PERF COUNTERS]\n%s",
+                    PerfCounters::instance().summary().c_str());
+    }
+
+    if (!tracePath.empty()) {
+        Tracer::instance().flush(tracePath);
+    }
 
     // Done
     return 0;
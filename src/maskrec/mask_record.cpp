@@ -0,0 +1,127 @@
+/**
+ * @file mask_record.cpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Run-length coding of recorded masks
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "mask_record.hpp"
+
+#include <cstring>
+
+namespace {
+
+constexpr uint64_t ALL_SET = ~uint64_t(0);
+
+/**
+ * @brief Append a LEB128 varint
+ *
+ * @param value Value
+ * @param out Output position
+ * @return  Position past the varint
+ */
+uint8_t* putVarint(size_t value, uint8_t* out) {
+    while (value >= 0x80) {
+        *out++ = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    *out++ = static_cast<uint8_t>(value);
+    return out;
+}
+
+/**
+ * @brief Read a LEB128 varint
+ *
+ * @param in Input position, moved past the varint
+ * @param end End of the input
+ * @param value Output value
+ * @return  True: read, False: truncated or too long
+ */
+bool getVarint(const uint8_t*& in, const uint8_t* end, size_t& value) {
+    value = 0;
+    for (int shift = 0; in < end && shift < 64; shift += 7) {
+        uint8_t byte = *in++;
+        value |= static_cast<size_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+size_t MaskRecord::encode(const uint8_t* mask,
+                          size_t numPixels,
+                          uint8_t* codes) {
+    uint8_t* out = codes;
+    size_t i = 0;
+    bool isForeground = false;
+
+    // Runs alternate starting with background, 8 pixels are skipped at a
+    // time inside long runs
+    while (i < numPixels) {
+        size_t begin = i;
+        uint64_t skipped = isForeground ? ALL_SET : 0;
+
+        while (i + 8 <= numPixels) {
+            uint64_t word;
+            std::memcpy(&word, mask + i, sizeof(word));
+            if (word != skipped) {
+                break;
+            }
+            i += 8;
+        }
+
+        while (i < numPixels && (mask[i] != 0) == isForeground) {
+            i++;
+        }
+
+        out = putVarint(i - begin, out);
+        isForeground = !isForeground;
+    }
+
+    return static_cast<size_t>(out - codes);
+}
+
+bool MaskRecord::decode(const uint8_t* codes,
+                        size_t size,
+                        uint8_t* mask,
+                        size_t numPixels) {
+    const uint8_t* in = codes;
+    const uint8_t* end = codes + size;
+    size_t i = 0;
+    bool isForeground = false;
+
+    while (in < end) {
+        size_t length;
+        if (!getVarint(in, end, length) || length > numPixels - i) {
+            return false;
+        }
+
+        std::memset(mask + i, isForeground ? 255 : 0, length);
+        i += length;
+        isForeground = !isForeground;
+    }
+
+    return i == numPixels;
+}
+
+size_t MaskRecord::countForeground(const uint8_t* codes, size_t size) {
+    const uint8_t* in = codes;
+    const uint8_t* end = codes + size;
+    size_t count = 0;
+    bool isForeground = false;
+
+    size_t length;
+    while (getVarint(in, end, length)) {
+        count += isForeground ? length : 0;
+        isForeground = !isForeground;
+    }
+
+    return count;
+}
@@ -0,0 +1,135 @@
+/**
+ * @file mask_record.hpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Run-length encoded mask record file format
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/*
+ * A mask record is a file header followed by one record per analysed frame.
+ * Every record is a MaskRecordHeader followed by the run-length encoded
+ * foreground mask, then the run-length encoded update mask, padded to 8
+ * bytes.
+ *
+ * A mask is encoded in raster order as alternating background and
+ * foreground run lengths, starting with background (possibly a 0 run),
+ * each run length a LEB128 varint. Any non-zero pixel is foreground and
+ * decodes to 255.
+ *
+ * Files are only ever appended to. A record cut short by a crash is the end
+ * of the file, and the writer truncates it before appending again.
+ */
+
+/**
+ * @brief File header of a mask record
+ */
+struct MaskRecordFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+};
+
+/**
+ * @brief Flags of a recorded frame
+ */
+enum MaskRecordFlags : uint32_t {
+    /**
+     * @brief Frame dropped for having too many blobs
+     */
+    MASK_RECORD_INVALID = 1U << 0U,
+
+    /**
+     * @brief Frame analysed in attention windows only
+     */
+    MASK_RECORD_WINDOWED = 1U << 1U,
+};
+
+/**
+ * @brief Header of a recorded frame
+ */
+struct MaskRecordHeader {
+    uint32_t size;       // Payload size (bytes), without padding
+    uint32_t index;      // Record index, gaps are dropped records
+    int64_t timeNs;      // Unix time (ns)
+    uint16_t width;      // Mask size
+    uint16_t height;
+    uint32_t fgSize;     // Foreground mask codes (bytes), update mask follows
+    uint32_t flags;      // MaskRecordFlags
+    uint32_t reserved;
+};
+
+/**
+ * @brief Format constants and run-length coding
+ */
+struct MaskRecord {
+    static constexpr char MAGIC[8] = {'F', 'O', 'D', 'M', 'A', 'S', 'K', 'S'};
+    static constexpr uint32_t VERSION = 1;
+    static constexpr size_t ALIGNMENT = 8;
+
+    /**
+     * @brief Get the size of a record payload padded to the alignment
+     *
+     * @param size Payload size
+     * @return  Padded size
+     */
+    static constexpr size_t getPaddedSize(size_t size) {
+        return (size + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    }
+
+    /**
+     * @brief Get the max size of an encoded mask: a run never takes more
+     * bytes than pixels, except the leading background run
+     *
+     * @param numPixels Number of pixels
+     * @return  Max size (bytes)
+     */
+    static constexpr size_t getMaxEncodedSize(size_t numPixels) {
+        return numPixels + 1;
+    }
+
+    /**
+     * @brief Run-length encode a mask
+     *
+     * @param mask Continuous mask pixels
+     * @param numPixels Number of pixels
+     * @param codes Output codes, getMaxEncodedSize() bytes available
+     * @return  Size of the codes (bytes)
+     */
+    static size_t encode(const uint8_t* mask, size_t numPixels, uint8_t* codes);
+
+    /**
+     * @brief Decode a run-length encoded mask
+     *
+     * @param codes Codes
+     * @param size Size of the codes (bytes)
+     * @param mask Output continuous mask pixels (0 or 255)
+     * @param numPixels Number of pixels
+     * @return  True: decoded, False: corrupted codes
+     */
+    static bool decode(const uint8_t* codes,
+                       size_t size,
+                       uint8_t* mask,
+                       size_t numPixels);
+
+    /**
+     * @brief Count the foreground pixels of a run-length encoded mask,
+     * without decoding it
+     *
+     * @param codes Codes
+     * @param size Size of the codes (bytes)
+     * @return  Number of foreground pixels
+     */
+    static size_t countForeground(const uint8_t* codes, size_t size);
+};
+
+static_assert(sizeof(MaskRecordFileHeader) == 16);
+static_assert(sizeof(MaskRecordHeader) == 32);
+static_assert(sizeof(MaskRecordHeader) % MaskRecord::ALIGNMENT == 0);
@@ -0,0 +1,147 @@
+/**
+ * @file mask_record_cli.cpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief List and export run-length encoded mask records
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "mask_record_reader.hpp"
+
+#include <argparse/argparse.hpp>
+#include <array>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <opencv2/core.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include <string>
+
+/**
+ * @brief Setup command line arguments
+ *
+ * @return argparse::ArgumentParser arg parser
+ */
+static argparse::ArgumentParser getArgParser() {
+    auto parser = argparse::ArgumentParser("fod_mask_record");
+
+    // clang-format off
+    parser.add_argument("file")
+        .help("Mask record file");
+
+    parser.add_argument("--from")
+        .help("First record index")
+        .default_value(0)
+        .action([](const std::string& arg) { return std::stoi(arg); });
+
+    parser.add_argument("--to")
+        .help("Last record index (-1: last record)")
+        .default_value(-1)
+        .action([](const std::string& arg) { return std::stoi(arg); });
+
+    parser.add_argument("--export")
+        .help("Write the masks of listed frames to this directory as "
+              "<index>_fgmask.png and <index>_update_mask.png")
+        .default_value(std::string(""));
+    // clang-format on
+
+    return parser;
+}
+
+int main(int argc, char* argv[]) {
+    auto parser = getArgParser();
+
+    try {
+        parser.parse_args(argc, argv);
+    } catch (const std::runtime_error& e) {
+        std::printf("%s\n", e.what());
+        std::cout << parser;
+        std::exit(0);
+    }
+
+    auto reader = MaskRecordReader(parser.get("file"));
+    if (!reader.isOpened()) {
+        std::fprintf(stderr,
+                     "[MASK RECORD] Cannot read %s\n",
+                     parser.get("file").c_str());
+        std::exit(EXIT_FAILURE);
+    }
+
+    auto fromIndex = static_cast<uint32_t>(parser.get<int>("--from"));
+    int to = parser.get<int>("--to");
+    auto toIndex = to < 0 ? std::numeric_limits<uint32_t>::max()
+                          : static_cast<uint32_t>(to);
+    auto exportDir = parser.get("--export");
+
+    std::printf("%-8s %-20s %-9s %10s %10s %8s %s\n",
+                "INDEX",
+                "TIME (s)",
+                "SIZE",
+                "FG",
+                "UPDATE",
+                "BYTES",
+                "FLAGS");
+
+    auto fgMask = cv::Mat();
+    auto updateMask = cv::Mat();
+    std::array<char, 512> path;
+    size_t numCorrupted = 0;
+    uint64_t numBytes = 0;
+
+    size_t numFrames = reader.forEachFrame(
+        [&](const MaskRecordReader::FrameView& frame) {
+            const auto& header = *frame.header;
+            numBytes += sizeof(header) + header.size;
+
+            std::printf(
+                "%-8u %-20.3f %4ux%-4u %10zu %10zu %8u %s%s\n",
+                header.index,
+                header.timeNs * 1e-9,
+                header.width,
+                header.height,
+                MaskRecord::countForeground(frame.getFgCodes(),
+                                            frame.getFgSize()),
+                MaskRecord::countForeground(frame.getUpdateCodes(),
+                                            frame.getUpdateSize()),
+                header.size,
+                (header.flags & MASK_RECORD_INVALID) != 0 ? "invalid " : "",
+                (header.flags & MASK_RECORD_WINDOWED) != 0 ? "windowed" : "");
+
+            if (exportDir.empty()) {
+                return;
+            }
+
+            if (!MaskRecordReader::decode(frame, fgMask, updateMask)) {
+                numCorrupted++;
+                return;
+            }
+
+            std::snprintf(path.data(),
+                          path.size(),
+                          "%s/%u_fgmask.png",
+                          exportDir.c_str(),
+                          header.index);
+            cv::imwrite(path.data(), fgMask);
+            std::snprintf(path.data(),
+                          path.size(),
+                          "%s/%u_update_mask.png",
+                          exportDir.c_str(),
+                          header.index);
+            cv::imwrite(path.data(), updateMask);
+        },
+        fromIndex,
+        toIndex);
+
+    std::printf("# %zu frames, %" PRIu64 " bytes of masks\n",
+                numFrames,
+                numBytes);
+    if (numCorrupted > 0) {
+        std::printf("# %zu corrupted frames not exported\n", numCorrupted);
+    }
+
+    return numCorrupted > 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
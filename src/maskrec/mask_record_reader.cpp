@@ -0,0 +1,132 @@
+/**
+ * @file mask_record_reader.cpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Memory mapped reader of run-length encoded mask records
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "mask_record_reader.hpp"
+
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MaskRecordReader::MaskRecordReader(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+
+    struct stat fileStat {};
+    if (::fstat(fd, &fileStat) != 0) {
+        ::close(fd);
+        return;
+    }
+
+    _size = static_cast<size_t>(fileStat.st_size);
+
+    // An empty file is a record without header yet
+    if (_size == 0) {
+        ::close(fd);
+        _isValid = true;
+        return;
+    }
+
+    void* data = ::mmap(nullptr, _size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        _size = 0;
+        return;
+    }
+    _data = static_cast<const uint8_t*>(data);
+
+    // A file cut short inside the file header is treated as empty
+    if (_size < sizeof(MaskRecordFileHeader)) {
+        _isValid = true;
+        return;
+    }
+
+    const auto* header = reinterpret_cast<const MaskRecordFileHeader*>(_data);
+    if (std::memcmp(header->magic, MaskRecord::MAGIC, sizeof(header->magic)) !=
+            0 ||
+        header->version != MaskRecord::VERSION) {
+        return;
+    }
+    _isValid = true;
+
+    // Find the end of the last complete record
+    size_t offset = sizeof(MaskRecordFileHeader);
+    while (const auto* record = getRecord(offset)) {
+        offset = getNextOffset(offset, record);
+    }
+    _validSize = offset;
+}
+
+MaskRecordReader::~MaskRecordReader() {
+    if (_data != nullptr) {
+        ::munmap(const_cast<uint8_t*>(_data), _size);
+    }
+}
+
+size_t MaskRecordReader::forEachFrame(const FrameCallback& callback,
+                                      uint32_t fromIndex,
+                                      uint32_t toIndex) const {
+    size_t numVisited = 0;
+    size_t offset = sizeof(MaskRecordFileHeader);
+
+    while (offset < _validSize) {
+        const auto* record = getRecord(offset);
+        offset = getNextOffset(offset, record);
+
+        if (record->index < fromIndex || record->index > toIndex) {
+            continue;
+        }
+
+        callback(FrameView{
+            .header = record,
+            .codes = reinterpret_cast<const uint8_t*>(record + 1),
+        });
+        numVisited++;
+    }
+
+    return numVisited;
+}
+
+bool MaskRecordReader::decode(const FrameView& frame,
+                              cv::Mat& fgMask,
+                              cv::Mat& updateMask) {
+    int h = frame.header->height;
+    int w = frame.header->width;
+    fgMask.create(h, w, CV_8UC1);
+    updateMask.create(h, w, CV_8UC1);
+
+    auto numPixels = static_cast<size_t>(h) * w;
+    return MaskRecord::decode(
+               frame.getFgCodes(), frame.getFgSize(), fgMask.data, numPixels) &&
+           MaskRecord::decode(frame.getUpdateCodes(),
+                              frame.getUpdateSize(),
+                              updateMask.data,
+                              numPixels);
+}
+
+const MaskRecordHeader* MaskRecordReader::getRecord(size_t offset) const {
+    if (offset + sizeof(MaskRecordHeader) > _size) {
+        return nullptr;
+    }
+
+    const auto* header =
+        reinterpret_cast<const MaskRecordHeader*>(_data + offset);
+    if (header->width == 0 || header->height == 0 ||
+        header->fgSize > header->size ||
+        getNextOffset(offset, header) > _size) {
+        return nullptr;
+    }
+
+    return header;
+}
@@ -0,0 +1,153 @@
+/**
+ * @file mask_record_reader.hpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Memory mapped reader of run-length encoded mask records
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+
+#include "mask_record.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <opencv2/core.hpp>
+#include <string>
+
+/**
+ * @brief Reads a mask record in place from a memory mapping.
+ *        Frames are visited in file order with their codes, masks are only
+ *        decoded on request.
+ */
+class MaskRecordReader final {
+  public:
+#pragma region Public types
+
+    /**
+     * @brief Recorded frame, pointing into the mapping
+     */
+    struct FrameView {
+        const MaskRecordHeader* header;
+
+        /**
+         * @brief Foreground mask codes, update mask codes follow
+         */
+        const uint8_t* codes;
+
+        const uint8_t* getFgCodes() const { return codes; }
+
+        size_t getFgSize() const { return header->fgSize; }
+
+        const uint8_t* getUpdateCodes() const {
+            return codes + header->fgSize;
+        }
+
+        size_t getUpdateSize() const { return header->size - header->fgSize; }
+    };
+
+    using FrameCallback = std::function<void(const FrameView&)>;
+
+#pragma endregion
+
+#pragma region Public member methods
+
+    /**
+     * @brief Construct a new MaskRecordReader object, maps the whole file
+     *
+     * @param path Record file path
+     */
+    explicit MaskRecordReader(const std::string& path);
+
+    /**
+     * @brief Destroy the MaskRecordReader object, unmaps the file
+     */
+    ~MaskRecordReader();
+
+    MaskRecordReader(const MaskRecordReader&) = delete;
+    MaskRecordReader& operator=(const MaskRecordReader&) = delete;
+
+    /**
+     * @brief Tells whether the file is mapped and has a valid file header
+     *
+     * @return  True: Opened
+     */
+    bool isOpened() const { return _isValid; }
+
+    /**
+     * @brief Get the size of the file up to the end of the last complete
+     * record
+     *
+     * @return  Size (bytes)
+     */
+    size_t getValidSize() const { return _validSize; }
+
+    /**
+     * @brief Visit frames in a range of record indices
+     *
+     * @param callback Called with each frame
+     * @param fromIndex First record index
+     * @param toIndex Last record index
+     * @return  Number of visited frames
+     */
+    size_t forEachFrame(
+        const FrameCallback& callback,
+        uint32_t fromIndex = 0,
+        uint32_t toIndex = std::numeric_limits<uint32_t>::max()) const;
+
+#pragma endregion
+
+#pragma region Static methods
+
+    /**
+     * @brief Decode the masks of a frame
+     *
+     * @param frame Frame
+     * @param fgMask Output foreground mask, (re)allocated as needed
+     * @param updateMask Output update mask, (re)allocated as needed
+     * @return  True: decoded, False: corrupted codes
+     */
+    static bool decode(const FrameView& frame,
+                       cv::Mat& fgMask,
+                       cv::Mat& updateMask);
+
+#pragma endregion
+
+  private:
+#pragma region Private member variables
+
+    const uint8_t* _data = nullptr;
+    size_t _size = 0;
+    size_t _validSize = 0;
+    bool _isValid = false;
+
+#pragma endregion
+
+#pragma region Private member methods
+
+    /**
+     * @brief Get the record at an offset
+     *
+     * @param offset Record offset
+     * @return  Record header, nullptr if the record is incomplete
+     */
+    const MaskRecordHeader* getRecord(size_t offset) const;
+
+    /**
+     * @brief Get the offset of the record following one
+     *
+     * @param offset Record offset
+     * @param header Record header
+     * @return  Next record offset
+     */
+    static size_t getNextOffset(size_t offset, const MaskRecordHeader* header) {
+        return offset + sizeof(MaskRecordHeader) +
+               MaskRecord::getPaddedSize(header->size);
+    }
+
+#pragma endregion
+};
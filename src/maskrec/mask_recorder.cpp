@@ -0,0 +1,113 @@
+/**
+ * @file mask_recorder.cpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Buffered append-only recorder of run-length encoded masks
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "mask_recorder.hpp"
+
+#include "mask_record_reader.hpp"
+#include "trace.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+
+MaskRecorder::MaskRecorder(const std::string& path,
+                           const MaskRecorderParams& params)
+    : _file(AppendFileParams{
+          .flushIntervalMs = params.flushIntervalMs,
+          .syncIntervalMs = 0,
+          .bufferSize = params.bufferSize,
+          .maxBufferSize = params.maxBufferSize,
+      }) {
+    if (!open(path)) {
+        std::printf("[MASK RECORDER] Cannot open %s\n", path.c_str());
+    }
+}
+
+MaskRecorder::~MaskRecorder() = default;
+
+bool MaskRecorder::record(const cv::Mat& fgMask,
+                          const cv::Mat& updateMask,
+                          uint32_t flags,
+                          Clock::time_point time) {
+    TRACE_SCOPE("MaskRecorder::record");
+
+    if (!isOpened()) {
+        return false;
+    }
+
+    CV_Assert(fgMask.type() == CV_8UC1 && updateMask.type() == CV_8UC1);
+    CV_Assert(fgMask.size() == updateMask.size());
+    CV_Assert(fgMask.isContinuous() && updateMask.isContinuous());
+
+    uint32_t index = _index++;
+
+    // Encode both masks behind the header, the buffer only grows on the
+    // first frames
+    auto numPixels = static_cast<size_t>(fgMask.rows) * fgMask.cols;
+    size_t maxSize = sizeof(MaskRecordHeader) +
+                     MaskRecord::getMaxEncodedSize(numPixels) * 2 +
+                     MaskRecord::ALIGNMENT;
+    if (_codes.size() < maxSize) {
+        _codes.resize(maxSize);
+    }
+
+    uint8_t* codes = _codes.data() + sizeof(MaskRecordHeader);
+    size_t fgSize = MaskRecord::encode(fgMask.data, numPixels, codes);
+    size_t updateSize =
+        MaskRecord::encode(updateMask.data, numPixels, codes + fgSize);
+
+    auto header = MaskRecordHeader{
+        .size = static_cast<uint32_t>(fgSize + updateSize),
+        .index = index,
+        .timeNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                      time.time_since_epoch())
+                      .count(),
+        .width = static_cast<uint16_t>(fgMask.cols),
+        .height = static_cast<uint16_t>(fgMask.rows),
+        .fgSize = static_cast<uint32_t>(fgSize),
+        .flags = flags,
+        .reserved = 0,
+    };
+    std::memcpy(_codes.data(), &header, sizeof(header));
+
+    // Padding stays zero
+    size_t recordSize =
+        sizeof(header) + MaskRecord::getPaddedSize(header.size);
+    std::fill(codes + header.size, _codes.data() + recordSize, 0);
+
+    if (!_file.append(_codes.data(), recordSize)) {
+        _numDropped++;
+        return false;
+    }
+
+    _numRecorded++;
+    _numBytes += recordSize;
+    return true;
+}
+
+bool MaskRecorder::open(const std::string& path) {
+    // Find the end of the last complete record of an existing file
+    auto validSize = size_t(0);
+    if (::access(path.c_str(), F_OK) == 0) {
+        auto reader = MaskRecordReader(path);
+        if (!reader.isOpened()) {
+            return false;
+        }
+        validSize = reader.getValidSize();
+    }
+
+    auto header = MaskRecordFileHeader{};
+    std::memcpy(header.magic, MaskRecord::MAGIC, sizeof(header.magic));
+    header.version = MaskRecord::VERSION;
+
+    return _file.open(path, validSize, &header, sizeof(header));
+}
@@ -0,0 +1,148 @@
+/**
+ * @file mask_recorder.hpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Buffered append-only recorder of run-length encoded masks
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+
+#include "append_file.hpp"
+#include "mask_record.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <opencv2/core.hpp>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Additional parameters for MaskRecorder class
+ */
+struct MaskRecorderParams {
+    /**
+     * @brief Interval between two writes of buffered records (ms)
+     */
+    int flushIntervalMs = 1000;
+
+    /**
+     * @brief Initial capacity of the record buffer (bytes)
+     */
+    size_t bufferSize = 1 << 20;
+
+    /**
+     * @brief Max size of records waiting to be written (bytes), records are
+     * dropped beyond, e.g. while storage stalls
+     */
+    size_t maxBufferSize = 16 << 20;
+};
+
+/**
+ * @brief Records the foreground and update masks of every analysed frame.
+ *        Masks are run-length encoded on the caller's thread (a few
+ *        microseconds for sparse masks) into the buffer of an AppendFile,
+ *        its background thread appends them to the file. Read records back
+ *        with MaskRecordReader or fod_mask_record.
+ */
+class MaskRecorder final {
+  public:
+#pragma region Public types
+
+    using Clock = std::chrono::system_clock;
+
+#pragma endregion
+
+#pragma region Public member methods
+
+    /**
+     * @brief Construct a new MaskRecorder object, the record file is created
+     * or appended to
+     *
+     * @param path Record file path
+     * @param params Additional parameters
+     */
+    explicit MaskRecorder(
+        const std::string& path,
+        const MaskRecorderParams& params = MaskRecorderParams());
+
+    /**
+     * @brief Destroy the MaskRecorder object, buffered records are written
+     * and synced
+     */
+    ~MaskRecorder();
+
+    MaskRecorder(const MaskRecorder&) = delete;
+    MaskRecorder& operator=(const MaskRecorder&) = delete;
+
+    /**
+     * @brief Tells whether the record file is opened
+     *
+     * @return  True: Opened
+     */
+    bool isOpened() const { return _file.isOpened(); }
+
+    /**
+     * @brief Record the masks of a frame
+     *
+     * @param fgMask Foreground mask (CV_8UC1, continuous)
+     * @param updateMask Update mask (same size and type)
+     * @param flags MaskRecordFlags
+     * @param time Frame time
+     * @return  True: recorded, False: dropped or not opened
+     */
+    bool record(const cv::Mat& fgMask,
+                const cv::Mat& updateMask,
+                uint32_t flags = 0,
+                Clock::time_point time = Clock::now());
+
+    /**
+     * @brief Write buffered records now
+     *
+     * @param sync Also sync the file to storage
+     * @return
+     */
+    void flush(bool sync = false) { _file.flush(sync); }
+
+    uint64_t getNumRecorded() const { return _numRecorded; }
+
+    uint64_t getNumDropped() const { return _numDropped; }
+
+    /**
+     * @brief Get the number of bytes recorded so far, with headers
+     *
+     * @return  Size (bytes)
+     */
+    uint64_t getNumBytes() const { return _numBytes; }
+
+#pragma endregion
+
+  private:
+#pragma region Private member variables
+
+    AppendFile _file;
+
+    /* Record being encoded, only used by the caller */
+    std::vector<uint8_t> _codes;
+    uint32_t _index = 0;
+    uint64_t _numRecorded = 0;
+    uint64_t _numDropped = 0;
+    uint64_t _numBytes = 0;
+
+#pragma endregion
+
+#pragma region Private member methods
+
+    /**
+     * @brief Open the record file, writing a file header to a new file and
+     * dropping a partial record at the end of an existing one
+     *
+     * @param path Record file path
+     * @return  True: Opened
+     */
+    bool open(const std::string& path);
+
+#pragma endregion
+};
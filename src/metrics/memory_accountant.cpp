@@ -0,0 +1,101 @@
+/**
+ * @file memory_accountant.cpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Per-camera accounting of the memory held by pipeline components
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "memory_accountant.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <unistd.h>
+
+MemoryAccountant::MemoryAccountant(MetricsRegistry* registry)
+    : _registry(registry) {
+    if (_registry != nullptr) {
+        _totalGauge = &_registry->gauge(
+            "fod_memory_bytes", "Memory held by the pipeline components");
+        _residentGauge = &_registry->gauge("fod_memory_resident_bytes",
+                                           "Resident set size of the process");
+    }
+}
+
+void MemoryAccountant::add(std::string_view name, Source source) {
+    Gauge* gauge = nullptr;
+    if (_registry != nullptr) {
+        auto gaugeName = "fod_memory_" + std::string(name) + "_bytes";
+        auto help = "Memory held by " + std::string(name);
+        gauge = &_registry->gauge(gaugeName, help);
+    }
+
+    _components.push_back(Component{
+        .name = std::string(name),
+        .source = std::move(source),
+        .usage = 0,
+        .gauge = gauge,
+    });
+}
+
+size_t MemoryAccountant::sample() {
+    _total = 0;
+    for (auto& component : _components) {
+        component.usage = component.source();
+        _total += component.usage;
+        if (component.gauge != nullptr) {
+            component.gauge->set(static_cast<int64_t>(component.usage));
+        }
+    }
+    _peak = std::max(_peak, _total);
+
+    if (_totalGauge != nullptr) {
+        _totalGauge->set(static_cast<int64_t>(_total));
+        _residentGauge->set(static_cast<int64_t>(getResidentSize()));
+    }
+
+    return _total;
+}
+
+std::string MemoryAccountant::summary() const {
+    std::string text;
+    std::array<char, 128> line;
+    for (const auto& component : _components) {
+        std::snprintf(line.data(),
+                      line.size(),
+                      "  %-16s %10.1f KiB\n",
+                      component.name.c_str(),
+                      component.usage / 1024.0);
+        text += line.data();
+    }
+    std::snprintf(line.data(),
+                  line.size(),
+                  "  %-16s %10.1f KiB (peak %.1f KiB)\n",
+                  "total",
+                  _total / 1024.0,
+                  _peak / 1024.0);
+    text += line.data();
+    return text;
+}
+
+size_t MemoryAccountant::getResidentSize() {
+    FILE* file = std::fopen("/proc/self/statm", "r");
+    if (file == nullptr) {
+        return 0;
+    }
+
+    unsigned long numPages = 0;
+    unsigned long numResidentPages = 0;
+    int n = std::fscanf(file, "%lu %lu", &numPages, &numResidentPages);
+    std::fclose(file);
+    if (n != 2) {
+        return 0;
+    }
+
+    return static_cast<size_t>(numResidentPages) *
+           static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+}
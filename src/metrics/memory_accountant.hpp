@@ -0,0 +1,137 @@
+/**
+ * @file memory_accountant.hpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Per-camera accounting of the memory held by pipeline components
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+
+#include "metrics.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Collects the memory reported by the components of one camera
+ *        pipeline (reader, background model, detection buffers, tracker...).
+ *        Components only tell their current size; the accountant asks them
+ *        between two frames, so nothing is counted on the hot path.
+ */
+class MemoryAccountant final {
+  public:
+#pragma region Public types
+
+    /**
+     * @brief Reports the memory held by a component (bytes)
+     */
+    using Source = std::function<size_t()>;
+
+#pragma endregion
+
+#pragma region Public member methods
+
+    /**
+     * @brief Construct a new MemoryAccountant object
+     *
+     * @param registry Registry of the exported gauges (nullptr: not exported)
+     */
+    explicit MemoryAccountant(MetricsRegistry* registry = nullptr);
+
+    /**
+     * @brief Register a component, exported as fod_memory_<name>_bytes
+     *
+     * @param name Component name
+     * @param source Reports the memory of the component, called from the
+     * thread calling sample()
+     * @return
+     */
+    void add(std::string_view name, Source source);
+
+    /**
+     * @brief Ask all components for their memory
+     *
+     * @return  Total memory of the components (bytes)
+     */
+    size_t sample();
+
+    /**
+     * @brief Get the total memory of the last sample
+     *
+     * @return  Size (bytes)
+     */
+    size_t getTotal() const { return _total; }
+
+    /**
+     * @brief Get the largest total memory sampled so far
+     *
+     * @return  Size (bytes)
+     */
+    size_t getPeak() const { return _peak; }
+
+    int getNumComponents() const {
+        return static_cast<int>(_components.size());
+    }
+
+    const std::string& getName(int i) const { return _components[i].name; }
+
+    /**
+     * @brief Get the memory of a component in the last sample
+     *
+     * @param i Component index (in registration order)
+     * @return  Size (bytes)
+     */
+    size_t getUsage(int i) const { return _components[i].usage; }
+
+    /**
+     * @brief Format the last sample, one component per line
+     *
+     * @return  Text
+     */
+    std::string summary() const;
+
+#pragma endregion
+
+#pragma region Static methods
+
+    /**
+     * @brief Get the resident set size of this process, which also counts
+     * what no component reports (libraries, allocator slack...)
+     *
+     * @return  Size (bytes), 0 if unknown
+     */
+    static size_t getResidentSize();
+
+#pragma endregion
+
+  private:
+#pragma region Private types
+
+    struct Component {
+        std::string name;
+        Source source;
+        size_t usage;
+        Gauge* gauge;
+    };
+
+#pragma endregion
+
+#pragma region Private member variables
+
+    MetricsRegistry* _registry;
+    std::vector<Component> _components;
+
+    size_t _total = 0;
+    size_t _peak = 0;
+
+    Gauge* _totalGauge = nullptr;
+    Gauge* _residentGauge = nullptr;
+
+#pragma endregion
+};
@@ -0,0 +1,232 @@
+/**
+ * @file metrics.cpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Low-overhead runtime metrics (latency histograms, counters, gauges)
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "metrics.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+
+LatencyHistogram::LatencyHistogram(std::string name, std::string help)
+    : _name(std::move(name)),
+      _help(std::move(help)),
+      _shards(std::make_unique<Shard[]>(NUM_SHARDS)) {}
+
+void LatencyHistogram::record(uint64_t ns) {
+    auto& shard = _shards[getShardIndex()];
+
+    shard.buckets[getBucketIndex(ns)].fetch_add(1, std::memory_order_relaxed);
+    shard.count.fetch_add(1, std::memory_order_relaxed);
+    shard.sumNs.fetch_add(ns, std::memory_order_relaxed);
+
+    // Only the owning thread(s) of this shard race on max, a CAS loop is fine
+    uint64_t prevMax = shard.maxNs.load(std::memory_order_relaxed);
+    while (ns > prevMax && !shard.maxNs.compare_exchange_weak(
+                               prevMax, ns, std::memory_order_relaxed)) {
+    }
+}
+
+LatencyHistogram::Snapshot LatencyHistogram::snapshot() const {
+    auto snapshot = Snapshot{
+        .count = 0,
+        .sumNs = 0,
+        .maxNs = 0,
+        .buckets = std::vector<uint64_t>(NUM_BUCKETS, 0),
+    };
+
+    for (int s = 0; s < NUM_SHARDS; s++) {
+        const auto& shard = _shards[s];
+        for (int i = 0; i < NUM_BUCKETS; i++) {
+            snapshot.buckets[i] +=
+                shard.buckets[i].load(std::memory_order_relaxed);
+        }
+        snapshot.count += shard.count.load(std::memory_order_relaxed);
+        snapshot.sumNs += shard.sumNs.load(std::memory_order_relaxed);
+        snapshot.maxNs = std::max(snapshot.maxNs,
+                                  shard.maxNs.load(std::memory_order_relaxed));
+    }
+
+    return snapshot;
+}
+
+uint64_t LatencyHistogram::Snapshot::quantile(double q) const {
+    uint64_t total = 0;
+    for (auto n : buckets) {
+        total += n;
+    }
+
+    if (total == 0) {
+        return 0;
+    }
+
+    auto rank = static_cast<uint64_t>(q * static_cast<double>(total - 1)) + 1;
+    uint64_t accumulated = 0;
+    for (int i = 0; i < static_cast<int>(buckets.size()); i++) {
+        accumulated += buckets[i];
+        if (accumulated >= rank) {
+            return std::min(getBucketValue(i), maxNs);
+        }
+    }
+
+    return maxNs;
+}
+
+int LatencyHistogram::getBucketIndex(uint64_t ns) {
+    // Values below SUB_BUCKETS are stored exactly in the first range
+    if (ns < SUB_BUCKETS) {
+        return static_cast<int>(ns);
+    }
+
+    int msb = 63 - __builtin_clzll(ns);
+    int range = msb - SUB_BUCKET_BITS + 1;
+    if (range >= NUM_RANGES) {
+        return NUM_BUCKETS - 1;
+    }
+
+    int sub = static_cast<int>((ns >> (msb - SUB_BUCKET_BITS)) &
+                               (SUB_BUCKETS - 1));
+    return range * SUB_BUCKETS + sub;
+}
+
+uint64_t LatencyHistogram::getBucketValue(int index) {
+    int range = index / SUB_BUCKETS;
+    int sub = index % SUB_BUCKETS;
+
+    if (range == 0) {
+        return sub;
+    }
+
+    uint64_t lower = static_cast<uint64_t>(SUB_BUCKETS + sub) << (range - 1);
+    uint64_t width = 1ULL << (range - 1);
+    return lower + width / 2;
+}
+
+int LatencyHistogram::getShardIndex() {
+    static std::atomic<int> nextThreadIndex{0};
+    thread_local int shardIndex =
+        nextThreadIndex.fetch_add(1, std::memory_order_relaxed) % NUM_SHARDS;
+    return shardIndex;
+}
+
+MetricsRegistry& MetricsRegistry::instance() {
+    static MetricsRegistry registry;
+    return registry;
+}
+
+LatencyHistogram& MetricsRegistry::histogram(std::string_view name,
+                                             std::string_view help) {
+    auto lock = std::scoped_lock(_mutex);
+    for (auto& h : _histograms) {
+        if (h->getName() == name) {
+            return *h;
+        }
+    }
+    return *_histograms.emplace_back(std::make_unique<LatencyHistogram>(
+        std::string(name), std::string(help)));
+}
+
+Counter& MetricsRegistry::counter(std::string_view name,
+                                  std::string_view help) {
+    auto lock = std::scoped_lock(_mutex);
+    for (auto& c : _counters) {
+        if (c->getName() == name) {
+            return *c;
+        }
+    }
+    return *_counters.emplace_back(
+        std::make_unique<Counter>(std::string(name), std::string(help)));
+}
+
+Gauge& MetricsRegistry::gauge(std::string_view name, std::string_view help) {
+    auto lock = std::scoped_lock(_mutex);
+    for (auto& g : _gauges) {
+        if (g->getName() == name) {
+            return *g;
+        }
+    }
+    return *_gauges.emplace_back(
+        std::make_unique<Gauge>(std::string(name), std::string(help)));
+}
+
+std::string MetricsRegistry::toPrometheusText() const {
+    static constexpr std::array<double, 4> QUANTILES{0.5, 0.9, 0.99, 0.999};
+
+    auto lock = std::scoped_lock(_mutex);
+    std::string text;
+    std::array<char, 256> line;
+
+    auto append = [&text, &line](int n) {
+        text.append(line.data(), std::min<size_t>(n, line.size() - 1));
+    };
+
+    for (const auto& h : _histograms) {
+        auto snapshot = h->snapshot();
+        const char* name = h->getName().c_str();
+
+        append(std::snprintf(line.data(),
+                             line.size(),
+                             "# HELP %s_seconds %s\n# TYPE %s_seconds summary\n",
+                             name,
+                             h->getHelp().c_str(),
+                             name));
+
+        for (double q : QUANTILES) {
+            append(std::snprintf(line.data(),
+                                 line.size(),
+                                 "%s_seconds{quantile=\"%g\"} %.9f\n",
+                                 name,
+                                 q,
+                                 snapshot.quantile(q) * 1e-9));
+        }
+
+        append(std::snprintf(line.data(),
+                             line.size(),
+                             "%s_seconds_sum %.9f\n%s_seconds_count %llu\n",
+                             name,
+                             snapshot.sumNs * 1e-9,
+                             name,
+                             static_cast<unsigned long long>(snapshot.count)));
+
+        append(std::snprintf(line.data(),
+                             line.size(),
+                             "# TYPE %s_seconds_max gauge\n"
+                             "%s_seconds_max %.9f\n",
+                             name,
+                             name,
+                             snapshot.maxNs * 1e-9));
+    }
+
+    for (const auto& c : _counters) {
+        const char* name = c->getName().c_str();
+        append(std::snprintf(line.data(),
+                             line.size(),
+                             "# HELP %s %s\n# TYPE %s counter\n%s %llu\n",
+                             name,
+                             c->getHelp().c_str(),
+                             name,
+                             name,
+                             static_cast<unsigned long long>(c->get())));
+    }
+
+    for (const auto& g : _gauges) {
+        const char* name = g->getName().c_str();
+        append(std::snprintf(line.data(),
+                             line.size(),
+                             "# HELP %s %s\n# TYPE %s gauge\n%s %lld\n",
+                             name,
+                             g->getHelp().c_str(),
+                             name,
+                             name,
+                             static_cast<long long>(g->get())));
+    }
+
+    return text;
+}
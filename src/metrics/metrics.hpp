@@ -0,0 +1,326 @@
+/**
+ * @file metrics.hpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Low-overhead runtime metrics (latency histograms, counters, gauges)
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+
+#include "perf_counters.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Latency histogram with log-linear (HDR style) buckets.
+ *        Each recording thread writes into its own shard with relaxed atomic
+ *        increments, so recording never locks and rarely shares cache lines.
+ *        Shards are only merged when a snapshot is taken for export.
+ */
+class LatencyHistogram final {
+  public:
+#pragma region Public types
+
+    /**
+     * @brief Merged view of all shards at the time it was taken
+     */
+    struct Snapshot {
+        uint64_t count;
+        uint64_t sumNs;
+        uint64_t maxNs;
+        std::vector<uint64_t> buckets;
+
+        /**
+         * @brief Estimate a quantile from the bucket counts
+         *
+         * @param q Quantile in [0, 1]
+         * @return  Latency (ns) at the given quantile
+         */
+        uint64_t quantile(double q) const;
+
+        /**
+         * @brief Mean latency (ns)
+         */
+        double mean() const {
+            return count == 0 ? 0.0 : static_cast<double>(sumNs) / count;
+        }
+    };
+
+#pragma endregion
+
+#pragma region Public member methods
+
+    LatencyHistogram(std::string name, std::string help);
+
+    /**
+     * @brief Record a latency sample
+     *
+     * @param ns Latency in nanoseconds
+     * @return
+     */
+    void record(uint64_t ns);
+
+    /**
+     * @brief Merge all shards into a snapshot
+     *
+     * @return  Snapshot
+     */
+    Snapshot snapshot() const;
+
+    const std::string& getName() const { return _name; }
+
+    const std::string& getHelp() const { return _help; }
+
+#pragma endregion
+
+#pragma region Public constants
+
+    /**
+     * @brief Number of linear sub-buckets within one power-of-two range
+     * (precision is about 1 / SUB_BUCKETS)
+     */
+    static constexpr int SUB_BUCKET_BITS = 4;
+    static constexpr int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+
+    /**
+     * @brief Number of power-of-two ranges covered (up to ~2^40 ns = 18 min)
+     */
+    static constexpr int NUM_RANGES = 41;
+
+    static constexpr int NUM_BUCKETS = NUM_RANGES * SUB_BUCKETS;
+
+    /**
+     * @brief Number of per-thread shards
+     */
+    static constexpr int NUM_SHARDS = 8;
+
+#pragma endregion
+
+#pragma region Static helper methods
+
+    /**
+     * @brief Map a value to its bucket index
+     */
+    static int getBucketIndex(uint64_t ns);
+
+    /**
+     * @brief Get the representative (middle) value of a bucket
+     */
+    static uint64_t getBucketValue(int index);
+
+    /**
+     * @brief Get the shard index of the calling thread
+     */
+    static int getShardIndex();
+
+#pragma endregion
+
+  private:
+#pragma region Private types
+
+    struct alignas(64) Shard {
+        std::array<std::atomic<uint64_t>, NUM_BUCKETS> buckets{};
+        std::atomic<uint64_t> count{0};
+        std::atomic<uint64_t> sumNs{0};
+        std::atomic<uint64_t> maxNs{0};
+    };
+
+#pragma endregion
+
+#pragma region Private member variables
+
+    std::string _name;
+    std::string _help;
+    std::unique_ptr<Shard[]> _shards;
+
+#pragma endregion
+};
+
+/**
+ * @brief Monotonically increasing counter
+ */
+class Counter final {
+  public:
+    Counter(std::string name, std::string help)
+        : _name(std::move(name)), _help(std::move(help)) {}
+
+    void increment(uint64_t n = 1) {
+        _value.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    uint64_t get() const { return _value.load(std::memory_order_relaxed); }
+
+    const std::string& getName() const { return _name; }
+
+    const std::string& getHelp() const { return _help; }
+
+  private:
+    std::string _name;
+    std::string _help;
+    alignas(64) std::atomic<uint64_t> _value{0};
+};
+
+/**
+ * @brief Gauge that holds the latest value of a quantity (e.g. queue depth)
+ */
+class Gauge final {
+  public:
+    Gauge(std::string name, std::string help)
+        : _name(std::move(name)), _help(std::move(help)) {}
+
+    void set(int64_t value) { _value.store(value, std::memory_order_relaxed); }
+
+    void add(int64_t delta) {
+        _value.fetch_add(delta, std::memory_order_relaxed);
+    }
+
+    int64_t get() const { return _value.load(std::memory_order_relaxed); }
+
+    const std::string& getName() const { return _name; }
+
+    const std::string& getHelp() const { return _help; }
+
+  private:
+    std::string _name;
+    std::string _help;
+    alignas(64) std::atomic<int64_t> _value{0};
+};
+
+/**
+ * @brief Process-wide registry of named metrics.
+ *        Registration takes a lock and is meant to happen at startup, the
+ *        returned references stay valid for the lifetime of the process.
+ */
+class MetricsRegistry final {
+  public:
+#pragma region Public member methods
+
+    /**
+     * @brief Get the global registry
+     */
+    static MetricsRegistry& instance();
+
+    /**
+     * @brief Get or create a latency histogram
+     *
+     * @param name Metric name (Prometheus naming, without unit suffix)
+     * @param help Help text
+     * @return  Histogram reference
+     */
+    LatencyHistogram& histogram(std::string_view name, std::string_view help);
+
+    /**
+     * @brief Get or create a counter
+     *
+     * @param name Metric name
+     * @param help Help text
+     * @return  Counter reference
+     */
+    Counter& counter(std::string_view name, std::string_view help);
+
+    /**
+     * @brief Get or create a gauge
+     *
+     * @param name Metric name
+     * @param help Help text
+     * @return  Gauge reference
+     */
+    Gauge& gauge(std::string_view name, std::string_view help);
+
+    /**
+     * @brief Render all metrics in Prometheus text exposition format
+     *
+     * @return  Text
+     */
+    std::string toPrometheusText() const;
+
+#pragma endregion
+
+  private:
+#pragma region Private member variables
+
+    mutable std::mutex _mutex;
+    std::vector<std::unique_ptr<LatencyHistogram>> _histograms;
+    std::vector<std::unique_ptr<Counter>> _counters;
+    std::vector<std::unique_ptr<Gauge>> _gauges;
+
+#pragma endregion
+
+    MetricsRegistry() = default;
+};
+
+/**
+ * @brief Stopwatch that records consecutive stage latencies into histograms.
+ *        When hardware counters are enabled, counter deltas of each lap are
+ *        attributed to the stage as well.
+ */
+class StageTimer final {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    StageTimer() { reset(); }
+
+    /**
+     * @brief Restart timing from now
+     */
+    void reset() {
+        if (PerfCounters::isEnabled()) {
+            PerfCounters::read(_lastCounters);
+        }
+        _last = Clock::now();
+    }
+
+    /**
+     * @brief Record the time elapsed since the last lap (or reset)
+     *
+     * @param histogram Destination histogram
+     * @return  Elapsed time (ns)
+     */
+    uint64_t lap(LatencyHistogram& histogram) { return lap(&histogram); }
+
+    /**
+     * @brief Record the time elapsed since the last lap (or reset), if a
+     * histogram is given
+     *
+     * @param histogram Destination histogram (nullptr: only timed)
+     * @return  Elapsed time (ns)
+     */
+    uint64_t lap(LatencyHistogram* histogram) {
+        auto now = Clock::now();
+        auto ns = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(now - _last)
+                .count());
+        _last = now;
+        if (histogram != nullptr) {
+            histogram->record(ns);
+        }
+
+        if (PerfCounters::isEnabled()) {
+            PerfCounters::Values counters;
+            PerfCounters::read(counters);
+            if (histogram != nullptr) {
+                PerfCounters::instance().accumulate(
+                    histogram, histogram->getName(), _lastCounters, counters);
+            }
+            _lastCounters = counters;
+        }
+
+        return ns;
+    }
+
+  private:
+    Clock::time_point _last;
+    PerfCounters::Values _lastCounters{};
+};
@@ -0,0 +1,167 @@
+/**
+ * @file metrics_exporter.cpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Periodic file and localhost HTTP (Prometheus text) metrics export
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "metrics_exporter.hpp"
+
+#include <arpa/inet.h>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+MetricsExporter::MetricsExporter(const MetricsRegistry& registry,
+                                 MetricsExporterParams params)
+    : _registry(registry),
+      _params(std::move(params)),
+      _isRunning(false),
+      _listenFd(-1) {}
+
+MetricsExporter::~MetricsExporter() { stop(); }
+
+bool MetricsExporter::start() {
+    if (_isRunning.exchange(true)) {
+        return true;
+    }
+
+    if (_params.httpPort != 0) {
+        _listenFd = socket(AF_INET, SOCK_STREAM, 0);
+        int reuse = 1;
+        setsockopt(_listenFd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(_params.httpPort);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+        if (_listenFd < 0 ||
+            bind(_listenFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) <
+                0 ||
+            listen(_listenFd, 4) < 0) {
+            std::printf("[METRICS] Failed to listen on 127.0.0.1:%u\n",
+                        _params.httpPort);
+            if (_listenFd >= 0) {
+                ::close(_listenFd);
+                _listenFd = -1;
+            }
+        } else {
+            _httpThread = std::thread(&MetricsExporter::runHttpServer, this);
+        }
+    }
+
+    if (!_params.filePath.empty()) {
+        _fileThread = std::thread(&MetricsExporter::runFileExport, this);
+    }
+
+    return _params.httpPort == 0 || _listenFd >= 0;
+}
+
+void MetricsExporter::stop() {
+    if (!_isRunning.exchange(false)) {
+        return;
+    }
+
+    if (_httpThread.joinable()) {
+        _httpThread.join();
+    }
+
+    if (_fileThread.joinable()) {
+        _fileThread.join();
+    }
+
+    if (_listenFd >= 0) {
+        ::close(_listenFd);
+        _listenFd = -1;
+    }
+}
+
+bool MetricsExporter::writeFile() const {
+    if (_params.filePath.empty()) {
+        return false;
+    }
+
+    auto text = _registry.toPrometheusText();
+
+    // Write to a temporary file then rename, so readers never see a partial
+    // export
+    auto tempPath = _params.filePath + ".tmp";
+    FILE* file = std::fopen(tempPath.c_str(), "w");
+    if (file == nullptr) {
+        return false;
+    }
+
+    bool isOK = std::fwrite(text.data(), 1, text.size(), file) == text.size();
+    isOK = (std::fclose(file) == 0) && isOK;
+
+    return isOK &&
+           std::rename(tempPath.c_str(), _params.filePath.c_str()) == 0;
+}
+
+void MetricsExporter::runFileExport() {
+    using namespace std::chrono_literals;
+    auto interval = std::chrono::milliseconds(_params.fileIntervalMs);
+    auto nextExport = std::chrono::steady_clock::now() + interval;
+
+    while (_isRunning.load()) {
+        std::this_thread::sleep_for(100ms);
+        if (std::chrono::steady_clock::now() < nextExport) {
+            continue;
+        }
+
+        writeFile();
+        nextExport += interval;
+    }
+
+    // Final export on shutdown
+    writeFile();
+}
+
+void MetricsExporter::runHttpServer() {
+    while (_isRunning.load()) {
+        pollfd pfd{.fd = _listenFd, .events = POLLIN, .revents = 0};
+        if (poll(&pfd, 1, HTTP_POLL_TIMEOUT_MS) <= 0) {
+            continue;
+        }
+
+        int clientFd = accept(_listenFd, nullptr, nullptr);
+        if (clientFd < 0) {
+            continue;
+        }
+
+        serveClient(clientFd);
+        ::close(clientFd);
+    }
+}
+
+void MetricsExporter::serveClient(int clientFd) const {
+    // Drain (and ignore) the request, every path returns the metrics page
+    std::array<char, 1024> request;
+    pollfd pfd{.fd = clientFd, .events = POLLIN, .revents = 0};
+    if (poll(&pfd, 1, HTTP_POLL_TIMEOUT_MS) > 0) {
+        recv(clientFd, request.data(), request.size(), 0);
+    }
+
+    auto body = _registry.toPrometheusText();
+
+    std::array<char, 128> header;
+    int headerSize =
+        std::snprintf(header.data(),
+                      header.size(),
+                      "HTTP/1.0 200 OK\r\n"
+                      "Content-Type: text/plain; version=0.0.4\r\n"
+                      "Content-Length: %zu\r\n\r\n",
+                      body.size());
+
+    send(clientFd, header.data(), headerSize, MSG_NOSIGNAL);
+    send(clientFd, body.data(), body.size(), MSG_NOSIGNAL);
+}
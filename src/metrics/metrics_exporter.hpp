@@ -0,0 +1,122 @@
+/**
+ * @file metrics_exporter.hpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Periodic file and localhost HTTP (Prometheus text) metrics export
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+
+#include "metrics.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+/**
+ * @brief Additional parameters for MetricsExporter class
+ */
+struct MetricsExporterParams {
+    /**
+     * @brief Path of the periodically rewritten metrics file (empty: disabled)
+     */
+    std::string filePath = "";
+
+    /**
+     * @brief Interval between two file exports (ms)
+     */
+    int fileIntervalMs = 10000;
+
+    /**
+     * @brief TCP port of the HTTP endpoint bound to 127.0.0.1 (0: disabled)
+     */
+    uint16_t httpPort = 0;
+};
+
+/**
+ * @brief Export metrics of a registry on background threads
+ */
+class MetricsExporter final {
+  public:
+#pragma region Public member methods
+
+    /**
+     * @brief Construct a new MetricsExporter object
+     *
+     * @param registry Metrics registry to export
+     * @param params Additional parameters
+     */
+    MetricsExporter(const MetricsRegistry& registry,
+                    MetricsExporterParams params);
+
+    MetricsExporter(const MetricsExporter&) = delete;
+
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+    /**
+     * @brief Stop exporting and join background threads
+     */
+    ~MetricsExporter();
+
+    /**
+     * @brief Start background threads
+     *
+     * @return  True: started successfully
+     *          False: failed to bind the HTTP endpoint
+     */
+    bool start();
+
+    /**
+     * @brief Stop background threads (a final file export is written)
+     *
+     * @return
+     */
+    void stop();
+
+    /**
+     * @brief Write current metrics to the export file immediately
+     *
+     * @return  True: written successfully
+     *          False: failed to write
+     */
+    bool writeFile() const;
+
+#pragma endregion
+
+  private:
+#pragma region Private constants
+
+    /**
+     * @brief Poll timeout of the HTTP listening socket (ms), bounds the
+     * latency of stop()
+     */
+    static constexpr int HTTP_POLL_TIMEOUT_MS = 200;
+
+#pragma endregion
+
+#pragma region Private member variables
+
+    const MetricsRegistry& _registry;
+    MetricsExporterParams _params;
+
+    std::atomic<bool> _isRunning;
+    std::thread _fileThread;
+    std::thread _httpThread;
+    int _listenFd;
+
+#pragma endregion
+
+#pragma region Private member methods
+
+    void runFileExport();
+
+    void runHttpServer();
+
+    void serveClient(int clientFd) const;
+
+#pragma endregion
+};
@@ -0,0 +1,255 @@
+/**
+ * @file perf_counters.cpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Per-stage hardware performance counters via perf_event_open (Linux)
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "perf_counters.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+std::atomic<bool> PerfCounters::_isEnabled{false};
+
+#if defined(__linux__)
+
+namespace {
+
+/**
+ * @brief perf_event_attr (type, config) of each counted event
+ */
+constexpr std::array<std::pair<uint32_t, uint64_t>, PerfCounters::NUM_EVENTS>
+    EVENT_CONFIGS{
+        std::make_pair(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES),
+        std::make_pair(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS),
+        std::make_pair(PERF_TYPE_HW_CACHE,
+                       PERF_COUNT_HW_CACHE_L1D |
+                           (PERF_COUNT_HW_CACHE_OP_READ << 8U) |
+                           (PERF_COUNT_HW_CACHE_RESULT_MISS << 16U)),
+        std::make_pair(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES),
+        std::make_pair(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES),
+    };
+
+/**
+ * @brief Counter group owned by one thread
+ */
+struct ThreadGroup {
+    int leaderFd = -1;
+    std::vector<int> fds;
+    std::vector<int> events;
+    bool isOpened = false;
+
+    ~ThreadGroup() {
+        for (int fd : fds) {
+            ::close(fd);
+        }
+    }
+
+    void open(const std::array<bool, PerfCounters::NUM_EVENTS>* mask) {
+        isOpened = true;
+
+        for (int e = 0; e < PerfCounters::NUM_EVENTS; e++) {
+            if (mask != nullptr && !(*mask)[e]) {
+                continue;
+            }
+
+            perf_event_attr attr{};
+            attr.size = sizeof(attr);
+            attr.type = EVENT_CONFIGS[e].first;
+            attr.config = EVENT_CONFIGS[e].second;
+            attr.read_format = PERF_FORMAT_GROUP;
+            attr.disabled = leaderFd == -1 ? 1 : 0;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+
+            int fd = static_cast<int>(
+                syscall(SYS_perf_event_open, &attr, 0, -1, leaderFd, 0));
+            if (fd < 0) {
+                continue;
+            }
+
+            if (leaderFd == -1) {
+                leaderFd = fd;
+            }
+            fds.push_back(fd);
+            events.push_back(e);
+        }
+
+        if (leaderFd != -1) {
+            ioctl(leaderFd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(leaderFd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+    }
+};
+
+thread_local ThreadGroup threadGroup;
+
+} // namespace
+
+bool PerfCounters::enable() {
+    if (!threadGroup.isOpened) {
+        threadGroup.open(nullptr);
+    }
+
+    for (int e : threadGroup.events) {
+        _isAvailable[e] = true;
+    }
+
+    bool hasAnyEvent = !threadGroup.events.empty();
+    _isEnabled.store(hasAnyEvent, std::memory_order_relaxed);
+    return hasAnyEvent;
+}
+
+void PerfCounters::read(Values& values) {
+    values.fill(0);
+
+    if (!threadGroup.isOpened) {
+        threadGroup.open(&instance()._isAvailable);
+    }
+
+    if (threadGroup.leaderFd == -1) {
+        return;
+    }
+
+    // Layout with PERF_FORMAT_GROUP: { nr, values[nr] }
+    std::array<uint64_t, NUM_EVENTS + 1> buffer{};
+    if (::read(threadGroup.leaderFd, buffer.data(), sizeof(buffer)) <= 0) {
+        return;
+    }
+
+    auto numRead = std::min<uint64_t>(buffer[0], threadGroup.events.size());
+    for (uint64_t i = 0; i < numRead; i++) {
+        values[threadGroup.events[i]] = buffer[i + 1];
+    }
+}
+
+#else
+
+bool PerfCounters::enable() { return false; }
+
+void PerfCounters::read(Values& values) { values.fill(0); }
+
+#endif
+
+PerfCounters& PerfCounters::instance() {
+    static PerfCounters perfCounters;
+    return perfCounters;
+}
+
+PerfCounters::ThreadStages& PerfCounters::getThreadStages() {
+    thread_local ThreadStages* threadStages = nullptr;
+    if (threadStages == nullptr) {
+        auto lock = std::scoped_lock(_mutex);
+        threadStages =
+            _threadStages.emplace_back(std::make_unique<ThreadStages>()).get();
+    }
+    return *threadStages;
+}
+
+void PerfCounters::accumulate(const void* key,
+                              std::string_view name,
+                              const Values& begin,
+                              const Values& end) {
+    auto& threadStages = getThreadStages();
+    auto lock = std::scoped_lock(threadStages.mutex);
+
+    Stage* stage = nullptr;
+    for (auto& s : threadStages.stages) {
+        if (s.key == key) {
+            stage = &s;
+            break;
+        }
+    }
+
+    if (stage == nullptr) {
+        stage = &threadStages.stages.emplace_back(Stage{
+            .key = key,
+            .name = std::string(name),
+            .numLaps = 0,
+            .totals = {},
+        });
+    }
+
+    stage->numLaps++;
+    for (int e = 0; e < NUM_EVENTS; e++) {
+        stage->totals[e] += end[e] - begin[e];
+    }
+}
+
+std::string PerfCounters::summary() const {
+    // Merge the totals of all threads by stage, in order of first appearance
+    std::vector<Stage> stages;
+    {
+        auto lock = std::scoped_lock(_mutex);
+        for (const auto& threadStages : _threadStages) {
+            auto threadLock = std::scoped_lock(threadStages->mutex);
+            for (const auto& threadStage : threadStages->stages) {
+                auto it = std::find_if(
+                    stages.begin(), stages.end(), [&](const Stage& stage) {
+                        return stage.key == threadStage.key;
+                    });
+                if (it == stages.end()) {
+                    stages.push_back(threadStage);
+                    continue;
+                }
+
+                it->numLaps += threadStage.numLaps;
+                for (int e = 0; e < NUM_EVENTS; e++) {
+                    it->totals[e] += threadStage.totals[e];
+                }
+            }
+        }
+    }
+
+    std::string text;
+    std::array<char, 192> line;
+
+    auto append = [&text, &line](int n) {
+        text.append(line.data(), std::min<size_t>(n, line.size() - 1));
+    };
+
+    append(std::snprintf(line.data(),
+                         line.size(),
+                         "%-24s %8s %12s %12s %6s %10s %10s %10s\n",
+                         "STAGE (per lap)",
+                         "LAPS",
+                         "CYCLES",
+                         "INSTR",
+                         "IPC",
+                         "L1D-MISS",
+                         "LLC-MISS",
+                         "BR-MISS"));
+
+    for (const auto& stage : stages) {
+        double n = stage.numLaps == 0 ? 1.0 : stage.numLaps;
+        double cycles = stage.totals[CYCLES] / n;
+        double instructions = stage.totals[INSTRUCTIONS] / n;
+
+        append(std::snprintf(line.data(),
+                             line.size(),
+                             "%-24s %8llu %12.0f %12.0f %6.2f %10.0f %10.0f "
+                             "%10.0f\n",
+                             stage.name.c_str(),
+                             static_cast<unsigned long long>(stage.numLaps),
+                             cycles,
+                             instructions,
+                             cycles > 0.0 ? instructions / cycles : 0.0,
+                             stage.totals[L1D_READ_MISSES] / n,
+                             stage.totals[LLC_MISSES] / n,
+                             stage.totals[BRANCH_MISSES] / n));
+    }
+
+    return text;
+}
@@ -0,0 +1,151 @@
+/**
+ * @file perf_counters.hpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Per-stage hardware performance counters via perf_event_open (Linux)
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Hardware performance counter sampling.
+ *        Every thread that samples opens its own counter group (cycles,
+ *        instructions, L1D read misses, LLC misses, branch misses) on first
+ *        use. Deltas between two readings are attributed to named stages and
+ *        summarized per lap (one reading interval of a stage). Every thread
+ *        accumulates its own totals, merged by stage name in the summary.
+ *        On non-Linux platforms it is a no-op.
+ */
+class PerfCounters final {
+  public:
+#pragma region Public types
+
+    enum Event : int {
+        CYCLES,
+        INSTRUCTIONS,
+        L1D_READ_MISSES,
+        LLC_MISSES,
+        BRANCH_MISSES,
+        NUM_EVENTS,
+    };
+
+    using Values = std::array<uint64_t, NUM_EVENTS>;
+
+#pragma endregion
+
+#pragma region Public member methods
+
+    /**
+     * @brief Get the global instance
+     */
+    static PerfCounters& instance();
+
+    /**
+     * @brief Tells whether counters are being sampled
+     */
+    static bool isEnabled() {
+        return _isEnabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Enable sampling (probes perf_event_open on the calling thread)
+     *
+     * @return  True: at least one hardware event is available
+     *          False: perf events are unsupported or not permitted
+     */
+    bool enable();
+
+    /**
+     * @brief Read current counter values of the calling thread
+     *
+     * @param values Output counter values (unavailable events read as 0)
+     * @return
+     */
+    static void read(Values& values);
+
+    /**
+     * @brief Attribute counter deltas of one lap to a stage, in the totals of
+     * the calling thread
+     *
+     * @param key Unique key of the stage
+     * @param name Stage name
+     * @param begin Counter values at the beginning of the stage
+     * @param end Counter values at the end of the stage
+     * @return
+     */
+    void accumulate(const void* key,
+                    std::string_view name,
+                    const Values& begin,
+                    const Values& end);
+
+    /**
+     * @brief Render a per-lap summary table of all stages, merging the
+     * totals of all threads
+     *
+     * @return  Table text
+     */
+    std::string summary() const;
+
+#pragma endregion
+
+  private:
+#pragma region Private types
+
+    struct Stage {
+        const void* key;
+        std::string name;
+        uint64_t numLaps;
+        Values totals;
+    };
+
+    /**
+     * @brief Stage totals of one thread, owned by the instance so that they
+     * outlive the thread. The mutex is only contended by summary().
+     */
+    struct ThreadStages {
+        std::mutex mutex;
+        std::vector<Stage> stages;
+    };
+
+#pragma endregion
+
+#pragma region Private member variables
+
+    static std::atomic<bool> _isEnabled;
+
+    mutable std::mutex _mutex;
+    std::vector<std::unique_ptr<ThreadStages>> _threadStages;
+
+    /**
+     * @brief Availability of each event (probed by enable())
+     */
+    std::array<bool, NUM_EVENTS> _isAvailable{};
+
+#pragma endregion
+
+#pragma region Private member methods
+
+    PerfCounters() = default;
+
+    /**
+     * @brief Get the stage totals of the calling thread, registered on first
+     * use
+     *
+     * @return  Stage totals
+     */
+    ThreadStages& getThreadStages();
+
+#pragma endregion
+};
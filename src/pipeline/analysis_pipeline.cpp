@@ -0,0 +1,273 @@
+/**
+ * @file analysis_pipeline.cpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Implementation of the per-frame detect-and-track stages
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "analysis_pipeline.hpp"
+
+#include "sigma_delta.hpp"
+#include "vibe_sequential.hpp"
+
+#include <algorithm>
+
+namespace {
+
+/**
+ * @brief Sigma-Delta parameters of a config
+ *
+ * @param config Tuning parameters
+ * @return  Sigma-Delta parameters
+ */
+SigmaDeltaParams getSigmaDeltaParams(const PipelineConfig& config) {
+    return SigmaDeltaParams{
+        .amplification = config.sigmaDelta.amplification,
+        .minVariance = config.sigmaDelta.minVariance,
+        .maxVariance = config.sigmaDelta.maxVariance,
+        .differenceThreshold = config.sigmaDelta.differenceThreshold,
+        .updatePeriod = config.sigmaDelta.updatePeriod,
+    };
+}
+
+/**
+ * @brief Sample count of the background model under a cap
+ *
+ * @param numSamples Configured sample count
+ * @param maxNumSamples Max sample count (0: uncapped)
+ * @return  Sample count
+ */
+int capNumSamples(int numSamples, int maxNumSamples) {
+    return maxNumSamples > 0 ? std::min(numSamples, maxNumSamples)
+                             : numSamples;
+}
+
+} // namespace
+
+AnalysisPipeline::AnalysisPipeline(int height,
+                                   int width,
+                                   const PipelineConfig& config,
+                                   const AnalysisPipelineParams& params)
+    : _config(config),
+      _params(params),
+      _blobDetectorParams{
+          .maxNumBlobs = config.blob.maxNumBlobs,
+          .bboxMargin = config.blob.bboxMargin,
+          .engine = params.blobEngine,
+      },
+      _subtractor(makeSubtractor(height, width)),
+      _vibe(dynamic_cast<ViBeSequential*>(_subtractor.get())),
+      _blobDetector(
+          std::make_unique<BlobDetector>(height, width, _blobDetectorParams)),
+      _tracker(config.tracker.maxBBoxAge,
+               config.tracker.minBBoxHitStreak,
+               config.tracker.maxTrajectoryAge,
+               config.tracker.minTrajectoryNumSamples,
+               static_cast<int>(config.tracker.minTrajectoryFallingDistance),
+               config.tracker.iouThreshold),
+      _attention(height, width, params.attention),
+      _activeTiles(height, width),
+      _fgMask(height, width, CV_8U),
+      _updateMask(height, width, CV_8U) {
+    _detections.reserve(config.blob.maxNumBlobs + 1);
+    _predictedTracks.reserve(config.blob.maxNumBlobs + 1);
+}
+
+bool AnalysisPipeline::detect(const cv::Mat& frame) {
+    _stageTimes.fill(0);
+    _timer.reset();
+
+    // Whole frame, or only windows around the predicted tracks
+    _isFullFrame = true;
+    if (_attention.isEnabled()) {
+        _tracker.getPredictedTracks(_predictedTracks);
+        _isFullFrame = _attention.plan(_predictedTracks);
+    }
+    const auto& windows = _attention.getWindows();
+
+    // Run background segmentation
+    if (_isFullFrame) {
+        _subtractor->segment(frame, _fgMask);
+    } else {
+        _fgMask.setTo(0);
+        _updateMask.setTo(0);
+        _subtractor->segment(frame, _fgMask, windows);
+    }
+
+    // Windows of post-processing: around active tiles when sparse (none at
+    // all for an empty mask), else those of segmentation
+    bool isSparse = _activeTiles.build(_fgMask);
+    bool isFullPost = _isFullFrame && !isSparse;
+    const auto& postWindows = isSparse ? _activeTiles.getWindows() : windows;
+    lap(AnalysisStage::SEGMENT);
+
+    // Process update mask
+    if (isFullPost) {
+        _blobDetector->makeUpdateMask(_fgMask, _updateMask);
+    } else {
+        if (_isFullFrame) {
+            _updateMask.setTo(0);
+        }
+        _blobDetector->makeUpdateMask(_fgMask, _updateMask, postWindows);
+    }
+    lap(AnalysisStage::UPDATE_MASK);
+
+    // Update background model
+    if (_isFullFrame) {
+        _subtractor->update(frame, _updateMask);
+    } else {
+        _subtractor->update(frame, _updateMask, windows);
+    }
+    lap(AnalysisStage::UPDATE);
+
+    // Post-processing on foreground mask
+    if (isFullPost) {
+        _blobDetector->filter(_fgMask);
+    } else {
+        _blobDetector->filter(_fgMask, postWindows);
+    }
+    lap(AnalysisStage::FILTER);
+
+    // Find all connected components, none without foreground, so the
+    // tracker only predicts
+    _numBlobs =
+        isFullPost ? _blobDetector->extract(_fgMask, _detections)
+                   : _blobDetector->extract(_fgMask, _detections, postWindows);
+    lap(AnalysisStage::LABELLING);
+
+    _isValid = _numBlobs <= _blobDetector->getMaxNumBlobs();
+    return _isValid;
+}
+
+void AnalysisPipeline::track(const cv::Mat& frame,
+                             SortTracker::Timestamp timestamp) {
+    if (!_isValid) {
+        // Too many blobs, consider this frame invalid
+        _tracker.clear();
+        _attention.requestFullFrame();
+        return;
+    }
+
+    // Update tracker with newly detected bboxes
+    _timer.reset();
+    _tracker.update(_detections, frame, timestamp);
+    lap(AnalysisStage::TRACKING);
+}
+
+void AnalysisPipeline::resize(int height, int width) {
+    _subtractor = makeSubtractor(height, width);
+    _vibe = dynamic_cast<ViBeSequential*>(_subtractor.get());
+    setNumActiveSamples(_numActiveSamples);
+    _blobDetector =
+        std::make_unique<BlobDetector>(height, width, _blobDetectorParams);
+    _fgMask.create(height, width, CV_8U);
+    _updateMask.create(height, width, CV_8U);
+    _tracker.clear();
+    _attention = AttentionScheduler(height, width, _params.attention);
+    _activeTiles = ActiveTiles(height, width);
+}
+
+bool AnalysisPipeline::setConfig(const PipelineConfig& config) {
+    bool isModelCompatible =
+        _vibe == nullptr || _config.isModelCompatible(config);
+    _config = config;
+
+    if (_vibe == nullptr) {
+        static_cast<SigmaDelta*>(_subtractor.get())
+            ->setParams(getSigmaDeltaParams(_config));
+    } else if (isModelCompatible) {
+        _vibe->setThresholdL1(_config.vibe.thresholdL1);
+        _vibe->setMinNumCloseSamples(_config.vibe.minNumCloseSamples);
+        _vibe->setUpdateFactor(_config.vibe.updateFactor);
+    } else {
+        rebuildSubtractor();
+    }
+
+    _tracker.setBBoxThresholds(_config.tracker.maxBBoxAge,
+                               _config.tracker.minBBoxHitStreak,
+                               _config.tracker.iouThreshold);
+    _tracker.setTrajectoryThresholds(
+        _config.tracker.maxTrajectoryAge,
+        _config.tracker.minTrajectoryNumSamples,
+        _config.tracker.minTrajectoryFallingDistance);
+
+    _blobDetectorParams.maxNumBlobs = _config.blob.maxNumBlobs;
+    _blobDetectorParams.bboxMargin = _config.blob.bboxMargin;
+    _blobDetector->setMaxNumBlobs(_config.blob.maxNumBlobs);
+    _blobDetector->setBBoxMargin(_config.blob.bboxMargin);
+    _detections.reserve(_config.blob.maxNumBlobs + 1);
+
+    return !isModelCompatible;
+}
+
+bool AnalysisPipeline::setMaxNumSamples(int maxNumSamples) {
+    _maxNumSamples = maxNumSamples;
+    if (_vibe == nullptr ||
+        _vibe->getNumSamples() ==
+            capNumSamples(_config.vibe.numSamples, _maxNumSamples)) {
+        return false;
+    }
+
+    rebuildSubtractor();
+    return true;
+}
+
+void AnalysisPipeline::setNumActiveSamples(int numActiveSamples) {
+    _numActiveSamples = numActiveSamples;
+    if (_vibe != nullptr && _numActiveSamples > 0) {
+        _vibe->setNumActiveSamples(_numActiveSamples);
+    }
+}
+
+int AnalysisPipeline::getNumSamples() const {
+    return _vibe != nullptr ? _vibe->getNumSamples() : 0;
+}
+
+int AnalysisPipeline::getMinNumSamples() const {
+    return _vibe != nullptr ? _vibe->getMinNumCloseSamples() : 1;
+}
+
+const char* AnalysisPipeline::getStageName(AnalysisStage stage) {
+    switch (stage) {
+    case AnalysisStage::SEGMENT: return "segment";
+    case AnalysisStage::UPDATE_MASK: return "update_mask";
+    case AnalysisStage::UPDATE: return "update";
+    case AnalysisStage::FILTER: return "filter";
+    case AnalysisStage::LABELLING: return "labelling";
+    case AnalysisStage::TRACKING: return "tracking";
+    default: return "unknown";
+    }
+}
+
+std::unique_ptr<BackgroundSubtractor>
+AnalysisPipeline::makeSubtractor(int height, int width) const {
+    if (_params.bgEngine == BackgroundSubtractorEngine::SIGMA_DELTA) {
+        return std::make_unique<SigmaDelta>(
+            height, width, getSigmaDeltaParams(_config));
+    }
+
+    return std::make_unique<ViBeSequential>(
+        height,
+        width,
+        capNumSamples(_config.vibe.numSamples, _maxNumSamples),
+        _config.vibe.thresholdL1,
+        _config.vibe.minNumCloseSamples,
+        _config.vibe.updateFactor);
+}
+
+void AnalysisPipeline::rebuildSubtractor() {
+    _subtractor = makeSubtractor(_fgMask.rows, _fgMask.cols);
+    _vibe = dynamic_cast<ViBeSequential*>(_subtractor.get());
+    setNumActiveSamples(_numActiveSamples);
+    _tracker.clear();
+    _attention.requestFullFrame();
+}
+
+void AnalysisPipeline::lap(AnalysisStage stage) {
+    auto i = static_cast<size_t>(stage);
+    _stageTimes[i] += _timer.lap(_histograms[i]);
+}
@@ -0,0 +1,349 @@
+/**
+ * @file analysis_pipeline.hpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Per-frame detect-and-track stages shared by the application and
+ * the benchmarks
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+
+#include "active_tiles.hpp"
+#include "attention_scheduler.hpp"
+#include "background_subtractor.hpp"
+#include "blob_detector.hpp"
+#include "config.hpp"
+#include "metrics.hpp"
+#include "tracker.hpp"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <opencv2/core.hpp>
+#include <vector>
+
+class ViBeSequential;
+
+/**
+ * @brief Stage of the analysis of one frame
+ */
+enum class AnalysisStage {
+    /**
+     * @brief Attention planning and background segmentation
+     */
+    SEGMENT,
+
+    /**
+     * @brief Update mask morphology
+     */
+    UPDATE_MASK,
+
+    /**
+     * @brief Background model update
+     */
+    UPDATE,
+
+    /**
+     * @brief Foreground mask open / close filter
+     */
+    FILTER,
+
+    /**
+     * @brief Connected components labelling
+     */
+    LABELLING,
+
+    /**
+     * @brief SORT tracker update
+     */
+    TRACKING,
+
+    NUM_STAGES,
+};
+
+/**
+ * @brief Additional parameters for AnalysisPipeline class
+ */
+struct AnalysisPipelineParams {
+    /**
+     * @brief Morphology and labelling implementation
+     */
+    BlobDetectorEngine blobEngine = BlobDetectorEngine::NATIVE;
+
+    /**
+     * @brief Background subtraction implementation
+     */
+    BackgroundSubtractorEngine bgEngine = BackgroundSubtractorEngine::VIBE;
+
+    /**
+     * @brief Attention windows between full-frame passes
+     */
+    AttentionSchedulerParams attention;
+};
+
+/**
+ * @brief Runs the stages of the analysis of one frame: attention planning,
+ *        segmentation, update mask, model update, filter, labelling and
+ *        tracking, on the whole frame or on attention windows, and on the
+ *        active tiles of the foreground mask while it is sparse. Capture,
+ *        governors, idle duty-cycling and outputs stay with the caller,
+ *        which may act between detect() and track().
+ */
+class AnalysisPipeline final {
+  public:
+#pragma region Public types
+
+    /**
+     * @brief Time (ns) spent in each stage
+     */
+    using StageTimes =
+        std::array<uint64_t, static_cast<size_t>(AnalysisStage::NUM_STAGES)>;
+
+    /**
+     * @brief Histogram of each stage (nullptr: only timed)
+     */
+    using StageHistograms =
+        std::array<LatencyHistogram*,
+                   static_cast<size_t>(AnalysisStage::NUM_STAGES)>;
+
+#pragma endregion
+
+#pragma region Public member methods
+
+    /**
+     * @brief Construct a new AnalysisPipeline object
+     *
+     * @param height Frame height
+     * @param width Frame width
+     * @param config Tuning parameters (analysis scale is up to the caller,
+     * frames are processed at the size they are given)
+     * @param params Additional parameters
+     */
+    AnalysisPipeline(
+        int height,
+        int width,
+        const PipelineConfig& config,
+        const AnalysisPipelineParams& params = AnalysisPipelineParams());
+
+    /**
+     * @brief Run the stages from segmentation to labelling on a frame
+     *
+     * @param frame Frame (CV_8UC3)
+     * @return  True: valid frame
+     *          False: too many blobs, the frame is dropped by track()
+     */
+    bool detect(const cv::Mat& frame);
+
+    /**
+     * @brief Update the tracker with the detections of the last frame, or
+     * clear it (and analyse the next frame in full) if it was dropped
+     *
+     * @param frame Frame given to detect()
+     * @param timestamp Frame timestamp
+     * @return
+     */
+    void track(const cv::Mat& frame, SortTracker::Timestamp timestamp);
+
+    /**
+     * @brief Analyse one frame, detect() then track()
+     *
+     * @param frame Frame (CV_8UC3)
+     * @param timestamp Frame timestamp
+     * @return  True: frame analysed
+     *          False: frame dropped for having too many blobs
+     */
+    bool process(const cv::Mat& frame, SortTracker::Timestamp timestamp) {
+        bool isValid = detect(frame);
+        track(frame, timestamp);
+        return isValid;
+    }
+
+    /**
+     * @brief Change the frame size, size-dependent state is rebuilt and the
+     * tracker cleared
+     *
+     * @param height Frame height
+     * @param width Frame width
+     * @return
+     */
+    void resize(int height, int width);
+
+    /**
+     * @brief Apply new tuning parameters between two frames. Thresholds
+     * take effect in place, a new ViBe sample count rebuilds the background
+     * model.
+     *
+     * @param config Tuning parameters
+     * @return  True: background model rebuilt
+     */
+    bool setConfig(const PipelineConfig& config);
+
+    /**
+     * @brief Cap the sample count of the background model, rebuilding it if
+     * the count changes
+     *
+     * @param maxNumSamples Max sample count (0: as configured)
+     * @return  True: background model rebuilt
+     */
+    bool setMaxNumSamples(int maxNumSamples);
+
+    /**
+     * @brief Set the number of samples compared per pixel, kept across
+     * rebuilds of the model (ViBe only)
+     *
+     * @param numActiveSamples Active sample count (0: all)
+     * @return
+     */
+    void setNumActiveSamples(int numActiveSamples);
+
+    /**
+     * @brief Get the sample count of the background model
+     *
+     * @return  Sample count (0: not sample based)
+     */
+    int getNumSamples() const;
+
+    /**
+     * @brief Get the min active sample count of the background model
+     *
+     * @return  Min sample count
+     */
+    int getMinNumSamples() const;
+
+    /**
+     * @brief Record stage times of following frames in histograms
+     *
+     * @param histograms Histogram of each stage
+     * @return
+     */
+    void setStageHistograms(const StageHistograms& histograms) {
+        _histograms = histograms;
+    }
+
+    /**
+     * @brief Get the time spent in each stage of the last frame
+     *
+     * @return  Stage times, stages that did not run are zero
+     */
+    const StageTimes& getLastStageTimes() const { return _stageTimes; }
+
+    /**
+     * @brief Tells whether the last frame was analysed in full
+     *
+     * @return  False: attention windows only
+     */
+    bool isFullFrame() const { return _isFullFrame; }
+
+    /**
+     * @brief Tells whether the last frame had no foreground at all, its
+     * post-processing was skipped
+     *
+     * @return  True: empty foreground mask
+     */
+    bool isEmpty() const { return _activeTiles.getNumActiveTiles() == 0; }
+
+    /**
+     * @brief Get the number of blobs found in the last frame
+     *
+     * @return  Number of blobs, beyond the max for a dropped frame
+     */
+    int getNumBlobs() const { return _numBlobs; }
+
+    const cv::Mat& getFgMask() const { return _fgMask; }
+
+    const cv::Mat& getUpdateMask() const { return _updateMask; }
+
+    const std::vector<cv::Rect2f>& getDetections() const {
+        return _detections;
+    }
+
+    const BackgroundSubtractor& getSubtractor() const { return *_subtractor; }
+
+    const BlobDetector& getBlobDetector() const { return *_blobDetector; }
+
+    SortTracker& getTracker() { return _tracker; }
+
+    const SortTracker& getTracker() const { return _tracker; }
+
+    const AttentionScheduler& getAttention() const { return _attention; }
+
+#pragma endregion
+
+#pragma region Static methods
+
+    /**
+     * @brief Get the name of a stage
+     *
+     * @param stage Stage
+     * @return  Name
+     */
+    static const char* getStageName(AnalysisStage stage);
+
+#pragma endregion
+
+  private:
+#pragma region Private member variables
+
+    PipelineConfig _config;
+    AnalysisPipelineParams _params;
+    BlobDetectorParams _blobDetectorParams;
+    int _maxNumSamples = 0;
+    int _numActiveSamples = 0;
+
+    std::unique_ptr<BackgroundSubtractor> _subtractor;
+    // Sample count and thresholds only apply to ViBe
+    ViBeSequential* _vibe = nullptr;
+    std::unique_ptr<BlobDetector> _blobDetector;
+    SortTracker _tracker;
+    AttentionScheduler _attention;
+    ActiveTiles _activeTiles;
+
+    cv::Mat _fgMask;
+    cv::Mat _updateMask;
+    std::vector<cv::Rect2f> _detections;
+    std::vector<AttentionScheduler::Prediction> _predictedTracks;
+
+    /* Last frame */
+    bool _isFullFrame = true;
+    bool _isValid = true;
+    int _numBlobs = 0;
+
+    StageTimer _timer;
+    StageHistograms _histograms{};
+    StageTimes _stageTimes{};
+
+#pragma endregion
+
+#pragma region Private member methods
+
+    /**
+     * @brief Create the background subtractor of the configured engine and
+     * sample count
+     *
+     * @param height Frame height
+     * @param width Frame width
+     * @return  Background subtractor
+     */
+    std::unique_ptr<BackgroundSubtractor> makeSubtractor(int height,
+                                                         int width) const;
+
+    /**
+     * @brief Rebuild the background model, the tracker is cleared
+     *
+     * @return
+     */
+    void rebuildSubtractor();
+
+    /**
+     * @brief Account the time since the last lap to a stage
+     *
+     * @param stage Stage
+     * @return
+     */
+    void lap(AnalysisStage stage);
+
+#pragma endregion
+};
@@ -0,0 +1,79 @@
+/**
+ * @file attention_scheduler.cpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Implementation of tracker-guided attention windows
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "attention_scheduler.hpp"
+
+#include "active_tiles.hpp"
+
+#include <cmath>
+
+AttentionScheduler::AttentionScheduler(int height,
+                                       int width,
+                                       const AttentionSchedulerParams& params)
+    : _h(height),
+      _w(width),
+      _params(params),
+      _numFramesSinceFull(0),
+      _isFullFrameRequested(true),
+      _coverage(1.0),
+      _numWindowFrames(0) {}
+
+bool AttentionScheduler::plan(const std::vector<Prediction>& predictions) {
+    bool isFullFrame = !isEnabled() || _isFullFrameRequested ||
+                       _numFramesSinceFull + 1 >= _params.fullFrameInterval;
+
+    if (!isFullFrame) {
+        int64_t area = makeWindows(predictions);
+        _coverage = static_cast<double>(area) / (static_cast<double>(_h) * _w);
+        isFullFrame = _coverage > _params.maxWindowCoverage;
+    }
+
+    if (isFullFrame) {
+        _windows.clear();
+        _coverage = 1.0;
+        _numFramesSinceFull = 0;
+        _isFullFrameRequested = false;
+        return true;
+    }
+
+    _numFramesSinceFull++;
+    _numWindowFrames++;
+    return false;
+}
+
+int64_t
+AttentionScheduler::makeWindows(const std::vector<Prediction>& predictions) {
+    auto frame = cv::Rect(0, 0, _w, _h);
+    int margin = _params.windowMargin;
+
+    _windows.clear();
+    for (const auto& [tag, bbox] : predictions) {
+        int x0 = static_cast<int>(std::floor(bbox.x)) - margin;
+        int y0 = static_cast<int>(std::floor(bbox.y)) - margin;
+        int x1 = static_cast<int>(std::ceil(bbox.x + bbox.width)) + margin;
+        int y1 = static_cast<int>(std::ceil(bbox.y + bbox.height)) + margin;
+        x0 = ActiveTiles::alignLeft(x0);
+
+        auto window = cv::Rect(x0, y0, x1 - x0, y1 - y0) & frame;
+        if (!window.empty()) {
+            _windows.push_back(window);
+        }
+    }
+
+    // Merged unions stay aligned
+    ActiveTiles::mergeWindows(_windows);
+
+    int64_t area = 0;
+    for (const auto& window : _windows) {
+        area += window.area();
+    }
+    return area;
+}
@@ -0,0 +1,136 @@
+/**
+ * @file attention_scheduler.hpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Tracker-guided attention windows between full-frame analyses
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+
+#include <cstdint>
+#include <opencv2/core.hpp>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Additional parameters for AttentionScheduler class
+ */
+struct AttentionSchedulerParams {
+    /**
+     * @brief Analyse the whole frame once every n frames, only the windows
+     * in between (1: every frame is analysed in full)
+     */
+    int fullFrameInterval = 1;
+
+    /**
+     * @brief Margin (pixels) around each predicted bbox, covers the
+     * prediction error and the morphology of the window edges
+     */
+    int windowMargin = 24;
+
+    /**
+     * @brief Max fraction of the frame covered by windows, a frame needing
+     * more is analysed in full
+     */
+    double maxWindowCoverage = 0.5;
+};
+
+/**
+ * @brief Decides per frame whether to analyse the whole frame or only
+ *        windows around the bboxes the tracker predicts for it.
+ *        Window frames keep the tracks at full rate while costing only the
+ *        area around them, and the full frames catch new objects. Windows
+ *        are the predicted bboxes plus a margin, with left edges aligned to
+ *        16 pixels for vector loops, merged until disjoint and not touching,
+ *        so that a blob never spans two windows.
+ */
+class AttentionScheduler final {
+  public:
+#pragma region Public types
+
+    using Prediction = std::pair<int, cv::Rect2f>;
+
+#pragma endregion
+
+#pragma region Public member methods
+
+    /**
+     * @brief Construct a new AttentionScheduler object
+     *
+     * @param height Frame height
+     * @param width Frame width
+     * @param params Additional parameters
+     */
+    AttentionScheduler(
+        int height,
+        int width,
+        const AttentionSchedulerParams& params = AttentionSchedulerParams());
+
+    /**
+     * @brief Plan the analysis of the next frame
+     *
+     * @param predictions Tracks predicted for the next frame
+     * @return  True: analyse the whole frame
+     *          False: analyse getWindows() only
+     */
+    bool plan(const std::vector<Prediction>& predictions);
+
+    /**
+     * @brief Get the windows planned for the next frame
+     *
+     * @return  Disjoint windows inside the frame (may be empty when nothing
+     * is tracked)
+     */
+    const std::vector<cv::Rect>& getWindows() const { return _windows; }
+
+    /**
+     * @brief Analyse the next frame in full, e.g. after the tracker was
+     * cleared
+     *
+     * @return
+     */
+    void requestFullFrame() { _isFullFrameRequested = true; }
+
+    /**
+     * @brief Get the fraction of the frame covered by the last windows
+     *
+     * @return  Coverage (1: the last frame was analysed in full)
+     */
+    double getCoverage() const { return _coverage; }
+
+    bool isEnabled() const { return _params.fullFrameInterval > 1; }
+
+    uint64_t getNumWindowFrames() const { return _numWindowFrames; }
+
+#pragma endregion
+
+  private:
+#pragma region Private member variables
+
+    int _h;
+    int _w;
+    AttentionSchedulerParams _params;
+
+    std::vector<cv::Rect> _windows;
+    int _numFramesSinceFull;
+    bool _isFullFrameRequested;
+    double _coverage;
+    uint64_t _numWindowFrames;
+
+#pragma endregion
+
+#pragma region Private member methods
+
+    /**
+     * @brief Build the windows of predicted bboxes
+     *
+     * @param predictions Predicted tracks
+     * @return  Number of pixels covered
+     */
+    int64_t makeWindows(const std::vector<Prediction>& predictions);
+
+#pragma endregion
+};
@@ -0,0 +1,223 @@
+/**
+ * @file cpu_placement.cpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief CPU affinity and scheduling policy of pipeline threads
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "cpu_placement.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+CpuPlacement CpuPlacement::parse(std::string_view spec, int captureRtPriority) {
+    auto placement = CpuPlacement();
+    placement._captureRtPriority = captureRtPriority;
+
+    while (!spec.empty()) {
+        size_t end = spec.find(';');
+        auto item = spec.substr(0, end);
+        spec = end == std::string_view::npos ? std::string_view()
+                                             : spec.substr(end + 1);
+
+        if (item.empty()) {
+            continue;
+        }
+
+        size_t delimiterPos = item.find('=');
+        if (delimiterPos == std::string_view::npos) {
+            throw std::invalid_argument("CPU placement: missing '=' in '" +
+                                        std::string(item) + "'");
+        }
+
+        auto name = item.substr(0, delimiterPos);
+        auto cpus = parseCpuList(item.substr(delimiterPos + 1));
+
+        bool isKnownRole = false;
+        for (int r = 0; r < NUM_ROLES; r++) {
+            if (name == getRoleName(static_cast<PipelineRole>(r))) {
+                placement._cpus[r] = std::move(cpus);
+                isKnownRole = true;
+                break;
+            }
+        }
+
+        if (!isKnownRole) {
+            throw std::invalid_argument("CPU placement: unknown role '" +
+                                        std::string(name) + "'");
+        }
+    }
+
+    return placement;
+}
+
+bool CpuPlacement::empty() const {
+    if (_captureRtPriority > 0) {
+        return false;
+    }
+
+    for (const auto& cpus : _cpus) {
+        if (!cpus.empty()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+std::string_view CpuPlacement::getRoleName(PipelineRole role) {
+    switch (role) {
+    case PipelineRole::CAPTURE: return "capture";
+    case PipelineRole::ANALYSIS: return "analysis";
+    case PipelineRole::AUX: return "aux";
+    }
+    return "unknown";
+}
+
+std::vector<int> CpuPlacement::parseCpuList(std::string_view list) {
+    std::vector<int> cpus;
+
+    while (!list.empty()) {
+        size_t end = list.find(',');
+        auto range = std::string(list.substr(0, end));
+        list = end == std::string_view::npos ? std::string_view()
+                                             : list.substr(end + 1);
+
+        if (range.empty()) {
+            continue;
+        }
+
+        try {
+            size_t dashPos = range.find('-');
+            int first = std::stoi(range.substr(0, dashPos));
+            int last = dashPos == std::string::npos
+                           ? first
+                           : std::stoi(range.substr(dashPos + 1));
+
+            if (first < 0 || last < first) {
+                throw std::invalid_argument(range);
+            }
+
+            for (int cpu = first; cpu <= last; cpu++) {
+                cpus.push_back(cpu);
+            }
+        } catch (const std::logic_error&) {
+            throw std::invalid_argument("CPU placement: bad CPU list '" +
+                                        range + "'");
+        }
+    }
+
+    return cpus;
+}
+
+#if defined(__linux__)
+
+bool CpuPlacement::apply(PipelineRole role) const {
+    const auto& cpus = getCpus(role);
+    auto roleName = getRoleName(role);
+    bool isSuccessful = true;
+
+    if (!cpus.empty()) {
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        for (int cpu : cpus) {
+            if (cpu < CPU_SETSIZE) {
+                CPU_SET(cpu, &cpuSet);
+            }
+        }
+
+        // pid 0 is the calling thread
+        if (sched_setaffinity(0, sizeof(cpuSet), &cpuSet) != 0) {
+            std::printf("[CPU PLACEMENT] Failed to pin %.*s thread: %s\n",
+                        static_cast<int>(roleName.size()),
+                        roleName.data(),
+                        std::strerror(errno));
+            isSuccessful = false;
+        }
+    }
+
+    if (role == PipelineRole::CAPTURE && _captureRtPriority > 0) {
+        auto param = sched_param{};
+        param.sched_priority = _captureRtPriority;
+
+        if (sched_setscheduler(0, SCHED_FIFO, &param) != 0) {
+            std::printf("[CPU PLACEMENT] Failed to set SCHED_FIFO %d on "
+                        "%.*s thread: %s\n",
+                        _captureRtPriority,
+                        static_cast<int>(roleName.size()),
+                        roleName.data(),
+                        std::strerror(errno));
+            isSuccessful = false;
+        }
+    }
+
+    std::printf("[CPU PLACEMENT] %.*s: %s\n",
+                static_cast<int>(roleName.size()),
+                roleName.data(),
+                describeCurrentThread().c_str());
+
+    return isSuccessful;
+}
+
+std::string CpuPlacement::describeCurrentThread() {
+    std::string text = "cpus {";
+
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    if (sched_getaffinity(0, sizeof(cpuSet), &cpuSet) == 0) {
+        bool isFirst = true;
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &cpuSet)) {
+                text += isFirst ? "" : ",";
+                text += std::to_string(cpu);
+                isFirst = false;
+            }
+        }
+    }
+    text += "}, ";
+
+    int policy = sched_getscheduler(0);
+    auto param = sched_param{};
+    sched_getparam(0, &param);
+
+    switch (policy) {
+    case SCHED_FIFO:
+        text += "SCHED_FIFO " + std::to_string(param.sched_priority);
+        break;
+    case SCHED_RR:
+        text += "SCHED_RR " + std::to_string(param.sched_priority);
+        break;
+    default: text += "SCHED_OTHER"; break;
+    }
+
+    text += ", running on " + std::to_string(sched_getcpu());
+    return text;
+}
+
+#else
+
+bool CpuPlacement::apply(PipelineRole role) const {
+    if (!empty()) {
+        auto roleName = getRoleName(role);
+        std::printf("[CPU PLACEMENT] Not supported on this platform, %.*s "
+                    "thread is not pinned\n",
+                    static_cast<int>(roleName.size()),
+                    roleName.data());
+    }
+    return empty();
+}
+
+std::string CpuPlacement::describeCurrentThread() { return "unknown"; }
+
+#endif
@@ -0,0 +1,137 @@
+/**
+ * @file cpu_placement.hpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief CPU affinity and scheduling policy of pipeline threads
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+
+#include <array>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Roles of pipeline threads that can be placed on CPUs
+ */
+enum class PipelineRole {
+    /**
+     * @brief Stream reading and decoding
+     */
+    CAPTURE,
+
+    /**
+     * @brief Segmentation, blob detection and tracking
+     */
+    ANALYSIS,
+
+    /**
+     * @brief Background helpers (metrics export etc.)
+     */
+    AUX,
+};
+
+/**
+ * @brief CPU placement policy: a CPU set per pipeline role and an optional
+ * real-time priority for the capture thread.
+ *
+ *        Spec format: "capture=0;analysis=1-2;aux=3", each CPU list uses the
+ *        Linux cpuset notation ("0-2,5"). Roles left out are not pinned.
+ */
+class CpuPlacement final {
+  public:
+#pragma region Public member methods
+
+    /**
+     * @brief Construct an empty placement (nothing pinned)
+     */
+    CpuPlacement() = default;
+
+    /**
+     * @brief Parse a placement spec
+     *
+     * @param spec Placement spec, e.g. "capture=0;analysis=1-2;aux=3"
+     * @param captureRtPriority SCHED_FIFO priority of the capture thread
+     * (0: keep the default scheduler)
+     * @return  Parsed placement
+     * @throw   std::invalid_argument on malformed spec
+     */
+    static CpuPlacement parse(std::string_view spec, int captureRtPriority = 0);
+
+    /**
+     * @brief Apply the placement of a role to the calling thread. Threads
+     * created afterwards by this thread inherit its CPU set.
+     *
+     * @param role Role of the calling thread
+     * @return  True: applied (or nothing to apply)
+     *          False: failed, the thread keeps running unpinned
+     */
+    bool apply(PipelineRole role) const;
+
+    /**
+     * @brief Get CPUs assigned to a role
+     *
+     * @param role Pipeline role
+     * @return  CPU indices (empty: not pinned)
+     */
+    const std::vector<int>& getCpus(PipelineRole role) const {
+        return _cpus[static_cast<int>(role)];
+    }
+
+    /**
+     * @brief Tells whether any role is pinned or prioritized
+     */
+    bool empty() const;
+
+#pragma endregion
+
+#pragma region Static methods
+
+    /**
+     * @brief Get the name of a role
+     *
+     * @param role Pipeline role
+     * @return  Role name
+     */
+    static std::string_view getRoleName(PipelineRole role);
+
+    /**
+     * @brief Describe the current CPU affinity and scheduler of the calling
+     * thread
+     *
+     * @return  Description, e.g. "cpus {1,2}, SCHED_OTHER, running on 2"
+     */
+    static std::string describeCurrentThread();
+
+#pragma endregion
+
+  private:
+#pragma region Private constants
+
+    static constexpr int NUM_ROLES = 3;
+
+#pragma endregion
+
+#pragma region Private member variables
+
+    std::array<std::vector<int>, NUM_ROLES> _cpus;
+    int _captureRtPriority = 0;
+
+#pragma endregion
+
+#pragma region Static helper methods
+
+    /**
+     * @brief Parse a CPU list in cpuset notation
+     *
+     * @param list CPU list, e.g. "0-2,5"
+     * @return  CPU indices
+     */
+    static std::vector<int> parseCpuList(std::string_view list);
+
+#pragma endregion
+};
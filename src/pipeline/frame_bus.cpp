@@ -0,0 +1,353 @@
+/**
+ * @file frame_bus.cpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Shared memory ring of decoded frames for other local processes
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "frame_bus.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+constexpr char MAGIC[8] = {'F', 'O', 'D', 'F', 'B', 'U', 'S', '\0'};
+constexpr uint32_t VERSION = 1;
+constexpr size_t CACHE_LINE_SIZE = 64;
+
+size_t alignUp(size_t size, size_t alignment) {
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+size_t getMetadataSize(uint32_t numSlots) {
+    return sizeof(FrameBusHeader) + numSlots * sizeof(FrameBusSlot);
+}
+
+} // namespace
+
+FrameBusPublisher::FrameBusPublisher(const std::string& name,
+                                     size_t maxFrameBytes,
+                                     int numSlots)
+    : _name(name) {
+    auto n = static_cast<uint32_t>(std::max(numSlots, 2));
+    auto pageSize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    size_t slotCapacity = alignUp(maxFrameBytes, CACHE_LINE_SIZE);
+    size_t dataOffset = alignUp(getMetadataSize(n), pageSize);
+    _mappedSize = dataOffset + n * slotCapacity;
+
+    // Readers of a previous producer keep their (closed) mapping
+    ::shm_unlink(name.c_str());
+
+    int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0660);
+    if (fd < 0) {
+        std::printf("[FRAME BUS] Cannot create %s: %s\n",
+                    name.c_str(),
+                    std::strerror(errno));
+        return;
+    }
+
+    void* mapped = MAP_FAILED;
+    if (::ftruncate(fd, static_cast<off_t>(_mappedSize)) == 0) {
+        mapped = ::mmap(nullptr,
+                        _mappedSize,
+                        PROT_READ | PROT_WRITE,
+                        MAP_SHARED,
+                        fd,
+                        0);
+    }
+    ::close(fd);
+
+    if (mapped == MAP_FAILED) {
+        std::printf("[FRAME BUS] Cannot map %s: %s\n",
+                    name.c_str(),
+                    std::strerror(errno));
+        ::shm_unlink(name.c_str());
+        return;
+    }
+
+    // The object is zero-filled, which is a valid initial state for the
+    // atomics, fill in the geometry and publish the magic last
+    _header = static_cast<FrameBusHeader*>(mapped);
+    _slots = reinterpret_cast<FrameBusSlot*>(_header + 1);
+    _data = static_cast<uint8_t*>(mapped) + dataOffset;
+
+    _header->version = VERSION;
+    _header->numSlots = n;
+    _header->slotCapacity = slotCapacity;
+    _header->dataOffset = dataOffset;
+    _header->producerPid = static_cast<uint32_t>(::getpid());
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(_header->magic, MAGIC, sizeof(MAGIC));
+
+    std::printf("[FRAME BUS] Publishing on %s: %u slots of %zu bytes\n",
+                name.c_str(),
+                n,
+                slotCapacity);
+}
+
+FrameBusPublisher::~FrameBusPublisher() {
+    if (_header == nullptr) {
+        return;
+    }
+
+    _header->isClosed.store(1, std::memory_order_release);
+    ::munmap(_header, _mappedSize);
+    ::shm_unlink(_name.c_str());
+}
+
+bool FrameBusPublisher::publish(const cv::Mat& frame, int64_t timestampNs) {
+    if (_header == nullptr) {
+        return false;
+    }
+
+    size_t rowBytes = frame.cols * frame.elemSize();
+    if (rowBytes * frame.rows > _header->slotCapacity) {
+        return false;
+    }
+
+    uint64_t sequence = _header->numPublished.load(std::memory_order_relaxed);
+    uint32_t index = sequence % _header->numSlots;
+    auto& slot = _slots[index];
+    uint8_t* data = _data + index * _header->slotCapacity;
+
+    // Odd version while writing
+    uint64_t version = slot.version.load(std::memory_order_relaxed);
+    slot.version.store(version + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.sequence.store(sequence, std::memory_order_relaxed);
+    slot.timestampNs.store(timestampNs, std::memory_order_relaxed);
+    slot.rows.store(frame.rows, std::memory_order_relaxed);
+    slot.cols.store(frame.cols, std::memory_order_relaxed);
+    slot.type.store(frame.type(), std::memory_order_relaxed);
+    slot.step.store(static_cast<int32_t>(rowBytes), std::memory_order_relaxed);
+
+    if (frame.isContinuous()) {
+        std::memcpy(data, frame.data, rowBytes * frame.rows);
+    } else {
+        for (int y = 0; y < frame.rows; y++) {
+            std::memcpy(data + y * rowBytes, frame.ptr(y), rowBytes);
+        }
+    }
+
+    slot.version.store(version + 2, std::memory_order_release);
+    _header->numPublished.store(sequence + 1, std::memory_order_release);
+    return true;
+}
+
+int FrameBusPublisher::getNumReaders() const {
+    if (_header == nullptr) {
+        return 0;
+    }
+
+    int numReaders = 0;
+    for (const auto& cursor : _header->cursors) {
+        auto pid = static_cast<pid_t>(cursor.pid.load());
+        // Ignore cursors left behind by readers that died
+        if (pid != 0 && (::kill(pid, 0) == 0 || errno == EPERM)) {
+            numReaders++;
+        }
+    }
+    return numReaders;
+}
+
+uint64_t FrameBusPublisher::getNumPublished() const {
+    return _header == nullptr ? 0 : _header->numPublished.load();
+}
+
+FrameBusSubscriber::FrameBusSubscriber(const std::string& name) {
+    int fd = ::shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        return;
+    }
+
+    struct stat objectStat {};
+    if (::fstat(fd, &objectStat) != 0 ||
+        static_cast<size_t>(objectStat.st_size) < sizeof(FrameBusHeader)) {
+        ::close(fd);
+        return;
+    }
+
+    _mappedSize = static_cast<size_t>(objectStat.st_size);
+    void* mapped = ::mmap(
+        nullptr, _mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapped == MAP_FAILED) {
+        return;
+    }
+
+    auto* header = static_cast<FrameBusHeader*>(mapped);
+    bool isValid = std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) == 0;
+    std::atomic_thread_fence(std::memory_order_acquire);
+    isValid = isValid && header->version == VERSION &&
+              header->dataOffset >= getMetadataSize(header->numSlots) &&
+              header->dataOffset + header->numSlots * header->slotCapacity <=
+                  _mappedSize;
+
+    if (!isValid) {
+        ::munmap(mapped, _mappedSize);
+        return;
+    }
+
+    _header = header;
+    _slots = reinterpret_cast<FrameBusSlot*>(_header + 1);
+    _data = static_cast<const uint8_t*>(mapped) + _header->dataOffset;
+    _nextSequence = _header->numPublished.load(std::memory_order_acquire);
+    if (_nextSequence > 0) {
+        _nextSequence--;
+    }
+
+    // Take a free cursor, reading works without one
+    auto pid = static_cast<uint32_t>(::getpid());
+    for (auto& cursor : _header->cursors) {
+        uint32_t expected = 0;
+        if (cursor.pid.compare_exchange_strong(expected, pid)) {
+            cursor.sequence.store(_nextSequence);
+            cursor.numSkipped.store(0);
+            _cursor = &cursor;
+            break;
+        }
+    }
+}
+
+FrameBusSubscriber::~FrameBusSubscriber() {
+    if (_header == nullptr) {
+        return;
+    }
+
+    if (_cursor != nullptr) {
+        _cursor->pid.store(0);
+    }
+    ::munmap(_header, _mappedSize);
+}
+
+bool FrameBusSubscriber::isClosed() const {
+    return _header == nullptr ||
+           _header->isClosed.load(std::memory_order_acquire) != 0;
+}
+
+bool FrameBusSubscriber::read(cv::Mat& frame, int timeoutMs) {
+    uint64_t version = 0;
+    while (const auto* slot = acquire(timeoutMs, version)) {
+        int rows = slot->rows.load(std::memory_order_relaxed);
+        int cols = slot->cols.load(std::memory_order_relaxed);
+        int type = slot->type.load(std::memory_order_relaxed);
+        auto step =
+            static_cast<size_t>(slot->step.load(std::memory_order_relaxed));
+        const uint8_t* data = _data + (slot - _slots) * _header->slotCapacity;
+
+        // Metadata may be torn too, only trust it after validation
+        if (rows > 0 && cols > 0 && step * rows <= _header->slotCapacity) {
+            frame.create(rows, cols, type);
+            size_t rowBytes = std::min(step, frame.cols * frame.elemSize());
+            for (int y = 0; y < rows; y++) {
+                std::memcpy(frame.ptr(y), data + y * step, rowBytes);
+            }
+        }
+
+        if (validate(slot, version)) {
+            return true;
+        }
+
+        // Overwritten while copying
+        _numSkipped++;
+    }
+
+    return false;
+}
+
+bool FrameBusSubscriber::view(cv::Mat& view, int timeoutMs) {
+    uint64_t version = 0;
+    const auto* slot = acquire(timeoutMs, version);
+    if (slot == nullptr) {
+        return false;
+    }
+
+    auto* data = const_cast<uint8_t*>(_data) +
+                 (slot - _slots) * _header->slotCapacity;
+    auto step = static_cast<size_t>(slot->step.load(std::memory_order_relaxed));
+    view = cv::Mat(slot->rows.load(std::memory_order_relaxed),
+                   slot->cols.load(std::memory_order_relaxed),
+                   slot->type.load(std::memory_order_relaxed),
+                   data,
+                   step);
+
+    _lastSlot = slot;
+    _lastVersion = version;
+    return true;
+}
+
+bool FrameBusSubscriber::isViewValid() const {
+    return _lastSlot != nullptr && validate(_lastSlot, _lastVersion);
+}
+
+const FrameBusSlot* FrameBusSubscriber::acquire(int timeoutMs,
+                                                uint64_t& version) {
+    if (_header == nullptr) {
+        return nullptr;
+    }
+
+    auto deadline = std::chrono::steady_clock::now() +
+                    std::chrono::milliseconds(timeoutMs);
+    uint32_t numSlots = _header->numSlots;
+
+    while (!isClosed()) {
+        uint64_t numPublished =
+            _header->numPublished.load(std::memory_order_acquire);
+
+        if (numPublished <= _nextSequence) {
+            if (std::chrono::steady_clock::now() >= deadline) {
+                return nullptr;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+
+        // Fell a ring behind, the producer may be rewriting our next slot,
+        // jump to the newest frame
+        if (numPublished - _nextSequence >= numSlots) {
+            _numSkipped += numPublished - 1 - _nextSequence;
+            _nextSequence = numPublished - 1;
+        }
+
+        const auto& slot = _slots[_nextSequence % numSlots];
+        version = slot.version.load(std::memory_order_acquire);
+        uint64_t sequence = _nextSequence++;
+
+        if (version % 2 != 0 ||
+            slot.sequence.load(std::memory_order_relaxed) != sequence) {
+            _numSkipped++;
+            continue;
+        }
+
+        _lastSequence = sequence;
+        _lastTimestampNs = slot.timestampNs.load(std::memory_order_relaxed);
+        if (_cursor != nullptr) {
+            _cursor->sequence.store(_nextSequence, std::memory_order_relaxed);
+            _cursor->numSkipped.store(_numSkipped, std::memory_order_relaxed);
+        }
+        return &slot;
+    }
+
+    return nullptr;
+}
+
+bool FrameBusSubscriber::validate(const FrameBusSlot* slot,
+                                  uint64_t version) const {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot->version.load(std::memory_order_relaxed) == version;
+}
@@ -0,0 +1,256 @@
+/**
+ * @file frame_bus.hpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Shared memory ring of decoded frames for other local processes
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <opencv2/core.hpp>
+#include <string>
+
+/*
+ * Layout of the shared memory object:
+ *
+ *   FrameBusHeader | FrameBusSlot x numSlots | (page aligned) frame data x
+ *   numSlots
+ *
+ * Frame n is written to slot n % numSlots. Each slot is a seqlock: its
+ * version is odd while the producer writes it, so a reader copies (or uses in
+ * place) a frame and then checks that the version has not moved. The
+ * producer never waits for readers, a reader that falls more than a ring
+ * behind skips to the newest frame.
+ */
+
+/**
+ * @brief Position of a subscribed reader, for monitoring only
+ */
+struct FrameBusCursor {
+    std::atomic<uint32_t> pid;
+    uint32_t reserved;
+    std::atomic<uint64_t> sequence;   // Next frame to read
+    std::atomic<uint64_t> numSkipped; // Frames skipped for being too slow
+};
+
+/**
+ * @brief Frame slot metadata
+ */
+struct FrameBusSlot {
+    std::atomic<uint64_t> version;  // Seqlock version, odd while writing
+    std::atomic<uint64_t> sequence; // Frame sequence number
+    std::atomic<int64_t> timestampNs;
+    std::atomic<int32_t> rows;
+    std::atomic<int32_t> cols;
+    std::atomic<int32_t> type;
+    std::atomic<int32_t> step;
+};
+
+/**
+ * @brief Header of the shared memory object
+ */
+struct FrameBusHeader {
+    static constexpr int MAX_NUM_READERS = 16;
+
+    char magic[8];
+    uint32_t version;
+    uint32_t numSlots;
+    uint64_t slotCapacity; // Bytes of frame data per slot
+    uint64_t dataOffset;   // Offset of the frame data of slot 0
+    uint32_t producerPid;
+    std::atomic<uint32_t> isClosed;
+    std::atomic<uint64_t> numPublished;
+    FrameBusCursor cursors[MAX_NUM_READERS];
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "Frame bus needs lock-free 64-bit atomics in shared memory");
+
+/**
+ * @brief Publishes frames onto a named POSIX shared memory ring
+ */
+class FrameBusPublisher final {
+  public:
+#pragma region Public member methods
+
+    /**
+     * @brief Construct a new FrameBusPublisher object, (re)creates the shared
+     * memory object
+     *
+     * @param name Shared memory object name (e.g. "/fod_cam0")
+     * @param maxFrameBytes Largest frame to publish (bytes)
+     * @param numSlots Number of frames in the ring
+     */
+    FrameBusPublisher(const std::string& name,
+                      size_t maxFrameBytes,
+                      int numSlots = 4);
+
+    /**
+     * @brief Destroy the FrameBusPublisher object, readers see the bus closed
+     * and the object is unlinked
+     */
+    ~FrameBusPublisher();
+
+    FrameBusPublisher(const FrameBusPublisher&) = delete;
+    FrameBusPublisher& operator=(const FrameBusPublisher&) = delete;
+
+    bool isOpened() const { return _header != nullptr; }
+
+    /**
+     * @brief Publish a frame (copied into the next slot)
+     *
+     * @param frame Frame
+     * @param timestampNs Timestamp of the frame (ns)
+     * @return  True: Published
+     *          False: Frame too large or bus not opened
+     */
+    bool publish(const cv::Mat& frame, int64_t timestampNs);
+
+    /**
+     * @brief Get the number of subscribed readers
+     *
+     * @return  Number of readers
+     */
+    int getNumReaders() const;
+
+    uint64_t getNumPublished() const;
+
+#pragma endregion
+
+  private:
+#pragma region Private member variables
+
+    std::string _name;
+    size_t _mappedSize = 0;
+    FrameBusHeader* _header = nullptr;
+    FrameBusSlot* _slots = nullptr;
+    uint8_t* _data = nullptr;
+
+#pragma endregion
+};
+
+/**
+ * @brief Reads frames from a shared memory ring published by another process
+ */
+class FrameBusSubscriber final {
+  public:
+#pragma region Public member methods
+
+    /**
+     * @brief Construct a new FrameBusSubscriber object, maps the shared memory
+     * object and starts from the newest frame
+     *
+     * @param name Shared memory object name
+     */
+    explicit FrameBusSubscriber(const std::string& name);
+
+    /**
+     * @brief Destroy the FrameBusSubscriber object, gives the cursor back
+     */
+    ~FrameBusSubscriber();
+
+    FrameBusSubscriber(const FrameBusSubscriber&) = delete;
+    FrameBusSubscriber& operator=(const FrameBusSubscriber&) = delete;
+
+    bool isOpened() const { return _header != nullptr; }
+
+    /**
+     * @brief Tells whether the producer has closed the bus (reopen to follow
+     * a restarted producer)
+     *
+     * @return  True: Closed
+     */
+    bool isClosed() const;
+
+    /**
+     * @brief Copy the next frame
+     *
+     * @param frame Output frame, only reallocated when its size changes
+     * @param timeoutMs Time to wait for a new frame
+     * @return  True: Frame read
+     *          False: Timed out or bus closed
+     */
+    bool read(cv::Mat& frame, int timeoutMs = 1000);
+
+    /**
+     * @brief Map the next frame in place, without copying. Results computed
+     * from it are only valid if isViewValid() is still true afterwards.
+     *
+     * @param view Output read-only view of the slot
+     * @param timeoutMs Time to wait for a new frame
+     * @return  True: Frame mapped
+     *          False: Timed out or bus closed
+     */
+    bool view(cv::Mat& view, int timeoutMs = 1000);
+
+    /**
+     * @brief Tells whether the frame returned by the last view() call has not
+     * been overwritten yet
+     *
+     * @return  True: Still valid
+     */
+    bool isViewValid() const;
+
+    /**
+     * @brief Get the sequence number of the last read frame
+     */
+    uint64_t getSequence() const { return _lastSequence; }
+
+    /**
+     * @brief Get the timestamp of the last read frame (ns)
+     */
+    int64_t getTimestamp() const { return _lastTimestampNs; }
+
+    /**
+     * @brief Get the number of frames skipped for reading too slowly
+     */
+    uint64_t getNumSkipped() const { return _numSkipped; }
+
+#pragma endregion
+
+  private:
+#pragma region Private member variables
+
+    size_t _mappedSize = 0;
+    FrameBusHeader* _header = nullptr;
+    FrameBusSlot* _slots = nullptr;
+    const uint8_t* _data = nullptr;
+    FrameBusCursor* _cursor = nullptr;
+
+    uint64_t _nextSequence = 0;
+    uint64_t _lastSequence = 0;
+    uint64_t _lastVersion = 0;
+    int64_t _lastTimestampNs = 0;
+    uint64_t _numSkipped = 0;
+    const FrameBusSlot* _lastSlot = nullptr;
+
+#pragma endregion
+
+#pragma region Private member methods
+
+    /**
+     * @brief Wait for the next frame and locate its slot
+     *
+     * @param timeoutMs Time to wait
+     * @param version Output seqlock version of the slot
+     * @return  Slot, nullptr if timed out or closed
+     */
+    const FrameBusSlot* acquire(int timeoutMs, uint64_t& version);
+
+    /**
+     * @brief Finish reading a slot, checking it has not been overwritten
+     *
+     * @param slot Slot
+     * @param version Version returned by acquire()
+     * @return  True: Frame is consistent
+     */
+    bool validate(const FrameBusSlot* slot, uint64_t version) const;
+
+#pragma endregion
+};
@@ -0,0 +1,136 @@
+/**
+ * @file frame_queue.cpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Bounded single-producer single-consumer queue of preallocated frames
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "frame_queue.hpp"
+
+#include <opencv2/core.hpp>
+
+FrameQueue::FrameQueue(int height,
+                       int width,
+                       int type,
+                       int capacity,
+                       bool dropOldest)
+    : _dropOldest(dropOldest) {
+    CV_Assert(capacity > 0);
+
+    // One slot being written, one being read, the rest waiting
+    int numSlots = capacity + 2;
+    _slots.reserve(numSlots);
+    _readyTimes.resize(numSlots);
+    _slotSizes.resize(numSlots);
+    _free.reserve(numSlots);
+    _ready.resize(capacity);
+
+    for (int i = 0; i < numSlots; i++) {
+        const auto& slot = _slots.emplace_back(height, width, type);
+        _slotSizes[i] = slot.total() * slot.elemSize();
+        _free.push_back(i);
+    }
+}
+
+cv::Mat* FrameQueue::beginWrite() {
+    auto lock = std::unique_lock(_mutex);
+
+    int capacity = static_cast<int>(_ready.size());
+
+    if (!_dropOldest) {
+        _freeCond.wait(lock, [this, capacity] {
+            return _isClosed || _readyCount < capacity;
+        });
+    }
+
+    if (_isClosed) {
+        return nullptr;
+    }
+
+    if (_readyCount == capacity) {
+        // Full: recycle the oldest waiting frame
+        _writing = _ready[_readyHead];
+        _readyHead = (_readyHead + 1) % capacity;
+        _readyCount--;
+        _numDropped++;
+    } else {
+        _writing = _free.back();
+        _free.pop_back();
+    }
+
+    return &_slots[_writing];
+}
+
+void FrameQueue::endWrite() {
+    {
+        auto lock = std::scoped_lock(_mutex);
+        CV_Assert(_writing != -1);
+        _readyTimes[_writing] = Clock::now();
+        const auto& slot = _slots[_writing];
+        _slotSizes[_writing] = slot.total() * slot.elemSize();
+
+        int tail = (_readyHead + _readyCount) % static_cast<int>(_ready.size());
+        _ready[tail] = _writing;
+        _readyCount++;
+        _writing = -1;
+    }
+
+    _readyCond.notify_one();
+}
+
+cv::Mat* FrameQueue::read() {
+    auto lock = std::unique_lock(_mutex);
+
+    if (_reading != -1) {
+        _free.push_back(_reading);
+        _reading = -1;
+    }
+
+    _readyCond.wait(lock, [this] { return _isClosed || _readyCount > 0; });
+
+    if (_readyCount == 0) {
+        return nullptr;
+    }
+
+    _reading = _ready[_readyHead];
+    _readyHead = (_readyHead + 1) % static_cast<int>(_ready.size());
+    _readyCount--;
+
+    // A waiting slot was taken, a blocked producer can go on
+    _freeCond.notify_one();
+
+    return &_slots[_reading];
+}
+
+void FrameQueue::close() {
+    {
+        auto lock = std::scoped_lock(_mutex);
+        _isClosed = true;
+    }
+
+    _readyCond.notify_all();
+    _freeCond.notify_all();
+}
+
+int FrameQueue::getDepth() const {
+    auto lock = std::scoped_lock(_mutex);
+    return _readyCount;
+}
+
+uint64_t FrameQueue::getNumDropped() const {
+    auto lock = std::scoped_lock(_mutex);
+    return _numDropped;
+}
+
+size_t FrameQueue::getMemoryUsage() const {
+    auto lock = std::scoped_lock(_mutex);
+    size_t size = 0;
+    for (size_t slotSize : _slotSizes) {
+        size += slotSize;
+    }
+    return size;
+}
@@ -0,0 +1,146 @@
+/**
+ * @file frame_queue.hpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Bounded single-producer single-consumer queue of preallocated frames
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <opencv2/core.hpp>
+#include <vector>
+
+/**
+ * @brief Hands frames over from the capture thread to the analysis thread.
+ *        Frames are decoded directly into preallocated slots, so no frame is
+ *        copied or allocated. The producer writes one slot while the consumer
+ *        holds another; up to `capacity` frames wait in between.
+ */
+class FrameQueue final {
+  public:
+#pragma region Public types
+
+    using Clock = std::chrono::steady_clock;
+
+#pragma endregion
+
+#pragma region Public member methods
+
+    /**
+     * @brief Construct a new FrameQueue object
+     *
+     * @param height Frame height
+     * @param width Frame width
+     * @param type Frame type
+     * @param capacity Max number of frames waiting for the consumer
+     * @param dropOldest True: when full, the oldest waiting frame is dropped
+     * (live streams); False: the producer waits (local files)
+     */
+    FrameQueue(int height,
+               int width,
+               int type,
+               int capacity = 2,
+               bool dropOldest = true);
+
+    /**
+     * @brief Get a free slot to write the next frame into (producer)
+     *
+     * @return  Slot, or nullptr if the queue is closed
+     */
+    cv::Mat* beginWrite();
+
+    /**
+     * @brief Publish the slot returned by beginWrite() (producer), the slot is
+     * stamped with the current time
+     *
+     * @return
+     */
+    void endWrite();
+
+    /**
+     * @brief Wait for the oldest frame (consumer). The slot returned by the
+     * previous call is given back to the producer.
+     *
+     * @return  Frame, or nullptr if the queue is closed and drained
+     */
+    cv::Mat* read();
+
+    /**
+     * @brief Get the time the frame returned by the last read() was published
+     * (consumer)
+     *
+     * @return  Publish time
+     */
+    Clock::time_point getReadyTime() const { return _readyTimes[_reading]; }
+
+    /**
+     * @brief Close the queue, wakes up both sides
+     *
+     * @return
+     */
+    void close();
+
+    /**
+     * @brief Get the number of frames waiting for the consumer
+     */
+    int getDepth() const;
+
+    /**
+     * @brief Get the number of frames dropped because the queue was full
+     */
+    uint64_t getNumDropped() const;
+
+    /**
+     * @brief Get the memory held by the slots, as of their last write
+     *
+     * @return  Size (bytes)
+     */
+    size_t getMemoryUsage() const;
+
+#pragma endregion
+
+  private:
+#pragma region Private member variables
+
+    std::vector<cv::Mat> _slots;
+    std::vector<Clock::time_point> _readyTimes;
+
+    /**
+     * @brief Size of each slot (bytes), updated on publish since the slot
+     * being written is only owned by the producer
+     */
+    std::vector<size_t> _slotSizes;
+
+    /**
+     * @brief Ring of slot indices waiting for the consumer
+     */
+    std::vector<int> _ready;
+    int _readyHead = 0;
+    int _readyCount = 0;
+
+    /**
+     * @brief Stack of slot indices free for the producer
+     */
+    std::vector<int> _free;
+
+    int _writing = -1;
+    int _reading = -1;
+
+    bool _dropOldest;
+    bool _isClosed = false;
+    uint64_t _numDropped = 0;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _readyCond;
+    std::condition_variable _freeCond;
+
+#pragma endregion
+};
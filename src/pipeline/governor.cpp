@@ -0,0 +1,160 @@
+/**
+ * @file governor.cpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Closed-loop CPU budget governor of the analysis pipeline
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "governor.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+
+Governor::Governor(const GovernorParams& params)
+    : _params(params),
+      _ladder(makeLadder(params)) {}
+
+bool Governor::update(uint64_t busyNs,
+                      uint64_t latencyNs,
+                      Clock::time_point now) {
+    if (!_isWindowStarted) {
+        _windowBegin = now;
+        _isWindowStarted = true;
+    }
+
+    _busyNs += busyNs;
+    _maxLatencyNs = std::max(_maxLatencyNs, latencyNs);
+
+    auto elapsed = now - _windowBegin;
+    if (elapsed < std::chrono::milliseconds(_params.windowMs)) {
+        return false;
+    }
+
+    // Close the window
+    double wallNs = static_cast<double>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    _lastCpuShare = static_cast<double>(_busyNs) / wallNs;
+    _lastLatencyMs = static_cast<double>(_maxLatencyNs) * 1e-6;
+
+    _windowBegin = now;
+    _busyNs = 0;
+    _maxLatencyNs = 0;
+
+    if (_ladder.isSettling()) {
+        return false;
+    }
+
+    bool isOverBudget = _lastCpuShare > _params.targetCpuShare ||
+                        _lastLatencyMs > _params.targetLatencyMs;
+    bool isUnderBudget =
+        _lastCpuShare < _params.targetCpuShare * _params.stepUpMargin &&
+        _lastLatencyMs < _params.targetLatencyMs * _params.stepUpMargin;
+
+    using Load = StepLadder<Settings>::Load;
+    int step = _ladder.update(isOverBudget    ? Load::OVER
+                              : isUnderBudget ? Load::CALM
+                                              : Load::NORMAL);
+    if (step == 0) {
+        return false;
+    }
+
+    const auto& settings = getSettings();
+    std::array<char, 128> details;
+    std::snprintf(details.data(),
+                  details.size(),
+                  "scale %.2f, samples %d, stride %d (cpu %.2f, latency "
+                  "%.1f ms)",
+                  settings.scale,
+                  settings.numSamples,
+                  settings.frameStride,
+                  _lastCpuShare,
+                  _lastLatencyMs);
+    _ladder.logStep(step, details.data());
+    return true;
+}
+
+bool Governor::setNumSamples(int numSamples, int minNumSamples) {
+    if (numSamples == _params.numSamples &&
+        minNumSamples == _params.minNumSamples) {
+        return false;
+    }
+
+    auto current = getSettings();
+    _params.numSamples = numSamples;
+    _params.minNumSamples = minNumSamples;
+    _ladder = makeLadder(_params);
+
+    // Keep the degradation: first level at least as degraded on every knob
+    int numActiveSamples = getNumActiveSamples(_params, current.sampleFraction);
+    int level = getNumLevels() - 1;
+    for (int i = 0; i < getNumLevels(); i++) {
+        const auto& settings = _ladder.getSettings(i);
+        if (settings.numSamples <= numActiveSamples &&
+            settings.scale <= current.scale &&
+            settings.frameStride >= current.frameStride) {
+            level = i;
+            break;
+        }
+    }
+    _ladder.moveTo(level);
+
+    return getSettings().numSamples != current.numSamples ||
+           getSettings().scale != current.scale ||
+           getSettings().frameStride != current.frameStride;
+}
+
+int Governor::getNumActiveSamples(const GovernorParams& params,
+                                  float fraction) {
+    if (params.numSamples <= 0) {
+        return 0;
+    }
+
+    auto numActiveSamples = static_cast<int>(
+        std::lround(static_cast<float>(params.numSamples) * fraction));
+    return std::clamp(numActiveSamples,
+                      std::min(params.minNumSamples, params.numSamples),
+                      params.numSamples);
+}
+
+StepLadder<Governor::Settings>
+Governor::makeLadder(const GovernorParams& params) {
+    // Each level degrades one knob by one step, level 0 uses all samples
+    auto settings = Settings{
+        .scale = params.scales.empty() ? 1.0F : params.scales.front(),
+        .sampleFraction = 1.0F,
+        .numSamples = getNumActiveSamples(params, 1.0F),
+        .frameStride =
+            params.frameStrides.empty() ? 1 : params.frameStrides.front(),
+    };
+    auto ladder = StepLadder<Settings>(
+        settings,
+        StepLadderParams{
+            .tag = "GOVERNOR",
+            .stepDownEvent = "governor step down",
+            .stepUpEvent = "governor step up",
+            .numCalmChecksToStepUp = params.numCalmWindowsToStepUp,
+            .numCooldownChecks = params.numCooldownWindows,
+        });
+
+    // Sample steps that don't lower the active count would only cost a
+    // cooldown
+    for (size_t i = 1; i < params.sampleFractions.size(); i++) {
+        int numActiveSamples =
+            getNumActiveSamples(params, params.sampleFractions[i]);
+        if (numActiveSamples < settings.numSamples) {
+            settings.sampleFraction = params.sampleFractions[i];
+            settings.numSamples = numActiveSamples;
+            ladder.addLevel(settings);
+        }
+    }
+
+    ladder.addSteps(&Settings::scale, params.scales);
+    ladder.addSteps(&Settings::frameStride, params.frameStrides);
+    return ladder;
+}
@@ -0,0 +1,194 @@
+/**
+ * @file governor.hpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Closed-loop CPU budget governor of the analysis pipeline
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+
+#include "step_ladder.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Additional parameters for Governor class
+ */
+struct GovernorParams {
+    /**
+     * @brief Target share of one core spent in analysis (busy / wall time)
+     */
+    double targetCpuShare = 0.7;
+
+    /**
+     * @brief Target end-to-end latency from a decoded frame being ready to
+     * its analysis being done (ms)
+     */
+    double targetLatencyMs = 200.0;
+
+    /**
+     * @brief Length of the measurement window (ms)
+     */
+    int windowMs = 1000;
+
+    /**
+     * @brief Step back up after this many consecutive windows well under
+     * budget
+     */
+    int numCalmWindowsToStepUp = 5;
+
+    /**
+     * @brief Windows to skip after a change, letting the pipeline settle
+     */
+    int numCooldownWindows = 2;
+
+    /**
+     * @brief Under-budget margin: step up only if load < margin * target
+     */
+    double stepUpMargin = 0.6;
+
+    /**
+     * @brief Analysis resolution steps (scale of the full analysis size)
+     */
+    std::vector<float> scales = {1.0F, 0.75F, 0.5F};
+
+    /**
+     * @brief Background model sample count (0: not sample based), see
+     * Governor::setNumSamples()
+     */
+    int numSamples = 0;
+
+    /**
+     * @brief Min active sample count of the background model
+     */
+    int minNumSamples = 1;
+
+    /**
+     * @brief Active sample steps, fractions of the model sample count
+     */
+    std::vector<float> sampleFractions = {1.0F, 0.7F, 0.55F};
+
+    /**
+     * @brief Analysis frame stride steps (analyse one of every n frames)
+     */
+    std::vector<int> frameStrides = {1, 2, 3};
+};
+
+/**
+ * @brief Watches per-frame analysis time and latency and walks a ladder of
+ *        settings to hold the CPU budget. Cheapest quality losses come first:
+ *        fewer ViBe samples, then lower resolution, then lower frame rate.
+ */
+class Governor final {
+  public:
+#pragma region Public types
+
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Pipeline settings of one level
+     */
+    struct Settings {
+        float scale;
+        float sampleFraction;
+        int numSamples; // Active samples of the model (0: not sample based)
+        int frameStride;
+    };
+
+#pragma endregion
+
+#pragma region Public member methods
+
+    /**
+     * @brief Construct a new Governor object (starting at full quality)
+     *
+     * @param params Additional parameters
+     */
+    explicit Governor(const GovernorParams& params = GovernorParams());
+
+    /**
+     * @brief Account one analysed frame
+     *
+     * @param busyNs Analysis time of this frame (ns)
+     * @param latencyNs End-to-end latency of this frame (ns)
+     * @param now Current time
+     * @return  True: settings changed, apply getSettings()
+     *          False: keep current settings
+     */
+    bool update(uint64_t busyNs, uint64_t latencyNs, Clock::time_point now);
+
+    /**
+     * @brief Follow a rebuilt or reconfigured background model. Sample
+     * steps are rebuilt from its sample count, steps not lowering the active
+     * count are left out, and the current degradation is kept.
+     *
+     * @param numSamples Model sample count (0: not sample based)
+     * @param minNumSamples Min active sample count of the model
+     * @return  True: settings changed, apply getSettings()
+     *          False: keep current settings
+     */
+    bool setNumSamples(int numSamples, int minNumSamples);
+
+    const Settings& getSettings() const { return _ladder.getSettings(); }
+
+    int getLevel() const { return _ladder.getLevel(); }
+
+    int getNumLevels() const { return _ladder.getNumLevels(); }
+
+    /**
+     * @brief Get CPU share measured in the last window
+     */
+    double getCpuShare() const { return _lastCpuShare; }
+
+    /**
+     * @brief Get max latency measured in the last window (ms)
+     */
+    double getLatencyMs() const { return _lastLatencyMs; }
+
+#pragma endregion
+
+  private:
+#pragma region Private member variables
+
+    GovernorParams _params;
+    StepLadder<Settings> _ladder;
+
+    /* Current window */
+    Clock::time_point _windowBegin;
+    bool _isWindowStarted = false;
+    uint64_t _busyNs = 0;
+    uint64_t _maxLatencyNs = 0;
+
+    double _lastCpuShare = 0.0;
+    double _lastLatencyMs = 0.0;
+
+#pragma endregion
+
+#pragma region Private member methods
+
+    /**
+     * @brief Build the ladder: fewer samples, then lower resolution, then
+     * lower frame rate
+     *
+     * @param params Parameters
+     * @return  Ladder
+     */
+    static StepLadder<Settings> makeLadder(const GovernorParams& params);
+
+    /**
+     * @brief Get the active sample count of a fraction of the model samples
+     *
+     * @param params Parameters
+     * @param fraction Fraction of the model samples
+     * @return  Active sample count (0: not sample based)
+     */
+    static int getNumActiveSamples(const GovernorParams& params,
+                                   float fraction);
+
+#pragma endregion
+};
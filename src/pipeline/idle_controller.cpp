@@ -0,0 +1,186 @@
+/**
+ * @file idle_controller.cpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Idle duty-cycling of analysis for static scenes
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "idle_controller.hpp"
+
+#include "trace.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+IdleController::IdleController(double fps, const IdleControllerParams& params)
+    : _params(params),
+      _idleAfterFrames(std::max(
+          1, static_cast<int>(std::round(params.idleAfterSec * fps)))) {
+    _params.idleStride = std::max(1, _params.idleStride);
+    _params.sampleStep = std::max(1, _params.sampleStep);
+    _params.tileSize = std::max(_params.sampleStep, _params.tileSize);
+    _catchUp.resize(std::max(0, _params.catchUpCapacity));
+    _catchUpTimes.resize(_catchUp.size());
+}
+
+IdleController::Decision IdleController::onFrame(const cv::Mat& frame,
+                                                Timestamp timestamp) {
+    TRACE_SCOPE("IdleController::onFrame");
+
+    _tileChange = probe(frame);
+
+    if (!_isIdle) {
+        updateReference();
+        return Decision::ANALYSE;
+    }
+
+    if (_tileChange > _params.maxStaticTileChange) {
+        // Motion: back to full rate, replay what was skipped
+        _isIdle = false;
+        _numStaticFrames = 0;
+        _numSkipped = 0;
+        updateReference();
+
+        std::printf("[IDLE] Motion detected (%.2f%% tiles changed), catching "
+                    "up %d frames\n",
+                    _tileChange * 100.0,
+                    _numCatchUp);
+        return Decision::WAKE;
+    }
+
+    if (++_numSkipped % _params.idleStride == 0) {
+        // Reduced rate analysis, skipped frames are no longer needed
+        _numCatchUp = 0;
+        updateReference();
+        return Decision::ANALYSE;
+    }
+
+    if (!_catchUp.empty()) {
+        int capacity = static_cast<int>(_catchUp.size());
+        int tail = (_catchUpHead + _numCatchUp) % capacity;
+        if (_numCatchUp == capacity) {
+            _catchUpHead = (_catchUpHead + 1) % capacity;
+        } else {
+            _numCatchUp++;
+        }
+        frame.copyTo(_catchUp[tail]);
+        _catchUpTimes[tail] = timestamp;
+    }
+
+    return Decision::SKIP;
+}
+
+void IdleController::onAnalysed(double foregroundFraction) {
+    bool isStatic = foregroundFraction <= _params.maxStaticForeground &&
+                    _tileChange <= _params.maxStaticTileChange;
+
+    if (!isStatic) {
+        if (_isIdle) {
+            std::printf("[IDLE] Foreground detected, back to full rate\n");
+        }
+        _isIdle = false;
+        _numStaticFrames = 0;
+        _numSkipped = 0;
+        _numCatchUp = 0;
+        return;
+    }
+
+    if (!_isIdle && ++_numStaticFrames >= _idleAfterFrames) {
+        _isIdle = true;
+        _numSkipped = 0;
+        _numCatchUp = 0;
+
+        std::printf("[IDLE] Scene static for %d frames, analysing 1/%d "
+                    "frames\n",
+                    _numStaticFrames,
+                    _params.idleStride);
+    }
+}
+
+cv::Mat& IdleController::getCatchUpFrame(int i) {
+    CV_Assert(i >= 0 && i < _numCatchUp);
+    return _catchUp[(_catchUpHead + i) % static_cast<int>(_catchUp.size())];
+}
+
+IdleController::Timestamp IdleController::getCatchUpTime(int i) const {
+    CV_Assert(i >= 0 && i < _numCatchUp);
+    return _catchUpTimes[(_catchUpHead + i) %
+                         static_cast<int>(_catchUpTimes.size())];
+}
+
+size_t IdleController::getMemoryUsage() const {
+    size_t size = (_tiles.capacity() + _referenceTiles.capacity()) *
+                  sizeof(uint16_t);
+    for (const auto& frame : _catchUp) {
+        size += frame.total() * frame.elemSize();
+    }
+    return size;
+}
+
+double IdleController::probe(const cv::Mat& frame) {
+    CV_Assert(frame.type() == CV_8UC3);
+
+    int tileSize = _params.tileSize;
+    int step = _params.sampleStep;
+
+    if (frame.size() != _frameSize) {
+        // Frame size changed (first frame or analysis resolution change)
+        _frameSize = frame.size();
+        _numTilesX = (frame.cols + tileSize - 1) / tileSize;
+        _numTilesY = (frame.rows + tileSize - 1) / tileSize;
+        _tiles.assign(_numTilesX * _numTilesY, 0);
+        _referenceTiles.assign(_numTilesX * _numTilesY, 0);
+        _hasReference = false;
+        _numCatchUp = 0;
+    }
+
+    // Mean of sampled green levels per tile
+    std::fill(_tiles.begin(), _tiles.end(), 0);
+    size_t numTiles = _tiles.size();
+
+    for (int ty = 0; ty < _numTilesY; ty++) {
+        int yEnd = std::min((ty + 1) * tileSize, frame.rows);
+
+        for (int tx = 0; tx < _numTilesX; tx++) {
+            int xEnd = std::min((tx + 1) * tileSize, frame.cols);
+            uint32_t sum = 0;
+            uint32_t count = 0;
+
+            for (int y = ty * tileSize; y < yEnd; y += step) {
+                const auto* row = frame.ptr<uint8_t>(y);
+                for (int x = tx * tileSize; x < xEnd; x += step) {
+                    sum += row[3 * x + 1];
+                    count++;
+                }
+            }
+
+            _tiles[ty * _numTilesX + tx] =
+                static_cast<uint16_t>(count == 0 ? 0 : sum / count);
+        }
+    }
+
+    if (!_hasReference) {
+        return 1.0;
+    }
+
+    int numChanged = 0;
+    for (size_t i = 0; i < numTiles; i++) {
+        if (std::abs(_tiles[i] - _referenceTiles[i]) >
+            _params.tileChangeThreshold) {
+            numChanged++;
+        }
+    }
+
+    return static_cast<double>(numChanged) / static_cast<double>(numTiles);
+}
+
+void IdleController::updateReference() {
+    _referenceTiles = _tiles;
+    _hasReference = true;
+}
@@ -0,0 +1,211 @@
+/**
+ * @file idle_controller.hpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Idle duty-cycling of analysis for static scenes
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <opencv2/core.hpp>
+#include <vector>
+
+/**
+ * @brief Additional parameters for IdleController class
+ */
+struct IdleControllerParams {
+    /**
+     * @brief Enter idle mode after the scene has been static for this long (s)
+     */
+    double idleAfterSec = 30.0;
+
+    /**
+     * @brief Analyse one of every n frames while idle
+     */
+    int idleStride = 5;
+
+    /**
+     * @brief Tile size of the change probe (pixels)
+     */
+    int tileSize = 32;
+
+    /**
+     * @brief Pixel sampling step inside a tile (the probe reads 1 / step^2 of
+     * the frame)
+     */
+    int sampleStep = 4;
+
+    /**
+     * @brief Mean level difference for a tile to count as changed
+     */
+    int tileChangeThreshold = 12;
+
+    /**
+     * @brief Max changed tile fraction of a static scene, more wakes up
+     */
+    double maxStaticTileChange = 0.002;
+
+    /**
+     * @brief Max foreground pixel fraction of a static scene
+     */
+    double maxStaticForeground = 0.0005;
+
+    /**
+     * @brief Number of most recent skipped frames kept for catch-up
+     */
+    int catchUpCapacity = 8;
+};
+
+/**
+ * @brief Decides per frame whether to run full analysis.
+ *        Every frame goes through a cheap probe: the mean of sparsely sampled
+ *        pixels per tile, compared with the last analysed frame. When both
+ *        the probe and the foreground of analysed frames stay near zero for
+ *        a while, only one of every idleStride frames is analysed and the
+ *        skipped ones are kept in a small ring with their capture times. The
+ *        first probe that sees motion wakes analysis up, and the ring is
+ *        replayed so the start of the event is not missed.
+ */
+class IdleController final {
+  public:
+#pragma region Public types
+
+    using Timestamp = std::chrono::system_clock::time_point;
+
+    enum class Decision {
+        /**
+         * @brief Analyse this frame
+         */
+        ANALYSE,
+
+        /**
+         * @brief Skip this frame (it was kept for catch-up)
+         */
+        SKIP,
+
+        /**
+         * @brief Motion detected while idle: analyse the catch-up frames,
+         * then this frame
+         */
+        WAKE,
+    };
+
+#pragma endregion
+
+#pragma region Public member methods
+
+    /**
+     * @brief Construct a new IdleController object
+     *
+     * @param fps Frame rate of the stream
+     * @param params Additional parameters
+     */
+    IdleController(double fps,
+                   const IdleControllerParams& params = IdleControllerParams());
+
+    /**
+     * @brief Probe a new frame and decide what to do with it
+     *
+     * @param frame Current frame (CV_8UC3)
+     * @param timestamp Capture time of the frame, kept with it for catch-up
+     * @return  Decision
+     */
+    Decision onFrame(const cv::Mat& frame, Timestamp timestamp);
+
+    /**
+     * @brief Report the foreground of an analysed frame
+     *
+     * @param foregroundFraction Fraction of foreground pixels (1: invalid
+     * frame)
+     * @return
+     */
+    void onAnalysed(double foregroundFraction);
+
+    /**
+     * @brief Get skipped frames kept for catch-up, oldest first. Valid until
+     * the next onFrame() call.
+     *
+     * @param i Index (0: oldest)
+     * @return  Frame
+     */
+    cv::Mat& getCatchUpFrame(int i);
+
+    /**
+     * @brief Get the capture time of a skipped frame kept for catch-up
+     *
+     * @param i Index (0: oldest)
+     * @return  Capture time
+     */
+    Timestamp getCatchUpTime(int i) const;
+
+    int getNumCatchUpFrames() const { return _numCatchUp; }
+
+    bool isIdle() const { return _isIdle; }
+
+    /**
+     * @brief Get changed tile fraction measured by the last probe
+     */
+    double getTileChange() const { return _tileChange; }
+
+    /**
+     * @brief Get the memory held by the catch-up frames and the probe tiles
+     *
+     * @return  Size (bytes)
+     */
+    size_t getMemoryUsage() const;
+
+#pragma endregion
+
+  private:
+#pragma region Private member variables
+
+    IdleControllerParams _params;
+    int _idleAfterFrames;
+
+    bool _isIdle = false;
+    int _numStaticFrames = 0;
+    int _numSkipped = 0;
+    double _tileChange = 1.0;
+
+    /* Probe */
+    cv::Size _frameSize;
+    int _numTilesX = 0;
+    int _numTilesY = 0;
+    std::vector<uint16_t> _tiles;
+    std::vector<uint16_t> _referenceTiles;
+    bool _hasReference = false;
+
+    /* Catch-up ring */
+    std::vector<cv::Mat> _catchUp;
+    std::vector<Timestamp> _catchUpTimes;
+    int _catchUpHead = 0;
+    int _numCatchUp = 0;
+
+#pragma endregion
+
+#pragma region Private member methods
+
+    /**
+     * @brief Compute tile means of a frame and the changed tile fraction
+     * against the reference
+     *
+     * @param frame Current frame
+     * @return  Changed tile fraction
+     */
+    double probe(const cv::Mat& frame);
+
+    /**
+     * @brief Make the last probed frame the reference
+     *
+     * @return
+     */
+    void updateReference();
+
+#pragma endregion
+};
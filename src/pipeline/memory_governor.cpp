@@ -0,0 +1,114 @@
+/**
+ * @file memory_governor.cpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Memory budget governor of a camera pipeline
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "memory_governor.hpp"
+
+#include <array>
+#include <cstdio>
+#include <string>
+
+namespace {
+
+constexpr double BYTES_PER_MIB = 1024.0 * 1024.0;
+
+} // namespace
+
+MemoryGovernor::MemoryGovernor(const MemoryGovernorParams& params)
+    : _params(params),
+      _ladder(makeLadder(params)) {
+    _stepCosts.resize(_ladder.getNumLevels(), 0);
+}
+
+bool MemoryGovernor::update(size_t usage, Clock::time_point now) {
+    _lastCheck = now;
+    _isStarted = true;
+
+    if (!isEnabled() || _ladder.isSettling()) {
+        return false;
+    }
+
+    // First settled check after a step down: what it has freed
+    if (_isMeasuringStep) {
+        _stepCosts[getLevel()] =
+            usage < _usageBeforeStep ? _usageBeforeStep - usage : 0;
+        _isMeasuringStep = false;
+    }
+
+    using Load = StepLadder<Settings>::Load;
+    auto load = Load::NORMAL;
+    if (usage > _params.budgetBytes) {
+        load = Load::OVER;
+        if (_ladder.isLowest() && !_isExhausted) {
+            std::printf("[MEMORY] Over budget at the lowest level: %.1f / "
+                        "%.1f MiB\n",
+                        usage / BYTES_PER_MIB,
+                        _params.budgetBytes / BYTES_PER_MIB);
+            _isExhausted = true;
+        }
+    } else {
+        _isExhausted = false;
+
+        // Step up only if what the step takes back still fits
+        auto room = static_cast<size_t>(
+            static_cast<double>(_params.budgetBytes) * _params.stepUpMargin);
+        if (getLevel() > 0 && usage + _stepCosts[getLevel()] < room) {
+            load = Load::CALM;
+        }
+    }
+
+    int step = _ladder.update(load);
+    if (step == 0) {
+        return false;
+    }
+
+    _usageBeforeStep = usage;
+    _isMeasuringStep = step > 0;
+
+    const auto& settings = getSettings();
+    auto maxNumSamples = settings.maxNumSamples > 0
+                             ? std::to_string(settings.maxNumSamples)
+                             : std::string("all");
+    std::array<char, 128> details;
+    std::snprintf(details.data(),
+                  details.size(),
+                  "samples %s, scale %.2f, %s evidence (%.1f / %.1f MiB)",
+                  maxNumSamples.c_str(),
+                  settings.scale,
+                  settings.isCropOnly ? "crop-only" : "full frame",
+                  usage / BYTES_PER_MIB,
+                  _params.budgetBytes / BYTES_PER_MIB);
+    _ladder.logStep(step, details.data());
+    return true;
+}
+
+StepLadder<MemoryGovernor::Settings>
+MemoryGovernor::makeLadder(const MemoryGovernorParams& params) {
+    // Each level frees memory with one more step
+    auto ladder = StepLadder<Settings>(
+        Settings{
+            .maxNumSamples = params.maxNumSamples.empty()
+                                 ? 0
+                                 : params.maxNumSamples.front(),
+            .scale = params.scales.empty() ? 1.0F : params.scales.front(),
+            .isCropOnly = false,
+        },
+        StepLadderParams{
+            .tag = "MEMORY",
+            .stepDownEvent = "memory step down",
+            .stepUpEvent = "memory step up",
+            .numCalmChecksToStepUp = params.numCalmChecksToStepUp,
+            .numCooldownChecks = params.numCooldownChecks,
+        });
+    ladder.addSteps(&Settings::maxNumSamples, params.maxNumSamples);
+    ladder.addSteps(&Settings::scale, params.scales);
+    ladder.addSteps(&Settings::isCropOnly, std::vector<bool>{false, true});
+    return ladder;
+}
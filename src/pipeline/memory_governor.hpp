@@ -0,0 +1,166 @@
+/**
+ * @file memory_governor.hpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Memory budget governor of a camera pipeline
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+
+#include "step_ladder.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Additional parameters for MemoryGovernor class
+ */
+struct MemoryGovernorParams {
+    /**
+     * @brief Memory budget of the camera pipeline (bytes, 0: accounting only)
+     */
+    size_t budgetBytes = 0;
+
+    /**
+     * @brief Interval between two checks of the accounted memory (ms)
+     */
+    int checkIntervalMs = 1000;
+
+    /**
+     * @brief Checks to skip after a change, letting buffers be reallocated
+     */
+    int numCooldownChecks = 1;
+
+    /**
+     * @brief Step back up after this many consecutive checks with room
+     */
+    int numCalmChecksToStepUp = 10;
+
+    /**
+     * @brief Room margin: step up only if the memory after the step is
+     * expected under margin * budget
+     */
+    double stepUpMargin = 0.8;
+
+    /**
+     * @brief Background model sample count caps (0: as configured)
+     */
+    std::vector<int> maxNumSamples = {0, 12, 8};
+
+    /**
+     * @brief Analysis resolution steps (scale of the full analysis size)
+     */
+    std::vector<float> scales = {1.0F, 0.75F, 0.5F};
+};
+
+/**
+ * @brief Checks the memory accounted to a camera pipeline against its budget
+ *        and walks a ladder of settings that free memory: fewer background
+ *        samples, then lower analysis resolution, then crop-only trajectory
+ *        evidence. Steps back up once the freed memory fits again.
+ */
+class MemoryGovernor final {
+  public:
+#pragma region Public types
+
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief Pipeline settings of one level
+     */
+    struct Settings {
+        int maxNumSamples;
+        float scale;
+        bool isCropOnly;
+    };
+
+#pragma endregion
+
+#pragma region Public member methods
+
+    /**
+     * @brief Construct a new MemoryGovernor object (starting at full
+     * quality)
+     *
+     * @param params Additional parameters
+     */
+    explicit MemoryGovernor(
+        const MemoryGovernorParams& params = MemoryGovernorParams());
+
+    /**
+     * @brief Tells whether a budget is enforced
+     *
+     * @return  True: budget set
+     */
+    bool isEnabled() const { return _params.budgetBytes > 0; }
+
+    /**
+     * @brief Tells whether the memory should be checked
+     *
+     * @param now Current time
+     * @return  True: the check interval has elapsed
+     */
+    bool isDue(Clock::time_point now) const {
+        return !_isStarted ||
+               now - _lastCheck >=
+                   std::chrono::milliseconds(_params.checkIntervalMs);
+    }
+
+    /**
+     * @brief Check the accounted memory
+     *
+     * @param usage Memory accounted to the pipeline (bytes)
+     * @param now Current time
+     * @return  True: settings changed, apply getSettings()
+     *          False: keep current settings
+     */
+    bool update(size_t usage, Clock::time_point now);
+
+    const Settings& getSettings() const { return _ladder.getSettings(); }
+
+    int getLevel() const { return _ladder.getLevel(); }
+
+    int getNumLevels() const { return _ladder.getNumLevels(); }
+
+    size_t getBudget() const { return _params.budgetBytes; }
+
+#pragma endregion
+
+  private:
+#pragma region Private member variables
+
+    MemoryGovernorParams _params;
+    StepLadder<Settings> _ladder;
+
+    Clock::time_point _lastCheck;
+    bool _isStarted = false;
+
+    /**
+     * @brief Memory freed by stepping down to each level, i.e. the expected
+     * cost of stepping back up from it (bytes, 0: unknown)
+     */
+    std::vector<size_t> _stepCosts;
+    size_t _usageBeforeStep = 0;
+    bool _isMeasuringStep = false;
+
+    bool _isExhausted = false;
+
+#pragma endregion
+
+#pragma region Private member methods
+
+    /**
+     * @brief Build the ladder: fewer background samples, then lower
+     * resolution, then crop-only evidence
+     *
+     * @param params Parameters
+     * @return  Ladder
+     */
+    static StepLadder<Settings> makeLadder(const MemoryGovernorParams& params);
+
+#pragma endregion
+};
@@ -0,0 +1,201 @@
+/**
+ * @file preview_sink.cpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Preview of analysis results, rendered on its own thread
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "preview_sink.hpp"
+
+#include "trace.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <utility>
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+
+#if !defined(ROCKCHIP_PLATFORM)
+#include <opencv2/highgui.hpp>
+#endif
+
+PreviewSink::PreviewSink(const PreviewSinkParams& params)
+    : _params(params),
+      _interval(std::chrono::duration_cast<Clock::duration>(
+          std::chrono::duration<double>(1.0 / std::max(params.fps, 1e-3)))),
+      _nextDueTime(Clock::time_point::min()) {
+    _params.scale = std::clamp(_params.scale, 0.05, 1.0);
+}
+
+PreviewSink::~PreviewSink() { stop(); }
+
+void PreviewSink::start() {
+    if (_isRunning.exchange(true)) {
+        return;
+    }
+    _thread = std::thread(&PreviewSink::run, this);
+}
+
+void PreviewSink::stop() {
+    if (!_isRunning.exchange(false)) {
+        return;
+    }
+
+    {
+        auto lock = std::lock_guard<std::mutex>(_mutex);
+        _readyCond.notify_all();
+    }
+    _thread.join();
+}
+
+PreviewSink::Snapshot& PreviewSink::beginSubmit(Clock::time_point now) {
+    _nextDueTime = now + _interval;
+    return _snapshots[_writeIndex];
+}
+
+void PreviewSink::endSubmit() {
+    auto lock = std::lock_guard<std::mutex>(_mutex);
+    std::swap(_writeIndex, _readyIndex);
+    _hasReady = true;
+    _readyCond.notify_one();
+}
+
+int PreviewSink::present(int delayMs) {
+#if defined(ROCKCHIP_PLATFORM)
+    (void)delayMs;
+    return -1;
+#else
+    if (!_params.outputDir.empty()) {
+        return -1;
+    }
+
+    {
+        auto lock = std::lock_guard<std::mutex>(_renderedMutex);
+        if (_hasRendered) {
+            cv::imshow("frame", _renderedFrame);
+            cv::imshow("fgmask", _renderedFgMask);
+            cv::imshow("update mask", _renderedUpdateMask);
+            _hasRendered = false;
+        }
+    }
+
+    return cv::waitKey(delayMs);
+#endif
+}
+
+void PreviewSink::run() {
+    if (Tracer::isEnabled()) {
+        Tracer::instance().setThreadName("preview");
+    }
+
+    cv::Mat frame;
+    cv::Mat fgMask;
+    cv::Mat updateMask;
+
+    while (true) {
+        {
+            auto lock = std::unique_lock<std::mutex>(_mutex);
+            _readyCond.wait(lock,
+                            [this]() { return _hasReady || !_isRunning; });
+            if (!_isRunning) {
+                return;
+            }
+
+            std::swap(_readyIndex, _renderIndex);
+            _hasReady = false;
+        }
+
+        render(_snapshots[_renderIndex], frame, fgMask, updateMask);
+
+        if (!_params.outputDir.empty()) {
+            write(frame, fgMask, updateMask);
+            continue;
+        }
+
+        auto lock = std::lock_guard<std::mutex>(_renderedMutex);
+        cv::swap(frame, _renderedFrame);
+        cv::swap(fgMask, _renderedFgMask);
+        cv::swap(updateMask, _renderedUpdateMask);
+        _hasRendered = true;
+    }
+}
+
+void PreviewSink::write(cv::Mat& frame,
+                        cv::Mat& fgMask,
+                        cv::Mat& updateMask) {
+    const auto& dir = _params.outputDir;
+
+    if (_params.encoder == nullptr) {
+        TRACE_SCOPE("PreviewSink::write");
+        cv::imwrite(dir + "/frame.png", frame);
+        cv::imwrite(dir + "/fgmask.png", fgMask);
+        cv::imwrite(dir + "/update_mask.png", updateMask);
+        return;
+    }
+
+    // Hand the rendered images over, the next render allocates new ones
+    auto* encoder = _params.encoder;
+    encoder->submit(dir + "/frame.png", std::move(frame));
+    encoder->submit(dir + "/fgmask.png", std::move(fgMask));
+    encoder->submit(dir + "/update_mask.png", std::move(updateMask));
+}
+
+void PreviewSink::render(const Snapshot& snapshot,
+                         cv::Mat& frame,
+                         cv::Mat& fgMask,
+                         cv::Mat& updateMask) const {
+    TRACE_SCOPE("PreviewSink::render");
+
+    auto scale = _params.scale;
+    auto size = cv::Size(static_cast<int>(snapshot.frame.cols * scale),
+                         static_cast<int>(snapshot.frame.rows * scale));
+
+    cv::resize(snapshot.frame, frame, size, 0.0, 0.0, cv::INTER_AREA);
+    cv::resize(snapshot.fgMask, fgMask, size, 0.0, 0.0, cv::INTER_NEAREST);
+    cv::resize(
+        snapshot.updateMask, updateMask, size, 0.0, 0.0, cv::INTER_NEAREST);
+
+    if (!snapshot.isValid) {
+        return;
+    }
+
+    auto scaled = [scale](const cv::Rect2f& bbox) {
+        return cv::Rect(static_cast<int>(bbox.x * scale),
+                        static_cast<int>(bbox.y * scale),
+                        static_cast<int>(bbox.width * scale),
+                        static_cast<int>(bbox.height * scale));
+    };
+
+    for (const auto& bbox : snapshot.detections) {
+        cv::rectangle(frame, scaled(bbox), {255, 50, 0}, 1);
+    }
+
+    std::array<char, 16> tag;
+    for (const auto& [id, bbox] : snapshot.tracks) {
+        auto rect = scaled(bbox);
+        cv::rectangle(frame, rect, {0, 200, 0}, 1);
+        std::snprintf(tag.data(), tag.size(), "%d", id);
+        cv::putText(frame,
+                    tag.data(),
+                    {rect.x, std::max(rect.y - 2, 8)},
+                    cv::FONT_HERSHEY_SIMPLEX,
+                    0.35,
+                    {0, 200, 0},
+                    1,
+                    cv::LINE_AA);
+    }
+
+    // Draw process time measurement result
+    cv::putText(frame,
+                snapshot.caption.data(),
+                {12, 30},
+                cv::FONT_HERSHEY_SIMPLEX,
+                0.5,
+                {0, 0, 255},
+                1,
+                cv::LINE_AA);
+}
@@ -0,0 +1,220 @@
+/**
+ * @file preview_sink.hpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Preview of analysis results, rendered on its own thread
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+
+#include "snapshot_encoder.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <opencv2/core.hpp>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Additional parameters for PreviewSink class
+ */
+struct PreviewSinkParams {
+    /**
+     * @brief Max number of previewed frames per second
+     */
+    double fps = 10.0;
+
+    /**
+     * @brief Preview resolution relative to the analysis resolution
+     */
+    double scale = 0.5;
+
+    /**
+     * @brief Write previews as frame.png, fgmask.png and update_mask.png to
+     * this directory instead of showing windows (for headless builds)
+     */
+    std::string outputDir = "";
+
+    /**
+     * @brief Encoder of preview files (written synchronously if null)
+     */
+    SnapshotEncoder* encoder = nullptr;
+};
+
+/**
+ * @brief Optional visualisation of the pipeline.
+ *        The analysis thread copies a sampled frame, its masks and a snapshot
+ *        of detections and tracks into a triple buffer, it never blocks and
+ *        never draws on its own buffers. A render thread downscales and
+ *        annotates the latest snapshot. Windows are shown by present() on the
+ *        main thread, since HighGUI is not thread-safe on every platform.
+ */
+class PreviewSink final {
+  public:
+#pragma region Public types
+
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief {Tag, BBox} of a track
+     */
+    using Track = std::pair<int, cv::Rect2f>;
+
+    /**
+     * @brief Analysis results of one frame
+     */
+    struct Snapshot {
+        cv::Mat frame;
+        cv::Mat fgMask;
+        cv::Mat updateMask;
+        std::vector<cv::Rect2f> detections;
+        std::vector<Track> tracks;
+        std::array<char, 64> caption;
+
+        /**
+         * @brief False if the frame had too many blobs
+         */
+        bool isValid;
+    };
+
+#pragma endregion
+
+#pragma region Public member methods
+
+    /**
+     * @brief Construct a new PreviewSink object
+     *
+     * @param params Additional parameters
+     */
+    explicit PreviewSink(const PreviewSinkParams& params = PreviewSinkParams());
+
+    /**
+     * @brief Destroy the PreviewSink object, stops the render thread
+     */
+    ~PreviewSink();
+
+    PreviewSink(const PreviewSink&) = delete;
+    PreviewSink& operator=(const PreviewSink&) = delete;
+
+    /**
+     * @brief Start the render thread
+     *
+     * @return
+     */
+    void start();
+
+    /**
+     * @brief Stop the render thread
+     *
+     * @return
+     */
+    void stop();
+
+    /**
+     * @brief Tells whether a new snapshot should be submitted (producer only)
+     *
+     * @param now Current time
+     * @return  True: Preview is due
+     */
+    bool isDue(Clock::time_point now) const { return now >= _nextDueTime; }
+
+    /**
+     * @brief Get the snapshot to fill (producer only). It is owned by the
+     * producer until endSubmit().
+     *
+     * @param now Current time
+     * @return  Snapshot
+     */
+    Snapshot& beginSubmit(Clock::time_point now);
+
+    /**
+     * @brief Hand the filled snapshot over to the render thread, replacing a
+     * snapshot that has not been rendered yet
+     *
+     * @return
+     */
+    void endSubmit();
+
+    /**
+     * @brief Show the latest rendered preview and poll the keyboard (call from
+     * the main thread)
+     *
+     * @param delayMs Time to wait for a key press
+     * @return  Pressed key code, -1 if none
+     */
+    int present(int delayMs = 1);
+
+#pragma endregion
+
+  private:
+#pragma region Private member variables
+
+    PreviewSinkParams _params;
+    Clock::duration _interval;
+    Clock::time_point _nextDueTime;
+
+    /* Triple buffer of snapshots: written, ready and rendering */
+    std::array<Snapshot, 3> _snapshots;
+    int _writeIndex = 0;
+    int _readyIndex = 1;
+    int _renderIndex = 2;
+    bool _hasReady = false;
+
+    /* Rendered previews, shown by present() */
+    cv::Mat _renderedFrame;
+    cv::Mat _renderedFgMask;
+    cv::Mat _renderedUpdateMask;
+    bool _hasRendered = false;
+
+    std::mutex _mutex;
+    std::condition_variable _readyCond;
+    std::mutex _renderedMutex;
+
+    std::atomic<bool> _isRunning{false};
+    std::thread _thread;
+
+#pragma endregion
+
+#pragma region Private member methods
+
+    /**
+     * @brief Render thread loop
+     *
+     * @return
+     */
+    void run();
+
+    /**
+     * @brief Downscale and annotate a snapshot
+     *
+     * @param snapshot Snapshot
+     * @param frame Output annotated frame
+     * @param fgMask Output foreground mask
+     * @param updateMask Output update mask
+     * @return
+     */
+    void render(const Snapshot& snapshot,
+                cv::Mat& frame,
+                cv::Mat& fgMask,
+                cv::Mat& updateMask) const;
+
+    /**
+     * @brief Write rendered previews to the output directory
+     *
+     * @param frame Annotated frame
+     * @param fgMask Foreground mask
+     * @param updateMask Update mask
+     * @return
+     */
+    void write(cv::Mat& frame, cv::Mat& fgMask, cv::Mat& updateMask);
+
+#pragma endregion
+};
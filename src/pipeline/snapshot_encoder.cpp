@@ -0,0 +1,165 @@
+/**
+ * @file snapshot_encoder.cpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Asynchronous image encoding and writing pool
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "snapshot_encoder.hpp"
+
+#include "trace.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <opencv2/imgcodecs.hpp>
+#include <utility>
+
+SnapshotEncoder::SnapshotEncoder(const SnapshotEncoderParams& params)
+    : _params(params) {
+    _params.numWorkers = std::max(1, _params.numWorkers);
+    _params.capacity = std::max(1, _params.capacity);
+}
+
+SnapshotEncoder::~SnapshotEncoder() { stop(); }
+
+void SnapshotEncoder::start() {
+    {
+        auto lock = std::lock_guard<std::mutex>(_mutex);
+        if (_isRunning) {
+            return;
+        }
+        _isRunning = true;
+    }
+
+    for (int i = 0; i < _params.numWorkers; i++) {
+        _workers.emplace_back(&SnapshotEncoder::run, this);
+    }
+}
+
+void SnapshotEncoder::stop() {
+    {
+        auto lock = std::lock_guard<std::mutex>(_mutex);
+        if (!_isRunning) {
+            return;
+        }
+        _isRunning = false;
+        _jobCond.notify_all();
+        _spaceCond.notify_all();
+    }
+
+    for (auto& worker : _workers) {
+        worker.join();
+    }
+    _workers.clear();
+}
+
+bool SnapshotEncoder::submit(const std::string& path,
+                             cv::Mat image,
+                             SnapshotPriority priority) {
+    auto lock = std::unique_lock<std::mutex>(_mutex);
+    auto capacity = static_cast<size_t>(_params.capacity);
+
+    if (priority == SnapshotPriority::LOW) {
+        if (!_isRunning || getNumJobs() >= capacity) {
+            _numDropped++;
+            return false;
+        }
+        _lowJobs.push_back(Job{path, std::move(image)});
+    } else {
+        // Make room by dropping the oldest debug image, otherwise wait
+        if (getNumJobs() >= capacity && !_lowJobs.empty()) {
+            _lowJobs.pop_front();
+            _numDropped++;
+        }
+
+        _spaceCond.wait(lock, [this, capacity]() {
+            return !_isRunning || getNumJobs() < capacity;
+        });
+        if (!_isRunning) {
+            _numDropped++;
+            return false;
+        }
+        _highJobs.push_back(Job{path, std::move(image)});
+    }
+
+    _jobCond.notify_one();
+    return true;
+}
+
+void SnapshotEncoder::run() {
+    if (Tracer::isEnabled()) {
+        Tracer::instance().setThreadName("encoder");
+    }
+
+    auto buffer = std::vector<uint8_t>();
+    auto job = Job();
+
+    while (true) {
+        {
+            auto lock = std::unique_lock<std::mutex>(_mutex);
+            _jobCond.wait(
+                lock, [this]() { return !_isRunning || getNumJobs() > 0; });
+
+            // Drain pending jobs before stopping
+            if (getNumJobs() == 0) {
+                return;
+            }
+
+            auto& jobs = _highJobs.empty() ? _lowJobs : _highJobs;
+            job = std::move(jobs.front());
+            jobs.pop_front();
+            _spaceCond.notify_one();
+        }
+
+        if (write(job, buffer)) {
+            _numWritten++;
+        } else {
+            _numFailed++;
+            std::printf("[SNAPSHOT] Failed to write %s\n", job.path.c_str());
+        }
+
+        // Give the image buffer back as soon as possible
+        job.image.release();
+    }
+}
+
+bool SnapshotEncoder::write(const Job& job,
+                            std::vector<uint8_t>& buffer) const {
+    TRACE_SCOPE("SnapshotEncoder::write");
+
+    const auto& path = job.path;
+    bool isPNG = path.size() >= 4 &&
+                 path.compare(path.size() - 4, 4, ".png") == 0;
+
+    auto encodeParams =
+        isPNG ? std::vector<int>{cv::IMWRITE_PNG_COMPRESSION,
+                                 _params.pngCompression}
+              : std::vector<int>{cv::IMWRITE_JPEG_QUALITY, _params.jpegQuality};
+
+    if (!cv::imencode(
+            isPNG ? ".png" : ".jpg", job.image, buffer, encodeParams)) {
+        return false;
+    }
+
+    // Write to a temporary file then rename, so the file appears complete
+    auto tmpPath = path + ".tmp";
+    std::FILE* file = std::fopen(tmpPath.c_str(), "wb");
+    if (file == nullptr) {
+        return false;
+    }
+
+    bool isWritten =
+        std::fwrite(buffer.data(), 1, buffer.size(), file) == buffer.size();
+    isWritten = std::fclose(file) == 0 && isWritten;
+
+    if (!isWritten || std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,180 @@
+/**
+ * @file snapshot_encoder.hpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Asynchronous image encoding and writing pool
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <opencv2/core.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Priority of a snapshot
+ */
+enum class SnapshotPriority {
+    /**
+     * @brief Debug images, dropped when the encoder is saturated
+     */
+    LOW,
+
+    /**
+     * @brief Results (e.g. trajectories), never dropped
+     */
+    HIGH,
+};
+
+/**
+ * @brief Additional parameters for SnapshotEncoder class
+ */
+struct SnapshotEncoderParams {
+    /**
+     * @brief Number of encoding threads
+     */
+    int numWorkers = 1;
+
+    /**
+     * @brief Max number of snapshots waiting to be encoded
+     */
+    int capacity = 8;
+
+    /**
+     * @brief JPEG quality (0 - 100)
+     */
+    int jpegQuality = 90;
+
+    /**
+     * @brief PNG compression level (0 - 9), low levels are much faster
+     */
+    int pngCompression = 1;
+};
+
+/**
+ * @brief Encodes and writes images on worker threads.
+ *        submit() takes a reference to the image buffer instead of copying
+ *        it, so the caller must not draw on the image afterwards. Files are
+ *        written to a temporary path and renamed, readers never see a
+ *        partial image. When the queue is full, low priority snapshots are
+ *        dropped, high priority ones wait.
+ */
+class SnapshotEncoder final {
+  public:
+#pragma region Public member methods
+
+    /**
+     * @brief Construct a new SnapshotEncoder object
+     *
+     * @param params Additional parameters
+     */
+    explicit SnapshotEncoder(
+        const SnapshotEncoderParams& params = SnapshotEncoderParams());
+
+    /**
+     * @brief Destroy the SnapshotEncoder object, pending snapshots are written
+     * first
+     */
+    ~SnapshotEncoder();
+
+    SnapshotEncoder(const SnapshotEncoder&) = delete;
+    SnapshotEncoder& operator=(const SnapshotEncoder&) = delete;
+
+    /**
+     * @brief Start worker threads
+     *
+     * @return
+     */
+    void start();
+
+    /**
+     * @brief Write all pending snapshots and stop worker threads
+     *
+     * @return
+     */
+    void stop();
+
+    /**
+     * @brief Queue an image to be written, the format is given by the file
+     * extension (.png or JPEG otherwise)
+     *
+     * @param path Output file path
+     * @param image Image, shared with the encoder until written
+     * @param priority Priority
+     * @return  True: Queued
+     *          False: Dropped (saturated low priority snapshot, or stopped)
+     */
+    bool submit(const std::string& path,
+                cv::Mat image,
+                SnapshotPriority priority = SnapshotPriority::LOW);
+
+    uint64_t getNumWritten() const { return _numWritten.load(); }
+
+    uint64_t getNumDropped() const { return _numDropped.load(); }
+
+    uint64_t getNumFailed() const { return _numFailed.load(); }
+
+#pragma endregion
+
+  private:
+#pragma region Private types
+
+    struct Job {
+        std::string path;
+        cv::Mat image;
+    };
+
+#pragma endregion
+
+#pragma region Private member variables
+
+    SnapshotEncoderParams _params;
+
+    /* Pending jobs, high priority ones are written first */
+    std::deque<Job> _highJobs;
+    std::deque<Job> _lowJobs;
+
+    std::mutex _mutex;
+    std::condition_variable _jobCond;
+    std::condition_variable _spaceCond;
+    bool _isRunning = false;
+
+    std::vector<std::thread> _workers;
+
+    std::atomic<uint64_t> _numWritten{0};
+    std::atomic<uint64_t> _numDropped{0};
+    std::atomic<uint64_t> _numFailed{0};
+
+#pragma endregion
+
+#pragma region Private member methods
+
+    /**
+     * @brief Worker thread loop
+     *
+     * @return
+     */
+    void run();
+
+    /**
+     * @brief Encode an image and atomically write it to a file
+     *
+     * @param job Job
+     * @param buffer Reused encoding buffer
+     * @return  True: Written
+     */
+    bool write(const Job& job, std::vector<uint8_t>& buffer) const;
+
+    size_t getNumJobs() const { return _highJobs.size() + _lowJobs.size(); }
+
+#pragma endregion
+};
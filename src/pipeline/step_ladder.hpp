@@ -0,0 +1,238 @@
+/**
+ * @file step_ladder.hpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Ladder of degraded pipeline settings walked with hysteresis
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+
+#include "trace.hpp"
+
+#include <cstdio>
+#include <vector>
+
+/**
+ * @brief Additional parameters for StepLadder class
+ */
+struct StepLadderParams {
+    /**
+     * @brief Tag of the step logs
+     */
+    const char* tag = "LADDER";
+
+    /**
+     * @brief Trace event names of the steps (string literals)
+     */
+    const char* stepDownEvent = "ladder step down";
+    const char* stepUpEvent = "ladder step up";
+
+    /**
+     * @brief Step back up after this many consecutive calm checks
+     */
+    int numCalmChecksToStepUp = 5;
+
+    /**
+     * @brief Checks to skip after a change, letting the pipeline settle
+     */
+    int numCooldownChecks = 2;
+};
+
+/**
+ * @brief Levels of pipeline settings, each degrading one knob by one step
+ *        from the level above. The owner measures the load on each check;
+ *        the ladder steps down at once when over budget, and back up only
+ *        after a run of calm checks, skipping the checks right after a
+ *        change.
+ *
+ * @tparam Settings Pipeline settings of one level
+ */
+template <typename Settings>
+class StepLadder final {
+  public:
+#pragma region Public types
+
+    /**
+     * @brief Load measured on one check
+     */
+    enum class Load {
+        /**
+         * @brief Over budget, step down
+         */
+        OVER,
+
+        /**
+         * @brief Within budget, stay
+         */
+        NORMAL,
+
+        /**
+         * @brief Well under budget, step up after a run of calm checks
+         */
+        CALM,
+    };
+
+#pragma endregion
+
+#pragma region Public member methods
+
+    /**
+     * @brief Construct a new StepLadder object with a single level
+     *
+     * @param settings Full quality settings
+     * @param params Additional parameters
+     */
+    explicit StepLadder(const Settings& settings,
+                        const StepLadderParams& params = StepLadderParams())
+        : _params(params),
+          _ladder{settings} {}
+
+    /**
+     * @brief Add a level for each step of a knob below its first one, the
+     * other knobs kept as in the last level
+     *
+     * @tparam T Knob type
+     * @param knob Knob member
+     * @param steps Knob values, first one already in the ladder
+     * @return
+     */
+    template <typename T>
+    void addSteps(T Settings::*knob, const std::vector<T>& steps) {
+        auto settings = _ladder.back();
+        for (size_t i = 1; i < steps.size(); i++) {
+            settings.*knob = steps[i];
+            _ladder.push_back(settings);
+        }
+    }
+
+    /**
+     * @brief Add a level below the last one
+     *
+     * @param settings Settings of the level
+     * @return
+     */
+    void addLevel(const Settings& settings) { _ladder.push_back(settings); }
+
+    /**
+     * @brief Move to a level without settling, e.g. the matching one of a
+     * rebuilt ladder
+     *
+     * @param level Level [0, getNumLevels())
+     * @return
+     */
+    void moveTo(int level) { _level = level; }
+
+    /**
+     * @brief Skip a check right after a change
+     *
+     * @return  True: settling, don't measure this check
+     */
+    bool isSettling() {
+        if (_numCooldownChecks > 0) {
+            _numCooldownChecks--;
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Account the load of a settled check
+     *
+     * @param load Measured load
+     * @return  1: stepped down, -1: stepped up, 0: level kept
+     */
+    int update(Load load) {
+        if (load == Load::OVER) {
+            _numCalmChecks = 0;
+            if (isLowest()) {
+                return 0;
+            }
+            setLevel(_level + 1);
+            return 1;
+        }
+
+        if (load != Load::CALM) {
+            _numCalmChecks = 0;
+            return 0;
+        }
+
+        if (++_numCalmChecks >= _params.numCalmChecksToStepUp && _level > 0) {
+            setLevel(_level - 1);
+            return -1;
+        }
+        return 0;
+    }
+
+    /**
+     * @brief Log the last step and record it in the trace
+     *
+     * @param step Return value of update()
+     * @param details Settings and load of the new level
+     * @return
+     */
+    void logStep(int step, const char* details) const {
+        bool isStepDown = step > 0;
+        std::printf("[%s] Step %s to level %d/%d: %s\n",
+                    _params.tag,
+                    isStepDown ? "down" : "up",
+                    _level,
+                    getNumLevels() - 1,
+                    details);
+
+        if (Tracer::isEnabled()) {
+            uint64_t now = Tracer::now();
+            Tracer::instance().record(isStepDown ? _params.stepDownEvent
+                                                 : _params.stepUpEvent,
+                                      now,
+                                      now);
+        }
+    }
+
+    const Settings& getSettings() const { return _ladder[_level]; }
+
+    const Settings& getSettings(int level) const { return _ladder[level]; }
+
+    int getLevel() const { return _level; }
+
+    int getNumLevels() const { return static_cast<int>(_ladder.size()); }
+
+    /**
+     * @brief Tells whether the ladder is at its most degraded level
+     *
+     * @return  True: cannot step down
+     */
+    bool isLowest() const { return _level + 1 >= getNumLevels(); }
+
+#pragma endregion
+
+  private:
+#pragma region Private member variables
+
+    StepLadderParams _params;
+    std::vector<Settings> _ladder;
+    int _level = 0;
+
+    int _numCalmChecks = 0;
+    int _numCooldownChecks = 0;
+
+#pragma endregion
+
+#pragma region Private member methods
+
+    /**
+     * @brief Move to another level and start settling
+     *
+     * @param level New level
+     * @return
+     */
+    void setLevel(int level) {
+        _level = level;
+        _numCalmChecks = 0;
+        _numCooldownChecks = _params.numCooldownChecks;
+    }
+
+#pragma endregion
+};
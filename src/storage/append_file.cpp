@@ -0,0 +1,144 @@
+/**
+ * @file append_file.cpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Buffered append-only file flushed by a background thread
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "append_file.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+bool writeAll(int fd, const uint8_t* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = ::write(fd, data, size);
+        if (n < 0) {
+            return false;
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+} // namespace
+
+AppendFile::AppendFile(const AppendFileParams& params) : _params(params) {}
+
+AppendFile::~AppendFile() {
+    if (!isOpened()) {
+        return;
+    }
+
+    {
+        auto lock = std::lock_guard<std::mutex>(_mutex);
+        _isRunning = false;
+        _stopCond.notify_all();
+    }
+    _thread.join();
+
+    flush(true);
+    ::close(_fd);
+}
+
+bool AppendFile::open(const std::string& path,
+                      size_t validSize,
+                      const void* header,
+                      size_t headerSize) {
+    if (isOpened()) {
+        return false;
+    }
+
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT, 0644);
+    if (fd < 0) {
+        return false;
+    }
+
+    // Drop a partial record at the end of an existing file, or start a new
+    // one with its header
+    bool isOk = validSize > 0
+                    ? ::ftruncate(fd, static_cast<off_t>(validSize)) == 0 &&
+                          ::lseek(fd, 0, SEEK_END) >= 0
+                    : ::ftruncate(fd, 0) == 0 &&
+                          writeAll(fd,
+                                   static_cast<const uint8_t*>(header),
+                                   headerSize);
+    if (!isOk) {
+        ::close(fd);
+        return false;
+    }
+
+    _path = path;
+    _fd = fd;
+    _buffer.reserve(_params.bufferSize);
+    _flushBuffer.reserve(_params.bufferSize);
+
+    _isRunning = true;
+    _thread = std::thread(&AppendFile::run, this);
+    return true;
+}
+
+bool AppendFile::append(const void* data, size_t size) {
+    return append(size, [data, size](uint8_t* dst) {
+        std::copy_n(static_cast<const uint8_t*>(data), size, dst);
+    });
+}
+
+void AppendFile::flush(bool sync) {
+    if (!isOpened()) {
+        return;
+    }
+
+    // Only one flush at a time, records stay in order
+    auto fileLock = std::lock_guard<std::mutex>(_fileMutex);
+
+    {
+        auto lock = std::lock_guard<std::mutex>(_mutex);
+        _buffer.swap(_flushBuffer);
+    }
+
+    if (!_flushBuffer.empty() &&
+        !writeAll(_fd, _flushBuffer.data(), _flushBuffer.size())) {
+        std::printf("[APPEND FILE] Write to %s failed\n", _path.c_str());
+    }
+    _flushBuffer.clear();
+
+    if (sync) {
+        ::fsync(_fd);
+    }
+}
+
+void AppendFile::run() {
+    auto flushInterval = std::chrono::milliseconds(_params.flushIntervalMs);
+    auto syncInterval = std::chrono::milliseconds(_params.syncIntervalMs);
+    auto lastSyncTime = std::chrono::steady_clock::now();
+
+    while (true) {
+        {
+            auto lock = std::unique_lock<std::mutex>(_mutex);
+            if (_stopCond.wait_for(
+                    lock, flushInterval, [this]() { return !_isRunning; })) {
+                return;
+            }
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        bool sync = _params.syncIntervalMs > 0 &&
+                    now - lastSyncTime >= syncInterval;
+        flush(sync);
+        if (sync) {
+            lastSyncTime = now;
+        }
+    }
+}
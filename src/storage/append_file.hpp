@@ -0,0 +1,170 @@
+/**
+ * @file append_file.hpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Buffered append-only file flushed by a background thread
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Additional parameters for AppendFile class
+ */
+struct AppendFileParams {
+    /**
+     * @brief Interval between two writes of buffered bytes (ms)
+     */
+    int flushIntervalMs = 1000;
+
+    /**
+     * @brief Interval between two syncs of written bytes to storage (ms),
+     * 0: only when closed
+     */
+    int syncIntervalMs = 0;
+
+    /**
+     * @brief Initial capacity of the buffer (bytes)
+     */
+    size_t bufferSize = 64 * 1024;
+
+    /**
+     * @brief Max size of bytes waiting to be written (bytes), appends are
+     * dropped beyond, e.g. while storage stalls, 0: unbounded
+     */
+    size_t maxBufferSize = 0;
+};
+
+/**
+ * @brief Appends records of a binary file format to a file.
+ *        Records are copied into a memory buffer by the caller, a background
+ *        thread writes the buffer out periodically and syncs the file less
+ *        often, so appending costs the caller a copy and the storage a few
+ *        sequential writes. The file format (header, record framing,
+ *        recovery of a partial record) is up to the owner.
+ */
+class AppendFile final {
+  public:
+#pragma region Public member methods
+
+    /**
+     * @brief Construct a new AppendFile object, not opened yet
+     *
+     * @param params Additional parameters
+     */
+    explicit AppendFile(const AppendFileParams& params = AppendFileParams());
+
+    /**
+     * @brief Destroy the AppendFile object, buffered bytes are written and
+     * synced
+     */
+    ~AppendFile();
+
+    AppendFile(const AppendFile&) = delete;
+    AppendFile& operator=(const AppendFile&) = delete;
+
+    /**
+     * @brief Open the file and start flushing
+     *
+     * @param path File path
+     * @param validSize Size of the complete records of an existing file,
+     * bytes beyond are dropped, 0: the file is (re)created with the header
+     * @param header File header of a new file
+     * @param headerSize File header size
+     * @return  True: Opened
+     */
+    bool open(const std::string& path,
+              size_t validSize,
+              const void* header,
+              size_t headerSize);
+
+    /**
+     * @brief Tells whether the file is opened
+     *
+     * @return  True: Opened
+     */
+    bool isOpened() const { return _fd >= 0; }
+
+    /**
+     * @brief Append bytes to the buffer
+     *
+     * @param data Bytes
+     * @param size Number of bytes
+     * @return  True: appended, False: dropped or not opened
+     */
+    bool append(const void* data, size_t size);
+
+    /**
+     * @brief Append bytes serialized in place, one append is never split
+     * by a flush
+     *
+     * @tparam Fill void(uint8_t* data), called with the buffer mutex held on
+     * zeroed bytes
+     * @param size Number of bytes
+     * @param fill Writes the bytes
+     * @return  True: appended, False: dropped or not opened
+     */
+    template <typename Fill>
+    bool append(size_t size, Fill&& fill) {
+        auto lock = std::lock_guard<std::mutex>(_mutex);
+        if (!isOpened() || (_params.maxBufferSize > 0 &&
+                            _buffer.size() + size > _params.maxBufferSize)) {
+            return false;
+        }
+
+        size_t offset = _buffer.size();
+        _buffer.resize(offset + size);
+        fill(_buffer.data() + offset);
+        return true;
+    }
+
+    /**
+     * @brief Write buffered bytes now
+     *
+     * @param sync Also sync the file to storage
+     * @return
+     */
+    void flush(bool sync = false);
+
+#pragma endregion
+
+  private:
+#pragma region Private member variables
+
+    std::string _path;
+    AppendFileParams _params;
+    int _fd = -1;
+
+    /* Bytes appended by the caller, swapped with the flushing buffer */
+    std::vector<uint8_t> _buffer;
+    std::vector<uint8_t> _flushBuffer;
+
+    std::mutex _mutex;
+    std::mutex _fileMutex;
+    std::condition_variable _stopCond;
+    bool _isRunning = false;
+    std::thread _thread;
+
+#pragma endregion
+
+#pragma region Private member methods
+
+    /**
+     * @brief Background flushing loop
+     *
+     * @return
+     */
+    void run();
+
+#pragma endregion
+};
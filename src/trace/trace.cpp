@@ -0,0 +1,124 @@
+/**
+ * @file trace.cpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Scoped trace events recorded into per-thread ring buffers and
+ * flushed as Chrome/Perfetto JSON trace
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "trace.hpp"
+
+#include <algorithm>
+#include <csignal>
+#include <cstdio>
+#include <unistd.h>
+
+std::atomic<bool> Tracer::_isEnabled{false};
+std::atomic<bool> Tracer::_isFlushRequested{false};
+
+Tracer::Tracer() : _originNs(now()) {}
+
+Tracer& Tracer::instance() {
+    static Tracer tracer;
+    return tracer;
+}
+
+Tracer::ThreadBuffer& Tracer::getThreadBuffer() {
+    thread_local ThreadBuffer* buffer = nullptr;
+
+    if (buffer == nullptr) {
+        // First event of this thread, register its buffer (the buffer is owned
+        // by the tracer so it survives thread exit until the next flush)
+        auto lock = std::scoped_lock(_mutex);
+        auto& newBuffer = _buffers.emplace_back(std::make_unique<ThreadBuffer>());
+        newBuffer->tid = static_cast<int>(_buffers.size());
+        newBuffer->events = std::make_unique<Event[]>(RING_CAPACITY);
+        buffer = newBuffer.get();
+    }
+
+    return *buffer;
+}
+
+void Tracer::record(const char* name, uint64_t beginNs, uint64_t endNs) {
+    auto& buffer = getThreadBuffer();
+    uint64_t head = buffer.head.load(std::memory_order_relaxed);
+
+    buffer.events[head % RING_CAPACITY] = Event{name, beginNs, endNs};
+    // Publish the event to flushing thread
+    buffer.head.store(head + 1, std::memory_order_release);
+}
+
+void Tracer::setThreadName(std::string_view name) {
+    auto& buffer = getThreadBuffer();
+    auto lock = std::scoped_lock(_mutex);
+    buffer.name = name;
+}
+
+bool Tracer::flush(const std::string& path) {
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (file == nullptr) {
+        return false;
+    }
+
+    std::fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    int pid = static_cast<int>(getpid());
+    bool isFirst = true;
+
+    auto lock = std::scoped_lock(_mutex);
+    std::vector<Event> events(RING_CAPACITY);
+
+    for (const auto& buffer : _buffers) {
+        if (!buffer->name.empty()) {
+            std::fprintf(file,
+                         "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,"
+                         "\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                         isFirst ? "" : ",\n",
+                         pid,
+                         buffer->tid,
+                         buffer->name.c_str());
+            isFirst = false;
+        }
+
+        // Copy out the ring, then discard slots the writer may have
+        // overwritten meanwhile
+        uint64_t head = buffer->head.load(std::memory_order_acquire);
+        uint64_t tail = head > RING_CAPACITY ? head - RING_CAPACITY : 0;
+        for (uint64_t i = tail; i < head; i++) {
+            events[i - tail] = buffer->events[i % RING_CAPACITY];
+        }
+
+        // A writer may be in the middle of recording event headAfter, which
+        // overwrites slot headAfter - RING_CAPACITY as well
+        uint64_t headAfter = buffer->head.load(std::memory_order_acquire);
+        uint64_t validTail = headAfter + 1 > RING_CAPACITY
+                                 ? headAfter + 1 - RING_CAPACITY
+                                 : 0;
+
+        for (uint64_t i = std::max(tail, validTail); i < head; i++) {
+            const auto& event = events[i - tail];
+            std::fprintf(file,
+                         "%s{\"name\":\"%s\",\"ph\":\"X\",\"pid\":%d,"
+                         "\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                         isFirst ? "" : ",\n",
+                         event.name,
+                         pid,
+                         buffer->tid,
+                         (event.beginNs - _originNs) * 1e-3,
+                         (event.endNs - event.beginNs) * 1e-3);
+            isFirst = false;
+        }
+    }
+
+    std::fprintf(file, "\n]}\n");
+    return std::fclose(file) == 0;
+}
+
+void Tracer::installFlushSignal(int signum) {
+    std::signal(signum, [](int) {
+        _isFlushRequested.store(true, std::memory_order_relaxed);
+    });
+}
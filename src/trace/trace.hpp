@@ -0,0 +1,194 @@
+/**
+ * @file trace.hpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Scoped trace events recorded into per-thread ring buffers and
+ * flushed as Chrome/Perfetto JSON trace
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Process-wide trace event collector.
+ *        Recording is lock-free: each thread owns a ring buffer and is its
+ *        only writer. When tracing is disabled a scope costs one relaxed load.
+ */
+class Tracer final {
+  public:
+#pragma region Public member methods
+
+    /**
+     * @brief Get the global tracer
+     */
+    static Tracer& instance();
+
+    /**
+     * @brief Tells whether trace events are being recorded
+     */
+    static bool isEnabled() {
+        return _isEnabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Enable or disable recording
+     *
+     * @param isEnabled Recording flag
+     * @return
+     */
+    static void setEnabled(bool isEnabled) {
+        _isEnabled.store(isEnabled, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Get current trace clock (ns)
+     */
+    static uint64_t now() {
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch())
+                .count());
+    }
+
+    /**
+     * @brief Record a complete event on the calling thread
+     *
+     * @param name Event name (must be a string literal or otherwise outlive
+     * the tracer)
+     * @param beginNs Begin time from Tracer::now()
+     * @param endNs End time from Tracer::now()
+     * @return
+     */
+    void record(const char* name, uint64_t beginNs, uint64_t endNs);
+
+    /**
+     * @brief Name the calling thread in the trace output
+     *
+     * @param name Thread name
+     * @return
+     */
+    void setThreadName(std::string_view name);
+
+    /**
+     * @brief Write all buffered events to a Chrome/Perfetto JSON trace file
+     *
+     * @param path Output file path
+     * @return  True: written successfully
+     *          False: failed to write
+     */
+    bool flush(const std::string& path);
+
+    /**
+     * @brief Install a signal handler (SIGUSR1 by default) that requests a
+     * flush, the request is served by whoever polls consumeFlushRequest()
+     *
+     * @param signum Signal number
+     * @return
+     */
+    static void installFlushSignal(int signum);
+
+    /**
+     * @brief Tells whether a flush was requested (by signal) and clears the
+     * request
+     *
+     * @return  True: flush requested
+     */
+    static bool consumeFlushRequest() {
+        return _isFlushRequested.exchange(false, std::memory_order_relaxed);
+    }
+
+#pragma endregion
+
+#pragma region Public constants
+
+    /**
+     * @brief Number of events kept in each per-thread ring buffer
+     */
+    static constexpr size_t RING_CAPACITY = 1U << 14U;
+
+#pragma endregion
+
+  private:
+#pragma region Private types
+
+    struct Event {
+        const char* name;
+        uint64_t beginNs;
+        uint64_t endNs;
+    };
+
+    struct ThreadBuffer {
+        int tid;
+        std::string name;
+        std::unique_ptr<Event[]> events;
+        std::atomic<uint64_t> head{0};
+    };
+
+#pragma endregion
+
+#pragma region Private member variables
+
+    static std::atomic<bool> _isEnabled;
+    static std::atomic<bool> _isFlushRequested;
+
+    std::mutex _mutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> _buffers;
+    uint64_t _originNs;
+
+#pragma endregion
+
+#pragma region Private member methods
+
+    Tracer();
+
+    /**
+     * @brief Get (or register) the ring buffer of the calling thread
+     */
+    ThreadBuffer& getThreadBuffer();
+
+#pragma endregion
+};
+
+/**
+ * @brief RAII trace scope, records a complete event on destruction
+ */
+class TraceScope final {
+  public:
+    explicit TraceScope(const char* name)
+        : _name(Tracer::isEnabled() ? name : nullptr),
+          _beginNs(_name != nullptr ? Tracer::now() : 0) {}
+
+    TraceScope(const TraceScope&) = delete;
+
+    TraceScope& operator=(const TraceScope&) = delete;
+
+    ~TraceScope() {
+        if (_name != nullptr) {
+            Tracer::instance().record(_name, _beginNs, Tracer::now());
+        }
+    }
+
+  private:
+    const char* _name;
+    uint64_t _beginNs;
+};
+
+#if defined(FOD_DISABLE_TRACE)
+#define TRACE_SCOPE(name)
+#else
+#define TRACE_CONCAT_IMPL(a, b) a##b
+#define TRACE_CONCAT(a, b)      TRACE_CONCAT_IMPL(a, b)
+#define TRACE_SCOPE(name)       TraceScope TRACE_CONCAT(_traceScope, __LINE__)(name)
+#endif
@@ -11,6 +11,8 @@
 
 #include "lap_solver.hpp"
 
+#include "trace.hpp"
+
 #include <algorithm>
 #include <cstdio>
 #include <limits>
@@ -20,6 +22,8 @@ float LAPSolver::solve(const cv::Mat& cost,
                        std::vector<int>& assignment,
                        std::vector<int>& assignmentReversed,
                        bool maximize) {
+    TRACE_SCOPE("LAPSolver::solve");
+
     CV_Assert(cost.type() == CV_32F);
 
     // Extract number of tasks (rows) and number of workers (columns)
@@ -43,26 +47,62 @@ float LAPSolver::solve(const cv::Mat& cost,
     // The algorithm requires more workers than tasks
     // If it's not the case, transpose the cost matrix
     if (_m > _n) {
-        costTransposed = cost.t();
-        costTransposed.copyTo(_workingCost);
-
         std::swap(_m, _n);
         isTransposed = true;
+    }
+
+    // Working matrices are headers over member buffers, so solving problems
+    // of varying size doesn't reallocate
+    size_t size = static_cast<size_t>(_m) * _n;
+    _workingCostBuffer.resize(size);
+    _workingCost = cv::Mat(_m, _n, CV_32F, _workingCostBuffer.data());
 
+    if (isTransposed) {
+        _costTransposedBuffer.resize(size);
+        costTransposed =
+            cv::Mat(_m, _n, CV_32F, _costTransposedBuffer.data());
+        cv::transpose(cost, costTransposed);
+        costTransposed.copyTo(_workingCost);
     } else {
         cost.copyTo(_workingCost);
     }
 
     // If the goal is to maximize total cost, minimize on the negative cost
     if (maximize) {
-        _workingCost = -_workingCost;
+        for (auto& value : _workingCostBuffer) {
+            value = -value;
+        }
+    }
+
+    const cv::Mat& workingInput = isTransposed ? costTransposed : cost;
+    auto& rowAssignment = isTransposed ? assignmentReversed : assignment;
+    float minTotalCost = _engine == LAPSolverEngine::SHORTEST_PATH
+                             ? solveShortestPath(workingInput, rowAssignment)
+                             : solveHungarian(workingInput, rowAssignment);
+
+    if (isTransposed) {
+        for (int j = 0; j < _m; j++) {
+            assignment[assignmentReversed[j]] = j;
+        }
+    } else {
+        for (int i = 0; i < _m; i++) {
+            assignmentReversed[assignment[i]] = i;
+        }
     }
 
-    // Initialize marker table
+    return minTotalCost;
+}
+
+float LAPSolver::solveHungarian(const cv::Mat& cost,
+                                std::vector<int>& assignment) {
+    // Initialize marker table (only grows)
     if (_markerTable.rows >= _m && _markerTable.cols >= _n) {
         _markerTable({0, _m}, {0, _n}) = Marker::NONE;
     } else {
-        _markerTable = cv::Mat(_m, _n, CV_8U, Marker::NONE);
+        _markerTable = cv::Mat(std::max(_m, _markerTable.rows),
+                               std::max(_n, _markerTable.cols),
+                               CV_8U,
+                               Marker::NONE);
     }
 
     // Initialize [covered] flags for rows and cols
@@ -84,7 +124,7 @@ float LAPSolver::solve(const cv::Mat& cost,
     std::fill_n(_hasNewlyStarredZeroInCol.begin(), _n, false);
 
     // Initialize paths array for augmenting paths algorithm
-    _paths.reserve(_m);
+    _paths.reserve(2 * _m + 1);
 
     // Do row and column reduction
     // printCost();
@@ -105,17 +145,16 @@ float LAPSolver::solve(const cv::Mat& cost,
     }
     // printCost();
 
-    float minTotalCost = assign(isTransposed ? costTransposed : cost,
-                                isTransposed ? assignmentReversed : assignment);
+    return assign(cost, assignment);
+}
 
-    if (isTransposed) {
-        for (int j = 0; j < _m; j++) {
-            assignment[assignmentReversed[j]] = j;
-        }
-    } else {
-        for (int i = 0; i < _m; i++) {
-            assignmentReversed[assignment[i]] = i;
-        }
+float LAPSolver::solveShortestPath(const cv::Mat& cost,
+                                   std::vector<int>& assignment) {
+    augmentShortestPaths(assignment);
+
+    float minTotalCost = 0.0F;
+    for (int i = 0; i < _m; i++) {
+        minTotalCost += cost.at<float>(i, assignment[i]);
     }
 
     return minTotalCost;
@@ -123,12 +162,13 @@ float LAPSolver::solve(const cv::Mat& cost,
 
 void LAPSolver::reduceRows() {
     // Row reduction
-    for (size_t i = 0; i < _m; i++) {
-        auto row = _workingCost.row(i);
-        double minVal;
+    for (int i = 0; i < _m; i++) {
+        auto* row = _workingCost.ptr<float>(i);
+        float minVal = *std::min_element(row, row + _n);
 
-        cv::minMaxLoc(row, &minVal);
-        row -= minVal;
+        for (int j = 0; j < _n; j++) {
+            row[j] -= minVal;
+        }
     }
 
     // Column reduction
@@ -340,6 +380,77 @@ void LAPSolver::adjustCost() {
     }
 }
 
+void LAPSolver::augmentShortestPaths(std::vector<int>& assignment) {
+    constexpr double INF = std::numeric_limits<double>::infinity();
+
+    // Buffers only grow, column 0 is the virtual root of each search
+    _rowPotential.assign(_m + 1, 0.0);
+    _colPotential.assign(_n + 1, 0.0);
+    _colOwner.assign(_n + 1, 0);
+    _way.resize(_n + 1);
+    _minSlack.resize(_n + 1);
+    _isColVisited.resize(_n + 1);
+
+    for (int i = 1; i <= _m; i++) {
+        // Grow a shortest path tree from row i until it reaches a free column
+        _colOwner[0] = i;
+        int j0 = 0;
+        std::fill_n(_minSlack.begin(), _n + 1, INF);
+        std::fill_n(_isColVisited.begin(), _n + 1, false);
+
+        do {
+            _isColVisited[j0] = true;
+            int i0 = _colOwner[j0];
+            const auto* row = _workingCost.ptr<float>(i0 - 1);
+            double delta = INF;
+            int j1 = 0;
+
+            for (int j = 1; j <= _n; j++) {
+                if (_isColVisited[j]) {
+                    continue;
+                }
+
+                double slack =
+                    row[j - 1] - _rowPotential[i0] - _colPotential[j];
+                if (slack < _minSlack[j]) {
+                    _minSlack[j] = slack;
+                    _way[j] = j0;
+                }
+
+                if (_minSlack[j] < delta) {
+                    delta = _minSlack[j];
+                    j1 = j;
+                }
+            }
+
+            // Keep reduced costs of the tree at zero
+            for (int j = 0; j <= _n; j++) {
+                if (_isColVisited[j]) {
+                    _rowPotential[_colOwner[j]] += delta;
+                    _colPotential[j] -= delta;
+                } else {
+                    _minSlack[j] -= delta;
+                }
+            }
+
+            j0 = j1;
+        } while (_colOwner[j0] != 0);
+
+        // Flip assignments along the path back to the root
+        do {
+            int j1 = _way[j0];
+            _colOwner[j0] = _colOwner[j1];
+            j0 = j1;
+        } while (j0 != 0);
+    }
+
+    for (int j = 1; j <= _n; j++) {
+        if (_colOwner[j] != 0) {
+            assignment[_colOwner[j] - 1] = j - 1;
+        }
+    }
+}
+
 float LAPSolver::assign(const cv::Mat& cost, std::vector<int>& assignment) {
     float minTotalCost = 0.0F;
     for (int i = 0; i < _m; i++) {
@@ -13,6 +13,22 @@
 #include <opencv2/core.hpp>
 #include <vector>
 
+/**
+ * @brief Algorithm used by LAPSolver
+ */
+enum class LAPSolverEngine {
+    /**
+     * @brief Kuhn-Munkres algorithm with starred / primed zeros
+     */
+    HUNGARIAN,
+
+    /**
+     * @brief Successive shortest augmenting paths over dual potentials, the
+     * augmentation phase of Jonker-Volgenant, O(m^2 n)
+     */
+    SHORTEST_PATH,
+};
+
 /**
  * @brief Linear Assignment Problem (LAP) Solver
  *        based on Kuhn-Munkres algorithm (Hungarian algorithm)
@@ -23,6 +39,15 @@ class LAPSolver final {
   public:
 #pragma region Public member methods
 
+    /**
+     * @brief Construct a new LAPSolver object
+     *
+     * @param engine Algorithm, both give an optimal assignment
+     * @return
+     */
+    explicit LAPSolver(LAPSolverEngine engine = LAPSolverEngine::HUNGARIAN)
+        : _engine(engine) {}
+
     /**
      * @brief Solve a linear assignment problem instance,
      *        the default goal is to minimize total cost
@@ -38,6 +63,8 @@ class LAPSolver final {
                 std::vector<int>& assignmentReversed,
                 bool maximize = false);
 
+    LAPSolverEngine getEngine() const { return _engine; }
+
 #pragma endregion
 
   private:
@@ -61,12 +88,24 @@ class LAPSolver final {
 
 #pragma region Private member variables
 
+    LAPSolverEngine _engine;
+
     /**
      * @brief Copy of the input cost matrix. It will be modified during the
      * algorithm
      */
     cv::Mat _workingCost;
 
+    /**
+     * @brief Storage of the working cost matrix, only grows
+     */
+    std::vector<float> _workingCostBuffer;
+
+    /**
+     * @brief Storage of the transposed input cost matrix, only grows
+     */
+    std::vector<float> _costTransposedBuffer;
+
     /**
      * @brief 2D table that holds markers corresponding to each cost value
      */
@@ -120,9 +159,54 @@ class LAPSolver final {
      */
     std::vector<Path> _paths;
 
+    /**
+     * @brief Dual potentials of rows and columns (SHORTEST_PATH only,
+     * 1-based, column 0 is the root of the search tree)
+     */
+    std::vector<double> _rowPotential;
+    std::vector<double> _colPotential;
+
+    /**
+     * @brief Minimum reduced cost from the search tree to each column
+     */
+    std::vector<double> _minSlack;
+
+    /**
+     * @brief Row (1-based, 0: none) assigned to each column
+     */
+    std::vector<int> _colOwner;
+
+    /**
+     * @brief Previous column on the shortest path to each column
+     */
+    std::vector<int> _way;
+
+    /**
+     * @brief 1D mask to tell whether some columns are in the search tree
+     */
+    std::vector<bool> _isColVisited;
+
 #pragma endregion
 
 #pragma region Private member methods
+    /**
+     * @brief Solve the working cost matrix with the Hungarian algorithm
+     *
+     * @param cost Input cost matrix (m x n, m <= n)
+     * @param assignment Assignment indices (rows -> columns)
+     * @return  Optimal total cost
+     */
+    float solveHungarian(const cv::Mat& cost, std::vector<int>& assignment);
+
+    /**
+     * @brief Solve the working cost matrix with shortest augmenting paths
+     *
+     * @param cost Input cost matrix (m x n, m <= n)
+     * @param assignment Assignment indices (rows -> columns)
+     * @return  Optimal total cost
+     */
+    float solveShortestPath(const cv::Mat& cost, std::vector<int>& assignment);
+
     /**
      * @brief Step 1: row cost reduction
      *
@@ -169,6 +253,15 @@ class LAPSolver final {
      */
     void adjustCost();
 
+    /**
+     * @brief Assign every row with one shortest augmenting path each
+     * (SHORTEST_PATH engine)
+     *
+     * @param assignment Assignment indices (rows -> columns)
+     * @return
+     */
+    void augmentShortestPaths(std::vector<int>& assignment);
+
     /**
      * @brief Do optimal assignment
      *
@@ -99,6 +99,12 @@ cv::Rect2f TrackedBBox::predict(const cv::Point2f& acceleration) {
     return measurementToRect(statePrior.get_minor<4, 1>(0, 0));
 }
 
+cv::Rect2f TrackedBBox::getPrediction(const cv::Point2f& acceleration) const {
+    auto kf = _kf;
+    auto statePrior = kf.predict(acceleration);
+    return measurementToRect(statePrior.get_minor<4, 1>(0, 0));
+}
+
 cv::Rect2f TrackedBBox::update(const cv::Rect2f& detectedBBox) {
     _numHits++;
     if (_age == 1) {
@@ -40,6 +40,14 @@ class TrackedBBox {
      */
     cv::Rect2f predict(const cv::Point2f& acceleration);
 
+    /**
+     * @brief Get what predict() would return, leaving this bbox unchanged
+     *
+     * @param acceleration Acceleration {a_x, a_y} (control)
+     * @return  Prior estimate of the position of this bbox
+     */
+    cv::Rect2f getPrediction(const cv::Point2f& acceleration) const;
+
     /**
      * @brief Update predicted state of this bbox with measurement
      *
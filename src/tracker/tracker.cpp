@@ -12,11 +12,14 @@
 #include "tracker.hpp"
 
 #include "kalman_filter.hpp"
+#include "trace.hpp"
 #include "tracked_bbox.hpp"
 #include "trajectory.hpp"
 
+#include <algorithm>
 #include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <cstdio>
 #include <iostream>
 #include <iterator>
@@ -25,6 +28,28 @@
 #include <vector>
 namespace chrono = std::chrono;
 
+namespace {
+
+/**
+ * @brief Acceleration {a_x, a_y} of falling objects used to predict tracks
+ */
+const cv::Point2f FALLING_ACCELERATION = {0.05F, 0.7F};
+
+/**
+ * @brief Nanoseconds elapsed since a time point, which is then moved to now
+ *
+ * @param last Time point
+ * @return  Elapsed time (ns)
+ */
+uint64_t lap(chrono::steady_clock::time_point& last) {
+    auto now = chrono::steady_clock::now();
+    auto ns = chrono::duration_cast<chrono::nanoseconds>(now - last).count();
+    last = now;
+    return static_cast<uint64_t>(ns);
+}
+
+} // namespace
+
 SortTracker::SortTracker(int maxBBoxAge,
                          int minBBoxHitStreak,
                          int maxTrajectoryAge,
@@ -38,24 +63,35 @@ SortTracker::SortTracker(int maxBBoxAge,
       _minTrajectoryFallingDistance(minTrajectoryFallingDistance),
       _iouThreshold(iouThreshold),
       _tagCount(0),
-      _frameCount(0) {}
+      _frameCount(0) {
+    _spareTrajectoryNodes.reserve(MAX_NUM_SPARE_TRAJECTORIES);
+}
 
 void SortTracker::update(const std::vector<cv::Rect2f>& detections,
                          const cv::Mat& frame,
                          Timestamp timestamp) {
+    TRACE_SCOPE("SortTracker::update");
+
+    auto begin = chrono::steady_clock::now();
+    _stageTimes = StageTimes();
 
     updateTracks(detections);
     updateTrajectories(frame, timestamp);
 
+    // Whatever is not predict, IoU or assignment is bookkeeping
+    _stageTimes.bookkeepingNs = lap(begin) - _stageTimes.predictNs -
+                                _stageTimes.iouNs - _stageTimes.assignmentNs;
+
     _frameCount++;
 }
 
 void SortTracker::updateTracks(const std::vector<cv::Rect2f>& detections) {
+    TRACE_SCOPE("SortTracker::updateTracks");
+
     // No tracked bbox available, make all detected bboxes as tracked
     if (_tracks.empty()) {
         for (const auto& bbox : detections) {
-            int tag = getUnusedTag();
-            _tracks.emplace(tag, TrackedBBox(bbox));
+            addTrack(bbox);
         }
         return;
     }
@@ -64,17 +100,30 @@ void SortTracker::updateTracks(const std::vector<cv::Rect2f>& detections) {
     _predictions.reserve(_tracks.size());
     _predictions.clear();
 
-    for (auto& [tag, bbox] : _tracks) {
-        _predictions.emplace_back(tag, bbox.predict({0.05F, 0.7F}));
+    auto last = chrono::steady_clock::now();
+    {
+        TRACE_SCOPE("SortTracker::predict");
+        for (auto& [tag, bbox] : _tracks) {
+            _predictions.emplace_back(tag, bbox.predict(FALLING_ACCELERATION));
+        }
     }
+    _stageTimes.predictNs = lap(last);
 
     // Initialize matches index table (prediction -> detections)
     _matches.resize(_predictions.size(), -1);
 
     // Calculate IoU matrix
-    auto iou = getIoU(_predictions, detections);
+    _iouBuffer.resize(_predictions.size() * detections.size());
+    auto iou = cv::Mat(static_cast<int>(_predictions.size()),
+                       static_cast<int>(detections.size()),
+                       CV_32F,
+                       _iouBuffer.data());
+    getIoU(_predictions, detections, iou);
+    _stageTimes.iouNs = lap(last);
+
     // Solve for optimal matches that can maximize total sum of IoUs
     _lapSolver.solve(iou, _matches, _matchesReversed, true);
+    _stageTimes.assignmentNs = lap(last);
 
     // std::cout << "\n[IoU Matrix]\n" << iou << std::endl;
     // std::cout << "\n[Assignment]" << std::endl;
@@ -102,7 +151,7 @@ void SortTracker::updateTracks(const std::vector<cv::Rect2f>& detections) {
 
         // Remove expired/bad track
         if (!canKeep(track)) {
-            _tracks.erase(it);
+            removeTrack(it);
             // If the track is removed,
             // its coresponding trajectory will end immediately
             if (auto jt = _trajectories.find(tag); jt != _trajectories.end()) {
@@ -115,14 +164,15 @@ void SortTracker::updateTracks(const std::vector<cv::Rect2f>& detections) {
     // Add unmatched detections to tracks
     for (int j = 0; j < _matchesReversed.size(); j++) {
         if (_matchesReversed[j] == -1) {
-            int tag = getUnusedTag();
-            _tracks.emplace(tag, TrackedBBox(detections[j]));
+            addTrack(detections[j]);
         }
     }
 }
 
 void SortTracker::updateTrajectories(const cv::Mat& frame,
                                      Timestamp timestamp) {
+    TRACE_SCOPE("SortTracker::updateTrajectories");
+
     if (timestamp == Timestamp::min()) {
         timestamp = chrono::system_clock::now();
     }
@@ -135,9 +185,7 @@ void SortTracker::updateTrajectories(const cv::Mat& frame,
         auto it = _trajectories.find(tag);
         // No trajectory for this track, create a new one
         if (it == _trajectories.end()) {
-            auto [itNew, isSuccessful] =
-                _trajectories.emplace(tag, Trajectory(frame));
-            it = itNew;
+            it = addTrajectory(tag, frame, track.getRect());
         }
 
         // Add the track to its coresponding trajectory
@@ -146,28 +194,74 @@ void SortTracker::updateTrajectories(const cv::Mat& frame,
     }
 
     for (auto it = _trajectories.begin(); it != _trajectories.end();) {
-        auto [tag, trajectory] = *it;
+        auto& [tag, trajectory] = *it;
         // Save and remove ended trajectory
         if (isEnded(trajectory)) {
-            if (isFallingObjectTrajectory(trajectory)) {
+            if (_trajectoryEndedCallback &&
+                isFallingObjectTrajectory(trajectory)) {
+                TRACE_SCOPE("SortTracker::trajectoryEndedCallback");
                 _trajectoryEndedCallback(tag, trajectory);
             }
-            it = _trajectories.erase(it);
+            it = removeTrajectory(it);
         } else {
+            trajectory.incrementAge();
             it = std::next(it);
         }
-
-        trajectory.incrementAge();
     }
 }
 
 void SortTracker::clear() {
-    _tracks.clear();
-    _trajectories.clear();
+    while (!_tracks.empty()) {
+        removeTrack(_tracks.begin());
+    }
+
+    for (auto it = _trajectories.begin(); it != _trajectories.end();) {
+        it = removeTrajectory(it);
+    }
 }
 
 bool SortTracker::empty() const { return _trajectories.empty(); }
 
+void SortTracker::setCropOnlyEvidence(bool isCropOnly) {
+    _isCropOnlyEvidence = isCropOnly;
+    if (isCropOnly) {
+        _spareTrajectoryNodes.clear();
+    }
+}
+
+size_t SortTracker::getMemoryUsage() const {
+    size_t size = 0;
+    for (const auto& [tag, trajectory] : _trajectories) {
+        size += sizeof(Trajectory) + trajectory.getMemoryUsage();
+    }
+    for (const auto& node : _spareTrajectoryNodes) {
+        size += sizeof(Trajectory) + node.mapped().getMemoryUsage();
+    }
+
+    size_t numTracks = _tracks.size() + _spareTrackNodes.size();
+    size += numTracks * sizeof(TrackedBBox);
+    size += _predictions.capacity() * sizeof(Prediction);
+    size += (_matches.capacity() + _matchesReversed.capacity()) * sizeof(int);
+    size += _iouBuffer.capacity() * sizeof(float);
+    return size;
+}
+
+void SortTracker::getTracks(
+    std::vector<std::pair<int, cv::Rect2f>>& tracks) const {
+    tracks.clear();
+    for (const auto& [tag, track] : _tracks) {
+        tracks.emplace_back(tag, track.getRect());
+    }
+}
+
+void SortTracker::getPredictedTracks(
+    std::vector<std::pair<int, cv::Rect2f>>& tracks) const {
+    tracks.clear();
+    for (const auto& [tag, track] : _tracks) {
+        tracks.emplace_back(tag, track.getPrediction(FALLING_ACCELERATION));
+    }
+}
+
 bool SortTracker::canKeep(const TrackedBBox& track) const {
     return track.getAge() <= _maxBBoxAge;
 }
@@ -201,11 +295,85 @@ bool SortTracker::isFallingObjectTrajectory(
 
 int SortTracker::getUnusedTag() { return _tagCount++; }
 
-cv::Mat SortTracker::getIoU(const std::vector<Prediction>& predictions,
-                            const std::vector<cv::Rect2f>& detections) {
+void SortTracker::addTrack(const cv::Rect2f& bbox) {
+    int tag = getUnusedTag();
+
+    if (_spareTrackNodes.empty()) {
+        _tracks.emplace(tag, TrackedBBox(bbox));
+        return;
+    }
+
+    auto node = std::move(_spareTrackNodes.back());
+    _spareTrackNodes.pop_back();
+
+    node.key() = tag;
+    node.mapped() = TrackedBBox(bbox);
+    _tracks.insert(std::move(node));
+}
+
+void SortTracker::removeTrack(std::map<int, TrackedBBox>::iterator it) {
+    _spareTrackNodes.push_back(_tracks.extract(it));
+}
+
+std::map<int, Trajectory>::iterator
+SortTracker::addTrajectory(int tag,
+                           const cv::Mat& frame,
+                           const cv::Rect2f& bbox) {
+    auto crop = getEvidenceCrop(bbox, frame.size());
+    if (_spareTrajectoryNodes.empty()) {
+        return _trajectories.emplace(tag, Trajectory(frame, crop)).first;
+    }
+
+    auto node = std::move(_spareTrajectoryNodes.back());
+    _spareTrajectoryNodes.pop_back();
+
+    node.key() = tag;
+    node.mapped().reset(frame, crop);
+    return _trajectories.insert(std::move(node)).position;
+}
+
+cv::Rect SortTracker::getEvidenceCrop(const cv::Rect2f& bbox,
+                                      cv::Size frameSize) const {
+    if (!_isCropOnlyEvidence) {
+        return {};
+    }
+
+    float margin = std::max(static_cast<float>(EVIDENCE_CROP_MIN_MARGIN),
+                            EVIDENCE_CROP_MARGIN_SCALE *
+                                std::max(bbox.width, bbox.height));
+
+    // The object and its surroundings down to the bottom of the frame
+    int xBegin = std::max(static_cast<int>(bbox.x - margin), 0);
+    int xEnd = std::min(static_cast<int>(bbox.x + bbox.width + margin),
+                        frameSize.width);
+    int yBegin = std::max(static_cast<int>(bbox.y - margin), 0);
+    if (xBegin >= xEnd || yBegin >= frameSize.height) {
+        return {};
+    }
+
+    return {xBegin, yBegin, xEnd - xBegin, frameSize.height - yBegin};
+}
+
+std::map<int, Trajectory>::iterator
+SortTracker::removeTrajectory(std::map<int, Trajectory>::iterator it) {
+    auto next = std::next(it);
+    auto node = _trajectories.extract(it);
+
+    // Beyond the cap, the node is freed with its copy of the first frame
+    if (_spareTrajectoryNodes.size() < MAX_NUM_SPARE_TRAJECTORIES) {
+        _spareTrajectoryNodes.push_back(std::move(node));
+    }
+    return next;
+}
+
+void SortTracker::getIoU(const std::vector<Prediction>& predictions,
+                         const std::vector<cv::Rect2f>& detections,
+                         cv::Mat& iou) {
+    TRACE_SCOPE("SortTracker::getIoU");
+
     int m = predictions.size();
     int n = detections.size();
-    auto cost = cv::Mat(m, n, CV_32F);
+    CV_Assert(iou.rows == m && iou.cols == n && iou.type() == CV_32F);
 
     for (int i = 0; i < m; i++) {
         for (int j = 0; j < n; j++) {
@@ -217,14 +385,12 @@ cv::Mat SortTracker::getIoU(const std::vector<Prediction>& predictions,
             float areaB = bboxPredicted.area();
             float areaI = bboxIntersected.area();
 
-            float iou = 0.0F;
+            float value = 0.0F;
             if (!bboxIntersected.empty()) {
-                iou = areaI / (areaA + areaB - areaI);
+                value = areaI / (areaA + areaB - areaI);
             }
 
-            cost.at<float>(i, j) = iou;
+            iou.at<float>(i, j) = value;
         }
     }
-
-    return cost;
 }
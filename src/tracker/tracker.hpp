@@ -16,6 +16,7 @@
 
 #include <chrono>
 #include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <map>
 #include <opencv2/core.hpp>
@@ -34,6 +35,16 @@ class SortTracker : public cv::Algorithm {
     using Duration = std::chrono::system_clock::duration;
     using Callback = std::function<void(int tag, const Trajectory&)>;
 
+    /**
+     * @brief Time (ns) spent in each stage of one update
+     */
+    struct StageTimes {
+        uint64_t predictNs = 0;     // Kalman prediction of tracked bboxes
+        uint64_t iouNs = 0;         // IoU matrix
+        uint64_t assignmentNs = 0;  // Linear assignment
+        uint64_t bookkeepingNs = 0; // Track and trajectory maintenance
+    };
+
 #pragma endregion
 
 #pragma region Public member methods
@@ -100,9 +111,139 @@ class SortTracker : public cv::Algorithm {
      */
     bool empty() const override;
 
+    /**
+     * @brief Get the number of currently tracked bboxes
+     *
+     * @return  Number of tracks
+     */
+    size_t getNumTracks() const { return _tracks.size(); }
+
+    /**
+     * @brief Get the number of trajectories in progress
+     *
+     * @return  Number of trajectories
+     */
+    size_t getNumTrajectories() const { return _trajectories.size(); }
+
+    /**
+     * @brief Get {Tag, BBox} of currently tracked bboxes
+     *
+     * @param tracks Output tracks (cleared first)
+     * @return
+     */
+    void getTracks(std::vector<std::pair<int, cv::Rect2f>>& tracks) const;
+
+    /**
+     * @brief Get {Tag, BBox} of currently tracked bboxes as predicted for
+     * the next update, without advancing the tracks
+     *
+     * @param tracks Output predicted tracks (cleared first)
+     * @return
+     */
+    void getPredictedTracks(
+        std::vector<std::pair<int, cv::Rect2f>>& tracks) const;
+
+    /**
+     * @brief Get the time spent in each stage of the last update
+     *
+     * @return  Stage times
+     */
+    const StageTimes& getLastStageTimes() const { return _stageTimes; }
+
+    /**
+     * @brief Select the algorithm used for bbox association
+     *
+     * @param engine LAP solver engine
+     * @return
+     */
+    void setLAPSolverEngine(LAPSolverEngine engine) {
+        _lapSolver = LAPSolver(engine);
+    }
+
+    /**
+     * @brief Set the thresholds of tracked bboxes, applied to existing tracks
+     * from the next update
+     *
+     * @param maxBBoxAge Age threshold to determine whether a tracked bbox is
+     * expired
+     * @param minBBoxHitStreak Hit streak threshold to determine whether a
+     * tracked bbox can added into its coresponding trajectory
+     * @param iouThreshold IoU threshold for bbox matching across consecutive
+     * frames
+     * @return
+     */
+    void setBBoxThresholds(int maxBBoxAge,
+                           int minBBoxHitStreak,
+                           float iouThreshold) {
+        _maxBBoxAge = maxBBoxAge;
+        _minBBoxHitStreak = minBBoxHitStreak;
+        _iouThreshold = iouThreshold;
+    }
+
+    /**
+     * @brief Set the thresholds of trajectories, applied to trajectories in
+     * progress from the next update
+     *
+     * @param maxTrajectoryAge Age threshold to determine whether a trajectory
+     * is ended
+     * @param minTrajectoryNumSamples Sample count threshold to determine
+     * whether a trajectory is valid
+     * @param minTrajectoryFallingDistance Vertical falling distance threshold
+     * to determine whether a trajectory is from a falling object
+     * @return
+     */
+    void setTrajectoryThresholds(int maxTrajectoryAge,
+                                 int minTrajectoryNumSamples,
+                                 float minTrajectoryFallingDistance) {
+        _maxTrajectoryAge = maxTrajectoryAge;
+        _minTrajectoryNumSamples = minTrajectoryNumSamples;
+        _minTrajectoryFallingDistance = minTrajectoryFallingDistance;
+    }
+
+    /**
+     * @brief Keep only a crop around the object (and the column below it,
+     * where it falls) as the annotated frame of new trajectories, instead of
+     * the whole frame. Spare trajectories are dropped with their frames.
+     *
+     * @param isCropOnly True: crop-only evidence
+     * @return
+     */
+    void setCropOnlyEvidence(bool isCropOnly);
+
+    bool isCropOnlyEvidence() const { return _isCropOnlyEvidence; }
+
+    /**
+     * @brief Get the memory held by tracks and trajectories, including the
+     * frames of trajectories in progress and spare ones
+     *
+     * @return  Size (bytes)
+     */
+    size_t getMemoryUsage() const;
+
 #pragma endregion
 
   private:
+#pragma region Private constants
+
+    /**
+     * @brief Margin of crop-only evidence around the object, relative to
+     * its size
+     */
+    static constexpr float EVIDENCE_CROP_MARGIN_SCALE = 2.0F;
+
+    /**
+     * @brief Minimum margin of crop-only evidence (pixels)
+     */
+    static constexpr int EVIDENCE_CROP_MIN_MARGIN = 48;
+
+    /**
+     * @brief Maximum number of spare trajectory nodes, each one keeps a copy
+     * of a whole frame
+     */
+    static constexpr size_t MAX_NUM_SPARE_TRAJECTORIES = 4;
+
+#pragma endregion
+
 #pragma region Private types
 
     /**
@@ -119,10 +260,23 @@ class SortTracker : public cv::Algorithm {
     std::map<int, TrackedBBox> _tracks;
     std::map<int, Trajectory> _trajectories;
 
+    /**
+     * @brief Nodes extracted from removed tracks / trajectories, reused for
+     * new ones so that map insertions don't allocate in steady state (at
+     * most MAX_NUM_SPARE_TRAJECTORIES trajectories are kept)
+     */
+    std::vector<std::map<int, TrackedBBox>::node_type> _spareTrackNodes;
+    std::vector<std::map<int, Trajectory>::node_type> _spareTrajectoryNodes;
+
     std::vector<Prediction> _predictions;
     std::vector<int> _matches;
     std::vector<int> _matchesReversed;
 
+    /**
+     * @brief Storage of the IoU matrix, only grows
+     */
+    std::vector<float> _iouBuffer;
+
     /**
      * @brief Linear assignment problem solver used for bbox association across
      * frames
@@ -139,6 +293,10 @@ class SortTracker : public cv::Algorithm {
     int _tagCount;
     int _frameCount;
 
+    bool _isCropOnlyEvidence = false;
+
+    StageTimes _stageTimes;
+
 #pragma endregion
 
 #pragma region Private member methods
@@ -210,6 +368,52 @@ class SortTracker : public cv::Algorithm {
      */
     int getUnusedTag();
 
+    /**
+     * @brief Add a new track, reusing a spare node if available
+     *
+     * @param bbox Detected bbox
+     * @return
+     */
+    void addTrack(const cv::Rect2f& bbox);
+
+    /**
+     * @brief Remove a track and keep its node for reuse
+     *
+     * @param it Iterator to the removed track
+     * @return
+     */
+    void removeTrack(std::map<int, TrackedBBox>::iterator it);
+
+    /**
+     * @brief Add a new trajectory, reusing a spare node (and its frame and
+     * sample buffers) if available
+     *
+     * @param tag Tag of the track
+     * @param frame Current frame
+     * @param bbox BBox of the track
+     * @return  Iterator to the added trajectory
+     */
+    std::map<int, Trajectory>::iterator
+    addTrajectory(int tag, const cv::Mat& frame, const cv::Rect2f& bbox);
+
+    /**
+     * @brief Get the region of the frame kept by a new trajectory
+     *
+     * @param bbox BBox of the track
+     * @param frameSize Frame size
+     * @return  Crop, empty for the whole frame
+     */
+    cv::Rect getEvidenceCrop(const cv::Rect2f& bbox, cv::Size frameSize) const;
+
+    /**
+     * @brief Remove a trajectory and keep its node for reuse
+     *
+     * @param it Iterator to the removed trajectory
+     * @return  Iterator following the removed trajectory
+     */
+    std::map<int, Trajectory>::iterator
+    removeTrajectory(std::map<int, Trajectory>::iterator it);
+
 #pragma endregion
 
 #pragma region Static helper methods
@@ -219,10 +423,12 @@ class SortTracker : public cv::Algorithm {
      *
      * @param predictions
      * @param detections
+     * @param iou Output IoU matrix (CV_32F, predictions x detections)
      * @return
      */
-    static cv::Mat getIoU(const std::vector<Prediction>& predictions,
-                          const std::vector<cv::Rect2f>& detections);
+    static void getIoU(const std::vector<Prediction>& predictions,
+                       const std::vector<cv::Rect2f>& detections,
+                       cv::Mat& iou);
 
 #pragma endregion
 };
\ No newline at end of file
@@ -17,8 +17,21 @@
 #include <opencv2/imgproc.hpp>
 #include <vector>
 
-Trajectory::Trajectory(const cv::Mat& firstFrame) {
-    firstFrame.copyTo(_firstFrame);
+Trajectory::Trajectory(const cv::Mat& firstFrame, const cv::Rect& crop) {
+    keepFirstFrame(firstFrame, crop);
+    _samples.reserve(INITIAL_NUM_SAMPLES);
+}
+
+void Trajectory::reset(const cv::Mat& firstFrame, const cv::Rect& crop) {
+    // Don't overwrite a frame that is still referenced elsewhere (e.g. an
+    // annotation image drawn on it)
+    if (_firstFrame.u != nullptr && _firstFrame.u->refcount > 1) {
+        _firstFrame.release();
+    }
+
+    keepFirstFrame(firstFrame, crop);
+    _samples.clear();
+    _age = 0;
 }
 
 void Trajectory::add(const cv::Rect2f& bbox,
@@ -45,8 +58,11 @@ void Trajectory::add(const cv::Rect2f& bbox,
 }
 
 void Trajectory::draw(cv::Mat& anno) const {
-    // Annotate on the first frame this trajectory starts with
+    // Annotate on the first frame this trajectory starts with, drawings
+    // outside a crop are clipped
     anno = cv::Mat(_firstFrame);
+    auto xOrigin = static_cast<float>(_cropOrigin.x);
+    auto yOrigin = static_cast<float>(_cropOrigin.y);
 
     // Fit parabola
     cv::Vec3f parameters;
@@ -65,14 +81,14 @@ void Trajectory::draw(cv::Mat& anno) const {
         xCenterMax = std::max(sample.xCenter, xCenterMax);
         xCenterMin = std::min(sample.xCenter, xCenterMin);
         // Draw bbox
-        int x = static_cast<int>(sample.x);
-        int y = static_cast<int>(sample.y);
+        int x = static_cast<int>(sample.x - xOrigin);
+        int y = static_cast<int>(sample.y - yOrigin);
         int w = static_cast<int>(sample.width);
         int h = static_cast<int>(sample.height);
         cv::rectangle(anno, {x, y, w, h}, {100, 50, 255});
         // Draw center point
-        int xCenter = static_cast<int>(sample.xCenter);
-        int yCenter = static_cast<int>(sample.yCenter);
+        int xCenter = static_cast<int>(sample.xCenter - xOrigin);
+        int yCenter = static_cast<int>(sample.yCenter - yOrigin);
         cv::drawMarker(anno,
                        {xCenter, yCenter},
                        {0, 0, 255},
@@ -101,14 +117,25 @@ void Trajectory::draw(cv::Mat& anno) const {
     for (int i = 0; i < numSamples; i++) {
         float x = xCenterMin + i * DRAW_POLYLINE_STEP_X;
         float y = parameters[0] * x * x + parameters[1] * x + parameters[2];
-        points[i].x = static_cast<int>(x);
-        points[i].y = static_cast<int>(y);
+        points[i].x = static_cast<int>(x - xOrigin);
+        points[i].y = static_cast<int>(y - yOrigin);
     }
 
     // Draw parabola
     cv::polylines(anno, points, false, {0, 255, 255}, 1, cv::LINE_AA);
 }
 
+void Trajectory::keepFirstFrame(const cv::Mat& firstFrame,
+                                const cv::Rect& crop) {
+    auto frameRect = cv::Rect(0, 0, firstFrame.cols, firstFrame.rows);
+    auto roi = crop.empty() ? frameRect : crop & frameRect;
+
+    // Only reallocates when the kept size changes
+    firstFrame(roi).copyTo(_firstFrame);
+    _frameSize = firstFrame.size();
+    _cropOrigin = roi.tl();
+}
+
 bool Trajectory::fitParabola(const std::vector<SamplePoint>& samples,
                              cv::Vec3f& parameters) {
     int numSamples = samples.size();
@@ -25,6 +25,21 @@ class Trajectory final {
     using Timestamp = std::chrono::system_clock::time_point;
     using Duration = std::chrono::system_clock::duration;
 
+    /**
+     * @brief Sample point class
+     */
+    struct SamplePoint {
+        float x;             // X (left) coordinate of the bbox
+        float y;             // Y (top) coordinate of the bbox
+        float width;         // Width of the bbox
+        float height;        // Height of the bbox
+        float xCenter;       // X (center) coordinate of the bbox
+        float yCenter;       // Y (center) coordinate of the bbox
+        float xVelocity;     // X-direction velocity of the bbox
+        float yVelocity;     // Y-direction velocity of the bbox
+        Timestamp timestamp; // Timestamp when the bbox is added
+    };
+
 #pragma endregion
 
 #pragma region Public member methods
@@ -33,9 +48,22 @@ class Trajectory final {
      * @brief Construct a new TrackedTrajectory object
      *
      * @param firstFrame Current frame
+     * @param crop Region of the frame kept for annotation (empty: whole
+     * frame)
      * @return
      */
-    Trajectory(const cv::Mat& firstFrame);
+    Trajectory(const cv::Mat& firstFrame, const cv::Rect& crop = cv::Rect());
+
+    /**
+     * @brief Restart this trajectory from a new frame, keeping the allocated
+     * frame and sample buffers
+     *
+     * @param firstFrame Current frame
+     * @param crop Region of the frame kept for annotation (empty: whole
+     * frame)
+     * @return
+     */
+    void reset(const cv::Mat& firstFrame, const cv::Rect& crop = cv::Rect());
 
     /**
      * @brief Add a bbox sample into this trajectory
@@ -66,7 +94,7 @@ class Trajectory final {
 
     /**
      * @brief Visualize all samples and fitted trajectory and annotate on the
-     * first frame
+     * first frame (or its kept crop, in crop coordinates)
      *
      * @param anno Output annotations image
      * @return
@@ -80,6 +108,37 @@ class Trajectory final {
      */
     size_t getNumSamples() const { return _samples.size(); }
 
+    /**
+     * @brief Get all sample points of this trajectory
+     *
+     * @return  Sample points
+     */
+    const std::vector<SamplePoint>& getSamples() const { return _samples; }
+
+    /**
+     * @brief Get the size of the frame this trajectory is annotated on
+     *
+     * @return  Frame size
+     */
+    cv::Size getFrameSize() const { return _frameSize; }
+
+    /**
+     * @brief Get the region of the first frame kept for annotation
+     *
+     * @return  Crop in frame coordinates
+     */
+    cv::Rect getCrop() const { return {_cropOrigin, _firstFrame.size()}; }
+
+    /**
+     * @brief Get the memory held by the kept frame and the samples
+     *
+     * @return  Size (bytes)
+     */
+    size_t getMemoryUsage() const {
+        return _firstFrame.total() * _firstFrame.elemSize() +
+               _samples.capacity() * sizeof(SamplePoint);
+    }
+
     /**
      * @brief Get the timestamp at the beginning of this trajectory
      * 
@@ -125,25 +184,6 @@ class Trajectory final {
 #pragma endregion
 
   private:
-#pragma region Private types
-
-    /**
-     * @brief Sample point class
-     */
-    struct SamplePoint {
-        float x;             // X (left) coordinate of the bbox
-        float y;             // Y (top) coordinate of the bbox
-        float width;         // Width of the bbox
-        float height;        // Height of the bbox
-        float xCenter;       // X (center) coordinate of the bbox
-        float yCenter;       // Y (center) coordinate of the bbox
-        float xVelocity;     // X-direction velocity of the bbox
-        float yVelocity;     // Y-direction velocity of the bbox
-        Timestamp timestamp; // Timestamp when the bbox is added
-    };
-
-#pragma endregion
-
 #pragma region Private constants
 
     /**
@@ -156,15 +196,30 @@ class Trajectory final {
      */
     static constexpr float DRAW_POLYLINE_STEP_X = 0.5F;
 
+    /**
+     * @brief Initial capacity of sample points, a typical fall fits in it
+     */
+    static constexpr size_t INITIAL_NUM_SAMPLES = 64;
+
 #pragma endregion
 
 #pragma region Private member variables
 
     /**
-     * @brief Frame captured when this trajectory started
+     * @brief Frame (or crop of it) captured when this trajectory started
      */
     cv::Mat _firstFrame;
 
+    /**
+     * @brief Size of the whole frame
+     */
+    cv::Size _frameSize;
+
+    /**
+     * @brief Top left corner of the kept crop in the frame
+     */
+    cv::Point _cropOrigin;
+
     /**
      * @brief Sample points added along the trajectory
      */
@@ -173,7 +228,20 @@ class Trajectory final {
     /**
      * @brief Age count used to determine whether this trajectory is ended
      */
-    int _age;
+    int _age = 0;
+
+#pragma endregion
+
+#pragma region Private member methods
+
+    /**
+     * @brief Copy the kept region of the first frame
+     *
+     * @param firstFrame Current frame
+     * @param crop Region of the frame kept (empty: whole frame)
+     * @return
+     */
+    void keepFirstFrame(const cv::Mat& firstFrame, const cv::Rect& crop);
 
 #pragma endregion
 
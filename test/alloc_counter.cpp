@@ -0,0 +1,161 @@
+/**
+ * @file alloc_counter.cpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Heap allocation counter for tests and benchmarks
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "alloc_counter.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+// Plain PODs so they are usable before any constructor runs
+thread_local uint64_t numAllocs = 0;
+thread_local uint64_t numBytes = 0;
+
+inline void record(size_t size) {
+    numAllocs++;
+    numBytes += size;
+}
+
+} // namespace
+
+uint64_t AllocCounter::count() { return numAllocs; }
+
+uint64_t AllocCounter::bytes() { return numBytes; }
+
+#if defined(__GLIBC__)
+
+extern "C" {
+
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t num, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* ptr);
+
+void* malloc(size_t size) {
+    record(size);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t num, size_t size) {
+    record(num * size);
+    return __libc_calloc(num, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+    record(size);
+    return __libc_realloc(ptr, size);
+}
+
+void* memalign(size_t alignment, size_t size) {
+    record(size);
+    return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) {
+    record(size);
+    return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** ptr, size_t alignment, size_t size) {
+    record(size);
+    void* p = __libc_memalign(alignment, size);
+    if (p == nullptr) {
+        return ENOMEM;
+    }
+    *ptr = p;
+    return 0;
+}
+
+void free(void* ptr) { __libc_free(ptr); }
+
+} // extern "C"
+
+bool AllocCounter::isMallocIntercepted() { return true; }
+
+// operator new below goes through the interposed malloc, so count it there
+#define ALLOC_COUNTER_RECORD_NEW(size)
+
+#else
+
+bool AllocCounter::isMallocIntercepted() { return false; }
+
+#define ALLOC_COUNTER_RECORD_NEW(size) record(size)
+
+#endif
+
+void* operator new(size_t size) {
+    ALLOC_COUNTER_RECORD_NEW(size);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) { return operator new(size); }
+
+void* operator new(size_t size, const std::nothrow_t& /*unused*/) noexcept {
+    ALLOC_COUNTER_RECORD_NEW(size);
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t& tag) noexcept {
+    return operator new(size, tag);
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+    ALLOC_COUNTER_RECORD_NEW(size);
+    void* p = nullptr;
+    if (posix_memalign(&p,
+                       std::max(sizeof(void*), static_cast<size_t>(alignment)),
+                       size == 0 ? 1 : size) == 0) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+    return operator new(size, alignment);
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, size_t /*unused*/) noexcept { std::free(ptr); }
+
+void operator delete[](void* ptr, size_t /*unused*/) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t /*unused*/) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t /*unused*/) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void* ptr,
+                     size_t /*unused*/,
+                     std::align_val_t /*unused*/) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr,
+                       size_t /*unused*/,
+                       std::align_val_t /*unused*/) noexcept {
+    std::free(ptr);
+}
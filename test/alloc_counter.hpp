@@ -0,0 +1,76 @@
+/**
+ * @file alloc_counter.hpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Heap allocation counter for tests and benchmarks. Linking
+ * alloc_counter.cpp into an executable interposes operator new and the malloc
+ * family (glibc), so allocations made by OpenCV and FFmpeg are counted too.
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+
+#include <cstdint>
+
+/**
+ * @brief Per-thread heap allocation counter
+ */
+class AllocCounter final {
+  public:
+#pragma region Static methods
+
+    /**
+     * @brief Get the number of allocations made by the calling thread
+     *
+     * @return  Allocation count
+     */
+    static uint64_t count();
+
+    /**
+     * @brief Get the number of bytes requested by the calling thread
+     *
+     * @return  Allocated bytes
+     */
+    static uint64_t bytes();
+
+    /**
+     * @brief Tells whether allocations are actually intercepted on this
+     * platform (operator new always is, malloc only with glibc)
+     *
+     * @return  True: malloc is intercepted
+     *          False: only operator new is intercepted
+     */
+    static bool isMallocIntercepted();
+
+#pragma endregion
+};
+
+/**
+ * @brief Count allocations made by the calling thread in a scope
+ */
+class AllocScope final {
+  public:
+    AllocScope()
+        : _count(AllocCounter::count()),
+          _bytes(AllocCounter::bytes()) {}
+
+    /**
+     * @brief Get the number of allocations since construction
+     *
+     * @return  Allocation count
+     */
+    uint64_t count() const { return AllocCounter::count() - _count; }
+
+    /**
+     * @brief Get the number of bytes allocated since construction
+     *
+     * @return  Allocated bytes
+     */
+    uint64_t bytes() const { return AllocCounter::bytes() - _bytes; }
+
+  private:
+    uint64_t _count;
+    uint64_t _bytes;
+};
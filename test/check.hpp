@@ -0,0 +1,29 @@
+/**
+ * @file check.hpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Assertion of the standalone test executables
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+
+/**
+ * @brief Exit the test with a failure status if an expression is false,
+ * printing the expression and its location
+ */
+#define CHECK(expr)                                                            \
+    do {                                                                       \
+        if (!(expr)) {                                                         \
+            std::printf("[TEST] FAILED: %s (%s:%d)\n",                         \
+                        #expr,                                                 \
+                        __FILE__,                                              \
+                        __LINE__);                                             \
+            std::exit(EXIT_FAILURE);                                           \
+        }                                                                      \
+    } while (0)
@@ -0,0 +1,154 @@
+/**
+ * @file event_index_test.cpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Region and time range queries and crash recovery of the event index
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "check.hpp"
+#include "event_index.hpp"
+#include "event_index_reader.hpp"
+#include "event_index_writer.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+
+constexpr int64_t NS_PER_SEC = 1'000'000'000LL;
+
+/**
+ * @brief Make an entry falling straight down a column of a 320x240 frame
+ *
+ * @param tag Tracker tag
+ * @param startSec Unix time of the first sample (seconds)
+ * @param x Left of the bboxes (pixels)
+ * @return  Entry
+ */
+static EventIndexEntry makeEntry(int tag, int64_t startSec, float x) {
+    auto entry = EventIndex::makeEntry(tag, 320, 240);
+    for (int i = 0; i < 16; i++) {
+        EventIndex::addSample(entry,
+                              startSec * NS_PER_SEC + i * 40'000'000LL,
+                              x,
+                              10.0F + 12.0F * i,
+                              12.0F,
+                              12.0F);
+    }
+    return entry;
+}
+
+/**
+ * @brief Collect the tags of matching entries as decimal digits
+ *
+ * @param reader Index reader
+ * @param fromSec Range begin (seconds)
+ * @param toSec Range end (seconds)
+ * @param region Queried region
+ * @return  Tags in visiting order
+ */
+static int queryTags(const EventIndexReader& reader,
+                     int64_t fromSec,
+                     int64_t toSec,
+                     const EventIndexRegion& region) {
+    int tags = 0;
+    reader.query(
+        [&tags](const EventIndexEntry& entry) { tags = tags * 10 + entry.tag; },
+        fromSec * NS_PER_SEC,
+        toSec * NS_PER_SEC,
+        region);
+    return tags;
+}
+
+static void testFormat() {
+    CHECK(EventIndex::getFileName(0) == "1970-01-01.fodidx");
+    CHECK(EventIndex::getFileName(-1) == "1969-12-31.fodidx");
+    CHECK(EventIndex::getFileName(20744) == "2026-10-18.fodidx");
+
+    int32_t day = 0;
+    CHECK(EventIndex::parseFileName("2026-10-18.fodidx", day));
+    CHECK(day == 20744);
+    CHECK(EventIndex::parseFileName("2024-02-29.fodidx", day));
+    CHECK(EventIndex::getFileName(day) == "2024-02-29.fodidx");
+    CHECK(!EventIndex::parseFileName("2026-10-18.evlog", day));
+    CHECK(!EventIndex::parseFileName("2026-13-01.fodidx", day));
+
+    CHECK(EventIndex::getDay(0) == 0);
+    CHECK(EventIndex::getDay(-1) == -1);
+    CHECK(EventIndex::getDay(EventIndex::NS_PER_DAY) == 1);
+
+    CHECK(EventIndex::getCellMask(0.0F, 0.0F, 1.0F, 1.0F) == ~uint64_t(0));
+    CHECK(EventIndex::getCellMask(0.0F, 0.0F, 0.1F, 0.1F) == 1);
+    CHECK(EventIndex::getCellMask(0.9F, 0.9F, 1.0F, 1.0F) ==
+          uint64_t(1) << 63);
+    CHECK(EventIndex::getCellMask(1.5F, 0.0F, 2.0F, 1.0F) == 0);
+
+    // Column of cells 1 x [0, 6], bboxes end at y = 202
+    auto entry = makeEntry(1, 0, 40.0F);
+    CHECK(entry.numSamples == 16);
+    CHECK(entry.endTimeNs - entry.startTimeNs == 15 * 40'000'000LL);
+    CHECK(entry.cellMask == 0x0002020202020202ULL);
+}
+
+static void testQuery() {
+    auto dir = std::string("event_index_test.index");
+    auto dayPath = dir + "/" + EventIndex::getFileName(1);
+    ::unlink((dir + "/" + EventIndex::getFileName(0)).c_str());
+    ::unlink(dayPath.c_str());
+    ::rmdir(dir.c_str());
+
+    constexpr int64_t DAY_SEC = 86400;
+    {
+        auto writer = EventIndexWriter(dir);
+        CHECK(writer.isOpened());
+        CHECK(writer.add(makeEntry(1, 1000, 40.0F)));  // Day 0, left
+        CHECK(writer.add(makeEntry(2, 2000, 280.0F))); // Day 0, right
+        CHECK(writer.add(makeEntry(3, DAY_SEC + 10, 40.0F)));
+        CHECK(!writer.add(EventIndex::makeEntry(4, 320, 240)));
+        CHECK(writer.getNumAdded() == 3);
+    }
+
+    auto reader = EventIndexReader(dir);
+    auto left = EventIndexRegion{0.0F, 0.0F, 0.25F, 1.0F};
+    auto right = EventIndexRegion{0.75F, 0.5F, 1.0F, 1.0F};
+    auto all = EventIndexRegion();
+
+    CHECK(queryTags(reader, 0, 3 * DAY_SEC, all) == 123);
+    CHECK(queryTags(reader, 0, 3 * DAY_SEC, left) == 13);
+    CHECK(queryTags(reader, 0, 3 * DAY_SEC, right) == 2);
+    CHECK(queryTags(reader, 1500, 2500, all) == 2);
+    CHECK(queryTags(reader, DAY_SEC, 2 * DAY_SEC, left) == 3);
+    CHECK(reader.getNumFiles() == 2);
+    CHECK(queryTags(reader, 3 * DAY_SEC, 4 * DAY_SEC, all) == 0);
+    CHECK(reader.getNumFiles() == 0);
+
+    // Cut the last entry short, it must be dropped and appending must go on
+    // after the complete ones
+    CHECK(::truncate(dayPath.c_str(),
+                     static_cast<off_t>(sizeof(EventIndexHeader) +
+                                        sizeof(EventIndexEntry) - 5)) == 0);
+    CHECK(queryTags(reader, DAY_SEC, 2 * DAY_SEC, all) == 0);
+
+    {
+        auto writer = EventIndexWriter(dir);
+        CHECK(writer.add(makeEntry(5, DAY_SEC + 20, 40.0F)));
+    }
+    CHECK(queryTags(reader, DAY_SEC, 2 * DAY_SEC, all) == 5);
+    CHECK(reader.getNumScanned() == 3); // Day 0 and day 1
+
+    ::unlink((dir + "/" + EventIndex::getFileName(0)).c_str());
+    ::unlink(dayPath.c_str());
+    ::rmdir(dir.c_str());
+}
+
+int main() {
+    testFormat();
+    testQuery();
+
+    std::printf("[EVENT INDEX TEST] PASSED\n");
+    return EXIT_SUCCESS;
+}
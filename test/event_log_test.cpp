@@ -0,0 +1,112 @@
+/**
+ * @file event_log_test.cpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Round trip and crash recovery of the binary event log
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "check.hpp"
+#include "event_log_reader.hpp"
+#include "event_log_writer.hpp"
+#include "trajectory.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <opencv2/core.hpp>
+#include <string>
+#include <unistd.h>
+
+/**
+ * @brief Make a trajectory falling along a parabola
+ *
+ * @param numSamples Number of samples
+ * @param startSec Unix time of the first sample (seconds)
+ * @return  Trajectory
+ */
+static Trajectory makeTrajectory(int numSamples, int startSec) {
+    auto trajectory = Trajectory(cv::Mat(240, 320, CV_8UC3));
+    auto start = Trajectory::Timestamp(std::chrono::seconds(startSec));
+
+    for (int i = 0; i < numSamples; i++) {
+        float x = 100.0F + 2.0F * i;
+        float y = 10.0F + 0.5F * i * i;
+        trajectory.add({x, y, 12.0F, 12.0F},
+                       {2.0F, static_cast<float>(i)},
+                       start + std::chrono::milliseconds(40 * i));
+    }
+
+    return trajectory;
+}
+
+int main() {
+    auto path = std::string("event_log_test.evlog");
+    ::unlink(path.c_str());
+
+    {
+        auto writer = EventLogWriter(path);
+        CHECK(writer.isOpened());
+        writer.writeMetadata("source", "test");
+        writer.writeTrajectory(1, makeTrajectory(12, 1000));
+        writer.writeTrajectory(2, makeTrajectory(20, 2000));
+    }
+
+    {
+        auto reader = EventLogReader(path);
+        CHECK(reader.isOpened());
+
+        int numMetadata = 0;
+        reader.forEachMetadata(
+            [&](std::string_view key, std::string_view value) {
+                CHECK(key == "source" && value == "test");
+                numMetadata++;
+            });
+        CHECK(numMetadata == 1);
+
+        // Only the second trajectory overlaps [1500 s, +inf)
+        size_t numVisited = reader.forEachTrajectory(
+            [](const EventLogReader::TrajectoryView& view) {
+                CHECK(view.record->tag == 2);
+                CHECK(view.record->numSamples == 20);
+                CHECK(view.record->frameWidth == 320);
+                CHECK(view.getSample(19).y == 10.0F + 0.5F * 19 * 19);
+                CHECK(view.getSample(19).timeNs - view.getSample(0).timeNs ==
+                      40'000'000LL * 19);
+            },
+            1500'000'000'000LL);
+        CHECK(numVisited == 1);
+    }
+
+    // Cut the log inside the samples of the last trajectory, it must be
+    // dropped and appending must go on after the first one
+    {
+        auto reader = EventLogReader(path);
+        CHECK(::truncate(path.c_str(),
+                         static_cast<off_t>(reader.getValidSize() - 20)) == 0);
+    }
+
+    {
+        auto writer = EventLogWriter(path);
+        CHECK(writer.isOpened());
+        writer.writeTrajectory(3, makeTrajectory(5, 3000));
+    }
+
+    {
+        auto reader = EventLogReader(path);
+        int tags = 0;
+        size_t numVisited = reader.forEachTrajectory(
+            [&tags](const EventLogReader::TrajectoryView& view) {
+                tags = tags * 10 + view.record->tag;
+            });
+        CHECK(numVisited == 2);
+        CHECK(tags == 13);
+    }
+
+    ::unlink(path.c_str());
+    std::printf("[EVENT LOG TEST] PASSED\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,127 @@
+/**
+ * @file frame_bus_test.cpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Ordering, slow readers and torn reads of the shared memory frame bus
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "check.hpp"
+#include "frame_bus.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <opencv2/core.hpp>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+constexpr int FRAME_WIDTH = 160;
+constexpr int FRAME_HEIGHT = 120;
+constexpr int NUM_SLOTS = 4;
+
+/**
+ * @brief Tells whether every byte of a frame equals a value
+ *
+ * @param frame Frame
+ * @param value Value
+ * @return  True: Uniform
+ */
+static bool isUniform(const cv::Mat& frame, uint8_t value) {
+    for (int y = 0; y < frame.rows; y++) {
+        const auto* row = frame.ptr<uint8_t>(y);
+        for (size_t x = 0; x < frame.cols * frame.elemSize(); x++) {
+            if (row[x] != value) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+int main() {
+    auto name = "/fod_frame_bus_test_" + std::to_string(::getpid());
+    auto frame = cv::Mat(FRAME_HEIGHT, FRAME_WIDTH, CV_8UC3);
+    auto received = cv::Mat();
+
+    auto publisher = std::make_unique<FrameBusPublisher>(
+        name, frame.total() * frame.elemSize(), NUM_SLOTS);
+    CHECK(publisher->isOpened());
+
+    auto subscriber = FrameBusSubscriber(name);
+    CHECK(subscriber.isOpened());
+    CHECK(publisher->getNumReaders() == 1);
+
+    // Frames arrive in order and intact
+    for (int i = 0; i < 3; i++) {
+        frame.setTo(i + 1);
+        CHECK(publisher->publish(frame, i));
+    }
+    for (int i = 0; i < 3; i++) {
+        CHECK(subscriber.read(received, 0));
+        CHECK(subscriber.getSequence() == static_cast<uint64_t>(i));
+        CHECK(received.rows == FRAME_HEIGHT && received.cols == FRAME_WIDTH);
+        CHECK(isUniform(received, i + 1));
+    }
+    CHECK(!subscriber.read(received, 0));
+
+    // A reader more than a ring behind skips to the newest frame
+    for (int i = 3; i < 13; i++) {
+        frame.setTo(i + 1);
+        CHECK(publisher->publish(frame, i));
+    }
+    CHECK(subscriber.read(received, 0));
+    CHECK(subscriber.getSequence() == 12);
+    CHECK(isUniform(received, 13));
+    CHECK(subscriber.getNumSkipped() == 9);
+
+    // An in-place view is invalidated once its slot is rewritten
+    frame.setTo(14);
+    CHECK(publisher->publish(frame, 13));
+    auto view = cv::Mat();
+    CHECK(subscriber.view(view, 0));
+    CHECK(isUniform(view, 14));
+    for (int i = 0; i < NUM_SLOTS - 1; i++) {
+        CHECK(publisher->publish(frame, 14 + i));
+        CHECK(subscriber.isViewValid());
+    }
+    CHECK(publisher->publish(frame, 14 + NUM_SLOTS));
+    CHECK(!subscriber.isViewValid());
+
+    // Concurrent producer: every frame read is consistent
+    std::atomic<bool> isDone{false};
+    auto producer = std::thread([&]() {
+        auto f = cv::Mat(FRAME_HEIGHT, FRAME_WIDTH, CV_8UC3);
+        for (int i = 0; i < 5000; i++) {
+            f.setTo(i % 251);
+            publisher->publish(f, i);
+        }
+        isDone = true;
+    });
+
+    int numRead = 0;
+    while (!isDone) {
+        if (subscriber.read(received, 10)) {
+            CHECK(isUniform(received, received.ptr<uint8_t>(0)[0]));
+            numRead++;
+        }
+    }
+    producer.join();
+    std::printf("[FRAME BUS TEST] %d frames read concurrently, %llu skipped\n",
+                numRead,
+                static_cast<unsigned long long>(subscriber.getNumSkipped()));
+
+    // Readers see the producer go away
+    publisher.reset();
+    CHECK(subscriber.isClosed());
+    CHECK(!subscriber.read(received, 0));
+
+    std::printf("[FRAME BUS TEST] PASSED\n");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,115 @@
+/**
+ * @file lap_solver_diff_test.cpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Differential check of the LAP solver engines against each other and
+ * against enumeration
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "check.hpp"
+#include "lap_instances.hpp"
+#include "lap_solver.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+/**
+ * @brief Tells whether two total costs are equal up to float rounding
+ *
+ * @param a Total cost A
+ * @param b Total cost B
+ * @return  True: equal
+ */
+static bool isEqual(double a, double b) {
+    return std::abs(a - b) <= 1e-6 * std::max(1.0, std::abs(b));
+}
+
+/**
+ * @brief Check both directions of an assignment are consistent
+ *
+ * @param assignment Rows -> columns
+ * @param assignmentReversed Columns -> rows
+ * @return  True: consistent and min(rows, cols) pairs assigned
+ */
+static bool isConsistent(const std::vector<int>& assignment,
+                         const std::vector<int>& assignmentReversed) {
+    int numAssigned = 0;
+    for (size_t i = 0; i < assignment.size(); i++) {
+        if (assignment[i] < 0) {
+            continue;
+        }
+        if (assignmentReversed[assignment[i]] != static_cast<int>(i)) {
+            return false;
+        }
+        numAssigned++;
+    }
+
+    return numAssigned == static_cast<int>(std::min(
+                              assignment.size(), assignmentReversed.size()));
+}
+
+int main() {
+    auto hungarian = LAPSolver(LAPSolverEngine::HUNGARIAN);
+    auto shortestPath = LAPSolver(LAPSolverEngine::SHORTEST_PATH);
+    auto assignment = std::vector<int>();
+    auto assignmentReversed = std::vector<int>();
+    int numInstances = 0;
+
+    auto solve = [&](LAPSolver& solver, const LAPInstance& instance) {
+        solver.solve(
+            instance.cost, assignment, assignmentReversed, instance.maximize);
+        CHECK(isConsistent(assignment, assignmentReversed));
+        return LAPInstances::getTotalCost(instance.cost, assignment);
+    };
+
+    // Small random shapes, checked against enumeration. Solvers are reused
+    // across sizes like in the tracker.
+    uint32_t seed = 1;
+    for (int t = 0; t < 2000; t++) {
+        seed = seed * 1664525U + 1013904223U;
+        int rows = 1 + static_cast<int>((seed >> 8U) % 7U);
+        int cols = 1 + static_cast<int>((seed >> 16U) % 7U);
+
+        // Coarse costs give ties between optimal assignments
+        auto instance = LAPInstance();
+        instance.cost.create(rows, cols, CV_32F);
+        for (int i = 0; i < rows; i++) {
+            auto* row = instance.cost.ptr<float>(i);
+            for (int j = 0; j < cols; j++) {
+                seed = seed * 1664525U + 1013904223U;
+                row[j] = t % 3 == 0 ? static_cast<float>(seed >> 29U)
+                                    : static_cast<float>(seed >> 8U) / 65536.0F;
+            }
+        }
+        instance.maximize = t % 2 == 1;
+
+        double expected = LAPInstances::solveBruteForce(instance);
+        CHECK(isEqual(solve(hungarian, instance), expected));
+        CHECK(isEqual(solve(shortestPath, instance), expected));
+        numInstances++;
+    }
+
+    // Every generated kind, engines checked against each other
+    for (int kind = 0; kind < static_cast<int>(LAPInstanceKind::NUM_KINDS);
+         kind++) {
+        for (int size = 4; size <= 64; size *= 2) {
+            for (uint32_t k = 0; k < 4; k++) {
+                auto instance = LAPInstances::make(
+                    static_cast<LAPInstanceKind>(kind), size, 100U + k);
+                CHECK(isEqual(solve(hungarian, instance),
+                              solve(shortestPath, instance)));
+                numInstances++;
+            }
+        }
+    }
+
+    std::printf("[LAP DIFF TEST] PASSED (%d instances)\n", numInstances);
+    return EXIT_SUCCESS;
+}
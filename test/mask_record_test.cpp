@@ -0,0 +1,207 @@
+/**
+ * @file mask_record_test.cpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Run-length coding, round trip and crash recovery of mask records
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "check.hpp"
+#include "mask_record_reader.hpp"
+#include "mask_recorder.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <opencv2/core.hpp>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+constexpr int MASK_HEIGHT = 37;
+constexpr int MASK_WIDTH = 53;
+
+/**
+ * @brief Render a mask of random rectangles, with pixel values other than
+ * 255 here and there
+ *
+ * @param mask Mask (CV_8UC1)
+ * @param numRects Number of rectangles
+ * @param seed Random seed
+ * @return
+ */
+static void renderMask(cv::Mat& mask, int numRects, uint32_t seed) {
+    mask.setTo(0);
+    for (int i = 0; i < numRects; i++) {
+        seed = seed * 1664525U + 1013904223U;
+        int x = static_cast<int>((seed >> 8U) % mask.cols);
+        int y = static_cast<int>((seed >> 16U) % mask.rows);
+        int w = 1 + static_cast<int>((seed >> 4U) % 24);
+        int h = 1 + static_cast<int>((seed >> 12U) % 6);
+        auto value = static_cast<uint8_t>(i % 3 == 0 ? 1 : 255);
+        mask(cv::Rect(x, y, w, h) & cv::Rect(0, 0, mask.cols, mask.rows))
+            .setTo(value);
+    }
+}
+
+/**
+ * @brief Tells whether a decoded mask is the binarized original
+ *
+ * @param decoded Decoded mask
+ * @param mask Original mask
+ * @return  True: same foreground
+ */
+static bool isSameForeground(const cv::Mat& decoded, const cv::Mat& mask) {
+    for (int i = 0; i < mask.rows * mask.cols; i++) {
+        if (decoded.data[i] != (mask.data[i] != 0 ? 255 : 0)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Empty, full, single pixel and random masks decode to themselves
+ * within the size bound
+ *
+ * @return
+ */
+static void testCoding() {
+    auto mask = cv::Mat(MASK_HEIGHT, MASK_WIDTH, CV_8UC1);
+    auto decoded = cv::Mat(MASK_HEIGHT, MASK_WIDTH, CV_8UC1);
+    size_t numPixels = MASK_HEIGHT * MASK_WIDTH;
+    auto codes = std::vector<uint8_t>(MaskRecord::getMaxEncodedSize(numPixels));
+
+    auto roundTrip = [&]() {
+        size_t size = MaskRecord::encode(mask.data, numPixels, codes.data());
+        CHECK(size <= codes.size());
+        CHECK(MaskRecord::decode(codes.data(), size, decoded.data, numPixels));
+        CHECK(isSameForeground(decoded, mask));
+        CHECK(MaskRecord::countForeground(codes.data(), size) ==
+              static_cast<size_t>(cv::countNonZero(mask)));
+        return size;
+    };
+
+    mask.setTo(0);
+    CHECK(roundTrip() == 2);
+
+    mask.setTo(255);
+    CHECK(roundTrip() == 3);
+
+    mask.setTo(0);
+    mask.data[numPixels - 1] = 255;
+    roundTrip();
+
+    // Alternating pixels, the worst case
+    for (size_t i = 0; i < numPixels; i++) {
+        mask.data[i] = i % 2 == 0 ? 255 : 0;
+    }
+    CHECK(roundTrip() == numPixels + 1);
+
+    for (uint32_t seed = 0; seed < 50; seed++) {
+        renderMask(mask, static_cast<int>(seed % 12), seed);
+        roundTrip();
+    }
+
+    // Codes describing more or fewer pixels than the mask are rejected
+    mask.setTo(0);
+    size_t size = MaskRecord::encode(mask.data, numPixels, codes.data());
+    CHECK(!MaskRecord::decode(codes.data(), size, decoded.data, numPixels - 1));
+    CHECK(!MaskRecord::decode(codes.data(), size, decoded.data, numPixels + 1));
+}
+
+/**
+ * @brief Recorded frames read back in order with their masks, a record cut
+ * short is dropped and the file appended to after it
+ *
+ * @return
+ */
+static void testRoundTrip() {
+    auto path = std::string("mask_record_test.fodmask");
+    ::unlink(path.c_str());
+
+    auto fgMasks = std::vector<cv::Mat>(6);
+    auto updateMasks = std::vector<cv::Mat>(6);
+    for (int i = 0; i < 6; i++) {
+        fgMasks[i].create(MASK_HEIGHT, MASK_WIDTH, CV_8UC1);
+        updateMasks[i].create(MASK_HEIGHT, MASK_WIDTH, CV_8UC1);
+        renderMask(fgMasks[i], i * 2, 100U + i);
+        renderMask(updateMasks[i], i, 200U + i);
+    }
+
+    {
+        auto recorder = MaskRecorder(path);
+        CHECK(recorder.isOpened());
+        for (int i = 0; i < 4; i++) {
+            CHECK(recorder.record(
+                fgMasks[i], updateMasks[i], i == 2 ? MASK_RECORD_INVALID : 0));
+        }
+        CHECK(recorder.getNumRecorded() == 4);
+    }
+
+    auto fgMask = cv::Mat();
+    auto updateMask = cv::Mat();
+    size_t validSize = 0;
+    {
+        auto reader = MaskRecordReader(path);
+        CHECK(reader.isOpened());
+        validSize = reader.getValidSize();
+
+        uint32_t index = 1;
+        size_t numVisited = reader.forEachFrame(
+            [&](const MaskRecordReader::FrameView& frame) {
+                CHECK(frame.header->index == index);
+                CHECK(frame.header->width == MASK_WIDTH);
+                CHECK(frame.header->height == MASK_HEIGHT);
+                CHECK(((frame.header->flags & MASK_RECORD_INVALID) != 0) ==
+                      (index == 2));
+                CHECK(MaskRecordReader::decode(frame, fgMask, updateMask));
+                CHECK(isSameForeground(fgMask, fgMasks[index]));
+                CHECK(isSameForeground(updateMask, updateMasks[index]));
+                index++;
+            },
+            1,
+            2);
+        CHECK(numVisited == 2);
+    }
+
+    // Cut the last record short, as a crash would
+    CHECK(::truncate(path.c_str(), static_cast<off_t>(validSize - 5)) == 0);
+
+    {
+        auto recorder = MaskRecorder(path);
+        CHECK(recorder.isOpened());
+        CHECK(recorder.record(fgMasks[4], updateMasks[4]));
+        CHECK(recorder.record(fgMasks[5], updateMasks[5]));
+    }
+
+    {
+        auto reader = MaskRecordReader(path);
+        CHECK(reader.isOpened());
+
+        // Records 0 - 2 survive, a new recorder counts from 0 again
+        auto expected = std::vector<int>{0, 1, 2, 4, 5};
+        size_t k = 0;
+        reader.forEachFrame([&](const MaskRecordReader::FrameView& frame) {
+            CHECK(k < expected.size());
+            CHECK(MaskRecordReader::decode(frame, fgMask, updateMask));
+            CHECK(isSameForeground(fgMask, fgMasks[expected[k]]));
+            CHECK(isSameForeground(updateMask, updateMasks[expected[k]]));
+            k++;
+        });
+        CHECK(k == expected.size());
+    }
+
+    ::unlink(path.c_str());
+}
+
+int main() {
+    testCoding();
+    testRoundTrip();
+
+    std::printf("[MASK RECORD TEST] PASSED\n");
+    return EXIT_SUCCESS;
+}
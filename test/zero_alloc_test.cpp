@@ -0,0 +1,234 @@
+/**
+ * @file zero_alloc_test.cpp
+ * @author Xiaoran Weng (goose_bomb@outlook.com)
+ * @brief Steady-state heap allocation gate of the per-frame pipeline
+ * @version 0.1
+ * @date 2026-10-18
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+
+#include "alloc_counter.hpp"
+#include "active_tiles.hpp"
+#include "blob_detector.hpp"
+#include "tracker.hpp"
+#include "trajectory.hpp"
+#include "vibe_sequential.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <opencv2/core.hpp>
+#include <vector>
+
+constexpr int FRAME_WIDTH = 320;
+constexpr int FRAME_HEIGHT = 240;
+
+// A falling object is visible for the first part of each cycle
+constexpr int CYCLE_LENGTH = 60;
+constexpr int FALLING_LENGTH = 40;
+constexpr int OBJECT_SIZE = 12;
+
+enum Stage {
+    SEGMENT,
+    MORPHOLOGY,
+    UPDATE,
+    LABELLING,
+    TRACKING,
+    NUM_STAGES,
+};
+
+constexpr std::array<const char*, NUM_STAGES> STAGE_NAMES{
+    "segment",
+    "morphology",
+    "update",
+    "labelling",
+    "tracking",
+};
+
+/**
+ * @brief Render a synthetic frame: static gradient background with a little
+ * sensor noise and a dark square falling along a parabola
+ *
+ * @param frame Output frame (CV_8UC3)
+ * @param t Frame index
+ * @param seed Noise generator state
+ * @return
+ */
+void renderFrame(cv::Mat& frame, int t, uint32_t& seed) {
+    for (int y = 0; y < frame.rows; y++) {
+        auto* row = frame.ptr<uint8_t>(y);
+        for (int x = 0; x < frame.cols; x++) {
+            seed = seed * 1664525U + 1013904223U;
+            int noise = static_cast<int>(seed >> 29U) - 4;
+            uint8_t value = cv::saturate_cast<uint8_t>(96 + x / 4 + noise);
+            row[3 * x + 0] = value;
+            row[3 * x + 1] = value;
+            row[3 * x + 2] = value;
+        }
+    }
+
+    int k = t % CYCLE_LENGTH;
+    if (k >= FALLING_LENGTH) {
+        return;
+    }
+
+    int x0 = 80 + 2 * k;
+    int y0 = 8 + static_cast<int>(0.12F * k * k);
+    for (int y = y0; y < std::min(y0 + OBJECT_SIZE, frame.rows); y++) {
+        auto* row = frame.ptr<uint8_t>(y);
+        for (int x = x0; x < std::min(x0 + OBJECT_SIZE, frame.cols); x++) {
+            row[3 * x + 0] = 16;
+            row[3 * x + 1] = 16;
+            row[3 * x + 2] = 16;
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int numWarmupFrames = argc > 1 ? std::atoi(argv[1]) : 8 * CYCLE_LENGTH;
+    int numFrames = argc > 2 ? std::atoi(argv[2]) : 4 * CYCLE_LENGTH;
+
+    if (!AllocCounter::isMallocIntercepted()) {
+        std::printf("[ZERO ALLOC] malloc is not intercepted on this platform, "
+                    "only operator new is counted\n");
+    }
+
+    auto vibe = std::make_unique<ViBeSequential>(
+        FRAME_HEIGHT, FRAME_WIDTH, 14, 20, 2, 5);
+    auto blobDetector = std::make_unique<BlobDetector>(
+        FRAME_HEIGHT,
+        FRAME_WIDTH,
+        BlobDetectorParams{.engine = BlobDetectorEngine::NATIVE});
+    auto activeTiles = ActiveTiles(FRAME_HEIGHT, FRAME_WIDTH);
+    auto tracker = std::make_unique<SortTracker>(3, 3);
+
+    int numTrajectories = 0;
+    tracker->setTrajectoryEndedCallback(
+        [&numTrajectories](int /*tag*/, const Trajectory& /*trajectory*/) {
+            numTrajectories++;
+        });
+
+    auto frame = cv::Mat(FRAME_HEIGHT, FRAME_WIDTH, CV_8UC3);
+    auto fgMask = cv::Mat(FRAME_HEIGHT, FRAME_WIDTH, CV_8UC1);
+    auto updateMask = cv::Mat(FRAME_HEIGHT, FRAME_WIDTH, CV_8UC1);
+    auto detections = std::vector<cv::Rect2f>();
+    detections.reserve(blobDetector->getMaxNumBlobs() + 1);
+
+    // Use a fixed timestamp clock so the tracker never asks the system
+    auto timestamp = SortTracker::Timestamp();
+
+    std::array<uint64_t, NUM_STAGES> totals{};
+    std::array<uint64_t, NUM_STAGES> maxPerFrame{};
+    uint32_t seed = 12345;
+    int numWarmupTrajectories = 0;
+
+    for (int t = 0; t < numWarmupFrames + numFrames; t++) {
+        renderFrame(frame, t, seed);
+        timestamp += std::chrono::milliseconds(40);
+
+        bool isMeasured = t >= numWarmupFrames;
+        if (t == numWarmupFrames) {
+            numWarmupTrajectories = numTrajectories;
+        }
+        std::array<uint64_t, NUM_STAGES> counts{};
+
+        bool isSparse = false;
+        {
+            auto scope = AllocScope();
+            vibe->segment(frame, fgMask);
+            isSparse = activeTiles.build(fgMask);
+            counts[SEGMENT] = scope.count();
+        }
+        const auto& windows = activeTiles.getWindows();
+
+        {
+            auto scope = AllocScope();
+            if (isSparse) {
+                updateMask.setTo(0);
+                blobDetector->makeUpdateMask(fgMask, updateMask, windows);
+                blobDetector->filter(fgMask, windows);
+            } else {
+                blobDetector->makeUpdateMask(fgMask, updateMask);
+                blobDetector->filter(fgMask);
+            }
+            counts[MORPHOLOGY] = scope.count();
+        }
+
+        {
+            auto scope = AllocScope();
+            vibe->update(frame, updateMask);
+            counts[UPDATE] = scope.count();
+        }
+
+        int numBlobs = 0;
+        {
+            auto scope = AllocScope();
+            numBlobs = isSparse
+                           ? blobDetector->extract(fgMask, detections, windows)
+                           : blobDetector->extract(fgMask, detections);
+            counts[LABELLING] = scope.count();
+        }
+
+        {
+            auto scope = AllocScope();
+            if (numBlobs > blobDetector->getMaxNumBlobs()) {
+                tracker->clear();
+            } else {
+                tracker->update(detections, frame, timestamp);
+            }
+            counts[TRACKING] = scope.count();
+        }
+
+        if (!isMeasured) {
+            continue;
+        }
+
+        for (int s = 0; s < NUM_STAGES; s++) {
+            totals[s] += counts[s];
+            maxPerFrame[s] = std::max(maxPerFrame[s], counts[s]);
+        }
+    }
+
+    int numMeasuredTrajectories = numTrajectories - numWarmupTrajectories;
+    std::printf("[ZERO ALLOC] %d warm-up frames, %d measured frames, "
+                "%d trajectories ended while measured\n",
+                numWarmupFrames,
+                numFrames,
+                numMeasuredTrajectories);
+    std::printf("%-12s %12s %12s %12s\n",
+                "STAGE",
+                "ALLOCS",
+                "PER FRAME",
+                "MAX");
+
+    bool isPassed = true;
+    for (int s = 0; s < NUM_STAGES; s++) {
+        std::printf("%-12s %12llu %12.3f %12llu\n",
+                    STAGE_NAMES[s],
+                    static_cast<unsigned long long>(totals[s]),
+                    static_cast<double>(totals[s]) / std::max(numFrames, 1),
+                    static_cast<unsigned long long>(maxPerFrame[s]));
+        isPassed = isPassed && totals[s] == 0;
+    }
+
+    if (!isPassed) {
+        std::printf("[ZERO ALLOC] FAILED: steady-state allocations found\n");
+        return EXIT_FAILURE;
+    }
+
+    // Otherwise trajectory reuse was never exercised
+    if (numMeasuredTrajectories == 0) {
+        std::printf("[ZERO ALLOC] FAILED: no trajectory ended while "
+                    "measured\n");
+        return EXIT_FAILURE;
+    }
+
+    std::printf("[ZERO ALLOC] PASSED\n");
+    return EXIT_SUCCESS;
+}